@@ -17,12 +17,20 @@
 #include "../Platform/Window.h"
 #include "../Platform/Input.h"
 #include "../Engine/Simulation/Scheduler.h"
+#include "../Engine/ECS/Components/Transform.h"
+#include "Profiler.h"
 #include "../Engine/WorldGen/TerrainNoise.h"
 
 // Global minimal terrain config/state for the viewer
 static TerrainNoiseConfig gNoiseCfg; // defaults defined in header
 static uint64_t gNoiseSeed = 123456789ull;
 static bool gRealtimeGen = true;
+static bool gQuantizeHeights = false; // stocke les hauteurs en uint16 (moitié mémoire RAM/VRAM)
+
+static void GenerateTerrain(TileMap& map) {
+    TerrainNoise::Generate(map, gNoiseSeed, gNoiseCfg);
+    if (gQuantizeHeights) map.quantizeHeights();
+}
 
 static void SetupImGui(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
@@ -71,233 +79,53 @@ bool Application::init() {
     worldMeshRenderer_ = std::make_unique<SimpleWorldMeshRenderer>();
     worldMeshRenderer_->init(&worldMap_);
     // First terrain
-    TerrainNoise::Generate(worldMap_, gNoiseSeed, gNoiseCfg);
+    GenerateTerrain(worldMap_);
     worldMeshRenderer_->rebuild(&worldMap_);
 
-    lastTime_=glfwGetTime(); accumulator_=0.0; fixedStep_=1.0/60.0; return true;
+    fixedStep_=1.0/60.0;
+    sim_ = std::make_unique<SimulationThread>([this](double dt){ fixedUpdate(dt); }, fixedStep_);
+    sim_->setSnapshotWriter([this](SimSnapshot& out){ writeSnapshot(out); });
+    sim_->setBatchUpdate([this](double dt, int ticks){ if (scheduler_) scheduler_->updateFixedBatch(dt, ticks); events_.dispatch(); });
+    if (threadedSim_) sim_->start();
+    lastTime_=glfwGetTime(); return true;
 }
 
 void Application::fixedUpdate(double dt) {
     if (scheduler_) scheduler_->updateFixed(dt);
+    events_.dispatch(); // point de synchronisation: systèmes terminés, producteurs à l'arrêt
+}
+
+// Positions 2D des entités à Transform, triées par index de slot (le rendu apparie deux snapshots par fusion)
+void Application::writeSnapshot(SimSnapshot& out) {
+    snapshotScratch_.clear();
+    View<const Transform>(world_).eachChunk([&](size_t n, const Entity* es, const Transform* ts) {
+        for (size_t i=0; i<n; ++i) snapshotScratch_.push_back({ es[i].index, glm::vec2(ts[i].position.x, ts[i].position.y) });
+    });
+    std::sort(snapshotScratch_.begin(), snapshotScratch_.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    out.ids.reserve(snapshotScratch_.size()); out.positions.reserve(snapshotScratch_.size());
+    for (const auto& [id, p] : snapshotScratch_) { out.ids.push_back(id); out.positions.push_back(p); }
 }
 
 void Application::render(double /*dt*/) {
+    PROFILE_ZONE("Application::render");
+    // Dernier snapshot publié, entités interpolées avec le précédent (rendu décalé d'un pas simulé)
+    if (sim_) { sim_->acquire(); sim_->interpolate(SimulationThread::Now(), renderIds_, renderPositions_); }
     int w, h; appWindow_->framebufferSize(w, h); glViewport(0,0,w,h); glClearColor(0.08f,0.09f,0.11f,1.0f); glClear(GL_COLOR_BUFFER_BIT);
-    static float camX=0.f, camY=0.f; 
-    static float baseZoom=1.f;             // base fit width
-    static float zoomFactor=1.f;           // user scroll factor (>1 close)
-    // Camera always perspective now
-    static float camYaw = 0.f;             // yaw=0 looks toward -Y (screen up)
-    static float camPitchDeg = 89.f;       // starts top-down
-    static float mouseLastX = 0.f, mouseLastY = 0.f; static bool hadMouseLast=false;
-    static const float pitchTopDown = 89.f; // top view
-    static const float pitchFPS      = 18.f; // low angle for FPS
-    static const float maxHeight     = 1200.f; // high altitude overview
-    static float       dynamicMinHeight = 5.f; // will be overridden by human scale computation
-    static const float yawSensitivity   = 0.0030f;
-    static const float pitchSensitivity = 0.0020f * 57.2957795f;
-    static const float fpsPitchSwitch   = 60.f; // below this pitch -> FPS style movement
-    static const float hideMapHeight    = 180.f; // below this height hide L1 map
     static bool meshWireframe = false; // affichage maillage L2
     // GPU tess params (shared with UI)
     static bool autoTessRange = false; static float tessNearD = 250.f, tessFarD = 3000.f; static int tessMinL=1, tessMaxL=24, tessBaseStep=8;
-    static int lastW=0, lastH=0; 
-    const float mapWidthUnits = worldMap_.worldMaxX > 0 ? worldMap_.worldMaxX : (float)worldMap_.width;
-    const float mapHeightUnits = worldMap_.worldMaxY > 0 ? worldMap_.worldMaxY : (float)worldMap_.height;
-    // Recalcul si première frame ou resize
-    static bool camCentered = false;
-    if (lastW!=w || lastH!=h) {
-        baseZoom = (mapWidthUnits>0)? (float)w / mapWidthUnits : 1.f;
-        lastW=w; lastH=h;
-        // Center camera on map
-        camX = mapWidthUnits * 0.5f;
-        camY = mapHeightUnits * 0.5f;
-        camCentered = true;
-    }
-    // Compute synthetic totalZoom (for layer logic) still used by renderers
-    float totalZoom = baseZoom * zoomFactor;
-
-    // Human scale adaptation (configurable)
-    static float cfgWorldKmWidth = 2700.f;      // largeur réelle carte (km)
-    static float cfgEyeHeightMeters = 1.70f;    // hauteur œil humaine (m)
-    float worldKmWidth = cfgWorldKmWidth;
-    float kmPerUnit = (mapWidthUnits>0) ? (worldKmWidth / mapWidthUnits) : 1.f;
-    float humanEyeHeightKm = cfgEyeHeightMeters / 1000.f; // m -> km
-    float humanEyeHeightUnits = (kmPerUnit>0.f) ? (humanEyeHeightKm / kmPerUnit) : 0.002f;
-    if (humanEyeHeightUnits < 0.0001f) humanEyeHeightUnits = 0.0001f; // avoid zero
-    dynamicMinHeight = humanEyeHeightUnits; // override previous fixed min
-
-    // Derive camera height (inverse relation with zoomFactor) using log curve for smoother mid-range
-    float zf = zoomFactor; if (zf < 0.05f) zf = 0.05f; if (zf > 300.f) zf = 300.f;
-    static float zoomEasePower = 2.2f; // >1 -> ralenti fortement la descente proche du sol
-    float tHeightLin = logf(zf) / logf(300.f); // 0 .. 1 (linéaire dans l'espace log du zoom)
-    if (tHeightLin < 0.f) tHeightLin = 0.f; if (tHeightLin>1.f) tHeightLin=1.f;
-    // Ease-out: t' = 1 - (1 - t)^p  (dérivée -> 0 quand t->1)
-    float tHeight = 1.f - powf(1.f - tHeightLin, zoomEasePower);
-    if (tHeight < 0.f) tHeight = 0.f; if (tHeight>1.f) tHeight=1.f;
-    float camHeight = maxHeight - tHeight * (maxHeight - dynamicMinHeight);
-        // Échantillonner hauteur mesh sous la caméra et empêcher la caméra de passer au travers
-        auto sampleHeight01At = [&](float wx, float wy){
-            if (worldMap_.width<=0 || worldMap_.height<=0 || worldMap_.tileHeights.empty()) return 0.0f;
-            float gx = (worldMap_.worldMaxX>0)? (wx / worldMap_.worldMaxX) * (float)(worldMap_.width - 1) : wx;
-            float gy = (worldMap_.worldMaxY>0)? (wy / worldMap_.worldMaxY) * (float)(worldMap_.height - 1) : wy;
-            // clamp to grid
-            if (!(gx>=0 && gy>=0 && gx<=worldMap_.width-1 && gy<=worldMap_.height-1)){
-                gx = std::clamp(gx, 0.0f, (float)(worldMap_.width - 1));
-                gy = std::clamp(gy, 0.0f, (float)(worldMap_.height - 1));
-            }
-            int x0 = (int)floorf(gx); int y0 = (int)floorf(gy);
-            int x1 = std::min(x0+1, worldMap_.width-1);
-            int y1 = std::min(y0+1, worldMap_.height-1);
-            float tx = gx - (float)x0; float ty = gy - (float)y0;
-            size_t i00 = (size_t)y0*worldMap_.width + x0;
-            size_t i10 = (size_t)y0*worldMap_.width + x1;
-            size_t i01 = (size_t)y1*worldMap_.width + x0;
-            size_t i11 = (size_t)y1*worldMap_.width + x1;
-            float h00 = (i00<worldMap_.tileHeights.size())? worldMap_.tileHeights[i00] : 0.f;
-            float h10 = (i10<worldMap_.tileHeights.size())? worldMap_.tileHeights[i10] : 0.f;
-            float h01 = (i01<worldMap_.tileHeights.size())? worldMap_.tileHeights[i01] : 0.f;
-            float h11 = (i11<worldMap_.tileHeights.size())? worldMap_.tileHeights[i11] : 0.f;
-            float hx0 = h00 + (h10 - h00) * tx;
-            float hx1 = h01 + (h11 - h01) * tx;
-            return hx0 + (hx1 - hx0) * ty; // 0..globalAmplitude
-        };
-        float ground01 = sampleHeight01At(camX, camY);
-        float heightScaleZ = (worldMeshRenderer_? worldMeshRenderer_->heightScale() : 1.0f);
-        // Convertit en Z en soustrayant la base min pour être cohérent avec le shader
-        float baseMin = worldMap_.landMinHeight;
-        float groundZ = std::max(0.0f, (ground01 - baseMin)) * heightScaleZ; // unités monde
-        // Anticipe la pente en échantillonnant un point devant la caméra
-        float fxYaw = sinf(camYaw), fyYaw = -cosf(camYaw);
-        float aheadDist = std::max(1.0f, 6.0f * dynamicMinHeight); // quelques mètres devant
-        float groundAhead01 = sampleHeight01At(camX + fxYaw * aheadDist, camY + fyYaw * aheadDist);
-        float groundAheadZ = std::max(0.0f, (groundAhead01 - baseMin)) * heightScaleZ;
-        groundZ = std::max(groundZ, groundAheadZ);
-        // Limite zoom: ne jamais descendre sous 1.70 m au-dessus du sol (epsilon pour éviter clipping)
-        {
-            float eps = std::max(0.25f * dynamicMinHeight, 0.05f);
-            float minCamZ = groundZ + eps;
-            float limitZ = groundZ + dynamicMinHeight;
-            if (minCamZ > limitZ) minCamZ = limitZ; // sécurité
-            if (camHeight < limitZ) camHeight = std::max(camHeight, minCamZ);
-        }
-    if (camHeight < dynamicMinHeight) camHeight = dynamicMinHeight;
-    float altitudeT = (camHeight - dynamicMinHeight) / (maxHeight - dynamicMinHeight); if (altitudeT<0) altitudeT=0; if (altitudeT>1) altitudeT=1;
-
-    // Target pitch based on height (higher -> top-down)
-    float tPitch = (camHeight - dynamicMinHeight) / (maxHeight - dynamicMinHeight); if (tPitch<0) tPitch=0; if (tPitch>1) tPitch=1;
-    float targetPitch = pitchFPS + tPitch * (pitchTopDown - pitchFPS);
-
-    // Mouse look only when below top-down threshold or user forces by holding mouse left
-    double mxNow,myNow; input_->mousePosition(mxNow,myNow);
-    if (!hadMouseLast) { mouseLastX=(float)mxNow; mouseLastY=(float)myNow; hadMouseLast=true; }
-    bool allowYaw = (targetPitch < pitchTopDown - 5.f); // avoid yaw changes in near top-down to keep north up
-    if (input_->isDown(GLFW_MOUSE_BUTTON_LEFT) && allowYaw) {
-        float dx = (float)mxNow - mouseLastX;
-        float dy = (float)myNow - mouseLastY;
-        camYaw += dx * yawSensitivity;
-        camPitchDeg -= dy * pitchSensitivity; // souris haut -> regarde haut
-        if (camYaw > 3.14159265f) camYaw -= 6.2831853f; else if (camYaw < -3.14159265f) camYaw += 6.2831853f;
-        if (camPitchDeg < pitchFPS) camPitchDeg = pitchFPS; if (camPitchDeg > pitchTopDown) camPitchDeg = pitchTopDown;
-    }
-    mouseLastX=(float)mxNow; mouseLastY=(float)myNow;
-    // Converge pitch toward target if user not actively dragging
-    if (!(input_->isDown(GLFW_MOUSE_BUTTON_LEFT) && allowYaw)) {
-        camPitchDeg = camPitchDeg * 0.90f + targetPitch * 0.10f;
-    }
-    if (camPitchDeg < pitchFPS) camPitchDeg = pitchFPS; if (camPitchDeg > pitchTopDown) camPitchDeg = pitchTopDown;
-    if (!allowYaw) camYaw = 0.f; // lock north-up in top-down region
-
-    // Movement (ZQSD)
-    bool keyFwd  = input_->isDown(GLFW_KEY_W) || input_->isDown(GLFW_KEY_Z);
-    bool keyBack = input_->isDown(GLFW_KEY_S);
-    bool keyLeft = input_->isDown(GLFW_KEY_A) || input_->isDown(GLFW_KEY_Q);
-    bool keyRight= input_->isDown(GLFW_KEY_D);
-    // Movement speed revisité (échelle humaine accrue):
-    bool keySprint = input_->isDown(GLFW_KEY_LEFT_SHIFT) || input_->isDown(GLFW_KEY_RIGHT_SHIFT);
-    float humanWalkKmPerSec = 0.0010f; // ~1.0 m/s très lent pour donner échelle
-    float humanRunKmPerSec  = 0.0028f; // ~2.8 m/s (Shift)
-    float humanSpeedKmPerSec = keySprint ? humanRunKmPerSec : humanWalkKmPerSec;
-    float humanSpeedUnitsPerSec = (kmPerUnit>0.f)? (humanSpeedKmPerSec / kmPerUnit) : 1.f;
-    float overviewSpeedUnitsPerSec = mapWidthUnits * 0.25f; // altitude haute
-    float heightT = (camHeight - dynamicMinHeight) / (maxHeight - dynamicMinHeight); if (heightT<0) heightT=0; if (heightT>1) heightT=1;
-    float localTransitionHeight = dynamicMinHeight * 1200.f + 0.0001f; // zone où on quitte la lenteur extrême
-    float groundT = (camHeight - dynamicMinHeight) / localTransitionHeight; if (groundT<0) groundT=0; if (groundT>1) groundT=1;
-    // Exponent + offset très faible au sol
-    float gamma = 2.8f; float minFactor = 0.03f; // 3% vitesse marche au ras
-    float nearGroundFactor = minFactor + (1 - minFactor) * powf(groundT, gamma);
-    float scaledHumanSpeed = humanSpeedUnitsPerSec * nearGroundFactor;
-    float currentSpeedUnitsPerSec = scaledHumanSpeed * (1.0f - heightT) + overviewSpeedUnitsPerSec * heightT;
-    float moveSpeed = currentSpeedUnitsPerSec * (float)fixedStep_;
-    if (camPitchDeg > fpsPitchSwitch) {
-        // Top-down style (screen axes)
-        if (keyFwd)  camY -= moveSpeed;
-        if (keyBack) camY += moveSpeed;
-    // Inversion X pour que Q (gauche) fasse défiler la carte vers la gauche visuelle
-    if (keyLeft) camX += moveSpeed;  // anciennement -
-    if (keyRight)camX -= moveSpeed;  // anciennement +
-    // no verbose logs in minimal viewer
-    } else {
-    float yaw = camYaw;
-    float fx = sinf(yaw);
-    float fy = -cosf(yaw);
-    float rx =  fy;
-    float ry =  fx;
-    glm::vec2 dir(0);
-        if (keyFwd)  dir += glm::vec2(fx,fy);
-        if (keyBack) dir -= glm::vec2(fx,fy);
-        if (keyLeft) dir -= glm::vec2(rx,ry);
-        if (keyRight)dir += glm::vec2(rx,ry);
-        // no verbose logs in minimal viewer
-        if (dir.x!=0 || dir.y!=0) {
-            dir = glm::normalize(dir);
-            camX += dir.x * moveSpeed;
-            camY += dir.y * moveSpeed;
-            // no verbose logs in minimal viewer
-        }
-    }
-
-    // Scroll zoom ancré sur la position souris (point monde sous le curseur reste stable)
-    double mx, my; input_->mousePosition(mx, my); // coords fenêtre en pixels
-    double scroll = input_->scrollDelta();
-    // Adaptive scroll: pas très fin proche du sol, plus gros en altitude
-    static float scrollMinStep = 0.010f; // multiplicateur - proche sol -> 1 +/- 0.01
-    static float scrollMaxStep = 0.11f;  // multiplicateur haut -> 1 +/- 0.11 (≈ précédent 10%)
-    float step = scrollMinStep + (scrollMaxStep - scrollMinStep) * altitudeT; if (step < 0.001f) step = 0.001f; if (step > 0.5f) step = 0.5f;
-    if (scroll != 0.0) {
-        float mult = (scroll > 0.0) ? (1.f + step) : (1.f - step);
-        if (mult < 0.01f) mult = 0.01f;
-        zoomFactor *= mult;
-        if (zoomFactor < 0.05f) zoomFactor = 0.05f; if (zoomFactor > 300.f) zoomFactor = 300.f;
-    }
-    glm::mat4 vp;
-    // Perspective always + FOV/clip dynamiques
-    float aspect = (float)w / (float)h;
-    float fovNear = 58.f, fovFar = 63.f;
-    float fovBlend = (camHeight - dynamicMinHeight) / (maxHeight - dynamicMinHeight); if (fovBlend<0) fovBlend=0; if (fovBlend>1) fovBlend=1;
-    float fov = fovNear * (1 - fovBlend) + fovFar * fovBlend;
-    float nearPlane = camHeight * 0.05f; float minNear = dynamicMinHeight * 0.02f; if (nearPlane < minNear) nearPlane = minNear; if (nearPlane < 0.0000005f) nearPlane = 0.0000005f;
-    float farPlaneLow = 600.f; float farPlaneHigh = 20000.f; float farPlane = farPlaneLow * (1 - fovBlend) + farPlaneHigh * fovBlend;
-    glm::mat4 proj = glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
-    float pitchRad = glm::radians(camPitchDeg);
-    float yaw = camYaw;
-    float fx3 = sinf(yaw) * cosf(pitchRad); float fy3 = -cosf(yaw) * cosf(pitchRad); float fz3 = -sinf(pitchRad);
-    glm::vec3 eye(camX, camY, camHeight); glm::vec3 forward(fx3,fy3,fz3); glm::vec3 center = eye + forward;
-    glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0,0,1));
-    // No Y reflection now (keep natural right-handed: +Y up). Movement logic keeps continuity.
-    vp = proj * view;
+    // Caméra: contrôles carte puis matrices/frustum/emprise calculés une fois, partagés par les renderers et les étiquettes
+    mapCamera_.update(camera_, worldMap_, *input_, w, h, worldMeshRenderer_? worldMeshRenderer_->heightScale() : 1.0f, (float)fixedStep_);
+    const float totalZoom = mapCamera_.totalZoom(); // logique de couches (seuils renderers)
     bool showFar = false;
-    // Compute view width in world units for adaptive/tess logic
-    float viewWorldWidth_now = (float)w / totalZoom;
+    // Emprise visible (unités monde) pour la portée de tessellation
+    float viewWorldWidth_now = camera_.visibleWidth();
     if (worldMeshRenderer_) {
         bool force = !showFar; // toujours visible quand la carte 2D est cachée
-    worldMeshRenderer_->setCamera(camX, camY);
-        // Auto-tie tess near/far to zoom (view width)
+        // Auto-tie tess near/far to the visible footprint
         if (worldMeshRenderer_->tessEnabled()) {
             if (autoTessRange) {
-                float nearF = std::clamp(viewWorldWidth_now * 0.15f, 10.f, 4000.f);
-                float farF  = std::clamp(viewWorldWidth_now * 1.50f, nearF + 50.f, 20000.f);
-                tessNearD = nearF; tessFarD = farF;
+                camera_.tessRange(tessNearD, tessFarD);
                 worldMeshRenderer_->setTessParams(tessNearD, tessFarD, tessMinL, tessMaxL, tessBaseStep);
             } else {
                 // Ensure renderer has latest manual values
@@ -305,27 +133,26 @@ void Application::render(double /*dt*/) {
             }
         }
         if (meshWireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        worldMeshRenderer_->render(&worldMap_, vp, totalZoom, force);
+        worldMeshRenderer_->render(&worldMap_, camera_, totalZoom, force);
         if (meshWireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
 
+    Profiler::Zone imguiZone("ImGui");
     ImGui_ImplOpenGL3_NewFrame(); ImGui_ImplGlfw_NewFrame(); ImGui::NewFrame();
+    if (input_->wasPressed(GLFW_KEY_F3)) overlays_.toggleProfiler();
+    overlays_.drawProfiler(glfwGetTime());
 
     // No HUD
 
     // Calque labels monde (avant fenêtre UI) : utiliser draw list background pour rester sous les fenêtres
     ImDrawList* dl = ImGui::GetBackgroundDrawList();
     // Ancien worldToScreen 2D (utile debug axes top-down)
-    auto worldToScreen2D = [&](float wx, float wy){ ImVec2 p; p.x = (wx - camX)*totalZoom; p.y = (wy - camY)*totalZoom; return p; };
-    // Projection perspective correcte (wx,wy,wz=0) -> écran pixels
-    auto projectToScreen = [&](float wx, float wy, float wz)->std::optional<ImVec2>{
-        glm::vec4 clip = vp * glm::vec4(wx, wy, wz, 1.0f);
-        if (clip.w <= 0.00001f) return std::nullopt; // derrière caméra
-        glm::vec3 ndc = glm::vec3(clip) / clip.w; // -1..1
-        // Optionnel: on garde même hors frustum partiel pour anti-pop; on peut tester ndc.z si besoin
-        float sx = (ndc.x * 0.5f + 0.5f) * (float)w;
-        float sy = (-ndc.y * 0.5f + 0.5f) * (float)h; // y écran down
-        return ImVec2(sx, sy);
+    auto worldToScreen2D = [&](float wx, float wy){ ImVec2 p; p.x = (wx - camera_.position().x)*totalZoom; p.y = (wy - camera_.position().y)*totalZoom; return p; };
+    // Projection perspective (étiquettes): ancre hors frustum (marge = rayon monde, anti-pop) ou derrière la caméra -> rejetée
+    auto projectToScreen = [&](float wx, float wy, float wz, float radius)->std::optional<ImVec2>{
+        glm::vec2 s;
+        if (!camera_.isVisible(glm::vec3(wx, wy, wz), radius) || !camera_.project(glm::vec3(wx, wy, wz), s)) return std::nullopt;
+        return ImVec2(s.x, s.y);
     };
 
     // Debug axes overlay (optionnel)
@@ -348,16 +175,41 @@ void Application::render(double /*dt*/) {
         }
     }
 
-    // No labels
+    // Étiquettes des lieux: ancre posée sur le relief, rejetée hors frustum avant projection
+    if (!worldMap_.places.empty()) {
+        const float psx = (worldMap_.width>1 && worldMap_.worldMaxX>0)? worldMap_.worldMaxX/(float)(worldMap_.width-1) : 1.f;
+        const float psy = (worldMap_.height>1 && worldMap_.worldMaxY>0)? worldMap_.worldMaxY/(float)(worldMap_.height-1) : 1.f;
+        const float hs = worldMeshRenderer_? worldMeshRenderer_->heightScale() : 1.f;
+        const PlaceTable& places = worldMap_.places;
+        for (size_t i=0; i<places.size(); ++i) {
+            float wx = places.x[i]*psx, wy = places.y[i]*psy, wz = std::max(0.f, worldMap_.sampleHeight(wx, wy) - worldMap_.landMinHeight) * hs;
+            auto p = projectToScreen(wx, wy, wz, 2.f); if (!p) continue;
+            std::string_view name = worldMap_.placeName(i);
+            dl->AddText(*p, IM_COL32(240,235,220,255), name.data(), name.data() + name.size());
+        }
+    }
+
+    // Entités simulées (positions interpolées), posées sur le relief comme les étiquettes
+    static bool showEntities = true;
+    if (showEntities && !renderPositions_.empty()) {
+        const float hs = worldMeshRenderer_? worldMeshRenderer_->heightScale() : 1.f;
+        for (const glm::vec2& e : renderPositions_) {
+            float wz = std::max(0.f, worldMap_.sampleHeight(e.x, e.y) - worldMap_.landMinHeight) * hs;
+            auto p = projectToScreen(e.x, e.y, wz, 1.f); if (!p) continue;
+            dl->AddCircleFilled(*p, 3.f, IM_COL32(255,200,60,255));
+        }
+    }
 
     ImGui::Begin("Warland");
     ImGui::Text("Map %dx%d", worldMap_.width, worldMap_.height);
-    ImGui::Text("Zoom: %.2f  Height: %.3f  Pitch: %.1f  Mode: %s", zoomFactor, camHeight, camPitchDeg, camPitchDeg>fpsPitchSwitch? "TopDown":"FPS");
+    ImGui::Text("Zoom: %.2f  Height: %.3f  Pitch: %.1f  Mode: %s", mapCamera_.zoomFactor(), mapCamera_.height(), mapCamera_.pitchDeg(), mapCamera_.topDown()? "TopDown":"FPS");
+    if (worldMeshRenderer_) ImGui::Text("Chunks: %d / %d visible", worldMeshRenderer_->visibleChunks(), worldMeshRenderer_->chunkCount());
     if (ImGui::CollapsingHeader("Render", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Checkbox("Wireframe mesh", &meshWireframe);
         bool hshade = worldMeshRenderer_? worldMeshRenderer_->heightShading() : true;
         if (ImGui::Checkbox("Height shading", &hshade)) { if (worldMeshRenderer_) worldMeshRenderer_->setHeightShading(hshade); }
         ImGui::Checkbox("Debug axes monde", &showAxes);
+        ImGui::Checkbox("Entities", &showEntities);
         static bool adaptive = false; static float radius = 200.f; static int refine = 4; static int outerStep = 4;
         if (ImGui::Checkbox("Adaptive refinement (near camera)", &adaptive)) { if(worldMeshRenderer_) worldMeshRenderer_->setAdaptive(adaptive, radius, refine, outerStep); }
         if (adaptive) {
@@ -387,14 +239,39 @@ void Application::render(double /*dt*/) {
             }
         }
     }
+    if (sim_ && ImGui::CollapsingHeader("Simulation")) {
+        if (ImGui::Checkbox("Threaded", &threadedSim_)) { if (threadedSim_) sim_->start(); else sim_->stop(); }
+        ImGui::SameLine(); bool prof = overlays_.profilerVisible(); if (ImGui::Checkbox("Profiler (F3)", &prof)) overlays_.toggleProfiler();
+        SimStats st = sim_->stats();
+        ImGui::Text("Tick %llu  alpha %.2f  entities %zu", (unsigned long long)sim_->current().tick, sim_->alpha(SimulationThread::Now()), renderIds_.size());
+        ImGui::Text("Sim tick: %.3f ms (max %.3f)  Render: %.2f ms", st.tickMs, st.tickMaxMs, st.renderMs);
+        ImGui::Text("Snapshot latency: %.3f ms  Dropped ticks: %llu", st.snapshotLatencyMs, (unsigned long long)st.droppedTicks);
+        Timewarp::Settings tw = sim_->timewarp(); bool twChanged = false;
+        for (int i=0; i<Timewarp::kSpeedCount; ++i) {
+            char label[16]; if (Timewarp::kSpeeds[i] == 0.0) std::snprintf(label, sizeof(label), "||"); else std::snprintf(label, sizeof(label), "x%g", Timewarp::kSpeeds[i]);
+            if (i) ImGui::SameLine();
+            if (ImGui::RadioButton(label, Timewarp::IndexOf(tw.speed) == i)) { tw.speed = Timewarp::kSpeeds[i]; twChanged = true; }
+        }
+        if (tw.speed == 0.0) { if (ImGui::Button("Step")) sim_->stepTicks(1); ImGui::SameLine(); if (ImGui::Button("Step x60")) sim_->stepTicks(60); }
+        float budget = (float)tw.frameBudgetMs; if (ImGui::SliderFloat("Budget (ms)", &budget, 1.f, 50.f)) { tw.frameBudgetMs = budget; twChanged = true; }
+        if (twChanged) sim_->setTimewarp(tw);
+        ImGui::Text("Speed x%g  effective x%.1f%s", st.requestedSpeed, st.effectiveSpeed, st.effectiveSpeed < st.requestedSpeed * 0.9 ? "  (budget-limited)" : "");
+        ImGui::Text("Batches %llu (%.1f ticks/batch)  Budget hits %llu", (unsigned long long)st.batches, st.ticksPerBatch, (unsigned long long)st.budgetHits);
+        int level = (int)simLevel_;
+        for (int l=0; l<SimLOD::kLevelCount; ++l) {
+            if (l) ImGui::SameLine();
+            if (ImGui::RadioButton(SimLOD::LevelName((SimLOD::Level)l), &level, l)) { simLevel_ = (SimLOD::Level)l; simLod_.apply(*scheduler_, simLevel_); }
+        }
+    }
     if (ImGui::CollapsingHeader("Camera / Zoom")) {
-        ImGui::SliderFloat("Zoom ease power", &zoomEasePower, 1.0f, 5.0f, "%.2f");
-        ImGui::SliderFloat("Scroll min step", &scrollMinStep, 0.001f, 0.05f, "%.3f");
-        ImGui::SliderFloat("Scroll max step", &scrollMaxStep, 0.05f, 0.25f, "%.2f");
+        ImGui::SliderFloat("Zoom ease power", &mapCamera_.zoomEasePower, 1.0f, 5.0f, "%.2f");
+        ImGui::SliderFloat("Scroll min step", &mapCamera_.scrollMinStep, 0.001f, 0.05f, "%.3f");
+        ImGui::SliderFloat("Scroll max step", &mapCamera_.scrollMaxStep, 0.05f, 0.25f, "%.2f");
     }
     if (ImGui::CollapsingHeader("Terrain", ImGuiTreeNodeFlags_DefaultOpen)) {
         bool dirty=false;
         ImGui::Checkbox("Realtime", &gRealtimeGen);
+        dirty |= ImGui::Checkbox("Quantized heights (16-bit)", &gQuantizeHeights);
         ImGui::Text("Seed: %llu", (unsigned long long)gNoiseSeed);
         if (ImGui::Button("Randomize seed")) { gNoiseSeed = (((uint64_t)rand()<<32) ^ (uint64_t)rand() ^ (uint64_t)glfwGetTime()); dirty=true; }
         // Vertical scale for mesh
@@ -413,24 +290,31 @@ void Application::render(double /*dt*/) {
         dirty |= ImGui::SliderInt("Blur passes", &gNoiseCfg.blurPasses, 0, 6);
         dirty |= ImGui::SliderFloat("Slope X", &gNoiseCfg.slopeX, -0.5f, 0.5f, "%.2f");
         dirty |= ImGui::SliderFloat("Slope Y", &gNoiseCfg.slopeY, -0.5f, 0.5f, "%.2f");
-        if (dirty && gRealtimeGen) { TerrainNoise::Generate(worldMap_, gNoiseSeed, gNoiseCfg); if (worldMeshRenderer_) worldMeshRenderer_->rebuild(&worldMap_); }
-        if (!gRealtimeGen && ImGui::Button("Generate")) { TerrainNoise::Generate(worldMap_, gNoiseSeed, gNoiseCfg); if (worldMeshRenderer_) worldMeshRenderer_->rebuild(&worldMap_); }
+        if (dirty && gRealtimeGen) { GenerateTerrain(worldMap_); if (worldMeshRenderer_) worldMeshRenderer_->rebuild(&worldMap_); }
+        if (!gRealtimeGen && ImGui::Button("Generate")) { GenerateTerrain(worldMap_); if (worldMeshRenderer_) worldMeshRenderer_->rebuild(&worldMap_); }
     }
     ImGui::End();
     ImGui::Render(); ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    imguiZone.end();
 }
 
 void Application::run() {
+    Profiler::SetThreadName("Main");
     while (!appWindow_->shouldClose()) {
-        double now = glfwGetTime(); double frame = now - lastTime_; lastTime_=now; accumulator_+=frame;
+        PROFILE_ZONE("Frame");
+        double now = glfwGetTime(); double frame = now - lastTime_; lastTime_=now;
         input_->beginFrame(); appWindow_->poll();
-        while (accumulator_>=fixedStep_) { fixedUpdate(fixedStep_); accumulator_-=fixedStep_; }
+        sim_->pump(); // sans effet si la simulation tourne sur son thread
+        double r0 = SimulationThread::Now();
         render(frame);
-        appWindow_->swap(); input_->endFrame();
+        sim_->reportRenderTime((SimulationThread::Now() - r0) * 1000.0);
+        { PROFILE_ZONE("Swap"); appWindow_->swap(); }
+        input_->endFrame();
     }
 }
 
 void Application::shutdown() {
+    if (sim_) { sim_->stop(); sim_.reset(); }
     if (worldMeshRenderer_) { worldMeshRenderer_->shutdown(); worldMeshRenderer_.reset(); }
     ShutdownImGui();
     if (input_) input_.reset();
@@ -6,10 +6,18 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "EventBus.h"
 #include "../Platform/Window.h"
 #include "../Platform/Input.h"
+#include "../Engine/ECS/Registry.h"
 #include "../Engine/Simulation/Scheduler.h"
+#include "../Engine/Simulation/SimulationThread.h"
+#include "../Engine/Simulation/LOD.h"
+#include "../Engine/UI/Overlays.h"
+#include "../Engine/Rendering/Camera.h"
 #include "../Engine/Rendering/GL/TileMap.h"
 #include "../Engine/Rendering/World/SimpleWorldMeshRenderer.h"
 
@@ -22,14 +30,21 @@ public:
     void shutdown();
     ~Application();
 
+    // Services de la simulation, capturés par les systèmes enregistrés sur scheduler() (thread simulation).
+    // events(): publier depuis n'importe quel système; s'abonner depuis le thread simulation (un système) ou
+    // simulation arrêtée. Livraison en fin de tick fixe.
+    Scheduler& scheduler() { return *scheduler_; }
+    EventBus& events() { return events_; }
+    Registry& world() { return world_; }
+
 private:
-    void fixedUpdate(double dt);
+    void fixedUpdate(double dt); // thread simulation
     void render(double dt);
     void renderWorld(double dt);
+    void writeSnapshot(SimSnapshot& out); // thread simulation
 
 private:
     GLFWwindow* window_ = nullptr;
-    double accumulator_ = 0.0;
     double lastTime_ = 0.0;
     double fixedStep_ = 1.0 / 60.0;
 
@@ -37,10 +52,22 @@ private:
     std::unique_ptr<Window> appWindow_;
     std::unique_ptr<Input> input_;
     std::unique_ptr<Scheduler> scheduler_;
+    EventBus events_;                       // événements moteur, livrés en fin de tick fixe (thread simulation)
+    Registry world_;                        // entités simulées: thread simulation seulement, le rendu lit les snapshots
+    std::vector<std::pair<uint32_t, glm::vec2>> snapshotScratch_; // tri par id avant publication (thread simulation)
+    std::unique_ptr<SimulationThread> sim_; // pas fixe découplé du rendu (snapshots triple buffer)
+    std::vector<uint32_t> renderIds_;       // entités interpolées de la frame (thread rendu)
+    std::vector<glm::vec2> renderPositions_;
+    bool threadedSim_ = true;               // false: ticks exécutés sur le thread rendu (debug)
+    SimLOD::Policy simLod_ = SimLOD::Policy::Default();
+    SimLOD::Level simLevel_ = SimLOD::Level::World;
+    Overlays overlays_;                     // profileur (F3)
 
     // Minimal world data & renderer (no L1)
     TileMap worldMap_;
     std::unique_ptr<SimpleWorldMeshRenderer> worldMeshRenderer_;
+    Camera camera_;                   // vue/projection/frustum de la frame, partagée par les renderers
+    MapCameraController mapCamera_;   // contrôles carte (zoom, ZQSD, regard)
 
     bool vsync_ = true;
 };
@@ -0,0 +1,68 @@
+#include "EventBus.h"
+#include "Profiler.h"
+#include <bitset>
+#include <cstdio>
+
+namespace {
+// Slots de threads producteurs partagés par tous les bus; rendus à la sortie du thread (pas d'épuisement quand des
+// threads éphémères publient). Un slot recyclé reprend le tampon de son ancien thread: jamais deux écrivains à la fois.
+std::mutex gSlotsM;
+std::bitset<EventBus::kMaxThreads> gSlotsUsed;
+
+struct ThreadSlotHolder {
+    unsigned slot = EventBus::kMaxThreads;
+    ThreadSlotHolder() {
+        std::lock_guard<std::mutex> lock(gSlotsM);
+        for (unsigned i=0; i<EventBus::kMaxThreads; ++i) if (!gSlotsUsed[i]) { gSlotsUsed[i] = true; slot = i; break; }
+    }
+    ~ThreadSlotHolder() {
+        if (slot >= EventBus::kMaxThreads) return;
+        std::lock_guard<std::mutex> lock(gSlotsM);
+        gSlotsUsed[slot] = false;
+    }
+};
+}
+
+uint32_t EventBus::NextChannelId() {
+    static std::atomic<uint32_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventBus::ReportTooManyChannels(uint32_t id) {
+    static std::atomic<uint32_t> reported{0}; // premier dépassement seulement (un type refusé le reste)
+    if (reported.fetch_add(1, std::memory_order_relaxed) == 0)
+        std::fprintf(stderr, "[EventBus] Plus de %u types d'événements (type #%u): publications et abonnements refusés\n", kMaxChannels, id);
+}
+
+unsigned EventBus::ThreadSlot() {
+    thread_local ThreadSlotHolder holder;
+    return holder.slot;
+}
+
+EventBus::~EventBus() {
+    for (auto& c : channels_) delete c.load(std::memory_order_relaxed);
+}
+
+void EventBus::unsubscribe(SubscriptionId id) {
+    for (ChannelBase* c : order_) if (c->unsubscribe(id)) return;
+}
+
+size_t EventBus::dispatch() {
+    PROFILE_ZONE("EventBus::dispatch");
+    // Canaux sans abonné vidés; lots de tous les canaux figés avant livraison (publications des abonnés: dispatch suivant)
+    for (auto& slot : channels_) if (ChannelBase* c = slot.load(std::memory_order_acquire); c && !c->ordered) c->drop();
+    size_t n = 0;
+    for (ChannelBase* c : order_) n += c->gather();
+    for (size_t i=0; i<order_.size(); ++i) order_[i]->deliver();
+    return n;
+}
+
+size_t EventBus::pending() const {
+    size_t n = 0;
+    for (auto& slot : channels_) if (const ChannelBase* c = slot.load(std::memory_order_acquire)) n += c->pending();
+    return n;
+}
+
+void EventBus::clear() {
+    for (auto& slot : channels_) if (ChannelBase* c = slot.load(std::memory_order_acquire)) c->drop();
+}
@@ -1,4 +1,216 @@
 #pragma once
-// [2] TODO: EventBus moteur (pub/sub), thread-safe, file d’événements, dispatch à la fin du fixed update
-// [2] TODO: Différencier des messages in-universe (Courier)
-struct EventBus { /* ... */ };
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bus d'événements moteur (pub/sub) à canaux typés. Distinct des messages in-universe du Courier (délai, portée).
+//
+// publish<E>() depuis n'importe quel thread écrit dans le tampon de ce thread pour le canal E: aucun verrou (seul
+// atomique partagé: la séquence des événements sans clé), aucune allocation une fois les tampons à leur taille de
+// croisière (vidés sans libérer à chaque dispatch).
+// dispatch() est le point de synchronisation (fin du tick fixe, producteurs à l'arrêt): les tampons de chaque canal
+// sont fusionnés puis livrés par lots (std::span) aux abonnés. Canaux dans l'ordre de leur premier abonnement, abonnés
+// dans l'ordre d'abonnement, événements sans clé d'abord, puis triés par clé d'ordre (stable).
+// Ordre déterministe: les producteurs parallèles passent une clé (index d'entité, de chunk..., 0 compris); à clé égale,
+// ordre d'émission du même thread. Les événements sans clé prennent un numéro de séquence du bus: ordre de
+// publication, indépendant du worker qui a exécuté le producteur (systèmes enchaînés sur des threads variables).
+// Publier pendant la livraison: livré au dispatch suivant. Canal sans abonné: vidé.
+class EventBus {
+public:
+    static constexpr unsigned kMaxThreads = 64;    // producteurs sans verrou; au-delà, tampon partagé sous verrou
+    static constexpr unsigned kMaxChannels = 256;  // types d'événements distincts (tous bus confondus)
+    using SubscriptionId = uint32_t;
+    static constexpr SubscriptionId kInvalidSubscription = 0; // abonnement refusé (plus de kMaxChannels types)
+
+    EventBus() = default;
+    ~EventBus();
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // false: type refusé (kMaxChannels atteint)
+    template<class E> bool publish(const E& event);                 // sans clé: ordre de publication
+    template<class E> bool publish(const E& event, uint64_t order); // avec clé d'ordre (toute valeur)
+    // Abonnement par lot ou par événement, sur le thread du dispatch; pendant une livraison, un nouvel abonné reçoit à partir du lot suivant
+    template<class E> SubscriptionId subscribe(std::function<void(std::span<const E>)> fn);
+    template<class E> SubscriptionId subscribeEach(std::function<void(const E&)> fn);
+    void unsubscribe(SubscriptionId id);
+
+    size_t dispatch();        // nombre d'événements livrés
+    size_t pending() const;   // au point de synchronisation
+    void clear();             // événements en attente abandonnés
+
+private:
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual size_t gather() = 0;   // tampons des threads -> lot trié
+        virtual void deliver() = 0;
+        virtual void drop() = 0;
+        virtual size_t pending() const = 0;
+        virtual bool unsubscribe(SubscriptionId id) = 0;
+        bool ordered = false;          // présent dans order_
+    };
+    template<class E> struct Channel;
+
+    static uint32_t NextChannelId();
+    template<class E> static uint32_t ChannelId() { static const uint32_t id = NextChannelId(); return id; }
+    static void ReportTooManyChannels(uint32_t id); // une fois par type refusé
+    static unsigned ThreadSlot();  // slot du thread appelant, recyclé à sa sortie
+    template<class E> Channel<E>* channel();       // nullptr au-delà de kMaxChannels
+
+    std::array<std::atomic<ChannelBase*>, kMaxChannels> channels_{};
+    std::vector<ChannelBase*> order_;  // canaux abonnés, ordre du premier abonnement
+    SubscriptionId nextSub_ = 1;
+    std::atomic<uint64_t> sequence_{1};    // ordre de publication des événements sans clé (0 réservé: avec clé)
+};
+
+template<class E>
+struct EventBus::Channel final : ChannelBase {
+    static_assert(std::is_copy_constructible_v<E>, "EventBus: événement copiable requis");
+    // Un tampon par thread (ligne de cache propre: pas de faux partage entre producteurs)
+    struct alignas(64) Buffer { std::vector<E> events; std::vector<uint64_t> orders, seqs; bool keyed = false; };
+
+    std::array<std::atomic<Buffer*>, kMaxThreads> buffers{};
+    Buffer shared; std::mutex sharedM;
+    std::vector<E> batch, scratch;                  // lot fusionné, réutilisés d'un dispatch à l'autre
+    struct Run { uint32_t begin, end; };
+    std::vector<uint64_t> keys, seqs; std::vector<uint32_t> perm; std::vector<Run> runs;
+    struct Sub { SubscriptionId id; std::function<void(std::span<const E>)> fn; bool active = true; };
+    std::vector<std::unique_ptr<Sub>> subs;          // adresses stables: (dés)abonnement possible pendant la livraison
+
+    ~Channel() override { for (auto& b : buffers) delete b.load(std::memory_order_relaxed); }
+
+    // seq = 0: événement avec clé (order), sinon numéro de séquence d'un événement sans clé
+    static void Push(Buffer& b, const E& e, uint64_t order, uint64_t seq) {
+        b.events.push_back(e); b.orders.push_back(order); b.seqs.push_back(seq);
+        b.keyed |= seq == 0;
+    }
+    void push(unsigned slot, const E& e, uint64_t order, uint64_t seq) {
+        if (slot >= kMaxThreads) { std::lock_guard<std::mutex> lock(sharedM); Push(shared, e, order, seq); return; }
+        Buffer* b = buffers[slot].load(std::memory_order_acquire);
+        if (!b) { b = new Buffer(); buffers[slot].store(b, std::memory_order_release); } // une fois par thread et canal
+        Push(*b, e, order, seq);
+    }
+    template<class F> void forBuffers(F&& f) {
+        for (auto& slot : buffers) if (Buffer* b = slot.load(std::memory_order_acquire)) f(*b);
+        f(shared);
+    }
+
+    static void Reset(Buffer& b) { b.events.clear(); b.orders.clear(); b.seqs.clear(); b.keyed = false; }
+    // Sans clé (par séquence) avant avec clé (par clé)
+    bool less(size_t a, size_t b) const {
+        if ((seqs[a] == 0) != (seqs[b] == 0)) return seqs[a] != 0;
+        return seqs[a] != 0 ? seqs[a] < seqs[b] : keys[a] < keys[b];
+    }
+
+    size_t gather() override {
+        batch.clear(); keys.clear(); seqs.clear();
+        // Tri inutile pour un seul tampon sans clé (ordre d'émission = ordre de séquence)
+        size_t sources = 0; bool keyed = false;
+        forBuffers([&](Buffer& b) { if (!b.events.empty()) { ++sources; keyed |= b.keyed; } });
+        const bool sorted = keyed || sources > 1;
+        forBuffers([&](Buffer& b) {
+            if (b.events.empty()) return;
+            if (batch.empty()) batch.swap(b.events); // cas courant: un seul producteur, pas de copie
+            else batch.insert(batch.end(), b.events.begin(), b.events.end());
+            if (sorted) { keys.insert(keys.end(), b.orders.begin(), b.orders.end()); seqs.insert(seqs.end(), b.seqs.begin(), b.seqs.end()); }
+            Reset(b);
+        });
+        if (sorted) for (size_t i=1; i<keys.size(); ++i) if (less(i, i - 1)) { sortBatch(); break; }
+        return batch.size();
+    }
+    // Tri stable (less). Cas courant (tranches de parallelFor): lot = suites croissantes disjointes, remises
+    // bout à bout en O(n); sinon tri d'indices.
+    void sortBatch() {
+        runs.clear();
+        for (size_t i=0; i<keys.size(); ++i) if (i == 0 || less(i, i - 1)) runs.push_back({ (uint32_t)i, 0 });
+        for (size_t r=0; r<runs.size(); ++r) runs[r].end = r + 1 < runs.size() ? runs[r + 1].begin : (uint32_t)keys.size();
+        std::sort(runs.begin(), runs.end(), [&](const Run& a, const Run& b) { return less(a.begin, b.begin) || (!less(b.begin, a.begin) && a.begin < b.begin); });
+        bool disjoint = true;
+        for (size_t r=1; r<runs.size() && disjoint; ++r) {
+            const size_t last = runs[r - 1].end - 1, first = runs[r].begin;
+            disjoint = less(last, first) || (!less(first, last) && runs[r - 1].begin < runs[r].begin);
+        }
+        scratch.clear(); scratch.reserve(batch.size());
+        if (disjoint) for (const Run& r : runs) for (uint32_t i=r.begin; i<r.end; ++i) scratch.push_back(std::move(batch[i]));
+        else {
+            perm.resize(batch.size());
+            for (size_t i=0; i<perm.size(); ++i) perm[i] = (uint32_t)i;
+            std::sort(perm.begin(), perm.end(), [&](uint32_t a, uint32_t b) { return less(a, b) || (!less(b, a) && a < b); });
+            for (uint32_t i : perm) scratch.push_back(std::move(batch[i]));
+        }
+        batch.swap(scratch);
+    }
+    void deliver() override {
+        if (!batch.empty()) {
+            const std::span<const E> events(batch.data(), batch.size());
+            for (size_t i=0, n=subs.size(); i<n; ++i) if (Sub* s = subs[i].get(); s->active) s->fn(events);
+            batch.clear();
+        }
+        // Désabonnements (pendant la livraison ou depuis le dispatch précédent) retirés même sans événement
+        subs.erase(std::remove_if(subs.begin(), subs.end(), [](const auto& s) { return !s->active; }), subs.end());
+    }
+    void drop() override { forBuffers([](Buffer& b) { Reset(b); }); batch.clear(); }
+    size_t pending() const override {
+        size_t n = shared.events.size();
+        for (auto& slot : buffers) if (const Buffer* b = slot.load(std::memory_order_acquire)) n += b->events.size();
+        return n;
+    }
+    bool unsubscribe(SubscriptionId id) override {
+        for (auto& s : subs) if (s->id == id && s->active) { s->active = false; return true; } // retiré après la livraison
+        return false;
+    }
+};
+
+template<class E>
+EventBus::Channel<E>* EventBus::channel() {
+    const uint32_t id = ChannelId<E>();
+    if (id >= kMaxChannels) { ReportTooManyChannels(id); return nullptr; }
+    ChannelBase* c = channels_[id].load(std::memory_order_acquire);
+    if (!c) {
+        // Premier usage concurrent possible (publish depuis plusieurs workers): un seul canal installé
+        auto* created = new Channel<E>();
+        if (channels_[id].compare_exchange_strong(c, created, std::memory_order_acq_rel)) c = created;
+        else delete created;
+    }
+    return static_cast<Channel<E>*>(c);
+}
+
+template<class E>
+bool EventBus::publish(const E& event) {
+    Channel<E>* c = channel<E>();
+    if (!c) return false;
+    c->push(ThreadSlot(), event, 0, sequence_.fetch_add(1, std::memory_order_relaxed));
+    return true;
+}
+
+template<class E>
+bool EventBus::publish(const E& event, uint64_t order) {
+    Channel<E>* c = channel<E>();
+    if (!c) return false;
+    c->push(ThreadSlot(), event, order, 0);
+    return true;
+}
+
+template<class E>
+EventBus::SubscriptionId EventBus::subscribe(std::function<void(std::span<const E>)> fn) {
+    Channel<E>* c = channel<E>();
+    if (!c) return kInvalidSubscription;
+    if (!c->ordered) { c->ordered = true; order_.push_back(c); }
+    c->subs.push_back(std::make_unique<typename Channel<E>::Sub>(typename Channel<E>::Sub{ nextSub_, std::move(fn) }));
+    return nextSub_++;
+}
+
+template<class E>
+EventBus::SubscriptionId EventBus::subscribeEach(std::function<void(const E&)> fn) {
+    return subscribe<E>([fn = std::move(fn)](std::span<const E> events) { for (const E& e : events) fn(e); });
+}
@@ -0,0 +1,327 @@
+#include "Headless.h"
+#include "Profiler.h"
+#include "../Engine/Rendering/GL/TileMap.h"
+#include "../Engine/WorldGen/TerrainNoise.h"
+#include "../Engine/WorldGen/Hydrology.h"
+#include "../Engine/WorldGen/BiomeGenerator.h"
+#include "../Engine/Simulation/Autosave.h"
+#include "../Engine/Simulation/Scheduler.h"
+#include "../Platform/ThreadPool.h"
+#include "../Tools/AssetPacker/AzgaarImporter.h"
+#include "../Tools/Benchmark/BenchmarkSuite.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+using json = nlohmann::json;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+double MsSince(Clock::time_point t0) { return std::chrono::duration<double, std::milli>(Clock::now() - t0).count(); }
+
+struct Metric { std::string name; double value; const char* unit; };
+
+struct RunState {
+    std::unique_ptr<TileMap> map;
+    std::vector<Metric> metrics;       // "<étape>.<mesure>" -> valeur
+    bool quiet = false;
+
+    void add(const std::string& step, const char* what, double value, const char* unit) {
+        metrics.push_back({ step + "." + what, value, unit });
+        if (!quiet) std::printf("  %-40s %14.3f %s\n", (step + "." + what).c_str(), value, unit);
+    }
+};
+
+struct Args {
+    std::vector<std::string> scenarios;
+    int threads = -1;
+    std::string tracePath, reportPath;
+    bool bench = false; std::string benchFilter; int mapSize = 0, repeat = 0;
+    bool quiet = false;
+    std::string compactDir, compactName = "autosave";
+};
+
+void Usage() {
+    std::fprintf(stderr,
+        "usage: Warland --headless scenario.json [...] [--threads N] [--trace trace.json] [--report out.json] [--quiet]\n"
+        "       Warland --headless --bench [filter] [--map-size N] [--repeat N]\n"
+        "       Warland --headless --compact-saves <dir> [name]\n");
+}
+
+bool ParseArgs(int argc, char** argv, Args& a) {
+    for (int i=1; i<argc; ++i) {
+        const std::string s = argv[i];
+        auto next = [&](const char* opt) -> const char* { if (i + 1 >= argc) { std::fprintf(stderr, "[Headless] %s requires a value\n", opt); return nullptr; } return argv[++i]; };
+        if (s == "--headless") continue;
+        else if (s == "--threads") { const char* v = next("--threads"); if (!v) return false; a.threads = std::atoi(v); }
+        else if (s == "--trace") { const char* v = next("--trace"); if (!v) return false; a.tracePath = v; }
+        else if (s == "--report") { const char* v = next("--report"); if (!v) return false; a.reportPath = v; }
+        else if (s == "--map-size") { const char* v = next("--map-size"); if (!v) return false; a.mapSize = std::atoi(v); }
+        else if (s == "--repeat") { const char* v = next("--repeat"); if (!v) return false; a.repeat = std::atoi(v); }
+        else if (s == "--quiet") a.quiet = true;
+        else if (s == "--compact-saves") { const char* v = next("--compact-saves"); if (!v) return false; a.compactDir = v; if (i + 1 < argc && argv[i + 1][0] != '-') a.compactName = argv[++i]; }
+        else if (s == "--bench") { a.bench = true; if (i + 1 < argc && argv[i + 1][0] != '-') a.benchFilter = argv[++i]; }
+        else if (!s.empty() && s[0] == '-') { std::fprintf(stderr, "[Headless] Unknown option %s\n", s.c_str()); return false; }
+        else a.scenarios.push_back(s);
+    }
+    return a.bench || !a.compactDir.empty() || !a.scenarios.empty();
+}
+
+// --- Etapes -------------------------------------------------------------------------------------------------
+
+int StepTerrain(const json& st, const std::string& name, RunState& rs) {
+    const int size = st.value("size", 1024);
+    const int w = st.value("width", size), h = st.value("height", size);
+    if (w <= 0 || h <= 0) { std::fprintf(stderr, "[Headless] %s: invalid size %dx%d\n", name.c_str(), w, h); return Headless::kUsage; }
+    TerrainNoiseConfig cfg;
+    cfg.octaves = st.value("octaves", cfg.octaves);
+    cfg.blurPasses = st.value("blurPasses", cfg.blurPasses);
+    cfg.chunkedBlur = st.value("chunkedBlur", cfg.chunkedBlur);
+    cfg.seaLevel = st.value("seaLevel", cfg.seaLevel);
+    rs.map = std::make_unique<TileMap>();
+    TileMap& map = *rs.map;
+    map.width = w; map.height = h; map.worldMaxX = (float)w; map.worldMaxY = (float)h;
+    map.paletteIndices.assign((size_t)w * h, 2u);
+    auto t0 = Clock::now();
+    TerrainNoise::Generate(map, st.value("seed", (uint64_t)123456789ull), cfg);
+    const double ms = MsSince(t0); const double cells = (double)w * h;
+    rs.add(name, "ms", ms, "ms");
+    rs.add(name, "cellsPerSec", cells / (ms / 1000.0), "cells/s");
+    if (st.value("quantize", false)) {
+        t0 = Clock::now(); map.quantizeHeights();
+        rs.add(name, "quantizeMs", MsSince(t0), "ms");
+    }
+    return Headless::kOk;
+}
+
+int StepHydrology(const json& st, const std::string& name, RunState& rs) {
+    if (!rs.map || !rs.map->hasHeights()) { std::fprintf(stderr, "[Headless] %s: no map (run a terrain or import step first)\n", name.c_str()); return Headless::kStepFailed; }
+    HydrologyConfig cfg;
+    cfg.tileSize = st.value("tileSize", cfg.tileSize);
+    cfg.riverThreshold = st.value("riverThreshold", cfg.riverThreshold);
+    HydrologyResult res;
+    auto t0 = Clock::now();
+    if (!Hydrology::Generate(*rs.map, cfg, &res)) { std::fprintf(stderr, "[Headless] %s: hydrology failed\n", name.c_str()); return Headless::kStepFailed; }
+    const double ms = MsSince(t0);
+    rs.add(name, "ms", ms, "ms");
+    rs.add(name, "fillMs", res.fillMs, "ms");
+    rs.add(name, "accumulationMs", res.accumMs, "ms");
+    rs.add(name, "cellsPerSec", (double)rs.map->width * rs.map->height / (ms / 1000.0), "cells/s");
+    rs.add(name, "rivers", (double)rs.map->rivers.size(), "");
+    return Headless::kOk;
+}
+
+// Hauteurs procédurales de tous les biomes de la carte (paletteIndices), une passe avec mélange aux frontières
+int StepBiomes(const json& st, const std::string& name, RunState& rs) {
+    if (!rs.map || rs.map->paletteIndices.size() != (size_t)rs.map->width * rs.map->height) { std::fprintf(stderr, "[Headless] %s: no map (run a terrain or import step first)\n", name.c_str()); return Headless::kStepFailed; }
+    TileMap& map = *rs.map;
+    const uint16_t maxPalette = map.paletteIndices.empty() ? 0 : *std::max_element(map.paletteIndices.begin(), map.paletteIndices.end());
+    const uint64_t seed = st.value("seed", (uint64_t)1ull);
+    for (int b=0; b+2<=(int)maxPalette; ++b) BiomeGenerator::EnsureBiomeSeed(map, b, seed);
+    auto t0 = Clock::now();
+    BiomeGenerator::GenerateHeightsAllBiomes(map, BiomeGenerator::DefaultConfigsFor(map), st.value("blendRadius", 4));
+    const double ms = MsSince(t0);
+    rs.add(name, "ms", ms, "ms");
+    rs.add(name, "cellsPerSec", (double)map.width * map.height / (ms / 1000.0), "cells/s");
+    return Headless::kOk;
+}
+
+int StepImport(const json& st, const std::string& name, RunState& rs, const std::string& baseDir) {
+    std::string path = st.value("path", std::string());
+    if (path.empty()) { std::fprintf(stderr, "[Headless] %s: missing 'path'\n", name.c_str()); return Headless::kUsage; }
+    if (!std::ifstream(path).good() && !baseDir.empty()) path = baseDir + "/" + path; // relatif au scénario
+    AzgaarImportConfig cfg;
+    cfg.targetWidth = st.value("width", cfg.targetWidth); cfg.targetHeight = st.value("height", cfg.targetHeight);
+    cfg.quantizeHeights = st.value("quantize", cfg.quantizeHeights);
+    auto res = std::make_unique<AzgaarImportResult>();
+    auto t0 = Clock::now();
+    if (!AzgaarImporter::Load(path, cfg, std::string(), st.value("seed", (uint64_t)1ull), *res)) {
+        std::fprintf(stderr, "[Headless] %s: import failed (%s)\n", name.c_str(), path.c_str()); return Headless::kStepFailed;
+    }
+    const double ms = MsSince(t0);
+    rs.map = std::make_unique<TileMap>(std::move(res->map));
+    rs.add(name, "ms", ms, "ms");
+    rs.add(name, "sourceCells", (double)res->sourceCellCount, "");
+    rs.add(name, "cellsPerSec", (double)res->sourceCellCount / (ms / 1000.0), "cells/s");
+    return Headless::kOk;
+}
+
+// Charge synthétique: 'entities' flottants mis à jour 'work' itérations chacun (en attendant les systèmes de jeu)
+struct SyntheticSystem {
+    std::vector<float> state; int work = 8;
+    void update(size_t b, size_t e, double dt) {
+        float* v = state.data();
+        for (size_t i=b; i<e; ++i) { float x = v[i]; for (int k=0; k<work; ++k) x = x * 0.999f + std::sqrt(x + (float)dt); v[i] = x; }
+    }
+};
+
+int StepSimulate(const json& st, const std::string& name, RunState& rs) {
+    const int ticks = st.value("ticks", 600);
+    const double hz = st.value("hz", 60.0);
+    if (!(hz > 0.0)) { std::fprintf(stderr, "[Headless] %s: invalid hz %g (must be > 0)\n", name.c_str(), hz); return Headless::kUsage; }
+    const double dt = 1.0 / hz;
+    const int batch = std::max(1, st.value("batch", 1));
+    Scheduler sched; sched.setParallel(st.value("parallel", true));
+    std::vector<std::unique_ptr<SyntheticSystem>> loads;
+    if (st.contains("systems") && st["systems"].is_array()) {
+        for (auto& js : st["systems"]) {
+            auto load = std::make_unique<SyntheticSystem>();
+            load->state.assign((size_t)std::max(0, js.value("entities", 10000)), 1.0f);
+            load->work = std::max(1, js.value("work", 8));
+            SyntheticSystem* L = load.get(); loads.push_back(std::move(load));
+            SystemDesc d;
+            d.name = js.value("name", std::string("load#") + std::to_string(loads.size()));
+            d.order = js.value("order", 0);
+            d.rateHz = js.value("rateHz", 0.0);
+            if (js.contains("reads")) d.reads = js["reads"].get<std::vector<std::string>>();
+            d.writes = js.contains("writes") ? js["writes"].get<std::vector<std::string>>() : std::vector<std::string>{ d.name };
+            if (js.value("sliced", false)) d.tickSlice = [L](double sdt, size_t k, size_t kc) { size_t b, e; Scheduler::SliceRange(L->state.size(), k, kc, b, e); L->update(b, e, sdt); };
+            else d.tick = [L](double sdt) { L->update(0, L->state.size(), sdt); };
+            if (js.value("batchable", false)) d.tickBatch = [L](double sdt, int n) { L->update(0, L->state.size(), sdt * n); };
+            sched.addSystem(std::move(d));
+        }
+    }
+    std::vector<double> tickMs; tickMs.reserve((size_t)ticks);
+    auto t0 = Clock::now();
+    for (int done=0; done<ticks; ) {
+        const int n = std::min(batch, ticks - done);
+        auto c0 = Clock::now();
+        if (n > 1) sched.updateFixedBatch(dt, n); else sched.updateFixed(dt);
+        const double ms = MsSince(c0);
+        for (int k=0; k<n; ++k) tickMs.push_back(ms / n);
+        done += n;
+    }
+    const double total = MsSince(t0);
+    std::vector<double> sorted = tickMs; std::sort(sorted.begin(), sorted.end());
+    const double p99 = sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+    rs.add(name, "ms", total, "ms");
+    rs.add(name, "ticksPerSec", ticks / (total / 1000.0), "ticks/s");
+    rs.add(name, "speedup", ticks * dt / (total / 1000.0), "x realtime");
+    rs.add(name, "tickAvgMs", total / std::max(1, ticks), "ms");
+    rs.add(name, "tickP99Ms", p99, "ms");
+    rs.add(name, "tickMaxMs", sorted.empty() ? 0.0 : sorted.back(), "ms");
+    if (st.value("dumpSchedule", false) && !rs.quiet) std::printf("%s", sched.dumpSchedule().c_str());
+    return Headless::kOk;
+}
+
+int StepBenchmark(const json& st, const std::string& name, RunState& rs) {
+    BenchmarkOptions opt;
+    opt.mapSize = st.value("mapSize", opt.mapSize); opt.repeat = st.value("repeat", opt.repeat);
+    opt.seed = st.value("seed", opt.seed); opt.filter = st.value("filter", std::string());
+    auto results = BenchmarkSuite::Run(opt);
+    if (results.empty()) { std::fprintf(stderr, "[Headless] %s: no benchmark matches '%s'\n", name.c_str(), opt.filter.c_str()); return Headless::kUsage; }
+    for (auto& r : results) { rs.add(name, (r.name + ".ms").c_str(), r.ms, "ms"); rs.add(name, (r.name + ".itemsPerSec").c_str(), r.itemsPerSec(), "items/s"); }
+    if (const size_t failed = BenchmarkSuite::Failures()) { std::fprintf(stderr, "[Headless] %s: %zu benchmark check(s) failed\n", name.c_str(), failed); return Headless::kStepFailed; }
+    return Headless::kOk;
+}
+
+// "limits": { "terrain.ms": { "max": 800 }, "sim.ticksPerSec": { "min": 2000 } } (un nombre seul = max)
+int CheckLimits(const json& limits, const RunState& rs) {
+    int failed = 0;
+    for (auto it = limits.begin(); it != limits.end(); ++it) {
+        const Metric* m = nullptr;
+        for (auto& x : rs.metrics) if (x.name == it.key()) m = &x;
+        if (!m) { std::fprintf(stderr, "[Headless] limit on unknown metric %s\n", it.key().c_str()); ++failed; continue; }
+        const json& l = it.value();
+        const double maxV = l.is_number() ? l.get<double>() : l.value("max", INFINITY), minV = l.is_object() ? l.value("min", -INFINITY) : -INFINITY;
+        const bool ok = m->value <= maxV && m->value >= minV;
+        std::printf("  [%s] %-40s %14.3f (min %g, max %g)\n", ok ? "ok  " : "FAIL", m->name.c_str(), m->value, minV, maxV);
+        if (!ok) ++failed;
+    }
+    return failed;
+}
+
+int RunScenario(const std::string& path, const Args& args, json& report) {
+    std::ifstream f(path);
+    if (!f) { std::fprintf(stderr, "[Headless] Cannot open scenario %s\n", path.c_str()); return Headless::kUsage; }
+    json sc;
+    try { f >> sc; } catch (const std::exception& e) { std::fprintf(stderr, "[Headless] %s: %s\n", path.c_str(), e.what()); return Headless::kUsage; }
+    const std::string baseDir = path.find_last_of("/\\") == std::string::npos ? std::string() : path.substr(0, path.find_last_of("/\\"));
+    const std::string scName = sc.value("name", path);
+    RunState rs; rs.quiet = args.quiet;
+    std::printf("[Headless] Scenario %s (%u workers)\n", scName.c_str(), ThreadPool::Shared().workerCount());
+    int status = Headless::kOk;
+    auto t0 = Clock::now();
+    const json steps = sc.value("steps", json::array());
+    for (size_t i=0; i<steps.size() && status == Headless::kOk; ++i) {
+        const json& st = steps[i];
+        const std::string type = st.value("type", std::string());
+        const std::string name = st.value("name", type);
+        const int repeat = std::max(1, st.value("repeat", 1));
+        for (int r=0; r<repeat && status == Headless::kOk; ++r) {
+            if (!args.quiet) std::printf("[%s] %s%s\n", type.c_str(), name.c_str(), repeat > 1 ? (" #" + std::to_string(r + 1)).c_str() : "");
+            Profiler::Zone zone(Profiler::Intern("Headless." + name));
+            if (type == "terrain") status = StepTerrain(st, name, rs);
+            else if (type == "hydrology") status = StepHydrology(st, name, rs);
+            else if (type == "biomes") status = StepBiomes(st, name, rs);
+            else if (type == "import") status = StepImport(st, name, rs, baseDir);
+            else if (type == "simulate") status = StepSimulate(st, name, rs);
+            else if (type == "benchmark") status = StepBenchmark(st, name, rs);
+            else { std::fprintf(stderr, "[Headless] Unknown step type '%s'\n", type.c_str()); status = Headless::kUsage; }
+        }
+    }
+    const double totalMs = MsSince(t0);
+    std::printf("[Headless] %s: %s in %.1f ms\n", scName.c_str(), status == Headless::kOk ? "done" : "FAILED", totalMs);
+    if (status == Headless::kOk && sc.contains("limits") && sc["limits"].is_object() && CheckLimits(sc["limits"], rs) > 0) status = Headless::kLimitExceeded;
+
+    json jr; jr["scenario"] = scName; jr["status"] = status; jr["totalMs"] = totalMs;
+    for (auto& m : rs.metrics) jr["metrics"][m.name] = m.value;
+    report["scenarios"].push_back(std::move(jr));
+    return status;
+}
+
+int RunBench(const Args& args) {
+    BenchmarkOptions opt; opt.filter = args.benchFilter;
+    if (args.mapSize > 0) opt.mapSize = args.mapSize;
+    if (args.repeat > 0) opt.repeat = args.repeat;
+    auto results = BenchmarkSuite::Run(opt);
+    if (results.empty()) {
+        std::fprintf(stderr, "[Headless] No benchmark matches '%s'. Available:", opt.filter.c_str());
+        for (auto& n : BenchmarkSuite::List()) std::fprintf(stderr, " %s", n.c_str());
+        std::fprintf(stderr, "\n"); return Headless::kUsage;
+    }
+    BenchmarkSuite::Print(results);
+    if (const size_t failed = BenchmarkSuite::Failures()) { std::fprintf(stderr, "[Headless] %zu benchmark check(s) failed\n", failed); return Headless::kStepFailed; }
+    return Headless::kOk;
+}
+
+}
+
+namespace Headless {
+
+bool Requested(int argc, char** argv) {
+    for (int i=1; i<argc; ++i) if (std::strcmp(argv[i], "--headless") == 0) return true;
+    return false;
+}
+
+int Main(int argc, char** argv) {
+    Args args;
+    if (!ParseArgs(argc, argv, args)) { Usage(); return kUsage; }
+    if (args.threads >= 0) ThreadPool::SetSharedWorkerCount(args.threads);
+    Profiler::SetThreadName("Main");
+    if (args.bench) return RunBench(args);
+    if (!args.compactDir.empty()) return Autosave::Compact(args.compactDir, args.compactName) ? kOk : kStepFailed;
+
+    json report; report["scenarios"] = json::array();
+    int status = kOk;
+    for (auto& path : args.scenarios) {
+        int s = RunScenario(path, args, report);
+        if (s != kOk && (status == kOk || s > status)) status = s; // la plus grave l'emporte
+    }
+    if (!args.tracePath.empty() && !Profiler::ExportChromeTrace(args.tracePath)) status = status == kOk ? kStepFailed : status;
+    if (!args.reportPath.empty()) {
+        std::ofstream out(args.reportPath);
+        if (!out) { std::fprintf(stderr, "[Headless] Cannot write report %s\n", args.reportPath.c_str()); return status == kOk ? kStepFailed : status; }
+        report["exitCode"] = status;
+        out << report.dump(2) << "\n";
+    }
+    return status;
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Mode sans fenêtre ni GL (CI, serveurs batch): scénarios JSON exécutés en séquence (terrain, hydrologie,
+// import Azgaar, hauteurs par biome, ticks Scheduler, suite de benchmarks), statistiques de temps/débit,
+// seuils de régression.
+//
+//   Warland --headless scenario.json [autre.json...] [--threads N] [--trace trace.json] [--report out.json]
+//   Warland --headless --bench [filtre] [--map-size N] [--repeat N]
+//
+// Codes de sortie: voir Headless::Exit.
+namespace Headless {
+
+enum Exit : int {
+    kOk = 0,
+    kLimitExceeded = 1,   // un seuil "limits" du scénario n'est pas respecté
+    kUsage = 2,           // arguments ou scénario invalides
+    kStepFailed = 3,      // une étape a échoué (fichier absent, étape sans carte, vérification de benchmark...)
+};
+
+// true si la ligne de commande demande le mode headless
+bool Requested(int argc, char** argv);
+int Main(int argc, char** argv);
+
+}
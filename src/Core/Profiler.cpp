@@ -0,0 +1,228 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_TSC 1
+#endif
+
+namespace {
+
+int64_t SteadyNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Horodatage des zones: compteur TSC (invariant sur les CPU actuels) bien moins cher que steady_clock;
+// converti en ns à la lecture d'après une référence prise au démarrage.
+inline int64_t Ticks() {
+#ifdef PROFILER_HAS_TSC
+    return (int64_t)__rdtsc();
+#else
+    return SteadyNs();
+#endif
+}
+
+struct Calibration {
+    int64_t ticks0 = Ticks(), ns0 = SteadyNs();
+    // ns par tick, réévalué sur tout l'intervalle écoulé depuis le démarrage
+    double nsPerTick() const {
+#ifdef PROFILER_HAS_TSC
+        const int64_t dt = Ticks() - ticks0, dn = SteadyNs() - ns0;
+        return (dt > 0 && dn > 1000000) ? (double)dn / (double)dt : CalibrateShort();
+#else
+        return 1.0;
+#endif
+    }
+    static double CalibrateShort() {
+        const int64_t t0 = Ticks(), n0 = SteadyNs();
+        while (SteadyNs() - n0 < 2000000) {}
+        return (double)(SteadyNs() - n0) / (double)std::max<int64_t>(1, Ticks() - t0);
+    }
+};
+const Calibration gCalibration;
+
+// Champs atomiques relâchés: écriture aussi simple qu'un store, lecture concurrente bien définie
+struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> beginTicks{0}, endTicks{0};
+    std::atomic<uint32_t> depth{0};
+};
+
+struct ThreadRing {
+    static constexpr size_t kCapacity = 1u << 14; // 16k zones par thread (512 Ko)
+    Slot slots[kCapacity];
+    std::atomic<uint64_t> head{0};                 // nombre total de zones écrites
+    std::atomic<uint64_t> cleared{0};              // Clear(): zones d'index < cleared ignorées (écrit hors du thread)
+    uint32_t tid = 0;
+    uint32_t depth = 0;                            // imbrication courante (thread propriétaire seulement)
+    std::atomic<const char*> name{nullptr};
+    bool free = false;                             // thread propriétaire sorti (sous Registry::m)
+};
+
+struct Registry {
+    std::mutex m;
+    // Anneau d'un thread sorti repris par le prochain thread qui enregistre une zone (redémarrages de la simulation,
+    // pools éphémères: nombre d'anneaux borné par le nombre de threads simultanés). Ses zones restent sur la même piste.
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::unordered_set<std::string> names;
+};
+Registry& GetRegistry() { static Registry r; return r; }
+
+thread_local ThreadRing* tl_ring = nullptr;
+
+// Rend l'anneau à la sortie du thread
+struct RingHolder {
+    ~RingHolder() {
+        if (!tl_ring) return;
+        Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+        tl_ring->free = true; tl_ring = nullptr;
+    }
+};
+
+ThreadRing& LocalRing() {
+    if (!tl_ring) {
+        thread_local RingHolder holder;
+        Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+        for (auto& ring : r.rings) if (ring->free) { tl_ring = ring.get(); break; }
+        if (tl_ring) { tl_ring->free = false; tl_ring->depth = 0; tl_ring->name.store(nullptr, std::memory_order_release); }
+        else { r.rings.push_back(std::make_unique<ThreadRing>()); tl_ring = r.rings.back().get(); tl_ring->tid = (uint32_t)r.rings.size(); }
+    }
+    return *tl_ring;
+}
+
+struct Event { const char* name; int64_t beginTicks, endTicks; uint32_t depth; };
+
+// Copie cohérente d'un anneau (seqlock sur head): les entrées potentiellement réécrites pendant la lecture sont écartées
+void Snapshot(ThreadRing& ring, std::vector<Event>& out) {
+    const uint64_t h1 = ring.head.load(std::memory_order_acquire);
+    const uint64_t begin = std::max(h1 - std::min<uint64_t>(h1, ThreadRing::kCapacity), ring.cleared.load(std::memory_order_relaxed));
+    if (begin >= h1) return;
+    const size_t first = out.size();
+    for (uint64_t i=begin; i<h1; ++i) {
+        const Slot& s = ring.slots[i & (ThreadRing::kCapacity - 1)];
+        out.push_back({ s.name.load(std::memory_order_relaxed), s.beginTicks.load(std::memory_order_relaxed), s.endTicks.load(std::memory_order_relaxed), s.depth.load(std::memory_order_relaxed) });
+    }
+    // Pendant de la barrière release de Zone::end: si une lecture a vu une écriture plus récente, h2 en tient compte
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t h2 = ring.head.load(std::memory_order_relaxed);
+    // Le slot h2 est peut-être en cours d'écriture: index < h2+1-capacité potentiellement écrasé
+    const uint64_t overwritten = h2 + 1 > ThreadRing::kCapacity ? h2 + 1 - ThreadRing::kCapacity : 0;
+    const uint64_t skip = overwritten > begin ? std::min<uint64_t>(overwritten - begin, h1 - begin) : 0;
+    out.erase(out.begin() + (ptrdiff_t)first, out.begin() + (ptrdiff_t)(first + skip));
+}
+
+void WriteJsonString(FILE* f, const char* s) {
+    std::fputc('"', f);
+    for (; s && *s; ++s) {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') { std::fputc('\\', f); std::fputc(c, f); }
+        else if (c < 0x20) std::fprintf(f, "\\u%04x", c);
+        else std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+}
+
+namespace Profiler {
+
+int64_t NowNs() { return SteadyNs(); }
+
+void SetThreadName(const char* name) { LocalRing().name.store(Intern(name ? name : ""), std::memory_order_release); }
+
+const char* Intern(const std::string& name) {
+    Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+    return r.names.insert(name).first->c_str();
+}
+
+void Zone::begin(const char* name) {
+    ThreadRing& ring = LocalRing();
+    ++ring.depth; name_ = name; beginTicks_ = Ticks();
+}
+
+void Zone::end() {
+    if (!name_) return;
+    const int64_t endTicks = Ticks();
+    if (!tl_ring) { name_ = nullptr; return; } // anneau déjà rendu (zone fermée pendant la sortie du thread)
+    ThreadRing& ring = *tl_ring;
+    const uint64_t h = ring.head.load(std::memory_order_relaxed);
+    Slot& s = ring.slots[h & (ThreadRing::kCapacity - 1)];
+    std::atomic_thread_fence(std::memory_order_release); // un lecteur qui voit ces écritures voit aussi head >= h
+    s.name.store(name_, std::memory_order_relaxed); s.beginTicks.store(beginTicks_, std::memory_order_relaxed);
+    s.endTicks.store(endTicks, std::memory_order_relaxed); s.depth.store(--ring.depth, std::memory_order_relaxed);
+    ring.head.store(h + 1, std::memory_order_release);
+    name_ = nullptr;
+}
+
+std::vector<ZoneStats> Stats(double windowSec) {
+    std::vector<Event> events;
+    {
+        Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+        for (auto& ring : r.rings) Snapshot(*ring, events);
+    }
+    const double nsPerTick = gCalibration.nsPerTick();
+    const int64_t since = Ticks() - (int64_t)(windowSec * 1e9 / nsPerTick);
+    std::unordered_map<const char*, std::vector<double>> byName;
+    for (auto& e : events) if (e.name && e.endTicks >= since) byName[e.name].push_back((double)(e.endTicks - e.beginTicks) * nsPerTick * 1e-6);
+    std::vector<ZoneStats> out; out.reserve(byName.size());
+    for (auto& [name, ms] : byName) {
+        std::sort(ms.begin(), ms.end());
+        ZoneStats z; z.name = name; z.calls = ms.size();
+        for (double v : ms) z.totalMs += v;
+        z.minMs = ms.front(); z.maxMs = ms.back(); z.avgMs = z.totalMs / (double)ms.size();
+        z.p99Ms = ms[std::min(ms.size() - 1, (size_t)((double)ms.size() * 0.99))];
+        out.push_back(z);
+    }
+    std::sort(out.begin(), out.end(), [](const ZoneStats& a, const ZoneStats& b){ return a.totalMs > b.totalMs; });
+    return out;
+}
+
+bool ExportChromeTrace(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) { std::fprintf(stderr, "[Profiler] Cannot write %s\n", path.c_str()); return false; }
+    std::vector<Event> events; std::vector<std::pair<uint32_t, const char*>> threads; std::vector<uint32_t> tids;
+    {
+        Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+        for (auto& ring : r.rings) {
+            Snapshot(*ring, events); tids.resize(events.size(), ring->tid);
+            threads.emplace_back(ring->tid, ring->name.load(std::memory_order_acquire));
+        }
+    }
+    const double usPerTick = gCalibration.nsPerTick() * 1e-3;
+    int64_t t0 = INT64_MAX; for (auto& e : events) t0 = std::min(t0, e.beginTicks);
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (auto& [tid, name] : threads) {
+        if (!name) continue;
+        std::fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", tid);
+        WriteJsonString(f, name); std::fprintf(f, "}}"); first = false;
+    }
+    for (size_t i=0; i<events.size(); ++i) {
+        const Event& e = events[i]; if (!e.name) continue;
+        std::fprintf(f, "%s{\"ph\":\"X\",\"name\":", first ? "" : ",\n"); WriteJsonString(f, e.name);
+        std::fprintf(f, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", tids[i], (double)(e.beginTicks - t0) * usPerTick, (double)(e.endTicks - e.beginTicks) * usPerTick);
+        first = false;
+    }
+    std::fprintf(f, "\n]}\n");
+    const bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+void Clear() {
+    // Les écrivains continuent d'avancer head sans rien savoir: on déplace seulement le début de lecture de chaque anneau
+    Registry& r = GetRegistry(); std::lock_guard<std::mutex> lk(r.m);
+    for (auto& ring : r.rings) ring->cleared.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+}
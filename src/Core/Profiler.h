@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Profileur par zones: PROFILE_ZONE("Nom") mesure le bloc courant. Chaque thread écrit dans son propre anneau
+// (un seul producteur, sans verrou ni allocation); les lecteurs (stats, export) copient l'anneau et écartent
+// les entrées réécrites pendant la copie. Les noms doivent rester valides: littéraux ou Profiler::Intern().
+namespace Profiler {
+
+inline std::atomic<bool> gEnabled{true};
+inline void SetEnabled(bool enabled) { gEnabled.store(enabled, std::memory_order_relaxed); }
+inline bool Enabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+int64_t NowNs();                              // horloge monotone (ns)
+void SetThreadName(const char* name);         // affiché dans l'export (Main, Simulation, Worker 3...)
+const char* Intern(const std::string& name);  // pointeur stable pour les noms construits à l'exécution
+
+// Zone en cours sur le thread courant (profondeur d'imbrication gérée par thread)
+class Zone {
+public:
+    explicit Zone(const char* name) { if (Enabled()) begin(name); }
+    ~Zone() { end(); }
+    Zone(const Zone&) = delete; Zone& operator=(const Zone&) = delete;
+    void end();                               // fin anticipée (étapes d'une longue fonction)
+private:
+    void begin(const char* name);
+    const char* name_ = nullptr;
+    int64_t beginTicks_ = 0;
+};
+
+struct ZoneStats {
+    const char* name = nullptr;
+    uint64_t calls = 0;
+    double minMs = 0.0, avgMs = 0.0, p99Ms = 0.0, maxMs = 0.0, totalMs = 0.0;
+};
+
+// Statistiques des zones terminées dans les 'windowSec' dernières secondes, triées par temps total décroissant
+std::vector<ZoneStats> Stats(double windowSec);
+// Trace Chrome (chrome://tracing, Perfetto) du contenu actuel des anneaux
+bool ExportChromeTrace(const std::string& path);
+void Clear();
+
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone_, __COUNTER__)(name)
@@ -0,0 +1,45 @@
+#include "StringPool.h"
+
+uint32_t StringPool::Hash(std::string_view s) {
+    uint32_t h = 2166136261u; // FNV-1a
+    for (char c : s) { h ^= (uint8_t)c; h *= 16777619u; }
+    return h;
+}
+
+void StringPool::clear() {
+    chars_.assign(1, '\0'); offsets_.assign({ 0u, 1u }); table_.assign(16, 0u);
+}
+
+void StringPool::reserve(size_t strings, size_t chars) {
+    chars_.reserve(chars + strings); offsets_.reserve(strings + 1);
+    size_t cap = table_.size(); while (cap < strings * 2) cap <<= 1;
+    if (cap != table_.size()) rehash(cap);
+}
+
+void StringPool::rehash(size_t capacity) {
+    table_.assign(capacity, 0u); const size_t mask = capacity - 1;
+    for (uint32_t id=1; id<size(); ++id) {
+        size_t slot = Hash(view(id)) & mask;
+        while (table_[slot]) slot = (slot + 1) & mask;
+        table_[slot] = id + 1;
+    }
+}
+
+uint32_t StringPool::find(std::string_view s) const {
+    if (s.empty()) return kEmpty;
+    const size_t mask = table_.size() - 1; size_t slot = Hash(s) & mask;
+    for (uint32_t e; (e = table_[slot]) != 0; slot = (slot + 1) & mask) if (view(e - 1) == s) return e - 1;
+    return kInvalid;
+}
+
+uint32_t StringPool::intern(std::string_view s) {
+    if (s.empty()) return kEmpty;
+    const size_t mask = table_.size() - 1; size_t slot = Hash(s) & mask;
+    for (uint32_t e; (e = table_[slot]) != 0; slot = (slot + 1) & mask) if (view(e - 1) == s) return e - 1;
+    const uint32_t id = (uint32_t)size();
+    chars_.insert(chars_.end(), s.begin(), s.end()); chars_.push_back('\0');
+    offsets_.push_back((uint32_t)chars_.size());
+    table_[slot] = id + 1;
+    if (size() * 2 > table_.size()) rehash(table_.size() * 2); // facteur de charge <= 0.5
+    return id;
+}
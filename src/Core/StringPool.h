@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Pool de chaînes internées: chaque chaîne distincte est stockée une fois dans un buffer contigu
+// (terminée par '\0') et identifiée par un id 32 bits stable. id 0 = chaîne vide.
+// Aucune allocation par élément: buffer de caractères + offsets + table de hachage ouverte d'ids.
+class StringPool {
+public:
+    static constexpr uint32_t kEmpty = 0;
+
+    StringPool() { clear(); }
+
+    uint32_t intern(std::string_view s);
+    uint32_t find(std::string_view s) const; // kInvalid si absente
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    std::string_view view(uint32_t id) const { return id + 1 < offsets_.size() ? std::string_view(chars_.data() + offsets_[id], offsets_[id + 1] - offsets_[id] - 1) : std::string_view(); }
+    const char* c_str(uint32_t id) const { return id + 1 < offsets_.size() ? chars_.data() + offsets_[id] : chars_.data(); }
+
+    size_t size() const { return offsets_.size() - 1; }   // nombre de chaînes (vide incluse)
+    size_t bytes() const { return chars_.size(); }
+    void reserve(size_t strings, size_t chars);
+    void clear();
+
+private:
+    static uint32_t Hash(std::string_view s);
+    void rehash(size_t capacity);
+
+    std::vector<char> chars_;      // chaînes concaténées, '\0' après chacune
+    std::vector<uint32_t> offsets_; // offsets_[id] = début; offsets_[size()] = fin du buffer
+    std::vector<uint32_t> table_;   // id+1 par slot (0 = libre), capacité puissance de 2
+};
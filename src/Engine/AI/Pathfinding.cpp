@@ -0,0 +1,534 @@
+#include "Pathfinding.h"
+#include "../Rendering/GL/TileMap.h"
+#include "../../Platform/ThreadPool.h"
+#include "../../Core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Pathfinding {
+
+namespace {
+using Cost = HierarchicalGrid::Cost;
+constexpr Cost kUnreachable = HierarchicalGrid::kUnreachable;
+constexpr uint32_t kNone = HierarchicalGrid::kNone;
+constexpr int kShortEntrance = 6;   // tronçon plus court: une transition au milieu, sinon deux aux extrémités
+constexpr int kDx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+constexpr int kDy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// Tas binaire min sur (f, index)
+using HeapItem = std::pair<uint64_t, uint32_t>;
+struct HeapGreater { bool operator()(const HeapItem& a, const HeapItem& b) const { return a.first > b.first; } };
+void HeapPush(std::vector<HeapItem>& h, uint64_t key, uint32_t v) { h.push_back({ key, v }); std::push_heap(h.begin(), h.end(), HeapGreater{}); }
+HeapItem HeapPop(std::vector<HeapItem>& h) { std::pop_heap(h.begin(), h.end(), HeapGreater{}); const HeapItem top = h.back(); h.pop_back(); return top; }
+
+double MsSince(std::chrono::steady_clock::time_point t0) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(); }
+
+// Recherche 8-connexe bornée au rectangle [x0,x1) x [y0,y1), sans couper les coins. g/parent/stamp indexés localement
+// ((y - y0) * (x1 - x0) + x - x0); arrêt à 'goal' si donné (A* octile si minStep > 0), sinon dès que les 'targets'
+// cases marquées dans 'target' sont fixées (inondation complète sans marques).
+// File à seaux (Dial): pas entiers <= 2 x 255 x 7, heuristique cohérente -> f des ouverts dans une fenêtre < kBuckets.
+constexpr uint32_t kBuckets = 8192;
+struct RectSearch {
+    const uint8_t* costs; int w, x0, y0, x1, y1;
+    std::vector<Cost>& g; std::vector<uint32_t>& parent; std::vector<uint32_t>& stamp; uint32_t query;
+    std::vector<std::vector<uint32_t>>& buckets;
+
+    uint32_t localOf(uint32_t cell) const { return (uint32_t)(((int)(cell / w) - y0) * (x1 - x0) + (int)(cell % w) - x0); }
+    uint32_t cellOf(uint32_t l) const { const int rw = x1 - x0; return (uint32_t)((y0 + (int)l / rw) * w + x0 + (int)l % rw); }
+    Cost at(uint32_t l) const { return stamp[l] == query ? g[l] : kUnreachable; }
+
+    Cost run(uint32_t from, uint32_t goal, Cost minStep, const uint8_t* target = nullptr, size_t targets = 0) {
+        const int rw = x1 - x0;
+        const int gx = goal != kNone ? (int)(goal % w) : 0, gy = goal != kNone ? (int)(goal / w) : 0;
+        const bool guided = goal != kNone && minStep > 0;
+        auto h = [&](int x, int y) -> Cost {
+            if (!guided) return 0;
+            const int dx = std::abs(x - gx), dy = std::abs(y - gy);
+            return (Cost)(std::min(dx, dy) * 7 + (std::max(dx, dy) - std::min(dx, dy)) * 5) * minStep;
+        };
+        if (buckets.size() != kBuckets) buckets.assign(kBuckets, {});
+        const uint32_t s = localOf(from);
+        g[s] = 0; parent[s] = kNone; stamp[s] = query;
+        Cost cur = h((int)(from % w), (int)(from / w));
+        buckets[cur & (kBuckets - 1)].push_back(s);
+        size_t open = 1;
+        Cost result = goal != kNone ? kUnreachable : 0;
+        while (open) {
+            std::vector<uint32_t>* bucket = &buckets[cur & (kBuckets - 1)];
+            while (bucket->empty()) bucket = &buckets[++cur & (kBuckets - 1)];
+            const uint32_t l = bucket->back(); bucket->pop_back(); --open;
+            const int lx = (int)l % rw, ly = (int)l / rw, x = x0 + lx, y = y0 + ly;
+            const Cost gl = g[l];
+            if (gl + h(x, y) != cur) continue; // entrée périmée
+            const uint32_t cell = (uint32_t)(y * w + x);
+            if (cell == goal) { result = gl; break; }
+            if (target && target[l] && --targets == 0) break;
+            for (int d=0; d<8; ++d) {
+                const int nx = x + kDx[d], ny = y + kDy[d];
+                if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1) continue;
+                const uint32_t nc = (uint32_t)(ny * w + nx);
+                if (!costs[nc]) continue;
+                if (d >= 4 && (!costs[y * w + nx] || !costs[ny * w + x])) continue;
+                const Cost ng = gl + (Cost)(costs[cell] + costs[nc]) * (d >= 4 ? 7u : 5u);
+                const uint32_t nl = (uint32_t)((ny - y0) * rw + nx - x0);
+                if (stamp[nl] == query && g[nl] <= ng) continue;
+                g[nl] = ng; parent[nl] = l; stamp[nl] = query;
+                buckets[(ng + h(nx, ny)) & (kBuckets - 1)].push_back(nl); ++open;
+            }
+        }
+        for (; open; ++cur) { std::vector<uint32_t>& bucket = buckets[cur & (kBuckets - 1)]; open -= bucket.size(); bucket.clear(); } // arrêt anticipé
+        return result;
+    }
+};
+}
+
+void BuildCostGrid(const TileMap& map, const TerrainCosts& costs, std::vector<uint8_t>& out) {
+    const size_t n = (size_t)std::max(map.width, 0) * std::max(map.height, 0);
+    out.assign(n, costs.land);
+    if (map.paletteIndices.size() == n) for (size_t i=0; i<n; ++i) out[i] = costs.at(map.paletteIndices[i]);
+    else if (map.tiles.size() == n) for (size_t i=0; i<n; ++i) out[i] = costs.at((uint16_t)(map.tiles[i] + 2));
+}
+
+void HierarchicalGrid::clusterRect(uint32_t c, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (int)(c % cw_) * cs_; y0 = (int)(c / cw_) * cs_;
+    x1 = std::min(x0 + cs_, w_); y1 = std::min(y0 + cs_, h_);
+}
+
+std::vector<uint16_t>* HierarchicalGrid::border(uint32_t c, int side) {
+    return const_cast<std::vector<uint16_t>*>(static_cast<const HierarchicalGrid*>(this)->border(c, side));
+}
+
+const std::vector<uint16_t>* HierarchicalGrid::border(uint32_t c, int side) const {
+    const uint32_t cx = c % cw_, cy = c / cw_;
+    switch (side) {
+    case North: return cy > 0 ? &south_[c - cw_] : nullptr;
+    case South: return cy + 1 < (uint32_t)ch_ ? &south_[c] : nullptr;
+    case West: return cx > 0 ? &east_[c - 1] : nullptr;
+    default: return cx + 1 < (uint32_t)cw_ ? &east_[c] : nullptr;
+    }
+}
+
+// Tronçons où les deux cases de part et d'autre du bord sont franchissables
+bool HierarchicalGrid::buildBorder(uint32_t c, int side) {
+    std::vector<uint16_t>* b = border(c, side);
+    if (!b) return false;
+    int x0, y0, x1, y1; clusterRect(c, x0, y0, x1, y1);
+    const bool south = side == South;
+    const int len = south ? x1 - x0 : y1 - y0;
+    auto open = [&](int o) {
+        const size_t a = south ? (size_t)(y1 - 1) * w_ + x0 + o : (size_t)(y0 + o) * w_ + x1 - 1;
+        return costs_[a] && costs_[south ? a + w_ : a + 1];
+    };
+    std::vector<uint16_t> t;
+    for (int o=0; o<len; ) {
+        if (!open(o)) { ++o; continue; }
+        int e = o; while (e < len && open(e)) ++e;
+        if (e - o < kShortEntrance) t.push_back((uint16_t)(o + (e - o) / 2));
+        else { t.push_back((uint16_t)o); t.push_back((uint16_t)(e - 1)); }
+        o = e;
+    }
+    if (t == *b) return false;
+    b->swap(t);
+    return true;
+}
+
+// Noeuds du cluster dans l'ordre des côtés Nord, Sud, Ouest, Est (une case peut porter deux noeuds: coin)
+void HierarchicalGrid::nodeCells(uint32_t c, std::vector<uint32_t>& cells) const {
+    int x0, y0, x1, y1; clusterRect(c, x0, y0, x1, y1);
+    cells.clear();
+    if (auto* b = border(c, North)) for (uint16_t o : *b) cells.push_back((uint32_t)(y0 * w_ + x0 + o));
+    if (auto* b = border(c, South)) for (uint16_t o : *b) cells.push_back((uint32_t)((y1 - 1) * w_ + x0 + o));
+    if (auto* b = border(c, West)) for (uint16_t o : *b) cells.push_back((uint32_t)((y0 + o) * w_ + x0));
+    if (auto* b = border(c, East)) for (uint16_t o : *b) cells.push_back((uint32_t)((y0 + o) * w_ + x1 - 1));
+}
+
+void HierarchicalGrid::buildCluster(uint32_t c, Workspace& ws) {
+    Cluster& cl = clusters_[c];
+    nodeCells(c, ws.cells);
+    const uint32_t n = (uint32_t)ws.cells.size();
+    cl.n = n; cl.dist.assign((size_t)n * n, kUnreachable);
+    int x0, y0, x1, y1; clusterRect(c, x0, y0, x1, y1);
+    const size_t cells = (size_t)cs_ * cs_;
+    if (ws.g.size() != cells) { ws.g.assign(cells, 0); ws.parent.assign(cells, kNone); ws.stamp.assign(cells, 0u); ws.target.assign(cells, 0); ws.query = 0; }
+    for (uint32_t i=0; i<n; ++i) {
+        cl.dist[(size_t)i * n + i] = 0;
+        if (i + 1 == n) break;
+        if (++ws.query == 0) { std::fill(ws.stamp.begin(), ws.stamp.end(), 0u); ws.query = 1; }
+        RectSearch s{ costs_.data(), w_, x0, y0, x1, y1, ws.g, ws.parent, ws.stamp, ws.query, ws.buckets };
+        // Cibles: noeuds j > i (distances symétriques)
+        size_t targets = 0;
+        for (uint32_t j=i+1; j<n; ++j) { uint8_t& m = ws.target[s.localOf(ws.cells[j])]; targets += !m; m = 1; }
+        s.run(ws.cells[i], kNone, 0, ws.target.data(), targets);
+        for (uint32_t j=i+1; j<n; ++j) ws.target[s.localOf(ws.cells[j])] = 0;
+        for (uint32_t j=i+1; j<n; ++j) { const Cost d = s.at(s.localOf(ws.cells[j])); cl.dist[(size_t)i * n + j] = cl.dist[(size_t)j * n + i] = d; }
+    }
+}
+
+// Renumérotation globale, région par région (noeuds d'une région contigus): noeuds, clusters, partenaires de l'autre
+// côté des bords (même rang de transition)
+void HierarchicalGrid::relink() {
+    const uint32_t clusters = (uint32_t)clusters_.size();
+    nodeFirst_.assign(clusters, 0u);
+    uint32_t total = 0;
+    for (uint32_t r=0; r<(uint32_t)regions_.size(); ++r) {
+        const int rx = (int)(r % rw_) * kRegionClusters, ry = (int)(r / rw_) * kRegionClusters;
+        regions_[r].first = total;
+        for (int cy=ry; cy<std::min(ry + kRegionClusters, ch_); ++cy) for (int cx=rx; cx<std::min(rx + kRegionClusters, cw_); ++cx) {
+            const uint32_t c = (uint32_t)(cy * cw_ + cx);
+            nodeFirst_[c] = total; total += clusters_[c].n;
+        }
+        regions_[r].n = total - regions_[r].first;
+    }
+    nodeCell_.resize(total); nodeXY_.resize(total); nodeCluster_.resize(total); partner_.assign(total, kNone); partnerCost_.assign(total, kUnreachable);
+    std::vector<uint32_t> cells;
+    size_t intra = 0;
+    auto sideCount = [&](uint32_t c, int side) { const auto* b = border(c, side); return b ? (uint32_t)b->size() : 0u; };
+    for (uint32_t c=0; c<clusters; ++c) {
+        nodeCells(c, cells);
+        const uint32_t first = nodeFirst_[c];
+        for (uint32_t i=0; i<cells.size(); ++i) { nodeCell_[first + i] = cells[i]; nodeXY_[first + i] = (cells[i] % w_) | (cells[i] / w_) << 16; nodeCluster_[first + i] = c; }
+        for (Cost d : clusters_[c].dist) intra += d != kUnreachable;
+        intra -= clusters_[c].n;
+        // Côtés Sud et Est: lien avec le Nord / l'Ouest du voisin (qui a le même nombre de transitions)
+        const uint32_t nN = sideCount(c, North), nS = sideCount(c, South), nW = sideCount(c, West), nE = sideCount(c, East);
+        for (uint32_t k=0; k<nS; ++k) {
+            const uint32_t a = first + nN + k, b = nodeFirst_[c + cw_] + k;
+            partner_[a] = b; partner_[b] = a;
+        }
+        for (uint32_t k=0; k<nE; ++k) {
+            const uint32_t nb = c + 1, a = first + nN + nS + nW + k, b = nodeFirst_[nb] + sideCount(nb, North) + sideCount(nb, South) + k;
+            partner_[a] = b; partner_[b] = a;
+        }
+    }
+    for (uint32_t u=0; u<total; ++u) if (partner_[u] != kNone) partnerCost_[u] = step(nodeCell_[u], nodeCell_[partner_[u]], false);
+    // Composantes connexes (union-find sur arêtes internes finies et passages de bord): requêtes impossibles rejetées
+    component_.resize(total);
+    for (uint32_t u=0; u<total; ++u) component_[u] = u;
+    auto find = [&](uint32_t u) { while (component_[u] != u) u = component_[u] = component_[component_[u]]; return u; };
+    auto unite = [&](uint32_t a, uint32_t b) { a = find(a); b = find(b); if (a != b) component_[std::max(a, b)] = std::min(a, b); };
+    for (uint32_t c=0; c<clusters; ++c) {
+        const Cluster& cl = clusters_[c];
+        for (uint32_t i=0; i<cl.n; ++i) for (uint32_t j=i+1; j<cl.n; ++j) if (cl.dist[(size_t)i * cl.n + j] != kUnreachable) unite(nodeFirst_[c] + i, nodeFirst_[c] + j);
+    }
+    for (uint32_t u=0; u<total; ++u) if (partner_[u] != kNone) unite(u, partner_[u]);
+    size_t components = 0;
+    for (uint32_t u=0; u<total; ++u) { component_[u] = find(u); components += component_[u] == u; }
+    stats_.clusters = clusters; stats_.nodes = total; stats_.intraEdges = intra; stats_.components = components;
+}
+
+void HierarchicalGrid::searchRegion(uint32_t r, Cost* g, uint32_t* parent, std::vector<HeapItem>& heap) const {
+    const Region& R = regions_[r];
+    std::make_heap(heap.begin(), heap.end(), HeapGreater{});
+    while (!heap.empty()) {
+        const HeapItem top = HeapPop(heap);
+        const uint32_t l = top.second;
+        const Cost d = g[l];
+        if (top.first != d) continue;
+        const uint32_t u = R.first + l, c = nodeCluster_[u], first = nodeFirst_[c], n = clusters_[c].n, li = u - first;
+        const Cost* row = clusters_[c].dist.data() + (size_t)li * n;
+        for (uint32_t j=0; j<n; ++j) {
+            if (j == li || row[j] == kUnreachable) continue;
+            const uint32_t v = first + j - R.first;
+            if (d + row[j] < g[v]) { g[v] = d + row[j]; parent[v] = l; HeapPush(heap, g[v], v); }
+        }
+        const uint32_t p = partner_[u];
+        if (p == kNone || p - R.first >= R.n) continue;
+        const uint32_t v = p - R.first;
+        if (d + partnerCost_[u] < g[v]) { g[v] = d + partnerCost_[u]; parent[v] = l; HeapPush(heap, g[v], v); }
+    }
+}
+
+// Portes de la région et arêtes porte -> porte (Dijkstra restreint depuis chaque porte). Arête a -> b redondante s'il
+// existe une porte k avec d(a,k) + d(k,b) = d(a,b), les deux termes > 0 (récurrence sur la distance: les arêtes
+// conservées suffisent); cliques de portes fortement élaguées en terrain ouvert (égalités octiles nombreuses).
+void HierarchicalGrid::buildRegion(uint32_t r, Workspace& ws) {
+    Region& R = regions_[r];
+    const uint32_t m = R.n;
+    R.gates.clear(); R.edgeFirst.assign(1, 0u); R.pathFirst.assign(1, 0u); R.edgeTo.clear(); R.path.clear(); R.edgeCost.clear();
+    for (uint32_t l=0; l<m; ++l) {
+        const uint32_t p = partner_[R.first + l];
+        if (p != kNone && regionOf(nodeCluster_[p]) != r) R.gates.push_back((uint16_t)l);
+    }
+    const size_t k = R.gates.size();
+    std::vector<Cost> dist(k * k);
+    ws.regionParent.resize(k * m);
+    for (size_t a=0; a<k; ++a) {
+        ws.regionG.assign(m, kUnreachable);
+        uint32_t* parent = ws.regionParent.data() + a * m;
+        std::fill(parent, parent + m, kNone);
+        ws.regionG[R.gates[a]] = 0; ws.heap.assign(1, { 0, R.gates[a] });
+        searchRegion(r, ws.regionG.data(), parent, ws.heap);
+        for (size_t b=0; b<k; ++b) dist[a * k + b] = ws.regionG[R.gates[b]];
+    }
+    std::vector<uint16_t> between;
+    for (size_t a=0; a<k; ++a) {
+        const uint32_t* parent = ws.regionParent.data() + a * m;
+        for (size_t b=0; b<k; ++b) {
+            const Cost d = dist[a * k + b];
+            if (b == a || d == kUnreachable) continue;
+            bool redundant = false;
+            for (size_t c=0; c<k && !redundant; ++c) {
+                const Cost ac = dist[a * k + c], cb = dist[c * k + b];
+                redundant = ac && cb && ac != kUnreachable && cb != kUnreachable && (uint64_t)ac + cb == d;
+            }
+            if (redundant) continue;
+            between.clear();
+            for (uint32_t l=parent[R.gates[b]]; l!=R.gates[a]; l=parent[l]) between.push_back((uint16_t)l);
+            R.edgeTo.push_back((uint16_t)b); R.edgeCost.push_back(d);
+            R.path.insert(R.path.end(), between.rbegin(), between.rend());
+            R.pathFirst.push_back((uint32_t)R.path.size());
+        }
+        R.edgeFirst.push_back((uint32_t)R.edgeTo.size());
+    }
+}
+
+void HierarchicalGrid::relinkGates() {
+    const uint32_t regions = (uint32_t)regions_.size();
+    gateFirst_.assign(regions + 1, 0u);
+    for (uint32_t r=0; r<regions; ++r) gateFirst_[r + 1] = gateFirst_[r] + (uint32_t)regions_[r].gates.size();
+    gateNode_.resize(gateFirst_[regions]); gateRegion_.resize(gateFirst_[regions]); gateOf_.assign(nodeCell_.size(), kNone);
+    size_t edges = 0;
+    for (uint32_t r=0; r<regions; ++r) {
+        const Region& R = regions_[r];
+        for (uint32_t i=0; i<R.gates.size(); ++i) { const uint32_t gi = gateFirst_[r] + i; gateNode_[gi] = R.first + R.gates[i]; gateRegion_[gi] = r; gateOf_[gateNode_[gi]] = gi; }
+        edges += R.edgeTo.size();
+    }
+    stats_.regions = regions; stats_.gates = gateNode_.size(); stats_.gateEdges = edges;
+}
+
+void HierarchicalGrid::build(std::vector<uint8_t> costs, int width, int height, int clusterSize) {
+    build(std::move(costs), width, height, clusterSize, ThreadPool::Shared());
+}
+
+bool HierarchicalGrid::build(const TileMap& map, const TerrainCosts& costs, int clusterSize) {
+    std::vector<uint8_t> grid;
+    BuildCostGrid(map, costs, grid);
+    build(std::move(grid), map.width, map.height, clusterSize);
+    return w_ > 0 && h_ > 0;
+}
+
+void HierarchicalGrid::build(std::vector<uint8_t> costs, int width, int height, int clusterSize, ThreadPool& pool) {
+    PROFILE_ZONE("HierarchicalGrid::build");
+    const auto t0 = std::chrono::steady_clock::now();
+    if (width > 0xFFFF || height > 0xFFFF) { std::fprintf(stderr, "[Pathfinding] carte trop grande: %dx%d\n", width, height); width = height = 0; }
+    w_ = std::max(width, 0); h_ = std::max(height, 0); cs_ = std::clamp(clusterSize, 2, 256);
+    costs_ = std::move(costs);
+    if (costs_.size() != (size_t)w_ * h_) costs_.assign((size_t)w_ * h_, 1);
+    cw_ = (w_ + cs_ - 1) / cs_; ch_ = (h_ + cs_ - 1) / cs_;
+    rw_ = (cw_ + kRegionClusters - 1) / kRegionClusters; rh_ = (ch_ + kRegionClusters - 1) / kRegionClusters;
+    minCost_ = 255;
+    for (uint8_t c : costs_) if (c && c < minCost_) minCost_ = c;
+    const uint32_t clusters = (uint32_t)cw_ * ch_;
+    south_.assign(clusters, {}); east_.assign(clusters, {});
+    clusters_.assign(clusters, {});
+    regions_.assign((size_t)rw_ * rh_, {});
+    dirty_.clear(); dirtyFlag_.assign(clusters, 0);
+    for (uint32_t c=0; c<clusters; ++c) { buildBorder(c, South); buildBorder(c, East); }
+    pool.parallelFor(clusters, 64, [&](size_t b, size_t e) {
+        Workspace ws;
+        for (size_t c=b; c<e; ++c) buildCluster((uint32_t)c, ws);
+    });
+    relink();
+    pool.parallelFor(regions_.size(), 1, [&](size_t b, size_t e) {
+        Workspace ws;
+        for (size_t r=b; r<e; ++r) buildRegion((uint32_t)r, ws);
+    });
+    relinkGates();
+    stats_.rebuiltClusters = clusters; stats_.rebuiltRegions = regions_.size();
+    stats_.buildMs = MsSince(t0);
+}
+
+void HierarchicalGrid::setCost(int x, int y, uint8_t cost) {
+    if (x < 0 || y < 0 || x >= w_ || y >= h_) return;
+    uint8_t& c = costs_[(size_t)y * w_ + x];
+    if (c == cost) return;
+    c = cost;
+    if (cost && cost < minCost_) minCost_ = cost; // heuristique toujours minorante
+    const uint32_t cl = clusterOf((uint32_t)(y * w_ + x));
+    if (!dirtyFlag_[cl]) { dirtyFlag_[cl] = 1; dirty_.push_back(cl); }
+}
+
+void HierarchicalGrid::updateFromMap(const TileMap& map, const TerrainCosts& costs, int x0, int y0, int x1, int y1) {
+    if (map.width != w_ || map.height != h_) return;
+    const size_t n = (size_t)w_ * h_;
+    const bool palette = map.paletteIndices.size() == n, tiles = map.tiles.size() == n;
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0); x1 = std::min(x1, w_); y1 = std::min(y1, h_);
+    for (int y=y0; y<y1; ++y) for (int x=x0; x<x1; ++x) {
+        const size_t i = (size_t)y * w_ + x;
+        setCost(x, y, palette ? costs.at(map.paletteIndices[i]) : tiles ? costs.at((uint16_t)(map.tiles[i] + 2)) : costs.land);
+    }
+}
+
+size_t HierarchicalGrid::flush() { return flush(ThreadPool::Shared()); }
+
+// Clusters modifiés: leurs 4 bords recalculés; un voisin dont le bord commun a changé de transitions change de noeuds,
+// donc de distances internes: reconstruit aussi. Renumérotation globale (linéaire en noeuds), puis portes et arêtes
+// des seules régions contenant un cluster reconstruit (index locaux des autres inchangés).
+size_t HierarchicalGrid::flush(ThreadPool& pool) {
+    if (dirty_.empty()) return 0;
+    PROFILE_ZONE("HierarchicalGrid::flush");
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint32_t> rebuild = dirty_;
+    auto mark = [&](uint32_t c) { if (!dirtyFlag_[c]) { dirtyFlag_[c] = 1; rebuild.push_back(c); } };
+    for (uint32_t c : dirty_) {
+        const uint32_t cx = c % cw_, cy = c / cw_;
+        if (cy > 0 && buildBorder(c - cw_, South)) mark(c - cw_);
+        if (cy + 1 < (uint32_t)ch_ && buildBorder(c, South)) mark(c + cw_);
+        if (cx > 0 && buildBorder(c - 1, East)) mark(c - 1);
+        if (cx + 1 < (uint32_t)cw_ && buildBorder(c, East)) mark(c + 1);
+    }
+    pool.parallelFor(rebuild.size(), 4, [&](size_t b, size_t e) {
+        Workspace ws;
+        for (size_t i=b; i<e; ++i) buildCluster(rebuild[i], ws);
+    });
+    for (uint32_t c : rebuild) dirtyFlag_[c] = 0;
+    dirty_.clear();
+    relink();
+    std::vector<uint32_t> regions;
+    for (uint32_t c : rebuild) regions.push_back(regionOf(c));
+    std::sort(regions.begin(), regions.end()); regions.erase(std::unique(regions.begin(), regions.end()), regions.end());
+    pool.parallelFor(regions.size(), 1, [&](size_t b, size_t e) {
+        Workspace ws;
+        for (size_t i=b; i<e; ++i) buildRegion(regions[i], ws);
+    });
+    relinkGates();
+    stats_.rebuiltClusters = rebuild.size(); stats_.rebuiltRegions = regions.size();
+    stats_.flushMs = MsSince(t0);
+    return rebuild.size();
+}
+
+void HierarchicalGrid::Query::fit() {
+    const size_t nodes = grid_->nodeCell_.size(), cells = (size_t)grid_->cs_ * grid_->cs_;
+    if (g_.size() != nodes) { g_.assign(nodes, kUnreachable); parent_.assign(nodes, kNone); via_.assign(nodes, kNone); stamp_.assign(nodes, 0u); query_ = 0; }
+    if (localG_.size() != cells) { localG_.assign(cells, kUnreachable); localParent_.assign(cells, kNone); localStamp_.assign(cells, 0u); localQuery_ = 0; }
+}
+
+HierarchicalGrid::Cost HierarchicalGrid::Query::local(uint32_t cluster, uint32_t from, uint32_t goal, std::vector<Cost>* nodeCost, std::vector<uint32_t>* cells) {
+    const HierarchicalGrid& gr = *grid_;
+    int x0, y0, x1, y1; gr.clusterRect(cluster, x0, y0, x1, y1);
+    if (++localQuery_ == 0) { std::fill(localStamp_.begin(), localStamp_.end(), 0u); localQuery_ = 1; }
+    RectSearch s{ gr.costs_.data(), gr.w_, x0, y0, x1, y1, localG_, localParent_, localStamp_, localQuery_, localBuckets_ };
+    // Liaison aux noeuds: Dijkstra jusqu'à ce que noeuds et goal soient fixés; raffinement: A* jusqu'à goal
+    const uint32_t first = gr.nodeFirst_[cluster], n = gr.clusters_[cluster].n;
+    size_t targets = 0;
+    if (nodeCost) {
+        if (localTarget_.size() != localG_.size()) localTarget_.assign(localG_.size(), 0);
+        for (uint32_t j=0; j<n; ++j) { uint8_t& m = localTarget_[s.localOf(gr.nodeCell_[first + j])]; targets += !m; m = 1; }
+        if (goal != kNone) { uint8_t& m = localTarget_[s.localOf(goal)]; targets += !m; m = 1; }
+    }
+    Cost d = s.run(from, nodeCost ? kNone : goal, nodeCost ? 0 : (Cost)gr.minCost_ * 2, nodeCost ? localTarget_.data() : nullptr, targets);
+    if (nodeCost) {
+        for (uint32_t j=0; j<n; ++j) localTarget_[s.localOf(gr.nodeCell_[first + j])] = 0;
+        if (goal != kNone) localTarget_[s.localOf(goal)] = 0;
+        nodeCost->resize(n);
+        for (uint32_t j=0; j<n; ++j) (*nodeCost)[j] = s.at(s.localOf(gr.nodeCell_[first + j]));
+        d = goal != kNone ? s.at(s.localOf(goal)) : kUnreachable;
+    }
+    if (cells && d != kUnreachable) {
+        const size_t before = cells->size();
+        for (uint32_t l=s.localOf(goal); l!=kNone && s.cellOf(l)!=from; l=localParent_[l]) cells->push_back(s.cellOf(l));
+        std::reverse(cells->begin() + (ptrdiff_t)before, cells->end());
+    }
+    return d;
+}
+
+bool HierarchicalGrid::Query::findPath(int sx, int sy, int gx, int gy, Path& out) {
+    const HierarchicalGrid& gr = *grid_;
+    out.waypoints.clear(); out.cost = kUnreachable; expanded_ = 0;
+    if (sx < 0 || sy < 0 || gx < 0 || gy < 0 || sx >= gr.w_ || gx >= gr.w_ || sy >= gr.h_ || gy >= gr.h_) return false;
+    const uint32_t s = (uint32_t)(sy * gr.w_ + sx), t = (uint32_t)(gy * gr.w_ + gx);
+    if (!gr.costs_[s] || !gr.costs_[t]) return false;
+    if (s == t) { out.waypoints = { s }; out.cost = 0; return true; }
+    fit();
+    const uint32_t cs = gr.clusterOf(s), cg = gr.clusterOf(t), rs = gr.regionOf(cs), rg = gr.regionOf(cg);
+    const uint32_t startFirst = gr.nodeFirst_[cs], goalFirst = gr.nodeFirst_[cg];
+    Cost best = local(cs, s, cs == cg ? t : kNone, &startCost_, nullptr);
+    local(cg, t, kNone, &goalCost_, nullptr);
+    components_.clear();
+    for (uint32_t j=0; j<startCost_.size(); ++j) if (startCost_[j] != kUnreachable) components_.push_back(gr.component_[startFirst + j]);
+    bool linked = false;
+    for (uint32_t j=0; j<goalCost_.size() && !linked; ++j)
+        linked = goalCost_[j] != kUnreachable && std::find(components_.begin(), components_.end(), gr.component_[goalFirst + j]) != components_.end();
+    if (!linked && best == kUnreachable) return false;
+
+    // A* mixte: niveau 1 dans les régions de départ et d'arrivée, ailleurs seules les portes (arêtes de région)
+    if (++query_ == 0) { std::fill(stamp_.begin(), stamp_.end(), 0u); query_ = 1; }
+    const uint64_t minStep = (uint64_t)gr.minCost_ * 2;
+    auto h = [&](uint32_t xy) -> uint64_t {
+        const int dx = std::abs((int)(xy & 0xFFFFu) - gx), dy = std::abs((int)(xy >> 16) - gy);
+        return (uint64_t)(std::min(dx, dy) * 7 + (std::max(dx, dy) - std::min(dx, dy)) * 5) * minStep;
+    };
+    heap_.clear();
+    auto relax = [&](uint32_t v, Cost d, uint32_t from, uint32_t edge) {
+        if (stamp_[v] == query_ && g_[v] <= d) return;
+        g_[v] = d; parent_[v] = from; via_[v] = edge; stamp_[v] = query_;
+        HeapPush(heap_, (uint64_t)d + h(gr.nodeXY_[v]), v);
+    };
+    if (linked) for (uint32_t j=0; j<startCost_.size(); ++j) if (startCost_[j] != kUnreachable) relax(startFirst + j, startCost_[j], kNone, kNone);
+    uint32_t bestNode = kNone;
+    while (!heap_.empty()) {
+        const HeapItem top = HeapPop(heap_);
+        const uint32_t u = top.second;
+        if (top.first >= best) break;
+        if (top.first != (uint64_t)g_[u] + h(gr.nodeXY_[u])) continue; // entrée périmée
+        ++expanded_;
+        const Cost gu = g_[u];
+        const uint32_t c = gr.nodeCluster_[u], r = gr.regionOf(c);
+        if (c == cg && goalCost_[u - goalFirst] != kUnreachable && gu + goalCost_[u - goalFirst] < best) { best = gu + goalCost_[u - goalFirst]; bestNode = u; }
+        if (r == rs || r == rg) {
+            const uint32_t first = gr.nodeFirst_[c], n = gr.clusters_[c].n, li = u - first;
+            const Cost* row = gr.clusters_[c].dist.data() + (size_t)li * n;
+            for (uint32_t j=0; j<n; ++j) if (j != li && row[j] != kUnreachable) relax(first + j, gu + row[j], u, kNone);
+        }
+        else if (gr.gateOf_[u] != kNone) {
+            const Region& R = gr.regions_[r];
+            const uint32_t i = gr.gateOf_[u] - gr.gateFirst_[r];
+            for (uint32_t e=R.edgeFirst[i]; e<R.edgeFirst[i + 1]; ++e) relax(R.first + R.gates[R.edgeTo[e]], gu + R.edgeCost[e], u, e);
+        }
+        if (gr.partner_[u] != kNone) relax(gr.partner_[u], gu + gr.partnerCost_[u], u, kNone);
+    }
+    if (best == kUnreachable) return false;
+
+    // Déroulé en noeuds du niveau 1 (noeuds intermédiaires des arêtes de région réinsérés)
+    nodes_.clear();
+    for (uint32_t v=bestNode; v!=kNone; v=parent_[v]) {
+        nodes_.push_back(v);
+        const uint32_t e = via_[v];
+        if (e == kNone) continue;
+        const Region& R = gr.regions_[gr.regionOf(gr.nodeCluster_[parent_[v]])];
+        for (uint32_t p=R.pathFirst[e + 1]; p-- > R.pathFirst[e]; ) nodes_.push_back(R.first + R.path[p]);
+    }
+    std::reverse(nodes_.begin(), nodes_.end());
+    out.cost = best;
+    out.waypoints.push_back(s);
+    for (uint32_t v : nodes_) if (gr.nodeCell_[v] != out.waypoints.back()) out.waypoints.push_back(gr.nodeCell_[v]);
+    if (out.waypoints.back() != t) out.waypoints.push_back(t);
+    return true;
+}
+
+bool HierarchicalGrid::Query::refineSegment(const Path& path, size_t i, std::vector<uint32_t>& cells) {
+    cells.clear();
+    if (i + 1 >= path.waypoints.size()) return false;
+    const HierarchicalGrid& gr = *grid_;
+    const uint32_t a = path.waypoints[i], b = path.waypoints[i + 1];
+    const uint32_t ca = gr.clusterOf(a), cb = gr.clusterOf(b);
+    if (ca != cb) { cells.push_back(b); return true; } // transition entre clusters: cases voisines
+    fit();
+    return local(ca, a, b, nullptr, &cells) != kUnreachable;
+}
+
+bool HierarchicalGrid::Query::refine(const Path& path, std::vector<uint32_t>& cells) {
+    cells.clear();
+    if (!path.found() || path.waypoints.empty()) return false;
+    cells.push_back(path.waypoints[0]);
+    std::vector<uint32_t> segment;
+    for (size_t i=0; i+1<path.waypoints.size(); ++i) {
+        if (!refineSegment(path, i, segment)) return false;
+        cells.insert(cells.end(), segment.begin(), segment.end());
+    }
+    return true;
+}
+
+} // namespace Pathfinding
@@ -1,3 +1,158 @@
 #pragma once
-// [7][8][10] TODO: A* sur graph routier (Monde), Detour queries (Ville/Intérieur)
-namespace Pathfinding { /* ... */ }
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+// [7][10] TODO: Detour queries (Ville/Intérieur)
+
+struct TileMap;
+class ThreadPool;
+
+namespace Pathfinding {
+
+// Coût de traversée par case hors route: 0 = infranchissable, sinon multiplicateur 1..255 (1 = plaine)
+struct TerrainCosts {
+    uint8_t deepWater = 0;
+    uint8_t shallowWater = 0;
+    uint8_t land = 1;                 // biome sans coût propre
+    std::vector<uint8_t> biome;       // par biomeId (paletteIndex - 2), 0 = land
+    uint8_t at(uint16_t paletteIndex) const {
+        if (paletteIndex == 0) return deepWater;
+        if (paletteIndex == 1) return shallowWater;
+        const size_t b = (size_t)paletteIndex - 2;
+        return b < biome.size() && biome[b] ? biome[b] : land;
+    }
+};
+
+// Coûts par case de la carte: paletteIndices (eau profonde/peu profonde/biomes), à défaut tiles (biomeId, terre)
+void BuildCostGrid(const TileMap& map, const TerrainCosts& costs, std::vector<uint8_t>& out);
+
+// HPA* à deux niveaux. Niveau 1: grille découpée en clusters carrés; entre deux clusters voisins, chaque tronçon
+// franchissable de leur bord commun donne une ou deux transitions (milieu si court, extrémités sinon), soit un noeud
+// abstrait de chaque côté; dans un cluster, coûts exacts entre ses noeuds (Dijkstra local). Niveau 2: régions de
+// kRegionClusters x kRegionClusters clusters; portes = noeuds dont le partenaire est dans une autre région, arêtes
+// porte -> porte = plus courts chemins du niveau 1 restreints à la région (séquence de noeuds conservée), sauf celles
+// passant déjà par une autre porte (cliques élaguées).
+// Requête: liaison du départ et de l'arrivée aux noeuds de leur cluster (recherche sur cases), rejet immédiat si leurs
+// composantes connexes diffèrent, puis A* mixte (heuristique octile x coût minimal): niveau 1 dans les régions de
+// départ et d'arrivée, arêtes de portes ailleurs, déroulées en noeuds du niveau 1. Chemin optimal sur le graphe du
+// niveau 1 (proche de l'optimum grille). Raffinement local segment par segment (A* borné au cluster) -> chemin de
+// cases, à la demande (refineSegment) ou complet (refine).
+// Déplacements 8-connexes sans couper les coins; coût d'un pas = somme des coûts des deux cases x 5 (orthogonal)
+// ou x 7 (diagonal), entier.
+// Modification du terrain: setCost / updateFromMap marquent les clusters, flush() ne reconstruit que ceux-ci, les
+// voisins dont les transitions ont changé, et les régions qui les contiennent.
+class HierarchicalGrid {
+public:
+    using Cost = uint32_t;
+    static constexpr Cost kUnreachable = std::numeric_limits<Cost>::max();
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    static constexpr int kRegionClusters = 8;
+    struct Stats { size_t clusters = 0, nodes = 0, intraEdges = 0, components = 0, regions = 0, gates = 0, gateEdges = 0, rebuiltClusters = 0, rebuiltRegions = 0; double buildMs = 0.0, flushMs = 0.0; };
+    // Chemin abstrait: cases de passage (index y * width + x), départ et arrivée compris
+    struct Path {
+        std::vector<uint32_t> waypoints;
+        Cost cost = kUnreachable;
+        bool found() const { return cost != kUnreachable; }
+    };
+
+    // Espace de travail d'une requête: un par thread. La grille ne doit pas être modifiée (flush) pendant les requêtes.
+    class Query {
+    public:
+        explicit Query(const HierarchicalGrid& grid) : grid_(&grid) {}
+        bool findPath(int sx, int sy, int gx, int gy, Path& out);
+        // Cases de waypoints[i] (exclue) à waypoints[i + 1] (incluse)
+        bool refineSegment(const Path& path, size_t i, std::vector<uint32_t>& cells);
+        // Chemin de cases complet, départ compris
+        bool refine(const Path& path, std::vector<uint32_t>& cells);
+        size_t lastExpanded() const { return expanded_; } // noeuds développés par le dernier findPath
+    private:
+        // Recherche bornée à un cluster depuis 'from': distances vers ses noeuds (nodeCost), ou chemin jusqu'à 'goal'
+        Cost local(uint32_t cluster, uint32_t from, uint32_t goal, std::vector<Cost>* nodeCost, std::vector<uint32_t>* cells);
+        void fit();
+        const HierarchicalGrid* grid_;
+        std::vector<Cost> startCost_, goalCost_;
+        // A* mixte (index de noeud du niveau 1): arête de région empruntée pour atteindre le noeud, kNone sinon
+        std::vector<Cost> g_;
+        std::vector<uint32_t> parent_, via_, stamp_;
+        uint32_t query_ = 0;
+        std::vector<std::pair<uint64_t, uint32_t>> heap_;
+        std::vector<uint32_t> nodes_, components_;
+        // Recherche locale (case du cluster -> index local)
+        std::vector<Cost> localG_;
+        std::vector<uint32_t> localParent_, localStamp_;
+        std::vector<uint8_t> localTarget_;
+        uint32_t localQuery_ = 0;
+        std::vector<std::vector<uint32_t>> localBuckets_;
+        size_t expanded_ = 0;
+    };
+
+    void build(std::vector<uint8_t> costs, int width, int height, int clusterSize = 32);
+    bool build(const TileMap& map, const TerrainCosts& costs = {}, int clusterSize = 32);
+    void build(std::vector<uint8_t> costs, int width, int height, int clusterSize, ThreadPool& pool);
+
+    // Terrain modifié: effet au prochain flush()
+    void setCost(int x, int y, uint8_t cost);
+    void updateFromMap(const TileMap& map, const TerrainCosts& costs, int x0, int y0, int x1, int y1); // [x0,x1) x [y0,y1)
+    size_t flush();                      // clusters reconstruits
+    size_t flush(ThreadPool& pool);
+    bool dirty() const { return !dirty_.empty(); }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    uint8_t cost(int x, int y) const { return costs_[(size_t)y * w_ + x]; }
+    size_t nodeCount() const { return nodeCell_.size(); }
+    size_t gateCount() const { return gateNode_.size(); }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Cluster { uint32_t n = 0; std::vector<Cost> dist; }; // n x n, kUnreachable hors d'atteinte
+    // Noeuds de la région: [first, first + n) (numérotation par région, index local stable tant que ses clusters le
+    // sont). Arêtes de la porte i: [edgeFirst[i], edgeFirst[i + 1]), noeuds intermédiaires de l'arête e (locaux, dans
+    // l'ordre): path[pathFirst[e], pathFirst[e + 1]).
+    struct Region {
+        uint32_t first = 0, n = 0;
+        std::vector<uint16_t> gates;
+        std::vector<uint32_t> edgeFirst{0u}, pathFirst{0u};
+        std::vector<uint16_t> edgeTo, path;
+        std::vector<Cost> edgeCost;
+    };
+    // Espace de travail des reconstructions (un par tranche de parallelFor)
+    struct Workspace {
+        std::vector<uint32_t> cells, parent, stamp; std::vector<Cost> g; std::vector<uint8_t> target; std::vector<std::vector<uint32_t>> buckets; uint32_t query = 0;
+        std::vector<Cost> regionG; std::vector<uint32_t> regionParent; std::vector<std::pair<uint64_t, uint32_t>> heap;
+    };
+    enum Side : int { North = 0, South = 1, West = 2, East = 3 };
+
+    uint32_t clusterOf(uint32_t cell) const { return (cell / w_ / cs_) * cw_ + (cell % w_) / cs_; }
+    uint32_t regionOf(uint32_t cluster) const { return (cluster / cw_ / kRegionClusters) * rw_ + (cluster % cw_) / kRegionClusters; }
+    void clusterRect(uint32_t c, int& x0, int& y0, int& x1, int& y1) const;
+    std::vector<uint16_t>* border(uint32_t c, int side);
+    const std::vector<uint16_t>* border(uint32_t c, int side) const;
+    bool buildBorder(uint32_t c, int side);      // cluster c et son voisin côté 'side' (Est ou Sud); true si changé
+    void nodeCells(uint32_t c, std::vector<uint32_t>& cells) const;
+    void buildCluster(uint32_t c, Workspace& ws);
+    void relink();
+    // Dijkstra niveau 1 restreint à la région r; g/parent (index local, regions_[r].n) et heap amorcés par l'appelant
+    void searchRegion(uint32_t r, Cost* g, uint32_t* parent, std::vector<std::pair<uint64_t, uint32_t>>& heap) const;
+    void buildRegion(uint32_t r, Workspace& ws);
+    void relinkGates();
+    Cost step(uint32_t a, uint32_t b, bool diagonal) const { return (Cost)(costs_[a] + costs_[b]) * (diagonal ? 7u : 5u); }
+
+    int w_ = 0, h_ = 0, cs_ = 32, cw_ = 0, ch_ = 0, rw_ = 0, rh_ = 0;
+    uint8_t minCost_ = 1;
+    std::vector<uint8_t> costs_;                       // largeur et hauteur <= 65535
+    std::vector<std::vector<uint16_t>> south_, east_;  // transitions du bord Sud / Est de chaque cluster (décalage le long du bord)
+    std::vector<Cluster> clusters_;
+    // Graphe du niveau 1 (renuméroté par relink, région par région): noeuds du cluster c = [nodeFirst_[c], + clusters_[c].n)
+    std::vector<uint32_t> nodeFirst_, nodeCell_, nodeXY_, nodeCluster_, partner_, component_; // nodeXY_: x | y << 16
+    std::vector<Cost> partnerCost_;
+    // Niveau 2: portes de la région r = [gateFirst_[r], gateFirst_[r + 1]) (renumérotées par relinkGates)
+    std::vector<Region> regions_;
+    std::vector<uint32_t> gateFirst_{0u}, gateNode_, gateRegion_, gateOf_;
+    std::vector<uint32_t> dirty_;
+    std::vector<uint8_t> dirtyFlag_;
+    Stats stats_;
+};
+
+} // namespace Pathfinding
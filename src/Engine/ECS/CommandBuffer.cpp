@@ -0,0 +1,47 @@
+#include "CommandBuffer.h"
+#include <algorithm>
+
+void* CommandBuffer::allocate(size_t size, size_t align) {
+    for (;;) {
+        if (block_ < blocks_.size()) {
+            size_t at = (offset_ + align - 1) & ~(align - 1);
+            if (at + size <= blockSizes_[block_]) { offset_ = at + size; return blocks_[block_].get() + at; }
+            ++block_; offset_ = 0;
+            continue;
+        }
+        // Nouveau bloc (plus grand si un composant dépasse la taille standard)
+        size_t bytes = std::max(kBlockSize, size);
+        blocks_.emplace_back(static_cast<std::byte*>(::operator new(bytes, std::align_val_t(kBlockAlign))));
+        blockSizes_.push_back(bytes);
+        block_ = blocks_.size() - 1; offset_ = 0;
+    }
+}
+
+void CommandBuffer::apply(Registry& reg, size_t begin, size_t end) {
+    for (size_t i=begin; i<end && i<commands_.size(); ++i) {
+        Command& c = commands_[i];
+        if (!c.apply) continue;
+        c.apply(reg, c.entity, c.payload);
+        c.apply = nullptr; c.drop = nullptr; // payload consommé
+    }
+}
+
+void CommandBuffer::clear() {
+    for (Command& c : commands_) if (c.drop) c.drop(c.payload);
+    commands_.clear();
+    block_ = 0; offset_ = 0;
+}
+
+namespace ECS {
+
+void ParallelCommands::apply(Registry& reg) {
+    struct Ref { size_t chunk; unsigned slot; size_t begin, end; };
+    std::vector<Ref> order;
+    for (unsigned s=0; s<segments_.size(); ++s) for (const Segment& seg : segments_[s]) order.push_back({ seg.chunk, s, seg.begin, seg.end });
+    // Les morceaux d'un chunk sont sur un même slot: (chunk, début) redonne l'ordre d'émission
+    std::sort(order.begin(), order.end(), [](const Ref& a, const Ref& b) { return a.chunk != b.chunk ? a.chunk < b.chunk : a.begin < b.begin; });
+    for (const Ref& r : order) buffers_[r.slot].apply(reg, r.begin, r.end);
+    for (unsigned s=0; s<buffers_.size(); ++s) { buffers_[s].clear(); segments_[s].clear(); }
+}
+
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include "Registry.h"
+#include "../../Platform/ThreadPool.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Changements structurels différés (create/destroy/add/remove), appliqués plus tard au Registry dans l'ordre d'enregistrement.
+// Les composants sont copiés dans une arène par blocs (jamais déplacée), sans verrou: un tampon n'appartient qu'à un thread.
+// Les commandes visant une entité devenue invalide (détruite entre-temps) sont ignorées.
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    ~CommandBuffer() { clear(); }
+    CommandBuffer(CommandBuffer&&) = default;
+    CommandBuffer& operator=(CommandBuffer&&) = default;
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    template<class... Ts> void create(Ts&&... components);
+    void destroy(Entity e) { push(e, nullptr, [](Registry& r, Entity e, void*) { r.destroy(e); }, nullptr); }
+    template<class T> void add(Entity e, T&& value);
+    template<class T> void remove(Entity e) { push(e, nullptr, [](Registry& r, Entity e, void*) { r.remove<T>(e); }, nullptr); }
+
+    size_t size() const { return commands_.size(); }
+    bool empty() const { return commands_.empty(); }
+    void apply(Registry& reg) { apply(reg, 0, commands_.size()); clear(); }
+    void apply(Registry& reg, size_t begin, size_t end); // sous-plage (fusion ordonnée), sans vider
+    void clear(); // détruit les composants non appliqués, garde les blocs
+
+private:
+    using ApplyFn = void (*)(Registry&, Entity, void*);
+    using DropFn = void (*)(void*);
+    struct Command { ApplyFn apply; DropFn drop; Entity entity; void* payload; };
+    static constexpr size_t kBlockSize = 16 * 1024;
+    static constexpr size_t kBlockAlign = 64;
+
+    void push(Entity e, void* payload, ApplyFn apply, DropFn drop) { commands_.push_back({ apply, drop, e, payload }); }
+    void* allocate(size_t size, size_t align);
+
+    struct BlockDeleter { void operator()(std::byte* p) const { ::operator delete(p, std::align_val_t(kBlockAlign)); } };
+    std::vector<Command> commands_;
+    std::vector<std::unique_ptr<std::byte, BlockDeleter>> blocks_;
+    std::vector<size_t> blockSizes_;
+    size_t block_ = 0, offset_ = 0; // bloc courant et position dans ce bloc
+};
+
+namespace ECS {
+
+// Lignes par tâche de forEachParallel (indépendant du nombre de threads: le découpage et donc l'ordre de fusion sont stables)
+constexpr size_t kParallelChunkRows = 4096;
+// > 0 pendant l'exécution d'une tranche sur ce thread: un forEachParallel imbriqué s'exécute alors inline
+// (sinon son attente volerait d'autres tranches de l'appel englobant dans le même CommandBuffer)
+inline thread_local int tl_parallelChunkDepth = 0;
+
+// Un CommandBuffer par thread (workers + thread appelant). Chaque chunk note la plage de commandes qu'il a produite;
+// apply() rejoue les plages triées par index de chunk: résultat identique quel que soit le thread qui a traité le chunk.
+// Si fn attend le pool (parallelFor, TaskGroup::wait), le thread peut voler un autre chunk du même appel et l'exécuter
+// sur le même tampon: le chunk interrompu est alors coupé en morceaux autour de lui (pile de chunks ouverts par slot).
+// Un autre thread extérieur au pool peut voler une tranche en attendant son propre travail: il partage le dernier
+// tampon sous verrou récursif (chemin rare, hors boucle chaude; réentrant pour la même raison).
+class ParallelCommands {
+public:
+    explicit ParallelCommands(unsigned slots) : buffers_(slots + 1), segments_(slots + 1), open_(slots + 1) {}
+    unsigned foreignSlot() const { return (unsigned)buffers_.size() - 1; }
+    std::recursive_mutex& foreignMutex() { return foreignM_; }
+    CommandBuffer& buffer(unsigned slot) { return buffers_[slot]; }
+    void beginChunk(unsigned slot, size_t chunk) {
+        if (!open_[slot].empty()) closePiece(slot, open_[slot].back()); // chunk volé pendant une attente de fn
+        open_[slot].push_back({ chunk, buffers_[slot].size() });
+    }
+    void endChunk(unsigned slot) {
+        closePiece(slot, open_[slot].back()); open_[slot].pop_back();
+        if (!open_[slot].empty()) open_[slot].back().begin = buffers_[slot].size(); // reprise du chunk interrompu
+    }
+    void apply(Registry& reg);
+
+private:
+    struct Segment { size_t chunk, begin, end; };
+    struct Open { size_t chunk, begin; };
+    void closePiece(unsigned slot, const Open& o) {
+        if (buffers_[slot].size() > o.begin) segments_[slot].push_back({ o.chunk, o.begin, buffers_[slot].size() });
+    }
+    std::vector<CommandBuffer> buffers_;
+    std::vector<std::vector<Segment>> segments_;
+    std::vector<std::vector<Open>> open_;
+    std::recursive_mutex foreignM_;
+};
+
+} // namespace ECS
+
+template<class... Ts>
+void CommandBuffer::create(Ts&&... components) {
+    using Pack = std::tuple<std::decay_t<Ts>...>;
+    void* p = new (allocate(sizeof(Pack), alignof(Pack))) Pack(std::forward<Ts>(components)...);
+    push(Entity::Null(), p,
+        [](Registry& r, Entity, void* p) { Pack& pack = *static_cast<Pack*>(p); std::apply([&](auto&... c) { r.create(std::move(c)...); }, pack); pack.~Pack(); },
+        [](void* p) { static_cast<Pack*>(p)->~Pack(); });
+}
+
+template<class T>
+void CommandBuffer::add(Entity e, T&& value) {
+    using C = std::decay_t<T>;
+    static_assert(alignof(C) <= kBlockAlign, "CommandBuffer: alignement de composant trop grand");
+    void* p = new (allocate(sizeof(C), alignof(C))) C(std::forward<T>(value));
+    push(e, p,
+        [](Registry& r, Entity e, void* p) { C& c = *static_cast<C*>(p); if (r.valid(e)) r.add<C>(e, std::move(c)); c.~C(); },
+        [](void* p) { static_cast<C*>(p)->~C(); });
+}
+
+template<class... Ts>
+template<class F>
+void View<Ts...>::forEachParallel(ThreadPool& pool, F&& fn) {
+    struct Range { ECS::Archetype* a; size_t begin, end; };
+    std::vector<Range> ranges;
+    for (size_t i=0, n=reg_->archetypeSlots(); i<n; ++i) {
+        ECS::Archetype& a = reg_->archetype(i);
+        if (a.size() == 0 || !matches(a)) continue;
+        for (size_t b=0; b<a.size(); b+=ECS::kParallelChunkRows) ranges.push_back({ &a, b, std::min(a.size(), b + ECS::kParallelChunkRows) });
+    }
+    if (ranges.empty()) return;
+    const bool nested = ECS::tl_parallelChunkDepth > 0;
+    ECS::ParallelCommands commands(nested ? 0 : pool.workerCount() + 1);
+    auto runChunks = [&](unsigned slot, size_t begin, size_t end) {
+        CommandBuffer& cb = commands.buffer(slot);
+        ++ECS::tl_parallelChunkDepth;
+        for (size_t c=begin; c<end; ++c) {
+            const Range& r = ranges[c]; commands.beginChunk(slot, c);
+            const Entity* entities = r.a->entities.data();
+            auto columns = std::make_tuple(r.a->template data<std::remove_cv_t<Ts>>()...);
+            forRuns(*r.a, r.begin, r.end, [&](size_t runBegin, size_t runEnd) {
+                std::apply([&](auto*... col) {
+                    for (size_t i=runBegin; i<runEnd; ++i) {
+                        if constexpr (std::is_invocable_v<F&, CommandBuffer&, Entity, Ts&...>) fn(cb, entities[i], col[i]...);
+                        else if constexpr (std::is_invocable_v<F&, Entity, Ts&...>) fn(entities[i], col[i]...);
+                        else fn(col[i]...);
+                    }
+                }, columns);
+            });
+            commands.endChunk(slot);
+        }
+        --ECS::tl_parallelChunkDepth;
+    };
+    if (nested) runChunks(0, 0, ranges.size());
+    else {
+        const std::thread::id caller = std::this_thread::get_id();
+        pool.parallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+            unsigned slot = pool.currentWorker();
+            std::unique_lock<std::recursive_mutex> foreign;
+            if (slot == pool.workerCount() && std::this_thread::get_id() != caller) { slot = commands.foreignSlot(); foreign = std::unique_lock<std::recursive_mutex>(commands.foreignMutex()); }
+            runChunks(slot, begin, end);
+        });
+    }
+    commands.apply(*reg_); // point de synchronisation: changements structurels dans l'ordre des chunks
+}
+
+template<class... Ts>
+template<class F>
+void View<Ts...>::forEachParallel(F&& fn) { forEachParallel(ThreadPool::Shared(), std::forward<F>(fn)); }
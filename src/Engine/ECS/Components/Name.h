@@ -1,3 +1,7 @@
 #pragma once
-// [4] TODO: Name: identifiant lisible, localisation-friendly
-struct Name { /* ... */ };
+#include <cstdint>
+// [4] TODO: Name: résolution localisée (clé -> texte via data/localization)
+
+// Nom lisible: id de chaîne interné (clé de localisation). Le StringPool est celui du créateur
+// (PrefabLibrary::strings() pour les entités issues de prefabs).
+struct Name { uint32_t id = 0; };
@@ -1,3 +1,10 @@
 #pragma once
-// [9] TODO: Residence: lien citoyen <-> bâtiment/logement, capacité
-struct Residence { /* ... */ };
+#include "../Entity.h"
+#include <cstdint>
+// [9] TODO: Residence: attribution des logements, déménagements
+
+// Logement: côté bâtiment, capacity/occupants; côté citoyen, home = bâtiment occupé
+struct Residence {
+    Entity home;
+    uint16_t capacity = 0, occupants = 0;
+};
@@ -1,3 +1,12 @@
 #pragma once
-// [4] TODO: Transform: position(m), rotation(quat), scale; parent optionnel; matrices
-struct Transform { /* ... */ };
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+// [4] TODO: Transform: parent optionnel; matrices
+
+// Position en mètres dans le repère monde (plan XY = carte, Z = altitude). Les écritures en place passent par
+// Registry::patch<Transform> pour que les systèmes réactifs (SpatialIndex, brouillard, rendu) les voient.
+struct Transform {
+    glm::vec3 position{0.f};
+    glm::quat rotation{};
+    glm::vec3 scale{1.f};
+};
@@ -1,3 +1,28 @@
 #pragma once
-// [4] TODO: Handle entité (id+version), comparaisons, null
-struct Entity { /* ... */ };
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Handle d'entité générationnel: index de slot + version. Un slot détruit puis réutilisé change de version,
+// donc un handle périmé n'est jamais confondu avec la nouvelle entité (Registry::valid).
+struct Entity {
+    static constexpr uint32_t kNullIndex = 0xFFFFFFFFu;
+    uint32_t index = kNullIndex;
+    uint32_t version = 0;
+
+    static constexpr Entity Null() { return Entity{}; }
+    constexpr bool isNull() const { return index == kNullIndex; }
+    constexpr explicit operator bool() const { return !isNull(); }
+
+    // Forme compacte 64 bits (sauvegardes, clés de hash, messages)
+    constexpr uint64_t bits() const { return ((uint64_t)version << 32) | index; }
+    static constexpr Entity FromBits(uint64_t b) { return Entity{ (uint32_t)b, (uint32_t)(b >> 32) }; }
+
+    friend constexpr bool operator==(Entity a, Entity b) { return a.index == b.index && a.version == b.version; }
+    friend constexpr bool operator!=(Entity a, Entity b) { return !(a == b); }
+    friend constexpr bool operator<(Entity a, Entity b) { return a.bits() < b.bits(); }
+};
+
+template<> struct std::hash<Entity> {
+    size_t operator()(Entity e) const noexcept { return std::hash<uint64_t>()(e.bits()); }
+};
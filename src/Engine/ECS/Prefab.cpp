@@ -0,0 +1,177 @@
+#include "Prefab.h"
+#include "Components/Transform.h"
+#include "Components/Name.h"
+#include "Components/Residence.h"
+#include "../Gameplay/City/Building.h"
+#include "../Gameplay/WorldMap/Country.h"
+#include "../Gameplay/Character/Item.h"
+#include "../../Core/Profiler.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace {
+// Tableau [x,y(,z)] -> composantes (absent: inchangé); false si mal formé
+bool ReadFloats(const json& j, const char* key, float* v, size_t n) {
+    if (!j.contains(key)) return true;
+    const json& a = j[key];
+    if (!a.is_array() || a.size() != n) return false;
+    for (size_t i=0; i<n; ++i) { if (!a[i].is_number()) return false; v[i] = a[i].get<float>(); }
+    return true;
+}
+
+// "#RRGGBB" ou entier
+bool ReadColor(const json& j, const char* key, uint32_t& out) {
+    if (!j.contains(key)) return true;
+    const json& c = j[key];
+    if (c.is_number_unsigned() || c.is_number_integer()) { out = c.get<uint32_t>() & 0xFFFFFFu; return true; }
+    if (!c.is_string()) return false;
+    const std::string s = c.get<std::string>();
+    if (s.size() != 7 || s[0] != '#') return false;
+    char* end = nullptr; unsigned long v = std::strtoul(s.c_str() + 1, &end, 16);
+    if (*end) return false;
+    out = (uint32_t)v; return true;
+}
+}
+
+PrefabLibrary::PrefabLibrary() {
+    registerComponent<Transform>("Transform", [](const json& j, Transform& t) {
+        float q[4] = { t.rotation.w, t.rotation.x, t.rotation.y, t.rotation.z };
+        if (!ReadFloats(j, "position", &t.position.x, 3) || !ReadFloats(j, "scale", &t.scale.x, 3) || !ReadFloats(j, "rotation", q, 4)) return false;
+        t.rotation = glm::quat(q[0], q[1], q[2], q[3]);
+        return true;
+    });
+    registerComponent<Name>("Name", [this](const json& j, Name& n) { n.id = strings_.intern(j.value("key", std::string())); return true; });
+    registerComponent<Building>("Building", [this](const json& j, Building& b) {
+        float fp[2] = { b.footprintX, b.footprintY };
+        if (!ReadFloats(j, "footprint", fp, 2)) return false;
+        b.footprintX = fp[0]; b.footprintY = fp[1];
+        b.typeId = strings_.intern(j.value("type", std::string()));
+        b.floors = (uint16_t)std::clamp(j.value("floors", 1), 1, 200);
+        return true;
+    });
+    registerComponent<Residence>("Residence", [](const json& j, Residence& r) { r.capacity = (uint16_t)std::clamp(j.value("capacity", 0), 0, 65535); return true; });
+    registerComponent<Country>("Country", [](const json& j, Country& c) { c.mapId = (uint16_t)j.value("mapId", 0); return ReadColor(j, "color", c.color); });
+    registerComponent<Item>("Item", [](const json& j, Item& it) {
+        it.weightKg = j.value("weightKg", it.weightKg); it.volumeL = j.value("volumeL", it.volumeL);
+        it.maxStack = (uint16_t)std::clamp(j.value("maxStack", 1), 1, 65535); it.baseValue = j.value("value", 0u);
+        return it.weightKg >= 0.f && it.volumeL >= 0.f;
+    });
+}
+
+PrefabLibrary::~PrefabLibrary() { clear(); }
+
+void PrefabLibrary::DestroyParts(Prefab& p) {
+    for (size_t i=0; i<p.ids.size(); ++i) {
+        const ECS::ComponentInfo& info = ECS::Info(p.ids[i]);
+        if (!info.trivial) info.destroy(const_cast<void*>(p.parts[i]));
+    }
+    p.ids.clear(); p.parts.clear();
+}
+
+void PrefabLibrary::clear() {
+    for (Prefab& p : prefabs_) DestroyParts(p);
+    prefabs_.clear(); byName_.clear();
+}
+
+PrefabId PrefabLibrary::find(std::string_view id) const {
+    const uint32_t s = strings_.find(id);
+    if (s == StringPool::kInvalid) return kInvalid;
+    auto it = byName_.find(s);
+    return it == byName_.end() ? kInvalid : it->second;
+}
+
+bool PrefabLibrary::compile(const std::string& source, const std::string& id, const json& def, Prefab& out) {
+    if (!def.is_object()) { std::fprintf(stderr, "[Prefab] %s: '%s' n'est pas un objet\n", source.c_str(), id.c_str()); return false; }
+    std::vector<std::pair<const Loader*, const json*>> parts;
+    for (auto it = def.begin(); it != def.end(); ++it) {
+        auto l = loaders_.find(it.key());
+        if (l == loaders_.end()) { std::fprintf(stderr, "[Prefab] %s: '%s': composant inconnu '%s' ignoré\n", source.c_str(), id.c_str(), it.key().c_str()); continue; }
+        parts.push_back({ &l->second, &it.value() });
+    }
+    std::sort(parts.begin(), parts.end(), [](const auto& a, const auto& b) { return a.first->id < b.first->id; });
+    // Disposition du blob puis construction + lecture de chaque composant
+    size_t bytes = 0;
+    for (const auto& p : parts) {
+        bytes = (bytes + p.first->align - 1) / p.first->align * p.first->align;
+        out.offsets.push_back(bytes); bytes += p.first->size;
+    }
+    out.blob.resize((bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+    std::byte* base = reinterpret_cast<std::byte*>(out.blob.data());
+    for (size_t i=0; i<parts.size(); ++i) {
+        bool ok = false;
+        try { ok = parts[i].first->construct(*parts[i].second, base + out.offsets[i]); }
+        catch (const std::exception& e) { std::fprintf(stderr, "[Prefab] %s: '%s': %s\n", source.c_str(), id.c_str(), e.what()); }
+        if (!ok) {
+            std::fprintf(stderr, "[Prefab] %s: '%s': composant '%s' invalide, prefab rejeté\n", source.c_str(), id.c_str(), parts[i].first->name.c_str());
+            DestroyParts(out);
+            return false;
+        }
+        out.ids.push_back(parts[i].first->id); out.parts.push_back(base + out.offsets[i]);
+        out.mask |= ECS::ComponentMask{1} << parts[i].first->id;
+    }
+    out.nameId = strings_.intern(id);
+    return true;
+}
+
+bool PrefabLibrary::loadJson(const json& doc, const std::string& source) {
+    PROFILE_ZONE("PrefabLibrary::loadJson");
+    if (!doc.is_object() || !doc.contains("prefabs") || !doc["prefabs"].is_object()) {
+        std::fprintf(stderr, "[Prefab] %s: objet \"prefabs\" attendu\n", source.c_str());
+        return false;
+    }
+    bool ok = true;
+    const json& defs = doc["prefabs"];
+    for (auto it = defs.begin(); it != defs.end(); ++it) {
+        Prefab p;
+        if (!compile(source, it.key(), it.value(), p)) { ok = false; continue; }
+        auto prev = byName_.find(p.nameId);
+        if (prev != byName_.end()) {
+            std::fprintf(stderr, "[Prefab] %s: '%s' redéfini\n", source.c_str(), it.key().c_str());
+            DestroyParts(prefabs_[prev->second]);
+            prefabs_[prev->second] = std::move(p);
+        } else {
+            byName_.emplace(p.nameId, (PrefabId)prefabs_.size());
+            prefabs_.push_back(std::move(p));
+        }
+    }
+    return ok;
+}
+
+bool PrefabLibrary::loadFile(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) { std::fprintf(stderr, "[Prefab] Impossible d'ouvrir %s\n", path.c_str()); return false; }
+    if (f.peek() == std::ifstream::traits_type::eof()) return true; // fichier vide: aucun prefab
+    json doc;
+    try { f >> doc; } catch (const std::exception& e) { std::fprintf(stderr, "[Prefab] %s: %s\n", path.c_str(), e.what()); return false; }
+    return loadJson(doc, path);
+}
+
+bool PrefabLibrary::loadDirectory(const std::string& dir) {
+    std::error_code ec;
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) if (entry.is_regular_file() && entry.path().extension() == ".json") files.push_back(entry.path());
+    if (ec) { std::fprintf(stderr, "[Prefab] Dossier illisible %s: %s\n", dir.c_str(), ec.message().c_str()); return false; }
+    std::sort(files.begin(), files.end());
+    bool ok = true;
+    for (const auto& p : files) ok = loadFile(p.string()) && ok;
+    return ok;
+}
+
+ECS::Archetype& PrefabLibrary::spawn(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out) const {
+    PROFILE_ZONE("PrefabLibrary::instantiate");
+    const Prefab& p = prefabs_[id];
+    return reg.createManyFrom(p.mask, p.parts.data(), n, out);
+}
+
+void PrefabLibrary::instantiate(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out) const { spawn(reg, id, n, out); }
+
+Entity PrefabLibrary::create(Registry& reg, PrefabId id) const {
+    ECS::Archetype& a = spawn(reg, id, 1, nullptr);
+    return a.entities.back();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Registry.h"
+#include "../../Core/StringPool.h"
+#include <nlohmann/json_fwd.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Prefabs: gabarits d'entités décrits dans data/defs/*.json, compilés une fois en blob de composants construits
+// (triés par id de composant), puis instanciés N à la fois: une recherche d'archétype, une réservation,
+// remplissage colonne par colonne (memcpy pour les composants triviaux), aucun déplacement d'archétype.
+//
+// Format: { "prefabs": { "<id>": { "<Composant>": { champs... }, ... }, ... } }
+// Les composants sont déclarés par registerComponent<T>("Nom", parse); Transform, Name, Building, Residence,
+// Country et Item le sont d'office. Composant inconnu: ignoré avec avertissement; erreur de champ: prefab rejeté.
+using PrefabId = uint32_t;
+
+class PrefabLibrary {
+public:
+    static constexpr PrefabId kInvalid = 0xFFFFFFFFu;
+
+    PrefabLibrary();
+    ~PrefabLibrary();
+    PrefabLibrary(const PrefabLibrary&) = delete;
+    PrefabLibrary& operator=(const PrefabLibrary&) = delete;
+
+    // parse(champs, composant déjà construit par défaut) -> false si invalide
+    template<class T> void registerComponent(const std::string& name, std::function<bool(const nlohmann::json&, T&)> parse);
+
+    bool loadFile(const std::string& path);
+    bool loadDirectory(const std::string& dir); // *.json, par ordre de nom de fichier
+    bool loadJson(const nlohmann::json& doc, const std::string& source);
+    void clear();
+
+    size_t size() const { return prefabs_.size(); }
+    PrefabId find(std::string_view id) const;
+    std::string_view name(PrefabId id) const { return strings_.view(prefabs_[id].nameId); }
+    ECS::ComponentMask mask(PrefabId id) const { return prefabs_[id].mask; }
+    // Chaînes des composants issus des prefabs (Name::id, Building::typeId)
+    const StringPool& strings() const { return strings_; }
+    StringPool& strings() { return strings_; }
+
+    Entity create(Registry& reg, PrefabId id) const;
+    void instantiate(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out = nullptr) const;
+    // Idem puis init(size_t i, Ts&...) sur les colonnes des n nouvelles lignes (positions, liens...):
+    // Ts doivent faire partie du prefab
+    template<class... Ts, class F> void instantiate(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out, F&& init) const;
+
+private:
+    struct Loader {
+        std::string name; ECS::ComponentId id; size_t size, align;
+        std::function<bool(const nlohmann::json&, void*)> construct; // construit par défaut puis lit les champs
+    };
+    struct Prefab {
+        uint32_t nameId = 0;
+        ECS::ComponentMask mask = 0;
+        std::vector<ECS::ComponentId> ids;  // croissants (ordre des colonnes de l'archétype)
+        std::vector<size_t> offsets;        // dans blob
+        std::vector<std::max_align_t> blob;
+        std::vector<const void*> parts;     // pointeurs dans blob, parallèles à ids
+    };
+
+    bool compile(const std::string& source, const std::string& id, const nlohmann::json& def, Prefab& out);
+    static void DestroyParts(Prefab& p);
+    ECS::Archetype& spawn(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out) const;
+
+    std::unordered_map<std::string, Loader> loaders_;
+    std::vector<Prefab> prefabs_;
+    std::unordered_map<uint32_t, PrefabId> byName_; // id de chaîne -> prefab
+    StringPool strings_;
+};
+
+template<class T>
+void PrefabLibrary::registerComponent(const std::string& name, std::function<bool(const nlohmann::json&, T&)> parse) {
+    static_assert(std::is_copy_constructible_v<T> && alignof(T) <= alignof(std::max_align_t), "PrefabLibrary: composant copiable et d'alignement standard requis");
+    loaders_[name] = Loader{ name, ECS::TypeId<T>(), sizeof(T), alignof(T), [parse](const nlohmann::json& j, void* dst) {
+        T* c = new (dst) T();
+        bool ok = false;
+        try { ok = parse(j, *c); } catch (...) { c->~T(); throw; } // erreurs de type nlohmann: rapportées par compile()
+        if (!ok) c->~T();
+        return ok;
+    } };
+}
+
+template<class... Ts, class F>
+void PrefabLibrary::instantiate(Registry& reg, PrefabId id, size_t n, std::vector<Entity>* out, F&& init) const {
+    assert((prefabs_[id].mask & ECS::MaskOf<Ts...>()) == ECS::MaskOf<Ts...>() && "PrefabLibrary::instantiate: type hors prefab");
+    ECS::Archetype& a = spawn(reg, id, n, out);
+    const size_t first = a.size() - n;
+    auto columns = std::make_tuple((a.template data<std::remove_cv_t<Ts>>() + first)...);
+    std::apply([&](auto*... col) { for (size_t i=0; i<n; ++i) init(i, col[i]...); }, columns);
+}
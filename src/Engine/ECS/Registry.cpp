@@ -0,0 +1,283 @@
+#include "Registry.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace ECS {
+
+namespace {
+std::mutex gInfoMutex;
+std::array<ComponentInfo, kMaxComponents> gInfos;
+ComponentId gInfoCount = 0;
+}
+
+ComponentId RegisterComponent(const ComponentInfo& info) {
+    std::lock_guard<std::mutex> lk(gInfoMutex);
+    if (gInfoCount >= kMaxComponents) { std::fprintf(stderr, "[ECS] Trop de types de composants (max %u): %s\n", kMaxComponents, info.name); std::abort(); }
+    gInfos[gInfoCount] = info;
+    return gInfoCount++;
+}
+
+const ComponentInfo& Info(ComponentId id) { return gInfos[id]; }
+
+Archetype::Archetype(ComponentMask m) : mask(m) {
+    columnOf.fill(-1); addEdge.fill(kNoArchetype); removeEdge.fill(kNoArchetype);
+    for (ComponentId id=0; id<kMaxComponents; ++id) {
+        if (!(m & (ComponentMask{1} << id))) continue;
+        columnOf[id] = (int8_t)types.size(); types.push_back(id);
+        Column c; c.info = &Info(id); columns.push_back(c);
+    }
+}
+
+Archetype::~Archetype() {
+    for (Column& c : columns) {
+        if (!c.info->trivial) for (size_t r=0; r<size(); ++r) c.info->destroy(c.at(r));
+        if (c.data) ::operator delete(c.data, std::align_val_t(c.info->align));
+    }
+}
+
+void Archetype::reserve(size_t n) {
+    if (n <= capacity) return;
+    for (Column& c : columns) {
+        std::byte* mem = static_cast<std::byte*>(::operator new(std::max<size_t>(n * c.info->size, 1), std::align_val_t(c.info->align)));
+        if (c.data) {
+            if (c.info->trivial) std::memcpy(mem, c.data, size() * c.info->size);
+            else for (size_t r=0; r<size(); ++r) c.info->moveConstruct(mem + r * c.info->size, c.at(r));
+            ::operator delete(c.data, std::align_val_t(c.info->align));
+        }
+        c.data = mem;
+        c.addedTick.reserve(n); c.changedTick.reserve(n);
+        c.addedBlock.reserve(n / kTickBlockRows + 1); c.changedBlock.reserve(n / kTickBlockRows + 1);
+    }
+    entities.reserve(n);
+    capacity = n;
+}
+
+size_t Archetype::pushRow(Entity e, uint32_t tick) {
+    if (size() == capacity) reserve(std::max<size_t>(64, capacity * 2));
+    const bool newBlock = size() % kTickBlockRows == 0;
+    for (Column& c : columns) {
+        c.addedTick.push_back(tick); c.changedTick.push_back(tick); c.lastAdded = c.lastChanged = tick;
+        if (newBlock) { c.addedBlock.push_back(tick); c.changedBlock.push_back(tick); } else { c.addedBlock.back() = tick; c.changedBlock.back() = tick; }
+    }
+    entities.push_back(e);
+    return entities.size() - 1;
+}
+
+size_t Archetype::pushRows(const Entity* es, size_t n, uint32_t tick) {
+    const size_t first = size();
+    if (first + n > capacity) reserve(std::max(first + n, capacity * 2));
+    const size_t blocks = (first + n + kTickBlockRows - 1) / kTickBlockRows;
+    for (Column& c : columns) {
+        c.addedTick.resize(first + n, tick); c.changedTick.resize(first + n, tick);
+        if (first % kTickBlockRows) { c.addedBlock.back() = tick; c.changedBlock.back() = tick; } // bloc partiel existant
+        c.addedBlock.resize(blocks, tick); c.changedBlock.resize(blocks, tick);
+        c.lastAdded = c.lastChanged = tick;
+    }
+    entities.insert(entities.end(), es, es + n);
+    return first;
+}
+
+Entity Archetype::removeRow(size_t row, ComponentMask movedOut) {
+    const size_t last = size() - 1;
+    for (size_t i=0; i<columns.size(); ++i) {
+        Column& c = columns[i];
+        if (c.info->trivial) { if (row != last) std::memcpy(c.at(row), c.at(last), c.info->size); continue; }
+        if (!(movedOut & (ComponentMask{1} << types[i]))) c.info->destroy(c.at(row));
+        if (row != last) c.info->moveConstruct(c.at(row), c.at(last));
+    }
+    for (Column& c : columns) {
+        if (row != last) {
+            c.addedTick[row] = c.addedTick[last]; c.changedTick[row] = c.changedTick[last];
+            uint32_t& ab = c.addedBlock[row / kTickBlockRows]; ab = std::max(ab, c.addedTick[row]);
+            uint32_t& cb = c.changedBlock[row / kTickBlockRows]; cb = std::max(cb, c.changedTick[row]);
+        }
+        c.addedTick.pop_back(); c.changedTick.pop_back();
+        if (last % kTickBlockRows == 0) { c.addedBlock.pop_back(); c.changedBlock.pop_back(); }
+    }
+    Entity moved = Entity::Null();
+    if (row != last) { moved = entities[last]; entities[row] = moved; }
+    entities.pop_back();
+    return moved;
+}
+
+} // namespace ECS
+
+Registry::Registry() { archetypeFor(0); } // archétype vide (entités sans composant) = index 0
+Registry::~Registry() { for (ECS::ChangeCursor* c : cursors_) c->reg_ = nullptr; }
+
+uint32_t Registry::archetypeFor(ECS::ComponentMask mask) {
+    auto it = archetypeByMask_.find(mask);
+    if (it != archetypeByMask_.end()) return it->second;
+    uint32_t idx = (uint32_t)archetypes_.size();
+    archetypes_.push_back(std::make_unique<ECS::Archetype>(mask));
+    archetypeByMask_.emplace(mask, idx);
+    return idx;
+}
+
+uint32_t Registry::neighbour(uint32_t from, ECS::ComponentId id, bool add) {
+    auto& edges = add ? archetypes_[from]->addEdge : archetypes_[from]->removeEdge;
+    if (edges[id] != ECS::kNoArchetype) return edges[id];
+    ECS::ComponentMask bit = ECS::ComponentMask{1} << id;
+    uint32_t to = archetypeFor(add ? (archetypes_[from]->mask | bit) : (archetypes_[from]->mask & ~bit));
+    edges[id] = to; // archétypes alloués individuellement: la référence reste valide si archetypes_ grandit
+    (add ? archetypes_[to]->removeEdge : archetypes_[to]->addEdge)[id] = from;
+    return to;
+}
+
+Entity Registry::allocate(uint32_t archetype) {
+    Entity e;
+    if (!free_.empty()) { e.index = free_.back(); free_.pop_back(); e.version = slots_[e.index].version; }
+    else { e.index = (uint32_t)slots_.size(); slots_.push_back(Slot{}); e.version = 0; }
+    Slot& s = slots_[e.index];
+    s.archetype = archetype; s.row = (uint32_t)archetypes_[archetype]->pushRow(e, tick_);
+    ++alive_;
+    return e;
+}
+
+Entity Registry::create() { return allocate(0); }
+
+ECS::Archetype& Registry::createManyFrom(ECS::ComponentMask mask, const void* const* prototypes, size_t n, std::vector<Entity>* out) {
+    const uint32_t arch = archetypeFor(mask);
+    ECS::Archetype& a = *archetypes_[arch];
+    const size_t first = a.size();
+    // Handles d'abord (slots libres puis nouveaux), puis toutes les lignes d'un coup
+    std::vector<Entity> local;
+    std::vector<Entity>& handles = out ? *out : local;
+    const size_t base = handles.size();
+    handles.resize(base + n);
+    slots_.reserve(slots_.size() + (n > free_.size() ? n - free_.size() : 0));
+    for (size_t i=0; i<n; ++i) {
+        Entity e;
+        if (!free_.empty()) { e.index = free_.back(); free_.pop_back(); e.version = slots_[e.index].version; }
+        else { e.index = (uint32_t)slots_.size(); slots_.push_back(Slot{}); e.version = 0; }
+        Slot& s = slots_[e.index]; s.archetype = arch; s.row = (uint32_t)(first + i);
+        handles[base + i] = e;
+    }
+    a.pushRows(handles.data() + base, n, tick_);
+    alive_ += n;
+    // Remplissage colonne par colonne (types par id croissant = ordre des colonnes)
+    for (size_t c=0; c<a.columns.size(); ++c) {
+        ECS::Column& col = a.columns[c]; const size_t size = col.info->size;
+        std::byte* dst = static_cast<std::byte*>(col.at(first));
+        if (col.info->trivial) for (size_t i=0; i<n; ++i) std::memcpy(dst + i * size, prototypes[c], size);
+        else {
+            assert(col.info->copyConstruct && "Registry::createManyFrom: composant non copiable");
+            for (size_t i=0; i<n; ++i) col.info->copyConstruct(dst + i * size, prototypes[c]);
+        }
+    }
+    return a;
+}
+
+void Registry::restoreSlots(const uint32_t* versions, size_t n) {
+    assert(alive_ == 0 && "Registry::restoreSlots: registre non vide");
+    slots_.assign(n, Slot{});
+    for (size_t i=0; i<n; ++i) slots_[i].version = versions[i];
+    free_.clear();
+}
+
+void Registry::restoreSlot(uint32_t index, uint32_t version) {
+    if (index >= slots_.size()) slots_.resize((size_t)index + 1);
+    Slot& s = slots_[index];
+    if (s.archetype != ECS::kNoArchetype) destroy(Entity{ index, s.version });
+    s.version = version;
+}
+
+void Registry::restoreSlotCount(size_t n) { if (n > slots_.size()) slots_.resize(n); }
+
+ECS::Archetype& Registry::createAt(ECS::ComponentMask mask, const Entity* handles, size_t n) {
+    const uint32_t arch = archetypeFor(mask);
+    ECS::Archetype& a = *archetypes_[arch];
+    const size_t first = a.size();
+    for (size_t i=0; i<n; ++i) {
+        if (handles[i].index >= slots_.size()) slots_.resize((size_t)handles[i].index + 1);
+        Slot& s = slots_[handles[i].index];
+        assert(s.archetype == ECS::kNoArchetype && "Registry::createAt: slot occupé");
+        s.version = handles[i].version; s.archetype = arch; s.row = (uint32_t)(first + i);
+    }
+    a.pushRows(handles, n, tick_);
+    alive_ += n;
+    return a;
+}
+
+void Registry::finishRestore() {
+    // Ordre décroissant: allocate() réutilise d'abord les plus petits index
+    free_.clear();
+    for (size_t i=slots_.size(); i-- > 0; ) if (slots_[i].archetype == ECS::kNoArchetype) free_.push_back((uint32_t)i);
+    for (auto& log : removed_) log.clear();
+    destroyed_.clear();
+    removedHorizon_ = tick_;
+}
+
+size_t Registry::moveEntity(Entity e, uint32_t to) {
+    Slot& s = slots_[e.index];
+    ECS::Archetype& src = *archetypes_[s.archetype];
+    ECS::Archetype& dst = *archetypes_[to];
+    const size_t srcRow = s.row;
+    const size_t row = dst.pushRow(e, tick_);
+    for (size_t c=0; c<src.columns.size(); ++c) {
+        ECS::ComponentId id = src.types[c];
+        if (!dst.has(id)) continue;
+        ECS::Column& from = src.columns[c]; ECS::Column& into = dst.column(id);
+        if (from.info->trivial) std::memcpy(into.at(row), from.at(srcRow), from.info->size);
+        else from.info->moveConstruct(into.at(row), from.at(srcRow));
+        // Un changement d'archétype n'est ni un ajout ni une modification des composants conservés
+        into.addedTick[row] = from.addedTick[srcRow]; into.changedTick[row] = from.changedTick[srcRow];
+    }
+    // Types communs déjà déplacés (donc détruits) côté source: removeRow ne doit détruire que les types abandonnés
+    fixMoved(src.removeRow(srcRow, src.mask & dst.mask), srcRow);
+    s.archetype = to; s.row = (uint32_t)row;
+    return row;
+}
+
+void Registry::destroy(Entity e) {
+    if (!valid(e)) return;
+    Slot& s = slots_[e.index];
+    ECS::Archetype& a = *archetypes_[s.archetype];
+    logRemovals(e, a.mask);
+    if (destroyTracked_) destroyed_.push_back({ e, tick_ });
+    fixMoved(a.removeRow(s.row), s.row);
+    s.archetype = ECS::kNoArchetype; ++s.version;
+    free_.push_back(e.index);
+    --alive_;
+}
+
+void Registry::destroy(const Entity* entities, size_t n) {
+    free_.reserve(free_.size() + n);
+    for (size_t i=0; i<n; ++i) destroy(entities[i]);
+}
+
+void Registry::clear() {
+    for (size_t i=0; i<slots_.size(); ++i) if (slots_[i].archetype != ECS::kNoArchetype) { slots_[i].archetype = ECS::kNoArchetype; ++slots_[i].version; free_.push_back((uint32_t)i); }
+    archetypes_.clear(); archetypeByMask_.clear();
+    archetypeFor(0);
+    alive_ = 0;
+    for (auto& log : removed_) log.clear();
+    destroyed_.clear();
+    removedHorizon_ = tick_;
+}
+
+uint32_t Registry::advanceTick() {
+    const uint32_t closed = tick_++;
+    // Journaux des retraits: purge amortie des entrées plus vieilles que la rétention et que tous les curseurs
+    if (closed % kRemovedPurgeEvery == 0 && closed > removedRetention_) {
+        uint32_t cutoff = closed - removedRetention_;
+        for (const ECS::ChangeCursor* c : cursors_) cutoff = std::min(cutoff, c->last);
+        removedHorizon_ = std::max(removedHorizon_, cutoff);
+        auto purge = [cutoff](std::vector<Removal>& log) {
+            auto it = std::upper_bound(log.begin(), log.end(), cutoff, [](uint32_t t, const Removal& r) { return t < r.tick; });
+            log.erase(log.begin(), it);
+        };
+        for (auto& log : removed_) purge(log);
+        purge(destroyed_);
+    }
+    return closed;
+}
+
+void Registry::logRemovals(Entity e, ECS::ComponentMask removed) {
+    for (ECS::ComponentMask m = removed & removedTracked_; m; m &= m - 1) removed_[(size_t)std::countr_zero(m)].push_back({ e, tick_ });
+}
@@ -0,0 +1,299 @@
+#include "SpatialIndex.h"
+#include "Components/Transform.h"
+#include "../../Platform/ThreadPool.h"
+#include "../../Core/Profiler.h"
+#include <algorithm>
+#include <utility>
+
+// ---- Table de cellules ----
+
+uint32_t SpatialIndex::CellTable::find(uint64_t key) const {
+    if (count == 0) return kNone;
+    const size_t mask = keys.size() - 1;
+    for (size_t i = slotOf(key); ; i = (i + 1) & mask) {
+        if (keys[i] == key) return values[i];
+        if (keys[i] == kEmpty) return kNone;
+    }
+}
+
+void SpatialIndex::CellTable::insert(uint64_t key, uint32_t value) {
+    if ((count + 1) * 2 > keys.size()) { // charge max 50%: rehachage
+        std::vector<uint64_t> oldKeys = std::move(keys); std::vector<uint32_t> oldValues = std::move(values);
+        size_t cap = std::max<size_t>(64, oldKeys.size() * 2);
+        keys.assign(cap, kEmpty); values.assign(cap, kNone); shift = 64;
+        for (size_t c = cap; c > 1; c >>= 1) --shift;
+        count = 0;
+        for (size_t i=0; i<oldKeys.size(); ++i) if (oldKeys[i] != kEmpty) insert(oldKeys[i], oldValues[i]);
+    }
+    const size_t mask = keys.size() - 1;
+    size_t i = slotOf(key);
+    while (keys[i] != kEmpty && keys[i] != key) i = (i + 1) & mask;
+    if (keys[i] == kEmpty) ++count;
+    keys[i] = key; values[i] = value;
+}
+
+void SpatialIndex::CellTable::erase(uint64_t key) {
+    if (count == 0) return;
+    const size_t mask = keys.size() - 1;
+    size_t i = slotOf(key);
+    while (keys[i] != key) { if (keys[i] == kEmpty) return; i = (i + 1) & mask; }
+    // Décalage arrière: remonte les éléments suivants du groupe dont la position idéale le permet
+    for (size_t j = (i + 1) & mask; keys[j] != kEmpty; j = (j + 1) & mask) {
+        const size_t ideal = slotOf(keys[j]);
+        if (((j - ideal) & mask) >= ((j - i) & mask)) { keys[i] = keys[j]; values[i] = values[j]; i = j; }
+    }
+    keys[i] = kEmpty; values[i] = kNone;
+    --count;
+}
+
+// ---- Index ----
+
+SpatialIndex::SpatialIndex(float cellSize, uint32_t coarseFactor)
+    : cellSize_(std::max(cellSize, 1e-3f)), invCell_(1.f / std::max(cellSize, 1e-3f)), coarseFactor_(std::max(coarseFactor, 2u)) {}
+
+void SpatialIndex::clear() {
+    cells_.clear(); freeCells_.clear(); buckets_.clear(); freeBuckets_.clear(); coarse_.clear(); freeCoarse_.clear();
+    fineMap_.clear(); coarseMap_.clear(); locs_.clear(); count_ = 0;
+    cursor_.last = 0; // prochain sync(): insertion complète, pas seulement les Transform modifiés depuis
+}
+
+int32_t SpatialIndex::cellCoord(float v) const {
+    constexpr float kLimit = 1073741824.f; // 2^30 cellules: loin de la clé vide
+    const float c = std::floor(v * invCell_);
+    return (int32_t)std::clamp(c, -kLimit, kLimit);
+}
+
+const SpatialIndex::Loc* SpatialIndex::locate(Entity e) const {
+    if (e.index >= locs_.size()) return nullptr;
+    const Loc& l = locs_[e.index];
+    return (l.cell != kNone && l.version == e.version) ? &l : nullptr;
+}
+
+bool SpatialIndex::position(Entity e, glm::vec2& out) const {
+    const Loc* l = locate(e);
+    if (!l) return false;
+    const Item& it = buckets_[l->bucket].items[l->slot];
+    out = glm::vec2(it.x, it.y);
+    return true;
+}
+
+uint32_t SpatialIndex::allocBucket() {
+    if (!freeBuckets_.empty()) { uint32_t b = freeBuckets_.back(); freeBuckets_.pop_back(); buckets_[b].next = kNone; buckets_[b].count = 0; return b; }
+    buckets_.emplace_back();
+    return (uint32_t)buckets_.size() - 1;
+}
+
+uint32_t SpatialIndex::allocCell(int32_t cx, int32_t cy) {
+    uint32_t ci;
+    if (!freeCells_.empty()) { ci = freeCells_.back(); freeCells_.pop_back(); }
+    else { ci = (uint32_t)cells_.size(); cells_.emplace_back(); }
+    Cell& c = cells_[ci];
+    c.cx = cx; c.cy = cy; c.head = kNone; c.count = 0;
+    fineMap_.insert(Key(cx, cy), ci);
+    const int32_t gx = coarseCoord(cx), gy = coarseCoord(cy);
+    uint32_t gi = coarseMap_.find(Key(gx, gy));
+    if (gi == kNone) {
+        if (!freeCoarse_.empty()) { gi = freeCoarse_.back(); freeCoarse_.pop_back(); }
+        else { gi = (uint32_t)coarse_.size(); coarse_.emplace_back(); }
+        coarse_[gi].gx = gx; coarse_[gi].gy = gy;
+        coarseMap_.insert(Key(gx, gy), gi);
+    }
+    c.coarse = gi; c.coarseSlot = (uint32_t)coarse_[gi].cells.size();
+    coarse_[gi].cells.push_back(ci);
+    return ci;
+}
+
+void SpatialIndex::freeCell(uint32_t ci) {
+    Cell& c = cells_[ci];
+    fineMap_.erase(Key(c.cx, c.cy));
+    Coarse& g = coarse_[c.coarse];
+    const uint32_t moved = g.cells.back();
+    g.cells[c.coarseSlot] = moved; cells_[moved].coarseSlot = c.coarseSlot;
+    g.cells.pop_back();
+    if (g.cells.empty()) { coarseMap_.erase(Key(g.gx, g.gy)); freeCoarse_.push_back(c.coarse); }
+    c.coarse = kNone; c.head = kNone;
+    freeCells_.push_back(ci);
+}
+
+void SpatialIndex::insertItem(Entity e, float x, float y, int32_t cx, int32_t cy) {
+    uint32_t ci = fineMap_.find(Key(cx, cy));
+    if (ci == kNone) ci = allocCell(cx, cy);
+    if (cells_[ci].head == kNone || buckets_[cells_[ci].head].count == kBucketItems) {
+        const uint32_t b = allocBucket(); // avant de prendre une référence: buckets_ peut grandir
+        buckets_[b].next = cells_[ci].head; cells_[ci].head = b;
+    }
+    Cell& c = cells_[ci];
+    Bucket& bk = buckets_[c.head];
+    const uint32_t slot = bk.count++;
+    bk.items[slot] = Item{ x, y, e };
+    ++c.count; ++count_;
+    if (e.index >= locs_.size()) locs_.resize((size_t)e.index + 1);
+    locs_[e.index] = Loc{ e.version, ci, c.head, slot };
+}
+
+void SpatialIndex::removeItem(Entity e) {
+    Loc l = locs_[e.index];
+    Cell& c = cells_[l.cell];
+    Bucket& head = buckets_[c.head];
+    // Le dernier élément du paquet de tête (seul partiel) comble le trou
+    const Item last = head.items[head.count - 1];
+    buckets_[l.bucket].items[l.slot] = last;
+    locs_[last.e.index].bucket = l.bucket; locs_[last.e.index].slot = l.slot;
+    locs_[e.index].cell = kNone;
+    --head.count; --c.count; --count_;
+    if (head.count == 0) { const uint32_t next = head.next; freeBuckets_.push_back(c.head); c.head = next; }
+    if (c.count == 0) freeCell(l.cell);
+}
+
+void SpatialIndex::insert(Entity e, glm::vec2 p) {
+    const int32_t cx = cellCoord(p.x), cy = cellCoord(p.y);
+    if (e.index < locs_.size() && locs_[e.index].cell != kNone) {
+        Loc& l = locs_[e.index];
+        const Cell& c = cells_[l.cell];
+        if (l.version == e.version && c.cx == cx && c.cy == cy) { Item& it = buckets_[l.bucket].items[l.slot]; it.x = p.x; it.y = p.y; return; }
+        removeItem(Entity{ e.index, l.version }); // déplacement, ou ancien occupant du slot d'entité recyclé
+    }
+    insertItem(e, p.x, p.y, cx, cy);
+}
+
+bool SpatialIndex::erase(Entity e) {
+    if (!locate(e)) return false;
+    removeItem(e);
+    return true;
+}
+
+void SpatialIndex::sync(Registry& reg) { collectMoves(reg, nullptr); }
+void SpatialIndex::sync(Registry& reg, ThreadPool& pool) { collectMoves(reg, &pool); }
+
+void SpatialIndex::collectMoves(Registry& reg, ThreadPool* pool) {
+    PROFILE_ZONE("SpatialIndex::sync");
+    if (!tracking_) { reg.trackRemovals<Transform>(); tracking_ = true; }
+    uint32_t since = cursor_.since(reg);
+    // Retraits d'abord (une entité retirée puis rajoutée pendant la période reste indexée via changed).
+    // Journal incomplet (clear, chargement, curseur remplacé): resynchronisation complète
+    if (!reg.eachRemoved<Transform>(since, [&](Entity e) { if (!reg.has<Transform>(e)) erase(e); })) {
+        for (uint32_t i=0; i<(uint32_t)locs_.size(); ++i) {
+            const Loc& l = locs_[i]; const Entity e{ i, l.version };
+            if (l.cell != kNone && !reg.has<Transform>(e)) removeItem(e);
+        }
+        since = 0; // tout Transform vivant est réinséré
+    }
+
+    pending_.clear();
+    reg.view<const Transform>().changed<Transform>(since).eachChunk([&](size_t n, const Entity* es, Transform* t) {
+        for (size_t i=0; i<n; ++i) pending_.push_back(Pending{ es[i], t[i].position.x, t[i].position.y });
+    });
+    if (pending_.empty()) return;
+    uint32_t maxIndex = 0;
+    for (const Pending& p : pending_) maxIndex = std::max(maxIndex, p.e.index);
+    if (maxIndex >= locs_.size()) locs_.resize((size_t)maxIndex + 1);
+
+    // Passe parallèle: déplacement dans la même cellule = mise à jour en place (éléments distincts);
+    // les changements de cellule (structurels) sont rejoués ensuite en série, dans l'ordre de la vue
+    moved_.assign(pending_.size(), 0);
+    auto classify = [&](size_t begin, size_t end) {
+        for (size_t i=begin; i<end; ++i) {
+            const Pending& p = pending_[i];
+            const Loc& l = locs_[p.e.index];
+            if (l.cell != kNone && l.version == p.e.version) {
+                const Cell& c = cells_[l.cell];
+                if (c.cx == cellCoord(p.x) && c.cy == cellCoord(p.y)) { Item& it = buckets_[l.bucket].items[l.slot]; it.x = p.x; it.y = p.y; continue; }
+            }
+            moved_[i] = 1;
+        }
+    };
+    if (pool && pending_.size() > 8192) pool->parallelFor(pending_.size(), 4096, classify);
+    else classify(0, pending_.size());
+    for (size_t i=0; i<pending_.size(); ++i) if (moved_[i]) insert(pending_[i].e, glm::vec2(pending_[i].x, pending_[i].y));
+}
+
+void SpatialIndex::queryAABB(glm::vec2 mn, glm::vec2 mx, std::vector<Entity>& out) const {
+    forEachInAABB(mn, mx, [&](Entity e, glm::vec2) { out.push_back(e); });
+}
+
+void SpatialIndex::queryRadius(glm::vec2 c, float r, std::vector<Entity>& out) const {
+    forEachInRadius(c, r, [&](Entity e, glm::vec2) { out.push_back(e); });
+}
+
+void SpatialIndex::queryKNearest(glm::vec2 c, size_t k, std::vector<Entity>& out, float maxDist) const {
+    out.clear();
+    if (k == 0 || count_ == 0) return;
+    const float maxD2 = maxDist * maxDist;
+    std::vector<std::pair<float, Entity>> heap; heap.reserve(k); // tas max sur la distance²
+    auto byDist = [](const std::pair<float, Entity>& a, const std::pair<float, Entity>& b) { return a.first < b.first; };
+    auto worst = [&] { return heap.size() < k ? maxD2 : heap.front().first; };
+    auto consider = [&](const Cell& cell) {
+        forItems(cell, [&](const Item& it) {
+            const float dx = it.x - c.x, dy = it.y - c.y, d2 = dx*dx + dy*dy;
+            if (d2 > worst() || (heap.size() == k && d2 == worst())) return;
+            if (heap.size() == k) { std::pop_heap(heap.begin(), heap.end(), byDist); heap.pop_back(); }
+            heap.push_back({ d2, it.e }); std::push_heap(heap.begin(), heap.end(), byDist);
+        });
+    };
+    // Distance minimale de c au bord du carré [lo, hi+1) (en cellules de taille size): borne des anneaux suivants
+    auto edge = [&](int32_t lox, int32_t hix, int32_t loy, int32_t hiy, float size) {
+        return std::max(0.f, std::min({ c.x - lox * size, (hix + 1) * size - c.x, c.y - loy * size, (hiy + 1) * size - c.y }));
+    };
+    auto done = [&](float lb) { return lb * lb > worst(); };
+
+    // Anneaux fins autour de la cellule de c
+    const int32_t cx = cellCoord(c.x), cy = cellCoord(c.y);
+    for (int r=0; r<=kFineRings; ++r) {
+        if (r > 0 && done(edge(cx - r + 1, cx + r - 1, cy - r + 1, cy + r - 1, cellSize_))) break;
+        for (int32_t y=cy-r; y<=cy+r; ++y) {
+            const bool rowEdge = (y == cy - r || y == cy + r);
+            for (int32_t x=cx-r; x<=cx+r; x += rowEdge ? 1 : 2 * r) {
+                const uint32_t ci = fineMap_.find(Key(x, y));
+                if (ci != kNone) consider(cells_[ci]);
+                if (r == 0) break;
+            }
+        }
+    }
+    // Au-delà: anneaux grossiers (cellules fines déjà vues exclues)
+    const float coarseSize = cellSize_ * coarseFactor_;
+    const int32_t gx = coarseCoord(cx), gy = coarseCoord(cy);
+    const size_t liveCoarse = coarse_.size() - freeCoarse_.size();
+    auto seen = [&](const Cell& cell) { return std::abs(cell.cx - cx) <= kFineRings && std::abs(cell.cy - cy) <= kFineRings; };
+    auto considerCoarse = [&](const Coarse& g) { for (uint32_t ci : g.cells) if (!seen(cells_[ci])) consider(cells_[ci]); };
+    if (!done(edge(cx - kFineRings, cx + kFineRings, cy - kFineRings, cy + kFineRings, cellSize_))) {
+        for (int32_t r=0; ; ++r) {
+            if (r > 0 && done(edge(gx - r + 1, gx + r - 1, gy - r + 1, gy + r - 1, coarseSize))) break;
+            if ((size_t)r * 8 > liveCoarse) {
+                // Anneau plus grand que le nombre de cellules grossières vivantes: on finit par un balayage de celles-ci
+                for (const Coarse& g : coarse_) if (!g.cells.empty() && std::max(std::abs(g.gx - gx), std::abs(g.gy - gy)) >= r) considerCoarse(g);
+                break;
+            }
+            for (int32_t y=gy-r; y<=gy+r; ++y) {
+                const bool rowEdge = (y == gy - r || y == gy + r);
+                for (int32_t x=gx-r; x<=gx+r; x += rowEdge ? 1 : 2 * r) {
+                    const uint32_t gi = coarseMap_.find(Key(x, y));
+                    if (gi != kNone) considerCoarse(coarse_[gi]);
+                    if (r == 0) break;
+                }
+            }
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), byDist);
+    out.reserve(heap.size());
+    for (const auto& h : heap) out.push_back(h.second);
+}
+
+void SpatialIndex::queryRadiusBatch(const glm::vec2* centers, size_t n, float r, std::vector<uint32_t>& offsets, std::vector<Entity>& out) const {
+    queryRadiusBatch(ThreadPool::Shared(), centers, n, r, offsets, out);
+}
+
+void SpatialIndex::queryRadiusBatch(ThreadPool& pool, const glm::vec2* centers, size_t n, float r, std::vector<uint32_t>& offsets, std::vector<Entity>& out) const {
+    PROFILE_ZONE("SpatialIndex::queryRadiusBatch");
+    constexpr size_t kBlock = 256;
+    const size_t blocks = (n + kBlock - 1) / kBlock;
+    std::vector<std::vector<Entity>> parts(blocks);
+    offsets.assign(n + 1, 0);
+    // Chaque bloc écrit ses résultats à part puis concaténation dans l'ordre des requêtes (déterministe)
+    pool.parallelFor(n, kBlock, [&](size_t begin, size_t end) {
+        std::vector<Entity>& part = parts[begin / kBlock];
+        for (size_t i=begin; i<end; ++i) { const size_t before = part.size(); queryRadius(centers[i], r, part); offsets[i + 1] = (uint32_t)(part.size() - before); }
+    });
+    for (size_t i=0; i<n; ++i) offsets[i + 1] += offsets[i];
+    out.clear(); out.reserve(offsets[n]);
+    for (const auto& part : parts) out.insert(out.end(), part.begin(), part.end());
+}
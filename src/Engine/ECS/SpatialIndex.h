@@ -0,0 +1,155 @@
+#pragma once
+#include "Entity.h"
+#include "Registry.h"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class ThreadPool;
+
+// Index spatial des entités à Transform (plan XY, mètres): grille hachée à deux niveaux.
+// - Niveau fin (cellSize, ~64 m): cellules creuses dans une table ouverte, éléments {x,y,entité} en paquets de 14
+//   (seul le paquet de tête est partiel): requêtes de ville denses = quelques cellules lues d'un bloc.
+// - Niveau grossier (coarseFactor x coarseFactor cellules fines): liste des cellules fines occupées, pour les
+//   grandes zones (niveau monde) sans balayer des millions de cellules vides.
+// Mise à jour incrémentale: sync() applique les Transform modifiés/ajoutés depuis le dernier appel (suivi des
+// changements du Registry) et les retraits; un déplacement dans la même cellule ne touche qu'un élément.
+// Les requêtes sont const et sûres en parallèle entre elles, pas pendant une mise à jour.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(float cellSize = 64.f, uint32_t coarseFactor = 32);
+
+    void clear(); // le sync() suivant réindexe tous les Transform
+    size_t size() const { return count_; }
+    float cellSize() const { return cellSize_; }
+    size_t cellCount() const { return cells_.size() - freeCells_.size(); }
+
+    // Mise à jour directe (hors ECS): insert déplace l'entité si elle est déjà indexée
+    void insert(Entity e, glm::vec2 p);
+    bool erase(Entity e);
+    bool contains(Entity e) const { return locate(e) != nullptr; }
+    bool position(Entity e, glm::vec2& out) const;
+
+    // Applique au plus juste les changements de Transform du Registry (premier appel: indexe tout)
+    void sync(Registry& reg);
+    void sync(Registry& reg, ThreadPool& pool);
+
+    // Requêtes: fn(Entity, glm::vec2 position), ordre non spécifié
+    template<class F> void forEachInAABB(glm::vec2 mn, glm::vec2 mx, F&& fn) const;
+    template<class F> void forEachInRadius(glm::vec2 c, float r, F&& fn) const;
+    // Variantes qui ajoutent à out (non vidé)
+    void queryAABB(glm::vec2 mn, glm::vec2 mx, std::vector<Entity>& out) const;
+    void queryRadius(glm::vec2 c, float r, std::vector<Entity>& out) const;
+    // k plus proches, triés par distance croissante (remplace out); maxDist borne la recherche
+    void queryKNearest(glm::vec2 c, size_t k, std::vector<Entity>& out, float maxDist = std::numeric_limits<float>::infinity()) const;
+    // Lot de requêtes de rayon, parallélisé: résultats de la requête i dans out[offsets[i], offsets[i+1])
+    void queryRadiusBatch(const glm::vec2* centers, size_t n, float r, std::vector<uint32_t>& offsets, std::vector<Entity>& out) const;
+    void queryRadiusBatch(ThreadPool& pool, const glm::vec2* centers, size_t n, float r, std::vector<uint32_t>& offsets, std::vector<Entity>& out) const;
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    static constexpr uint32_t kBucketItems = 14;
+    static constexpr uint64_t kDirectCells = 256; // au-delà, les grandes zones passent par le niveau grossier
+    static constexpr int kFineRings = 4;           // kNN: anneaux fins avant de passer aux anneaux grossiers
+
+    struct Item { float x, y; Entity e; };
+    struct Bucket { uint32_t next = kNone, count = 0; Item items[kBucketItems]; };
+    struct Cell { int32_t cx = 0, cy = 0; uint32_t head = kNone, count = 0; uint32_t coarse = kNone, coarseSlot = 0; };
+    struct Coarse { int32_t gx = 0, gy = 0; std::vector<uint32_t> cells; };
+    struct Loc { uint32_t version = 0, cell = kNone, bucket = 0, slot = 0; };
+
+    // Table ouverte clé de cellule -> index (sondage linéaire, suppression par décalage arrière, sans pierre tombale)
+    struct CellTable {
+        static constexpr uint64_t kEmpty = 0x8000000080000000ull; // (INT32_MIN, INT32_MIN): coordonnée impossible
+        std::vector<uint64_t> keys; std::vector<uint32_t> values; size_t count = 0; unsigned shift = 64;
+        size_t slotOf(uint64_t key) const { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> shift); }
+        uint32_t find(uint64_t key) const;
+        void insert(uint64_t key, uint32_t value);
+        void erase(uint64_t key);
+        void clear() { keys.clear(); values.clear(); count = 0; shift = 64; }
+    };
+
+    static uint64_t Key(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+    int32_t cellCoord(float v) const;
+    int32_t coarseCoord(int32_t c) const { return c >= 0 ? c / (int32_t)coarseFactor_ : -((-c - 1) / (int32_t)coarseFactor_) - 1; }
+
+    const Loc* locate(Entity e) const;
+    void insertItem(Entity e, float x, float y, int32_t cx, int32_t cy);
+    void removeItem(Entity e);
+    uint32_t allocCell(int32_t cx, int32_t cy);
+    void freeCell(uint32_t ci);
+    uint32_t allocBucket();
+    template<class F> void forItems(const Cell& c, F&& fn) const;
+    // fn(const Cell&, bool entièrementDedans) pour chaque cellule occupée intersectant [mn,mx]
+    template<class F> void visitCells(glm::vec2 mn, glm::vec2 mx, F&& fn) const;
+    void collectMoves(Registry& reg, ThreadPool* pool);
+
+    float cellSize_, invCell_;
+    uint32_t coarseFactor_;
+    std::vector<Cell> cells_; std::vector<uint32_t> freeCells_;
+    std::vector<Bucket> buckets_; std::vector<uint32_t> freeBuckets_;
+    std::vector<Coarse> coarse_; std::vector<uint32_t> freeCoarse_;
+    CellTable fineMap_, coarseMap_;
+    std::vector<Loc> locs_; // par index d'entité
+    size_t count_ = 0;
+
+    // Synchronisation ECS
+    ECS::ChangeCursor cursor_;
+    bool tracking_ = false;
+    struct Pending { Entity e; float x, y; };
+    std::vector<Pending> pending_;
+    std::vector<uint8_t> moved_;
+};
+
+template<class F>
+void SpatialIndex::forItems(const Cell& c, F&& fn) const {
+    for (uint32_t b = c.head; b != kNone; b = buckets_[b].next) {
+        const Bucket& bk = buckets_[b];
+        for (uint32_t i=0; i<bk.count; ++i) fn(bk.items[i]);
+    }
+}
+
+template<class F>
+void SpatialIndex::visitCells(glm::vec2 mn, glm::vec2 mx, F&& fn) const {
+    if (count_ == 0 || !(mn.x <= mx.x) || !(mn.y <= mx.y)) return;
+    const int32_t x0 = cellCoord(mn.x), x1 = cellCoord(mx.x), y0 = cellCoord(mn.y), y1 = cellCoord(mx.y);
+    auto visit = [&](uint32_t ci) {
+        const Cell& c = cells_[ci];
+        const float bx = (float)c.cx * cellSize_, by = (float)c.cy * cellSize_;
+        fn(c, bx >= mn.x && bx + cellSize_ <= mx.x && by >= mn.y && by + cellSize_ <= mx.y);
+    };
+    // Étendues en 64 bits: cellCoord borne à ±2^30, une différence peut dépasser int32
+    auto span = [](int32_t a, int32_t b) { return (uint64_t)((int64_t)b - (int64_t)a + 1); };
+    if (span(x0, x1) * span(y0, y1) <= kDirectCells) {
+        for (int32_t y=y0; y<=y1; ++y) for (int32_t x=x0; x<=x1; ++x) { uint32_t ci = fineMap_.find(Key(x, y)); if (ci != kNone) visit(ci); }
+        return;
+    }
+    // Grande zone: cellules fines occupées des cellules grossières qui l'intersectent
+    const int32_t gx0 = coarseCoord(x0), gx1 = coarseCoord(x1), gy0 = coarseCoord(y0), gy1 = coarseCoord(y1);
+    auto visitCoarse = [&](const Coarse& g) {
+        for (uint32_t ci : g.cells) { const Cell& c = cells_[ci]; if (c.cx >= x0 && c.cx <= x1 && c.cy >= y0 && c.cy <= y1) visit(ci); }
+    };
+    const size_t liveCoarse = coarse_.size() - freeCoarse_.size();
+    if (span(gx0, gx1) * span(gy0, gy1) > liveCoarse) {
+        for (const Coarse& g : coarse_) if (!g.cells.empty() && g.gx >= gx0 && g.gx <= gx1 && g.gy >= gy0 && g.gy <= gy1) visitCoarse(g);
+    } else {
+        for (int32_t gy=gy0; gy<=gy1; ++gy) for (int32_t gx=gx0; gx<=gx1; ++gx) { uint32_t gi = coarseMap_.find(Key(gx, gy)); if (gi != kNone) visitCoarse(coarse_[gi]); }
+    }
+}
+
+template<class F>
+void SpatialIndex::forEachInAABB(glm::vec2 mn, glm::vec2 mx, F&& fn) const {
+    visitCells(mn, mx, [&](const Cell& c, bool inside) {
+        forItems(c, [&](const Item& it) { if (inside || (it.x >= mn.x && it.x <= mx.x && it.y >= mn.y && it.y <= mx.y)) fn(it.e, glm::vec2(it.x, it.y)); });
+    });
+}
+
+template<class F>
+void SpatialIndex::forEachInRadius(glm::vec2 c, float r, F&& fn) const {
+    const float r2 = r * r;
+    visitCells(c - glm::vec2(r), c + glm::vec2(r), [&](const Cell& cell, bool) {
+        forItems(cell, [&](const Item& it) { float dx = it.x - c.x, dy = it.y - c.y; if (dx*dx + dy*dy <= r2) fn(it.e, glm::vec2(it.x, it.y)); });
+    });
+}
@@ -0,0 +1,44 @@
+#include "MessagingSystem.h"
+#include "../../../Core/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+MessagingSystem::Tick MessagingSystem::ticksFor(double seconds) const {
+    if (!(seconds > 0.0)) return 1;
+    const double ticks = std::ceil(seconds / step_ - 1e-9);
+    return ticks >= (double)kMaxTravelTicks ? kMaxTravelTicks : (Tick)ticks; // borné avant la conversion (inf, très grand)
+}
+
+MessagingSystem::MessageId MessagingSystem::send(Message m) {
+    const double seconds = travelTime_ ? travelTime_(m.from, m.to) : 0.0;
+    if (seconds < 0.0) return {};
+    return send(m, seconds);
+}
+
+MessagingSystem::MessageId MessagingSystem::send(Message m, double travelSeconds) {
+    if (!std::isfinite(travelSeconds)) return {}; // injoignable (+inf des RoadNetwork, CH, matrices)
+    m.sent = wheel_.now();
+    m.arrival = m.sent + ticksFor(travelSeconds);
+    return wheel_.schedule(m);
+}
+
+bool MessagingSystem::delay(MessageId id, double seconds) {
+    if (!std::isfinite(seconds)) return false;
+    const Message* m = wheel_.find(id);
+    if (!m) return false;
+    const Tick extra = seconds > 0.0 ? ticksFor(seconds) : 0;
+    return wheel_.reschedule(id, m->arrival + std::min(extra, InUniverseMessaging::kNever - 1 - m->arrival)); // saturé
+}
+
+size_t MessagingSystem::advance(Tick ticks) {
+    PROFILE_ZONE("MessagingSystem::advance");
+    return wheel_.advanceTo(wheel_.now() + ticks, [&](Tick t, std::span<const Message> batch) { if (deliver_) deliver_(t, batch); });
+}
+
+SystemDesc MessagingSystem::desc(int order) {
+    SystemDesc d;
+    d.name = "Messaging"; d.order = order; d.writes = { "Messaging" };
+    d.tick = [this](double dt) { tick(dt); };
+    d.tickBatch = [this](double dt, int ticks) { tickBatch(dt, ticks); };
+    return d;
+}
@@ -1,4 +1,48 @@
 #pragma once
-// [8] TODO: Système messagers: création ordres, planification trajets via RoadNetwork, délais réels
+#include "../../Gameplay/Common/Messaging.h"
+#include "../../Simulation/Scheduler.h"
+#include <functional>
+#include <span>
 // [8] TODO: Interaction avec diplomatie/économie (Common)
-struct MessagingSystem { /* ... */ };
+
+// Système messagers: un ordre part avec une heure d'arrivée = maintenant + durée du trajet (RoadNetwork via travelTime),
+// voyage dans la CourierWheel et est livré par lot au tick de son arrivée (deliver, thread simulation).
+// En timewarp (tickBatch), la roue saute les ticks sans arrivée: coût proportionnel aux livraisons, pas aux ticks.
+class MessagingSystem {
+public:
+    using Message = InUniverseMessaging::Message;
+    using MessageId = InUniverseMessaging::MessageId;
+    using Tick = InUniverseMessaging::Tick;
+    using TravelTime = std::function<double(Entity from, Entity to)>;   // secondes de jeu, < 0, inf ou NaN = injoignable
+    using Deliver = std::function<void(Tick, std::span<const Message>)>;
+
+    explicit MessagingSystem(double fixedStep = 1.0 / 60.0) : step_(fixedStep) {}
+
+    void setTravelTime(TravelTime fn) { travelTime_ = std::move(fn); }
+    void setDeliver(Deliver fn) { deliver_ = std::move(fn); }
+
+    // Trajet par travelTime ou durée explicite; id invalide si injoignable (durée non finie, travelTime < 0)
+    MessageId send(Message m);
+    MessageId send(Message m, double travelSeconds);
+    bool cancel(MessageId id, Message* out = nullptr) { return wheel_.cancel(id, out); }
+    bool delay(MessageId id, double seconds); // false si seconds n'est pas fini
+
+    Tick now() const { return wheel_.now(); }
+    static constexpr Tick kMaxTravelTicks = Tick{1} << 62; // trajet borné: now() + trajet ne déborde pas
+    Tick ticksFor(double seconds) const;
+    size_t inFlight() const { return wheel_.inFlight(); }
+    InUniverseMessaging::CourierWheel& wheel() { return wheel_; }
+
+    void tick(double dt) { advance(1); (void)dt; }
+    void tickBatch(double dt, int ticks) { advance(ticks > 0 ? (Tick)ticks : 0); (void)dt; }
+    size_t advance(Tick ticks);
+
+    // Déclaration Scheduler: ressource "Messaging" en écriture, tick + tickBatch
+    SystemDesc desc(int order = 0);
+
+private:
+    double step_;
+    TravelTime travelTime_;
+    Deliver deliver_;
+    InUniverseMessaging::CourierWheel wheel_;
+};
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint>
+
+// Objet (gabarit d'inventaire): poids/volume unitaires, taille de pile, valeur de base
+struct Item {
+    float weightKg = 0.f, volumeL = 0.f;
+    uint16_t maxStack = 1;
+    uint32_t baseValue = 0;
+};
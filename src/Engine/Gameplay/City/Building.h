@@ -1,3 +1,10 @@
 #pragma once
-// [9] TODO: Building: type, fonctions, entrées/sorties, intérieur visitable, navmesh local
-struct Building { /* ... */ };
+#include <cstdint>
+// [9] TODO: Building: fonctions, entrées/sorties, intérieur visitable, navmesh local
+
+// Bâtiment: type (id de chaîne), emprise au sol en mètres, étages
+struct Building {
+    uint32_t typeId = 0;
+    float footprintX = 10.f, footprintY = 10.f;
+    uint16_t floors = 1;
+};
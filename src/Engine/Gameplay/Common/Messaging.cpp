@@ -0,0 +1,128 @@
+#include "Messaging.h"
+#include <algorithm>
+#include <bit>
+
+namespace InUniverseMessaging {
+
+void CourierWheel::clear(Tick now) {
+    nodes_.clear(); free_ = kNil;
+    heads_.fill(kNil); occupied_.fill(0);
+    now_ = now; inFlight_ = 0; seq_ = 0;
+    batch_.clear();
+}
+
+CourierWheel::Node* CourierWheel::node(MessageId id) {
+    if (id.index >= nodes_.size()) return nullptr;
+    Node& n = nodes_[id.index];
+    return n.generation == id.generation && n.slot != kFreeSlot ? &n : nullptr;
+}
+
+const Message* CourierWheel::find(MessageId id) const {
+    const Node* n = const_cast<CourierWheel*>(this)->node(id);
+    return n ? &n->msg : nullptr;
+}
+
+// Niveau = octet de poids fort où l'arrivée diffère de now_: la case ne redevient courante qu'en atteignant cet octet
+void CourierWheel::place(uint32_t i) {
+    Node& n = nodes_[i];
+    const Tick t = n.msg.arrival, diff = t ^ now_;
+    const int level = diff == 0 ? 0 : (63 - std::countl_zero(diff)) / 8;
+    uint16_t slot = kFarSlot;
+    if (level < kLevels) {
+        slot = (uint16_t)(level * kSlots + ((t >> (8 * level)) & (kSlots - 1)));
+        occupied_[slot >> 6] |= 1ull << (slot & 63);
+    }
+    n.slot = slot; n.prev = kNil; n.next = heads_[slot];
+    if (n.next != kNil) nodes_[n.next].prev = i;
+    heads_[slot] = i;
+}
+
+void CourierWheel::unlink(uint32_t i) {
+    Node& n = nodes_[i];
+    if (n.prev != kNil) nodes_[n.prev].next = n.next;
+    else if ((heads_[n.slot] = n.next) == kNil && n.slot < kFarSlot) occupied_[n.slot >> 6] &= ~(1ull << (n.slot & 63));
+    if (n.next != kNil) nodes_[n.next].prev = n.prev;
+}
+
+void CourierWheel::release(uint32_t i) {
+    Node& n = nodes_[i];
+    n.slot = kFreeSlot; ++n.generation;
+    n.next = free_; free_ = i;
+    --inFlight_;
+}
+
+MessageId CourierWheel::schedule(Message m) {
+    uint32_t i = free_;
+    if (i != kNil) free_ = nodes_[i].next;
+    else { i = (uint32_t)nodes_.size(); nodes_.emplace_back(); }
+    Node& n = nodes_[i];
+    m.arrival = std::max(m.arrival, now_ + 1);
+    m.id = { i, n.generation }; m.seq = seq_++;
+    n.msg = m;
+    place(i);
+    ++inFlight_;
+    return m.id;
+}
+
+bool CourierWheel::cancel(MessageId id, Message* out) {
+    Node* n = node(id);
+    if (!n) return false;
+    if (out) *out = n->msg;
+    unlink(id.index); release(id.index);
+    return true;
+}
+
+bool CourierWheel::reschedule(MessageId id, Tick arrival) {
+    Node* n = node(id);
+    if (!n) return false;
+    unlink(id.index);
+    n->msg.arrival = std::max(arrival, now_ + 1);
+    place(id.index);
+    return true;
+}
+
+Tick CourierWheel::nextWake() const {
+    if (inFlight_ == 0) return kNever;
+    // Niveau l: première case occupée après la courante; les niveaux bas passent avant (révolution en cours)
+    for (int l=0; l<kLevels; ++l) {
+        const uint32_t cur = (uint32_t)((now_ >> (8 * l)) & (kSlots - 1));
+        for (uint32_t w=(l * kSlots + cur + 1) >> 6, end=(l + 1) * kSlots >> 6; w<end && cur + 1 < (uint32_t)kSlots; ++w) {
+            uint64_t bits = occupied_[w];
+            if (w == (l * kSlots + cur + 1) >> 6) bits &= ~0ull << ((cur + 1) & 63);
+            if (!bits) continue;
+            const Tick j = (Tick)(w * 64 + std::countr_zero(bits) - l * kSlots);
+            const int shift = 8 * (l + 1);
+            return ((now_ >> shift) << shift) | (j << (8 * l));
+        }
+    }
+    // Seulement des messages lointains: prochaine révolution du dernier niveau
+    const int shift = 8 * kLevels;
+    return ((now_ >> shift) + 1) << shift;
+}
+
+void CourierWheel::step(Tick t) {
+    const Tick diff = now_ ^ t;
+    now_ = t;
+    auto redistribute = [&](uint16_t slot) {
+        uint32_t i = heads_[slot];
+        heads_[slot] = kNil;
+        if (slot < kFarSlot) occupied_[slot >> 6] &= ~(1ull << (slot & 63));
+        while (i != kNil) { const uint32_t next = nodes_[i].next; place(i); i = next; }
+    };
+    if (diff >> (8 * kLevels)) redistribute(kFarSlot);
+    for (int l=kLevels - 1; l>=1; --l)
+        if (diff >> (8 * l)) redistribute((uint16_t)(l * kSlots + ((t >> (8 * l)) & (kSlots - 1))));
+}
+
+void CourierWheel::collect() {
+    batch_.clear();
+    const uint16_t slot = (uint16_t)(now_ & (kSlots - 1));
+    uint32_t i = heads_[slot];
+    if (i == kNil) return;
+    heads_[slot] = kNil;
+    occupied_[slot >> 6] &= ~(1ull << (slot & 63));
+    while (i != kNil) { const uint32_t next = nodes_[i].next; batch_.push_back(nodes_[i].msg); release(i); i = next; }
+    std::sort(batch_.begin(), batch_.end(), [](const Message& a, const Message& b) { return a.seq < b.seq; });
+}
+
+} // namespace InUniverseMessaging
@@ -1,3 +1,98 @@
 #pragma once
-// [8] TODO: Modèle de message (émetteur, destinataire, contenu), temps de trajet, statut
-namespace InUniverseMessaging { /* ... */ }
+#include "../../ECS/Entity.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// Messages in-universe: un ordre voyage physiquement (messager) et n'agit qu'à son arrivée.
+// Temps en ticks de jeu (pas fixe du Scheduler); l'heure d'arrivée vient du trajet routier (MessagingSystem).
+namespace InUniverseMessaging {
+
+using Tick = uint64_t;
+constexpr Tick kNever = std::numeric_limits<Tick>::max();
+
+// Handle générationnel: un message livré ou annulé invalide son id (slot réutilisé avec une autre génération)
+struct MessageId {
+    uint32_t index = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+    constexpr bool valid() const { return index != 0xFFFFFFFFu; }
+    friend constexpr bool operator==(MessageId a, MessageId b) { return a.index == b.index && a.generation == b.generation; }
+};
+
+struct Message {
+    Entity from, to;                     // émetteur / destinataire (pays, bâtiment, armée...)
+    uint32_t kind = 0;                   // type d'ordre (id de chaîne)
+    std::array<uint32_t, 3> args{};      // arguments de l'ordre
+    Tick sent = 0, arrival = 0;
+    MessageId id;                        // rempli par schedule
+    uint64_t seq = 0;                    // ordre d'envoi: départage des arrivées simultanées
+};
+
+// Roue temporelle hiérarchique: kLevels niveaux de 256 cases, niveau l = octet l du tick d'arrivée (au-delà de 2^32
+// ticks: liste lointaine). Planifier, annuler, replanifier: O(1) (listes chaînées intrusives dans un pool de noeuds).
+// Un message redescend d'au plus kLevels niveaux avant livraison (O(1) amorti). Les bitmaps d'occupation donnent le
+// prochain tick utile en O(kLevels): avancer saute directement les cases vides (timewarp), coût par tick constant
+// quel que soit le nombre de messages en vol.
+class CourierWheel {
+public:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlots = 256;
+
+    explicit CourierWheel(Tick now = 0) { clear(now); }
+
+    // m.arrival <= now(): livré au tick suivant
+    MessageId schedule(Message m);
+    bool cancel(MessageId id, Message* out = nullptr);
+    bool reschedule(MessageId id, Tick arrival); // retard, interception
+    const Message* find(MessageId id) const;
+
+    // Avance jusqu'à 'to' inclus: deliver(Tick, std::span<const Message>) une fois par tick ayant des arrivées,
+    // messages dans l'ordre d'envoi. deliver peut planifier (réponses) ou annuler. Renvoie le nombre livré.
+    template<class F> size_t advanceTo(Tick to, F&& deliver);
+
+    void reserve(size_t messages) { nodes_.reserve(messages); }
+    Tick now() const { return now_; }
+    size_t inFlight() const { return inFlight_; }
+    Tick nextWake() const; // prochain tick où la roue a du travail (livraison ou descente de niveau), kNever si vide
+    void clear(Tick now = 0);
+
+private:
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+    static constexpr uint16_t kFarSlot = kLevels * kSlots, kFreeSlot = kFarSlot + 1;
+    struct Node { Message msg; uint32_t prev = kNil, next = kNil; uint32_t generation = 0; uint16_t slot = kFreeSlot; };
+
+    Node* node(MessageId id);
+    void place(uint32_t n);
+    void unlink(uint32_t n);
+    void release(uint32_t n);
+    void step(Tick t);       // now_ = t (aucune case occupée sautée), descentes de niveau
+    void collect();          // case courante du niveau 0 -> batch_
+
+    std::vector<Node> nodes_;
+    uint32_t free_ = kNil;
+    std::array<uint32_t, kFarSlot + 1> heads_;
+    std::array<uint64_t, kLevels * kSlots / 64> occupied_;
+    Tick now_ = 0;
+    size_t inFlight_ = 0;
+    uint64_t seq_ = 0;
+    std::vector<Message> batch_;
+};
+
+template<class F>
+size_t CourierWheel::advanceTo(Tick to, F&& deliver) {
+    size_t delivered = 0;
+    while (now_ < to) {
+        const Tick wake = nextWake();
+        step(wake < to ? wake : to);
+        collect();
+        if (batch_.empty()) continue;
+        delivered += batch_.size();
+        deliver(now_, std::span<const Message>(batch_.data(), batch_.size()));
+    }
+    return delivered;
+}
+
+} // namespace InUniverseMessaging
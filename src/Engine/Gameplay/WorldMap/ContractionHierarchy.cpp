@@ -0,0 +1,314 @@
+#include "ContractionHierarchy.h"
+#include "RoadNetwork.h"
+#include "../../../Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <queue>
+
+namespace {
+constexpr uint32_t kNone = ContractionHierarchy::kNone;
+constexpr float kInf = ContractionHierarchy::kInf;
+std::atomic<uint64_t> gNextBuildId{ 1 };
+double MsSince(std::chrono::steady_clock::time_point t0) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(); }
+
+// Dissection emboîtée géométrique: coupe à la médiane selon 4 directions (axes, diagonales), séparateur = plus petit
+// bord (noeuds d'une moitié ayant un voisin dans l'autre) sur les 4 coupes, numéroté après les deux moitiés
+struct Dissector {
+    const RoadNetwork& net;
+    std::vector<uint32_t> mark, out;
+    uint32_t stamp = 0;
+
+    // Partitionne set autour de la médiane selon dir (moitié basse en tête), renvoie le plus petit des deux bords
+    std::vector<uint32_t> split(std::vector<uint32_t>& set, glm::vec2 dir) {
+        const size_t mid = set.size() / 2;
+        std::nth_element(set.begin(), set.begin() + mid, set.end(), [&](uint32_t a, uint32_t b) {
+            const glm::vec2 pa = net.node(a), pb = net.node(b);
+            const float ca = pa.x * dir.x + pa.y * dir.y, cb = pb.x * dir.x + pb.y * dir.y;
+            return ca != cb ? ca < cb : a < b;
+        });
+        const uint32_t left = stamp += 2, right = left + 1;
+        for (size_t i=0; i<set.size(); ++i) mark[set[i]] = i < mid ? left : right;
+        std::vector<uint32_t> sepL, sepR;
+        for (size_t i=0; i<set.size(); ++i) {
+            const uint32_t n = set[i], other = i < mid ? right : left;
+            for (uint32_t a=net.firstArc(n), e=a+net.degree(n); a<e; ++a)
+                if (mark[net.arcTarget(a)] == other) { (i < mid ? sepL : sepR).push_back(n); break; }
+        }
+        return sepL.size() <= sepR.size() ? std::move(sepL) : std::move(sepR);
+    }
+
+    void run(std::vector<uint32_t>& set) {
+        if (set.size() <= 2) { out.insert(out.end(), set.begin(), set.end()); return; }
+        static const glm::vec2 kDirs[] = { { 1.f, 0.f }, { 0.f, 1.f }, { 1.f, 1.f }, { 1.f, -1.f } };
+        std::vector<uint32_t> sep; int best = -1, last = -1;
+        for (int d=0; d<4 && (best < 0 || !sep.empty()); ++d) {
+            std::vector<uint32_t> s = split(set, kDirs[d]); last = d;
+            if (best < 0 || s.size() < sep.size()) { sep.swap(s); best = d; }
+        }
+        if (best != last) split(set, kDirs[best]); // partition de la meilleure coupe (unique: ordre total)
+        const size_t mid = set.size() / 2;
+        const uint32_t cut = stamp += 2;
+        for (uint32_t n : sep) mark[n] = cut;
+        std::vector<uint32_t> l, r;
+        for (size_t i=0; i<set.size(); ++i) if (mark[set[i]] != cut) (i < mid ? l : r).push_back(set[i]);
+        std::vector<uint32_t>().swap(set);
+        run(l); run(r);
+        out.insert(out.end(), sep.begin(), sep.end());
+    }
+};
+}
+
+void ContractionHierarchy::clear() {
+    rank_.clear(); order_.clear(); parent_.clear();
+    upFirst_.assign(1, 0u); upTail_.clear(); upHead_.clear(); upWeight_.clear(); upMiddle_.clear(); upEdge_.clear();
+    downFirst_.assign(1, 0u); downTail_.clear(); downArc_.clear();
+    inputFirst_.assign(1, 0u); inputEdges_.clear(); edgeArc_.clear(); queued_.clear();
+    previous_.clear(); changedAt_.clear(); buildId_ = 0;
+    weightsVersion_ = 0; edgeCount_ = 0; stats_ = {};
+}
+
+bool ContractionHierarchy::build(const RoadNetwork& net) {
+    PROFILE_ZONE("ContractionHierarchy::build");
+    clear();
+    const auto t0 = std::chrono::steady_clock::now();
+    order(net);
+    contract(net);
+    buildId_ = gNextBuildId.fetch_add(1, std::memory_order_relaxed);
+    changedAt_.assign(rank_.size(), 0u);
+    stats_.orderMs = MsSince(t0);
+    customize(net);
+    return !upHead_.empty();
+}
+
+void ContractionHierarchy::order(const RoadNetwork& net) {
+    const uint32_t n = (uint32_t)net.nodeCount();
+    Dissector d{ net, std::vector<uint32_t>(n, 0u), {} };
+    d.out.reserve(n);
+    std::vector<uint32_t> all(n); std::iota(all.begin(), all.end(), 0u);
+    d.run(all);
+    order_ = std::move(d.out);
+    rank_.assign(n, kNone);
+    for (uint32_t r=0; r<n; ++r) rank_[order_[r]] = r;
+}
+
+// Contraction symbolique dans l'ordre des rangs: les voisins montants d'un sommet forment une clique, portée par son
+// voisin montant le plus bas (parent dans l'arbre d'élimination) -> fusion de listes triées
+void ContractionHierarchy::contract(const RoadNetwork& net) {
+    const uint32_t n = (uint32_t)rank_.size();
+    edgeCount_ = net.edgeCount();
+    std::vector<std::vector<uint32_t>> up(n);
+    for (uint32_t e=0; e<edgeCount_; ++e) {
+        const uint32_t a = rank_[net.edge(e).a], b = rank_[net.edge(e).b];
+        if (a != b) up[std::min(a, b)].push_back(std::max(a, b));
+    }
+    for (std::vector<uint32_t>& u : up) { std::sort(u.begin(), u.end()); u.erase(std::unique(u.begin(), u.end()), u.end()); }
+    parent_.assign(n, kNone);
+    std::vector<uint32_t> merged;
+    for (uint32_t r=0; r<n; ++r) {
+        const std::vector<uint32_t>& u = up[r];
+        if (u.empty()) continue;
+        const uint32_t p = parent_[r] = u[0];
+        merged.clear();
+        std::set_union(up[p].begin(), up[p].end(), u.begin() + 1, u.end(), std::back_inserter(merged));
+        up[p].swap(merged);
+    }
+    upFirst_.assign(n + 1, 0u);
+    for (uint32_t r=0; r<n; ++r) upFirst_[r + 1] = upFirst_[r] + (uint32_t)up[r].size();
+    upTail_.resize(upFirst_[n]); upHead_.resize(upFirst_[n]);
+    for (uint32_t r=0; r<n; ++r) {
+        std::copy(up[r].begin(), up[r].end(), upHead_.begin() + upFirst_[r]);
+        std::fill(upTail_.begin() + upFirst_[r], upTail_.begin() + upFirst_[r + 1], r);
+        std::vector<uint32_t>().swap(up[r]);
+    }
+    const size_t arcs = upHead_.size();
+    upWeight_.assign(arcs, kInf); upMiddle_.assign(arcs, kNone); upEdge_.assign(arcs, kNone); queued_.assign(arcs, 0);
+    // Arcs descendants, triés par queue (parcours des queues par rang croissant)
+    downFirst_.assign(n + 1, 0u);
+    for (uint32_t h : upHead_) ++downFirst_[h + 1];
+    for (uint32_t r=0; r<n; ++r) downFirst_[r + 1] += downFirst_[r];
+    downTail_.resize(arcs); downArc_.resize(arcs);
+    {
+        std::vector<uint32_t> fill(downFirst_.begin(), downFirst_.end() - 1);
+        for (uint32_t a=0; a<arcs; ++a) { const uint32_t i = fill[upHead_[a]]++; downTail_[i] = upTail_[a]; downArc_[i] = a; }
+    }
+    // Arêtes d'origine par arc
+    edgeArc_.assign(edgeCount_, kNone);
+    inputFirst_.assign(arcs + 1, 0u);
+    for (uint32_t e=0; e<edgeCount_; ++e) {
+        const uint32_t a = rank_[net.edge(e).a], b = rank_[net.edge(e).b];
+        if (a != b) { edgeArc_[e] = findArc(std::min(a, b), std::max(a, b)); ++inputFirst_[edgeArc_[e] + 1]; }
+    }
+    for (size_t a=0; a<arcs; ++a) inputFirst_[a + 1] += inputFirst_[a];
+    inputEdges_.resize(inputFirst_[arcs]);
+    {
+        std::vector<uint32_t> fill(inputFirst_.begin(), inputFirst_.end() - 1);
+        for (uint32_t e=0; e<edgeCount_; ++e) if (edgeArc_[e] != kNone) inputEdges_[fill[edgeArc_[e]]++] = e;
+    }
+    std::vector<uint32_t> depth(n, 0u);
+    for (uint32_t r=n; r-->0; ) { depth[r] = parent_[r] == kNone ? 1 : depth[parent_[r]] + 1; stats_.treeHeight = std::max<size_t>(stats_.treeHeight, depth[r]); }
+    stats_.nodes = n; stats_.edges = edgeCount_; stats_.arcs = arcs;
+}
+
+uint32_t ContractionHierarchy::findArc(uint32_t low, uint32_t high) const {
+    const auto b = upHead_.begin() + upFirst_[low], e = upHead_.begin() + upFirst_[low + 1];
+    const auto it = std::lower_bound(b, e, high);
+    return it != e && *it == high ? (uint32_t)(it - upHead_.begin()) : kNone;
+}
+
+float ContractionHierarchy::inputWeight(const RoadNetwork& net, uint32_t arc, uint32_t* edge) const {
+    float w = kInf; *edge = kNone;
+    for (uint32_t i=inputFirst_[arc]; i<inputFirst_[arc + 1]; ++i) {
+        const float t = net.travelSeconds(inputEdges_[i]);
+        if (t < w || *edge == kNone) { w = t; *edge = inputEdges_[i]; }
+    }
+    return w;
+}
+
+// Triangles inférieurs en ordre de rang croissant: w(u,v) = min(w(u,v), w(r,u) + w(r,v)) pour r < u < v voisins.
+// Les têtes montantes de r (après u) sont toutes voisines montantes de u (graphe cordal): fusion de listes triées.
+void ContractionHierarchy::customize(const RoadNetwork& net) {
+    PROFILE_ZONE("ContractionHierarchy::customize");
+    const auto t0 = std::chrono::steady_clock::now();
+    const uint32_t n = (uint32_t)rank_.size();
+    ++customization_;
+    previous_ = upWeight_;
+    for (uint32_t a=0; a<upHead_.size(); ++a) { upWeight_[a] = inputWeight(net, a, &upEdge_[a]); upMiddle_[a] = kNone; }
+    size_t triangles = 0;
+    for (uint32_t r=0; r<n; ++r) {
+        const uint32_t end = upFirst_[r + 1];
+        for (uint32_t i=upFirst_[r]; i<end; ++i) {
+            const float wi = upWeight_[i];
+            triangles += end - i - 1;
+            if (wi == kInf) continue;
+            const uint32_t u = upHead_[i];
+            uint32_t k = upFirst_[u];
+            for (uint32_t j=i+1; j<end; ++j) {
+                const uint32_t v = upHead_[j];
+                while (upHead_[k] < v) ++k;
+                const float c = wi + upWeight_[j];
+                if (c < upWeight_[k]) { upWeight_[k] = c; upMiddle_[k] = r; upEdge_[k] = kNone; }
+            }
+        }
+    }
+    for (uint32_t a=0; a<upHead_.size(); ++a) if (upWeight_[a] != previous_[a]) changedAt_[upTail_[a]] = customization_;
+    stats_.triangles = triangles;
+    stats_.customizeMs = MsSince(t0);
+    weightsVersion_ = net.weightsVersion();
+}
+
+// Personnalisation partielle: arcs recalculés entièrement (entrée + triangles inférieurs) par queue croissante; un
+// arc (x,y) modifié ne peut changer que les arcs (y,z) des triangles dont x est le sommet bas. Au-delà d'1/16
+// des arcs revus (coupures hautes dans la hiérarchie, nombreuses arêtes), la personnalisation complète est moins chère.
+size_t ContractionHierarchy::update(const RoadNetwork& net, std::span<const uint32_t> changedEdges) {
+    PROFILE_ZONE("ContractionHierarchy::update");
+    if (net.nodeCount() != rank_.size() || net.edgeCount() != edgeCount_) { build(net); return upHead_.size(); } // topologie changée
+    using Item = std::pair<uint32_t, uint32_t>; // (queue, arc)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+    auto push = [&](uint32_t a) { if (a != kNone && !queued_[a]) { queued_[a] = 1; heap.push({ upTail_[a], a }); } };
+    for (uint32_t e : changedEdges) if (e < edgeArc_.size()) push(edgeArc_[e]);
+    ++customization_;
+    size_t changed = 0, visited = 0;
+    while (!heap.empty()) {
+        const uint32_t a = heap.top().second; heap.pop();
+        queued_[a] = 0;
+        if (++visited > upHead_.size() / 16) {
+            for (; !heap.empty(); heap.pop()) queued_[heap.top().second] = 0;
+            customize(net);
+            return upHead_.size();
+        }
+        const uint32_t x = upTail_[a], y = upHead_[a];
+        uint32_t edge, middle = kNone;
+        float w = inputWeight(net, a, &edge);
+        for (uint32_t i=downFirst_[x], j=downFirst_[y], ie=downFirst_[x + 1], je=downFirst_[y + 1]; i<ie && j<je; ) {
+            if (downTail_[i] < downTail_[j]) { ++i; continue; }
+            if (downTail_[j] < downTail_[i]) { ++j; continue; }
+            const float c = upWeight_[downArc_[i]] + upWeight_[downArc_[j]];
+            if (c < w) { w = c; middle = downTail_[i]; edge = kNone; }
+            ++i; ++j;
+        }
+        upMiddle_[a] = middle; upEdge_[a] = edge;
+        if (w == upWeight_[a]) continue;
+        upWeight_[a] = w; ++changed;
+        changedAt_[x] = customization_;
+        for (uint32_t k=upFirst_[x]; k<upFirst_[x + 1]; ++k) {
+            const uint32_t z = upHead_[k];
+            if (z != y) push(findArc(std::min(y, z), std::max(y, z)));
+        }
+    }
+    weightsVersion_ = net.weightsVersion();
+    return changed;
+}
+
+bool ContractionHierarchy::stale(const RoadNetwork& net) const {
+    return net.weightsVersion() != weightsVersion_ || net.nodeCount() != rank_.size() || net.edgeCount() != edgeCount_;
+}
+
+void ContractionHierarchy::unpack(uint32_t arc, bool towardHead, std::vector<uint32_t>& out) const {
+    if (upEdge_[arc] != kNone) { out.push_back(upEdge_[arc]); return; }
+    const uint32_t m = upMiddle_[arc];
+    const uint32_t toTail = findArc(m, upTail_[arc]), toHead = findArc(m, upHead_[arc]);
+    if (towardHead) { unpack(toTail, false, out); unpack(toHead, true, out); }
+    else { unpack(toHead, false, out); unpack(toTail, true, out); }
+}
+
+void ContractionHierarchy::Query::fit() {
+    const size_t n = ch_->rank_.size();
+    if (up_.size() == n) return;
+    up_.assign(n, kInf); down_.assign(n, kInf); upArc_.assign(n, kNone); downArc_.assign(n, kNone);
+}
+
+// Ancêtres de s puis de t dans l'arbre d'élimination, par rang croissant: chaque distance est définitive quand son
+// sommet est atteint. Rencontre = ancêtre commun minimisant up + down.
+float ContractionHierarchy::Query::run(uint32_t s, uint32_t t, uint32_t* meet) {
+    const ContractionHierarchy& ch = *ch_;
+    fit();
+    up_[s] = 0.f;
+    for (uint32_t v=s; v!=kNone; v=ch.parent_[v]) {
+        const float dv = up_[v];
+        if (dv == kInf) continue;
+        for (uint32_t a=ch.upFirst_[v]; a<ch.upFirst_[v + 1]; ++a) {
+            const float d = dv + ch.upWeight_[a]; const uint32_t h = ch.upHead_[a];
+            if (d < up_[h]) { up_[h] = d; upArc_[h] = a; }
+        }
+    }
+    float best = kInf; *meet = kNone;
+    down_[t] = 0.f;
+    for (uint32_t v=t; v!=kNone; v=ch.parent_[v]) {
+        const float dv = down_[v];
+        if (dv == kInf) continue;
+        if (up_[v] + dv < best) { best = up_[v] + dv; *meet = v; }
+        if (dv >= best) continue; // élagage: rien de mieux au-dessus par ce sommet
+        for (uint32_t a=ch.upFirst_[v]; a<ch.upFirst_[v + 1]; ++a) {
+            const float d = dv + ch.upWeight_[a]; const uint32_t h = ch.upHead_[a];
+            if (d < down_[h]) { down_[h] = d; downArc_[h] = a; }
+        }
+    }
+    for (uint32_t v=s; v!=kNone; v=ch.parent_[v]) up_[v] = kInf;
+    for (uint32_t v=t; v!=kNone; v=ch.parent_[v]) down_[v] = kInf;
+    return best;
+}
+
+float ContractionHierarchy::Query::travelSeconds(uint32_t from, uint32_t to) {
+    if (from >= ch_->rank_.size() || to >= ch_->rank_.size()) return kInf;
+    uint32_t meet;
+    return run(ch_->rank_[from], ch_->rank_[to], &meet);
+}
+
+bool ContractionHierarchy::Query::route(uint32_t from, uint32_t to, std::vector<uint32_t>& edges, float* seconds) {
+    edges.clear();
+    if (seconds) *seconds = kInf;
+    if (from >= ch_->rank_.size() || to >= ch_->rank_.size()) return false;
+    const uint32_t s = ch_->rank_[from], t = ch_->rank_[to];
+    uint32_t meet;
+    const float d = run(s, t, &meet);
+    if (meet == kNone) return false;
+    // upArc_/downArc_ ne sont pas remis à zéro: valides sur les chemins de cette requête
+    arcs_.clear();
+    for (uint32_t v=meet; v!=s; v=ch_->upTail_[upArc_[v]]) arcs_.push_back(upArc_[v]);
+    for (size_t i=arcs_.size(); i-->0; ) ch_->unpack(arcs_[i], true, edges);
+    for (uint32_t v=meet; v!=t; v=ch_->upTail_[downArc_[v]]) ch_->unpack(downArc_[v], false, edges);
+    if (seconds) *seconds = d;
+    return true;
+}
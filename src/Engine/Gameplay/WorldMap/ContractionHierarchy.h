@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+class RoadNetwork;
+
+// Hiérarchie de contraction personnalisable (CCH) du graphe routier, pour les itinéraires monde (messagers, armées,
+// caravanes). Trois étages:
+//  - ordre: dissection emboîtée géométrique (coupe à la médiane de l'axe le plus long, séparateur contracté en
+//    dernier), indépendante des poids; contraction sans recherche de témoins -> graphe cordal (arcs montants en CSR);
+//  - personnalisation: poids = temps de parcours (RoadNetwork::travelSeconds) propagés par triangles inférieurs, en
+//    ordre de rang croissant. update() ne repropage que les arcs touchés par des arêtes modifiées (route coupée par la
+//    guerre, crue): pas de reconstruction de l'ordre ni de la topologie;
+//  - requête: parcours des ancêtres de s et t dans l'arbre d'élimination (aucune file de priorité), rencontre au
+//    meilleur ancêtre commun, puis dépliage des raccourcis en arêtes du RoadNetwork.
+// Rangs: 0 = contracté en premier. Toutes les données internes sont indexées par rang (localité des parcours).
+class ContractionHierarchy {
+public:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    static constexpr float kInf = std::numeric_limits<float>::infinity();
+    struct Stats { size_t nodes = 0, edges = 0, arcs = 0, triangles = 0, treeHeight = 0; double orderMs = 0.0, customizeMs = 0.0; };
+
+    // Espace de travail d'une requête: un par thread (les requêtes ne modifient pas la hiérarchie)
+    class Query {
+    public:
+        explicit Query(const ContractionHierarchy& ch) : ch_(&ch) {}
+        // Temps en secondes de jeu entre deux noeuds du RoadNetwork (kInf si injoignable)
+        float travelSeconds(uint32_t from, uint32_t to);
+        // Arêtes du RoadNetwork de from à to, dans l'ordre du trajet; false si injoignable
+        bool route(uint32_t from, uint32_t to, std::vector<uint32_t>& edges, float* seconds = nullptr);
+    private:
+        float run(uint32_t s, uint32_t t, uint32_t* meet);
+        void fit();
+        const ContractionHierarchy* ch_;
+        std::vector<float> up_, down_;          // distances depuis s / t, par rang (kInf hors requête)
+        std::vector<uint32_t> upArc_, downArc_; // arc montant de la meilleure distance
+        std::vector<uint32_t> arcs_;
+    };
+
+    ContractionHierarchy() = default;
+    ContractionHierarchy(const ContractionHierarchy&) = delete;
+    ContractionHierarchy& operator=(const ContractionHierarchy&) = delete;
+
+    // Ordre + topologie + personnalisation complète. À refaire si la topologie du RoadNetwork change.
+    bool build(const RoadNetwork& net);
+    // Personnalisation complète avec les poids courants
+    void customize(const RoadNetwork& net);
+    // Personnalisation partielle après modification des arêtes listées; renvoie le nombre d'arcs dont le poids a changé
+    size_t update(const RoadNetwork& net, std::span<const uint32_t> changedEdges);
+    // Version des poids du RoadNetwork à la dernière personnalisation (RoadNetwork::weightsVersion)
+    uint64_t weightsVersion() const { return weightsVersion_; }
+    bool stale(const RoadNetwork& net) const;
+    void clear();
+
+    // Suivi des changements pour les tables en cache: identifiant de construction (unique, toutes instances), compteur
+    // de personnalisations, et dernière personnalisation ayant modifié un arc montant du rang r. Une distance s-t ne
+    // lit que les arcs des ancêtres de s et t: elle est inchangée si aucun n'a été modifié depuis.
+    uint64_t buildId() const { return buildId_; }
+    uint64_t customization() const { return customization_; }
+    uint64_t changedAt(uint32_t r) const { return changedAt_[r]; }
+
+    size_t nodeCount() const { return rank_.size(); }
+    uint32_t rank(uint32_t node) const { return rank_[node]; }
+    uint32_t nodeAt(uint32_t rank) const { return order_[rank]; }
+    const Stats& stats() const { return stats_; }
+
+    // Raccourci (Query interne, non réentrant): même thread que les mises à jour
+    float travelSeconds(uint32_t from, uint32_t to) const { return query_.travelSeconds(from, to); }
+    bool route(uint32_t from, uint32_t to, std::vector<uint32_t>& edges, float* seconds = nullptr) const { return query_.route(from, to, edges, seconds); }
+
+    // Accès bas niveau (tables plusieurs-à-plusieurs): arcs montants du rang r = [upFirst(r), upFirst(r+1))
+    uint32_t upFirst(uint32_t r) const { return upFirst_[r]; }
+    uint32_t upHead(uint32_t arc) const { return upHead_[arc]; }
+    float upWeight(uint32_t arc) const { return upWeight_[arc]; }
+    uint32_t parent(uint32_t r) const { return parent_[r]; } // arbre d'élimination (kNone: racine)
+
+private:
+    void order(const RoadNetwork& net);
+    void contract(const RoadNetwork& net);
+    uint32_t findArc(uint32_t low, uint32_t high) const; // arc montant low -> high, kNone si absent
+    float inputWeight(const RoadNetwork& net, uint32_t arc, uint32_t* edge) const;
+    void unpack(uint32_t arc, bool towardHead, std::vector<uint32_t>& out) const;
+
+    std::vector<uint32_t> rank_, order_, parent_;
+    // Arcs montants (tail < head en rang) en CSR, triés par tête
+    std::vector<uint32_t> upFirst_{0u}, upTail_, upHead_;
+    std::vector<float> upWeight_;
+    std::vector<uint32_t> upMiddle_, upEdge_;    // dépliage: rang du sommet milieu, ou arête d'origine
+    // Arcs descendants (pour les triangles inférieurs de update): par rang, (queue, arc) triés par queue
+    std::vector<uint32_t> downFirst_{0u}, downTail_, downArc_;
+    // Arêtes d'origine de chaque arc (parallèles possibles) et arc de chaque arête
+    std::vector<uint32_t> inputFirst_{0u}, inputEdges_, edgeArc_;
+    std::vector<uint8_t> queued_;              // file de update
+    std::vector<float> previous_;              // poids avant personnalisation complète
+    std::vector<uint64_t> changedAt_;
+    uint64_t buildId_ = 0, customization_ = 0;
+    uint64_t weightsVersion_ = 0;
+    size_t edgeCount_ = 0;
+    Stats stats_;
+    mutable Query query_{ *this };
+};
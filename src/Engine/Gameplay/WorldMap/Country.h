@@ -1,3 +1,9 @@
 #pragma once
-// [8] TODO: Country: couleur, doctrines, diplomatie, économie macro
-struct Country { /* ... */ };
+#include <cstdint>
+// [8] TODO: Country: doctrines, diplomatie, économie macro
+
+// Pays: id de TileMap::countryInfos et couleur politique (0xRRGGBB)
+struct Country {
+    uint16_t mapId = 0;
+    uint32_t color = 0x808080;
+};
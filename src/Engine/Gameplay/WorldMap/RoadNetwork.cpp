@@ -0,0 +1,362 @@
+#include "RoadNetwork.h"
+#include "../../Rendering/GL/TileMap.h"
+#include "../../Simulation/SaveGame.h"
+#include "../../../Core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+constexpr uint32_t kNone = RoadNetwork::kNone;
+constexpr uint32_t kCacheVersion = 1;
+constexpr float kSegmentCell = 8.f;   // grille des segments (croisements)
+constexpr float kParamEps = 1e-4f;    // croisement strictement intérieur aux deux segments
+
+uint64_t Fnv(uint64_t h, const void* data, size_t n) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    for (size_t i=0; i<n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+template<class T> uint64_t FnvArray(uint64_t h, const std::vector<T>& v) { const uint64_t n = v.size(); h = Fnv(h, &n, sizeof(n)); return Fnv(h, v.data(), v.size() * sizeof(T)); }
+
+uint64_t CellKey(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+float Dist2(glm::vec2 a, glm::vec2 b) { const glm::vec2 d = a - b; return d.x * d.x + d.y * d.y; }
+
+// Noeuds de points: positions + grille de hachage (têtes par cellule, chaînage par noeud)
+struct PointNodes {
+    float cell = 1.f;
+    std::vector<glm::vec2> pos;
+    std::vector<uint32_t> lastRoad, next;
+    std::unordered_map<uint64_t, uint32_t> heads;
+
+    int cellOf(float v) const { return (int)std::floor(v / cell); }
+    // Noeud le plus proche à distance² <= r2; accept(n, d2) filtre les candidats
+    template<class F> uint32_t find(glm::vec2 p, float r2, F&& accept) const {
+        const int cx = cellOf(p.x), cy = cellOf(p.y);
+        uint32_t best = kNone; float bestD = r2;
+        for (int dy=-1; dy<=1; ++dy) for (int dx=-1; dx<=1; ++dx) {
+            auto it = heads.find(CellKey(cx + dx, cy + dy));
+            if (it == heads.end()) continue;
+            for (uint32_t n=it->second; n!=kNone; n=next[n]) {
+                const float d2 = Dist2(pos[n], p);
+                if (d2 <= bestD && accept(n, d2) && (best == kNone || d2 < bestD || n < best)) { best = n; bestD = d2; }
+            }
+        }
+        return best;
+    }
+    uint32_t add(glm::vec2 p, uint32_t road) {
+        const uint32_t n = (uint32_t)pos.size();
+        pos.push_back(p); lastRoad.push_back(road);
+        uint32_t& head = heads.try_emplace(CellKey(cellOf(p.x), cellOf(p.y)), kNone).first->second;
+        next.push_back(head); head = n;
+        return n;
+    }
+};
+
+struct Segment { uint32_t a, b; };
+struct Insert { uint32_t segment; float t; uint32_t node; };
+
+// Projection de p sur [a,b]: paramètre t et distance²
+float Project(glm::vec2 p, glm::vec2 a, glm::vec2 b, float& d2) {
+    const glm::vec2 d = b - a; const float len2 = d.x * d.x + d.y * d.y;
+    const float t = len2 > 0.f ? ((p.x - a.x) * d.x + (p.y - a.y) * d.y) / len2 : 0.f;
+    d2 = Dist2(p, a + d * t);
+    return t;
+}
+
+struct ByteWriter {
+    SaveGame::Bytes& b;
+    void raw(const void* p, size_t n) { const size_t at = b.size(); b.resize(at + n); if (n) std::memcpy(b.data() + at, p, n); }
+    template<class T> void pod(const T& v) { raw(&v, sizeof(T)); }
+    template<class T> void array(const std::vector<T>& v) { pod<uint64_t>(v.size()); raw(v.data(), v.size() * sizeof(T)); }
+};
+struct ByteReader {
+    const std::byte* p; const std::byte* end; bool ok = true;
+    void raw(void* dst, size_t n) { if ((size_t)(end - p) < n) { ok = false; return; } if (n) std::memcpy(dst, p, n); p += n; }
+    template<class T> T pod() { T v{}; raw(&v, sizeof(T)); return v; }
+    template<class T> void array(std::vector<T>& v) {
+        const uint64_t n = pod<uint64_t>();
+        if (!ok || n > (uint64_t)(end - p) / sizeof(T)) { ok = false; return; }
+        v.resize((size_t)n); raw(v.data(), v.size() * sizeof(T));
+    }
+};
+}
+
+void RoadNetwork::clear() {
+    nodes_.clear(); edges_.clear(); shapePoints_.clear();
+    arcOffsets_.assign(1, 0u); arcTargets_.clear(); arcEdges_.clear();
+    locOffsets_.clear(); locNodes_.clear(); locW_ = locH_ = 0;
+    sourceHash_ = 0; ++weightsVersion_;
+    stats_ = {};
+}
+
+uint64_t RoadNetwork::SourceHash(const TileMap& map, const RoadBuildOptions& opt) {
+    uint64_t h = 1469598103934665603ull;
+    h = FnvArray(h, map.roads.points); h = FnvArray(h, map.roads.offsets);
+    const float f[] = { map.worldMaxX, map.worldMaxY, map.kmPerUnit, opt.snapRadius, opt.speedKmh, opt.capacity };
+    const int32_t dims[] = { map.width, map.height };
+    h = Fnv(h, f, sizeof(f)); h = Fnv(h, dims, sizeof(dims)); h = FnvArray(h, opt.roadSpeedKmh);
+    return Fnv(h, &kCacheVersion, sizeof(kCacheVersion));
+}
+
+bool RoadNetwork::build(const TileMap& map, const RoadBuildOptions& opt) {
+    PROFILE_ZONE("RoadNetwork::build");
+    const auto t0 = std::chrono::steady_clock::now();
+    clear();
+    const RoadTable& roads = map.roads;
+    const size_t roadCount = roads.size();
+    stats_.points = roads.points.size();
+    const float snap = std::max(opt.snapRadius, 0.f), snap2 = std::max(snap * snap, 1e-6f);
+
+    // 1. Fusion: un point rejoint le noeud le plus proche d'une autre route (ou identique d'un passage antérieur)
+    PointNodes pn; pn.cell = std::max(snap, 1.f);
+    pn.pos.reserve(roads.points.size()); pn.heads.reserve(roads.points.size());
+    std::vector<uint32_t> seq; seq.reserve(roads.points.size());
+    std::vector<uint32_t> seqOffsets(1, 0u);
+    for (uint32_t r=0; r<roadCount; ++r) {
+        for (const RoadSegment& rp : roads.road(r)) {
+            const glm::vec2 p((float)rp.x, (float)rp.y);
+            uint32_t n = pn.find(p, snap2, [&](uint32_t c, float d2) { return d2 == 0.f || pn.lastRoad[c] != r; });
+            if (n == kNone) n = pn.add(p, r);
+            else { pn.lastRoad[n] = r; ++stats_.snapped; }
+            if (seq.size() == seqOffsets.back() || seq.back() != n) seq.push_back(n);
+        }
+        seqOffsets.push_back((uint32_t)seq.size());
+    }
+
+    // 2. Croisements et raccords en T: segments en grille, paires d'une même cellule testées une fois
+    std::vector<Segment> segs; std::vector<uint32_t> segRoadFirst(roadCount + 1, 0u);
+    segs.reserve(seq.size());
+    for (uint32_t r=0; r<roadCount; ++r) {
+        segRoadFirst[r] = (uint32_t)segs.size();
+        for (uint32_t i=seqOffsets[r]; i + 1 < seqOffsets[r + 1]; ++i) segs.push_back({ seq[i], seq[i + 1] });
+    }
+    segRoadFirst[roadCount] = (uint32_t)segs.size();
+    std::vector<std::pair<uint64_t, uint32_t>> cells;
+    cells.reserve(segs.size() * 2);
+    auto segCell = [](float v) { return (int)std::floor(v / kSegmentCell); };
+    for (uint32_t s=0; s<segs.size(); ++s) {
+        const glm::vec2 a = pn.pos[segs[s].a], b = pn.pos[segs[s].b];
+        const int x0 = segCell(std::min(a.x, b.x) - snap), x1 = segCell(std::max(a.x, b.x) + snap);
+        const int y0 = segCell(std::min(a.y, b.y) - snap), y1 = segCell(std::max(a.y, b.y) + snap);
+        for (int cy=y0; cy<=y1; ++cy) for (int cx=x0; cx<=x1; ++cx) cells.push_back({ CellKey(cx, cy), s });
+    }
+    std::sort(cells.begin(), cells.end());
+    std::vector<Insert> inserts;
+    for (size_t g=0; g<cells.size(); ) {
+        size_t e = g; while (e < cells.size() && cells[e].first == cells[g].first) ++e;
+        const uint64_t key = cells[g].first;
+        auto inCell = [&](glm::vec2 p) { return CellKey(segCell(p.x), segCell(p.y)) == key; };
+        for (size_t i=g; i<e; ++i) for (size_t j=i+1; j<e; ++j) {
+            const uint32_t sa = cells[i].second, sb = cells[j].second;
+            const Segment A = segs[sa], B = segs[sb];
+            if (A.a == B.a || A.a == B.b || A.b == B.a || A.b == B.b) continue;
+            // Extrémité posée sur l'autre segment: insérée dans ce segment (traitée dans la cellule de l'extrémité)
+            bool touch = false;
+            auto endpoint = [&](uint32_t node, uint32_t seg) {
+                const Segment S = segs[seg]; float d2;
+                const float t = Project(pn.pos[node], pn.pos[S.a], pn.pos[S.b], d2);
+                if (t <= kParamEps || t >= 1.f - kParamEps || d2 > snap2) return;
+                touch = true;
+                if (inCell(pn.pos[node])) inserts.push_back({ seg, t, node });
+            };
+            endpoint(A.a, sb); endpoint(A.b, sb); endpoint(B.a, sa); endpoint(B.b, sa);
+            if (touch) continue;
+            const glm::vec2 p = pn.pos[A.a], r = pn.pos[A.b] - p, q = pn.pos[B.a], s = pn.pos[B.b] - q;
+            const float den = r.x * s.y - r.y * s.x;
+            if (std::fabs(den) < 1e-12f) continue; // parallèles
+            const glm::vec2 qp = q - p;
+            const float t = (qp.x * s.y - qp.y * s.x) / den, u = (qp.x * r.y - qp.y * r.x) / den;
+            if (t <= kParamEps || t >= 1.f - kParamEps || u <= kParamEps || u >= 1.f - kParamEps) continue;
+            const glm::vec2 x = p + r * t;
+            if (!inCell(x)) continue;
+            uint32_t n = pn.find(x, snap2, [](uint32_t, float) { return true; });
+            if (n == kNone) n = pn.add(x, kNone);
+            if (n != A.a && n != A.b) inserts.push_back({ sa, t, n });
+            if (n != B.a && n != B.b) inserts.push_back({ sb, u, n });
+            ++stats_.crossings;
+        }
+        g = e;
+    }
+    std::sort(inserts.begin(), inserts.end(), [](const Insert& a, const Insert& b) { return a.segment != b.segment ? a.segment < b.segment : a.t != b.t ? a.t < b.t : a.node < b.node; });
+
+    // 3. Paires de points adjacentes dédoublonnées (tronçons communs à plusieurs routes = une seule chaîne)
+    std::vector<std::pair<uint64_t, uint32_t>> pairs; // (min << 32 | max, route)
+    pairs.reserve(segs.size() + inserts.size());
+    {
+        size_t ins = 0; uint32_t prev = kNone;
+        auto emit = [&](uint32_t n, uint32_t r) {
+            if (prev != kNone && prev != n) pairs.push_back({ ((uint64_t)std::min(prev, n) << 32) | std::max(prev, n), r });
+            prev = n;
+        };
+        for (uint32_t r=0; r<roadCount; ++r) {
+            prev = kNone;
+            for (uint32_t s=segRoadFirst[r]; s<segRoadFirst[r + 1]; ++s) {
+                emit(segs[s].a, r);
+                for (; ins < inserts.size() && inserts[ins].segment == s; ++ins) emit(inserts[ins].node, r);
+                emit(segs[s].b, r);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) { return a.first == b.first; }), pairs.end());
+    const uint32_t pointCount = (uint32_t)pn.pos.size();
+    stats_.pointNodes = pointCount;
+
+    // 4. Adjacence des points (CSR), carrefours = degré != 2
+    std::vector<uint32_t> off(pointCount + 1, 0u), adj(pairs.size() * 2);
+    for (const auto& pr : pairs) { ++off[(uint32_t)(pr.first >> 32) + 1]; ++off[(uint32_t)pr.first + 1]; }
+    for (uint32_t i=0; i<pointCount; ++i) off[i + 1] += off[i];
+    {
+        std::vector<uint32_t> fill(off.begin(), off.end() - 1);
+        for (uint32_t k=0; k<pairs.size(); ++k) { adj[fill[(uint32_t)(pairs[k].first >> 32)]++] = k; adj[fill[(uint32_t)pairs[k].first]++] = k; }
+    }
+    auto other = [&](uint32_t pair, uint32_t n) { const uint32_t a = (uint32_t)(pairs[pair].first >> 32); return a == n ? (uint32_t)pairs[pair].first : a; };
+    std::vector<uint32_t> graphId(pointCount, kNone);
+    for (uint32_t n=0; n<pointCount; ++n) if (off[n + 1] - off[n] != 2 && off[n + 1] > off[n]) { graphId[n] = (uint32_t)nodes_.size(); nodes_.push_back(pn.pos[n]); }
+
+    // 5. Chaînes entre carrefours -> arêtes. Boucle (retour au carrefour de départ, ou anneau sans carrefour dont le
+    // plus petit point en devient un): coupée en son milieu en deux arêtes
+    const float sx = map.width > 1 && map.worldMaxX > 0.f ? map.worldMaxX / (float)(map.width - 1) : 1.f;
+    const float sy = map.height > 1 && map.worldMaxY > 0.f ? map.worldMaxY / (float)(map.height - 1) : 1.f;
+    const float kmPerUnit = map.kmPerUnit > 0.f ? map.kmPerUnit : 1.f;
+    auto roadSpeed = [&](uint32_t r) { return r < opt.roadSpeedKmh.size() && opt.roadSpeedKmh[r] > 0.f ? opt.roadSpeedKmh[r] : opt.speedKmh; };
+    std::vector<uint8_t> visited(pairs.size(), 0);
+    std::vector<uint32_t> chain, chainPairs; std::vector<float> chainKm, chainHours;
+    auto emit = [&](size_t i0, size_t i1) {
+        Edge e; e.a = graphId[chain[i0]]; e.b = graphId[chain[i1]]; e.road = pairs[chainPairs[i0]].second; e.capacity = opt.capacity;
+        e.shapeBegin = (uint32_t)shapePoints_.size();
+        float km = 0.f, hours = 0.f;
+        for (size_t i=i0; i<=i1; ++i) shapePoints_.push_back(pn.pos[chain[i]]);
+        for (size_t i=i0; i<i1; ++i) { km += chainKm[i]; hours += chainHours[i]; }
+        e.lengthKm = km; e.speedKmh = hours > 0.f ? km / hours : roadSpeed(e.road);
+        e.shapeEnd = (uint32_t)shapePoints_.size();
+        edges_.push_back(e);
+    };
+    auto walk = [&](uint32_t start, uint32_t firstPair) {
+        chain.assign(1, start); chainPairs.clear(); chainKm.clear(); chainHours.clear();
+        uint32_t cur = start, pair = firstPair;
+        for (;;) {
+            visited[pair] = 1;
+            const uint32_t nxt = other(pair, cur);
+            const glm::vec2 d = pn.pos[nxt] - pn.pos[cur];
+            const float segKm = std::sqrt(d.x * sx * d.x * sx + d.y * sy * d.y * sy) * kmPerUnit;
+            chain.push_back(nxt); chainPairs.push_back(pair);
+            chainKm.push_back(segKm); chainHours.push_back(segKm / std::max(roadSpeed(pairs[pair].second), 1e-3f));
+            cur = nxt;
+            if (graphId[cur] != kNone) break;
+            const uint32_t a0 = adj[off[cur]], a1 = adj[off[cur] + 1];
+            pair = a0 == pair ? a1 : a0;
+        }
+        if (cur != start) { emit(0, chain.size() - 1); return; }
+        if (chain.size() < 4) return; // aller-retour dégénéré
+        const size_t mid = chain.size() / 2;
+        graphId[chain[mid]] = (uint32_t)nodes_.size(); nodes_.push_back(pn.pos[chain[mid]]);
+        emit(0, mid); emit(mid, chain.size() - 1);
+    };
+    for (uint32_t n=0; n<pointCount; ++n) {
+        if (graphId[n] == kNone) continue;
+        for (uint32_t k=off[n]; k<off[n + 1]; ++k) if (!visited[adj[k]]) walk(n, adj[k]);
+    }
+    for (uint32_t k=0; k<pairs.size(); ++k) {
+        if (visited[k]) continue;
+        const uint32_t n = (uint32_t)(pairs[k].first >> 32);
+        graphId[n] = (uint32_t)nodes_.size(); nodes_.push_back(pn.pos[n]);
+        walk(n, k);
+    }
+
+    // 6. CSR des arcs (deux par arête, dans l'ordre des arêtes)
+    arcOffsets_.assign(nodes_.size() + 1, 0u);
+    for (const Edge& e : edges_) { ++arcOffsets_[e.a + 1]; ++arcOffsets_[e.b + 1]; }
+    for (size_t i=0; i<nodes_.size(); ++i) arcOffsets_[i + 1] += arcOffsets_[i];
+    arcTargets_.resize(edges_.size() * 2); arcEdges_.resize(edges_.size() * 2);
+    {
+        std::vector<uint32_t> fill(arcOffsets_.begin(), arcOffsets_.end() - 1);
+        for (uint32_t i=0; i<edges_.size(); ++i) {
+            const Edge& e = edges_[i];
+            arcTargets_[fill[e.a]] = e.b; arcEdges_[fill[e.a]++] = i;
+            arcTargets_[fill[e.b]] = e.a; arcEdges_[fill[e.b]++] = i;
+        }
+    }
+    buildLocator();
+    sourceHash_ = SourceHash(map, opt);
+    stats_.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return !edges_.empty();
+}
+
+void RoadNetwork::buildLocator() {
+    locOffsets_.clear(); locNodes_.clear(); locW_ = locH_ = 0;
+    if (nodes_.empty()) return;
+    glm::vec2 mn = nodes_[0], mx = nodes_[0];
+    for (const glm::vec2& p : nodes_) { mn.x = std::min(mn.x, p.x); mn.y = std::min(mn.y, p.y); mx.x = std::max(mx.x, p.x); mx.y = std::max(mx.y, p.y); }
+    locMin_ = mn;
+    locW_ = (int)((mx.x - mn.x) / kLocatorCell) + 1; locH_ = (int)((mx.y - mn.y) / kLocatorCell) + 1;
+    auto cellOf = [&](glm::vec2 p) { return (uint32_t)((int)((p.y - mn.y) / kLocatorCell) * locW_ + (int)((p.x - mn.x) / kLocatorCell)); };
+    locOffsets_.assign((size_t)locW_ * locH_ + 1, 0u);
+    for (const glm::vec2& p : nodes_) ++locOffsets_[cellOf(p) + 1];
+    for (size_t i=0; i+1<locOffsets_.size(); ++i) locOffsets_[i + 1] += locOffsets_[i];
+    locNodes_.resize(nodes_.size());
+    std::vector<uint32_t> fill(locOffsets_.begin(), locOffsets_.end() - 1);
+    for (uint32_t n=0; n<nodes_.size(); ++n) locNodes_[fill[cellOf(nodes_[n])]++] = n;
+}
+
+uint32_t RoadNetwork::nearestNode(glm::vec2 p, float maxDist) const {
+    if (locW_ == 0) return kNone;
+    const int cx = std::clamp((int)std::floor((p.x - locMin_.x) / kLocatorCell), 0, locW_ - 1);
+    const int cy = std::clamp((int)std::floor((p.y - locMin_.y) / kLocatorCell), 0, locH_ - 1);
+    uint32_t best = kNone; float bestD = maxDist * maxDist;
+    // Anneaux de cellules jusqu'à ce que l'anneau suivant soit plus loin que le meilleur candidat
+    for (int ring=0; ring<std::max(locW_, locH_); ++ring) {
+        if (best != kNone) {
+            const float reach = (float)(ring - 1) * kLocatorCell;
+            if (reach > 0.f && reach * reach > bestD) break;
+        }
+        for (int y=cy-ring; y<=cy+ring; ++y) {
+            if (y < 0 || y >= locH_) continue;
+            const bool edgeRow = y == cy - ring || y == cy + ring;
+            for (int x=cx-ring; x<=cx+ring; x += edgeRow ? 1 : 2 * ring) {
+                if (x >= 0 && x < locW_) {
+                    const uint32_t c = (uint32_t)(y * locW_ + x);
+                    for (uint32_t i=locOffsets_[c]; i<locOffsets_[c + 1]; ++i) {
+                        const uint32_t n = locNodes_[i]; const float d2 = Dist2(nodes_[n], p);
+                        if (d2 < bestD || (d2 == bestD && best != kNone && n < best) || (best == kNone && d2 <= bestD)) { best = n; bestD = d2; }
+                    }
+                }
+                if (ring == 0) break;
+            }
+        }
+    }
+    return best;
+}
+
+void RoadNetwork::capture(SaveGame::Snapshot& out) const {
+    SaveGame::Bytes b; ByteWriter w{ b };
+    w.pod(kCacheVersion); w.pod(sourceHash_);
+    w.array(nodes_); w.array(edges_); w.array(shapePoints_); w.array(arcOffsets_); w.array(arcTargets_); w.array(arcEdges_);
+    out.put({ "NET.roads", 0, (uint16_t)kCacheVersion, std::make_shared<const SaveGame::Bytes>(std::move(b)) });
+}
+
+bool RoadNetwork::load(const std::string& path, const TileMap& map, const RoadBuildOptions& opt) {
+    PROFILE_ZONE("RoadNetwork::load");
+    SaveGame::Bytes b;
+    if (!SaveGame::ReadSection(path, "NET.roads", b)) return false;
+    ByteReader r{ b.data(), b.data() + b.size() };
+    const uint32_t version = r.pod<uint32_t>(); const uint64_t hash = r.pod<uint64_t>();
+    if (!r.ok || version != kCacheVersion || hash != SourceHash(map, opt)) return false; // cache périmé: à recompiler
+    clear();
+    r.array(nodes_); r.array(edges_); r.array(shapePoints_); r.array(arcOffsets_); r.array(arcTargets_); r.array(arcEdges_);
+    bool ok = r.ok && arcOffsets_.size() == nodes_.size() + 1 && arcOffsets_.back() == arcTargets_.size() && arcTargets_.size() == edges_.size() * 2 && arcEdges_.size() == arcTargets_.size();
+    for (size_t i=0; ok && i<edges_.size(); ++i) ok = edges_[i].a < nodes_.size() && edges_[i].b < nodes_.size() && edges_[i].shapeBegin <= edges_[i].shapeEnd && edges_[i].shapeEnd <= shapePoints_.size();
+    for (size_t i=0; ok && i<arcTargets_.size(); ++i) ok = arcTargets_[i] < nodes_.size() && arcEdges_[i] < edges_.size();
+    if (!ok) { std::fprintf(stderr, "[RoadNetwork] %s: section NET.roads corrompue\n", path.c_str()); clear(); return false; }
+    buildLocator();
+    sourceHash_ = hash;
+    return true;
+}
+
+bool RoadNetwork::loadOrBuild(const std::string& path, const TileMap& map, const RoadBuildOptions& opt) {
+    return load(path, map, opt) || build(map, opt);
+}
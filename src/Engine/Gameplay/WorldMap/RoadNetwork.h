@@ -1,3 +1,87 @@
 #pragma once
-// [8] TODO: RoadNetwork: graph routier (noeuds/segments), coûts, vitesses, congestion
-struct RoadNetwork { /* ... */ };
+#include <glm/vec2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+// [8] TODO: congestion (TrafficSystem)
+
+struct TileMap;
+namespace SaveGame { struct Snapshot; }
+
+struct RoadBuildOptions {
+    float snapRadius = 1.f;          // cases: points de routes différentes plus proches fusionnés en un noeud
+    float speedKmh = 8.f;            // vitesse de référence (moyenne journalière d'un cavalier)
+    float capacity = 100.f;          // convois par jour
+    std::vector<float> roadSpeedKmh; // optionnel, par route de TileMap::roads (0 = speedKmh)
+};
+
+// Graphe routier monde compilé depuis TileMap::roads (polylignes de points de grille indépendantes):
+// points proches fusionnés (snapRadius), croisements et raccords en T détectés (segments qui se coupent ou extrémité
+// posée sur un segment), tronçons communs dédoublonnés, chaînes de points de degré 2 compressées en une arête.
+// Noeuds = carrefours et extrémités; arêtes non orientées avec forme (polyligne), longueur en km (kmPerUnit),
+// vitesse et capacité. Adjacence en CSR: arcs du noeud n = [firstArc(n), firstArc(n+1)), deux arcs par arête.
+// Coordonnées en cases de la grille TileMap (comme roads/places). Compilation O(points) (grilles de hachage);
+// le résultat se met en cache dans la carte cuite (section NET.roads) avec l'empreinte de ses entrées.
+class RoadNetwork {
+public:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    struct Edge {
+        uint32_t a = kNone, b = kNone;
+        float lengthKm = 0.f, speedKmh = 0.f, capacity = 0.f;
+        uint32_t road = kNone;          // route source du premier segment
+        uint32_t shapeBegin = 0, shapeEnd = 0; // shapePoints[shapeBegin, shapeEnd) de a vers b
+    };
+    struct BuildStats { size_t points = 0, snapped = 0, crossings = 0, pointNodes = 0; double ms = 0.0; };
+
+    bool build(const TileMap& map, const RoadBuildOptions& opt = {});
+    void clear();
+
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t edgeCount() const { return edges_.size(); }
+    bool empty() const { return edges_.empty(); }
+    glm::vec2 node(uint32_t n) const { return nodes_[n]; }
+    const Edge& edge(uint32_t e) const { return edges_[e]; }
+    std::span<const glm::vec2> shape(uint32_t e) const { return { shapePoints_.data() + edges_[e].shapeBegin, edges_[e].shapeEnd - edges_[e].shapeBegin }; }
+
+    uint32_t firstArc(uint32_t n) const { return arcOffsets_[n]; }
+    uint32_t arcTarget(uint32_t arc) const { return arcTargets_[arc]; }
+    uint32_t arcEdge(uint32_t arc) const { return arcEdges_[arc]; }
+    uint32_t degree(uint32_t n) const { return arcOffsets_[n + 1] - arcOffsets_[n]; }
+
+    // Temps de parcours (s de jeu); arête coupée (guerre, crue): vitesse 0 -> infini
+    float travelSeconds(uint32_t e) const { const Edge& d = edges_[e]; return d.speedKmh > 0.f ? d.lengthKm / d.speedKmh * 3600.f : std::numeric_limits<float>::infinity(); }
+    void setSpeed(uint32_t e, float kmh) { edges_[e].speedKmh = kmh; ++weightsVersion_; }
+    void setCapacity(uint32_t e, float capacity) { edges_[e].capacity = capacity; }
+    uint64_t weightsVersion() const { return weightsVersion_; } // incrémenté à chaque changement de vitesse
+
+    // Noeud le plus proche d'une position de grille (kNone si aucun à moins de maxDist)
+    uint32_t nearestNode(glm::vec2 p, float maxDist = std::numeric_limits<float>::infinity()) const;
+
+    const BuildStats& stats() const { return stats_; }
+    // Empreinte des entrées (routes, échelle, options): un cache n'est valide que pour la même empreinte
+    static uint64_t SourceHash(const TileMap& map, const RoadBuildOptions& opt);
+    uint64_t sourceHash() const { return sourceHash_; }
+
+    // Cache dans la carte cuite: section NET.roads d'une sauvegarde (SaveGame::Write)
+    void capture(SaveGame::Snapshot& out) const;
+    bool load(const std::string& path, const TileMap& map, const RoadBuildOptions& opt = {}); // false: absent ou périmé
+    bool loadOrBuild(const std::string& path, const TileMap& map, const RoadBuildOptions& opt = {});
+
+private:
+    void buildLocator();
+
+    std::vector<glm::vec2> nodes_;
+    std::vector<Edge> edges_;
+    std::vector<glm::vec2> shapePoints_;
+    std::vector<uint32_t> arcOffsets_{0u}, arcTargets_, arcEdges_;
+    // Recherche du noeud le plus proche: grille de kLocatorCell cases, noeuds par cellule en CSR
+    static constexpr float kLocatorCell = 32.f;
+    glm::vec2 locMin_{0.f};
+    int locW_ = 0, locH_ = 0;
+    std::vector<uint32_t> locOffsets_, locNodes_;
+    uint64_t sourceHash_ = 0, weightsVersion_ = 0;
+    BuildStats stats_;
+};
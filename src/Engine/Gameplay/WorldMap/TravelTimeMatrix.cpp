@@ -0,0 +1,135 @@
+#include "TravelTimeMatrix.h"
+#include "../../../Platform/ThreadPool.h"
+#include "../../../Core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+constexpr uint32_t kNone = ContractionHierarchy::kNone;
+constexpr unsigned kLanes = TravelTimeMatrix::kLanes;
+constexpr float kInf = TravelTimeMatrix::kInf;
+}
+
+void TravelTimeMatrix::Compute(const ContractionHierarchy& ch, std::span<const uint32_t> sources, std::span<const uint32_t> targets, float* out, size_t stride) {
+    Compute(ch, sources, targets, out, stride, ThreadPool::Shared());
+}
+
+void TravelTimeMatrix::Compute(const ContractionHierarchy& ch, std::span<const uint32_t> sources, std::span<const uint32_t> targets, float* out, size_t stride, ThreadPool& pool) {
+    PROFILE_ZONE("TravelTimeMatrix::Compute");
+    const uint32_t n = (uint32_t)ch.nodeCount();
+    auto rankOf = [&](uint32_t node) { return node < n ? ch.rank(node) : kNone; };
+    // Sélection: ancêtres des cibles (fermée vers le haut), numérotés par rang décroissant; arcs montants en local
+    std::vector<uint32_t> local(n, kNone), selected;
+    for (uint32_t t : targets)
+        for (uint32_t v=rankOf(t); v!=kNone && local[v]==kNone; v=ch.parent(v)) { local[v] = 0; selected.push_back(v); }
+    std::sort(selected.begin(), selected.end(), std::greater<uint32_t>());
+    for (uint32_t i=0; i<selected.size(); ++i) local[selected[i]] = i;
+    std::vector<uint32_t> selFirst(selected.size() + 1, 0u), selHead;
+    std::vector<float> selWeight;
+    for (uint32_t i=0; i<selected.size(); ++i) {
+        const uint32_t v = selected[i];
+        for (uint32_t a=ch.upFirst(v); a<ch.upFirst(v + 1); ++a) { selHead.push_back(local[ch.upHead(a)]); selWeight.push_back(ch.upWeight(a)); }
+        selFirst[i + 1] = (uint32_t)selHead.size();
+    }
+    std::vector<uint32_t> targetLocal(targets.size());
+    for (size_t j=0; j<targets.size(); ++j) { const uint32_t r = rankOf(targets[j]); targetLocal[j] = r == kNone ? kNone : local[r]; }
+
+    // Lots de kLanes sources: montée par source (ancêtres, dense par rang), puis balayage descendant commun
+    const size_t blocks = (sources.size() + kLanes - 1) / kLanes;
+    const size_t grain = std::max<size_t>(1, blocks / ((size_t)(pool.workerCount() + 1) * 4)); // tampons alloués par bloc de lots
+    pool.parallelFor(blocks, grain, [&](size_t b0, size_t b1) {
+        std::vector<float> up((size_t)n * kLanes, kInf), dist(selected.size() * kLanes);
+        for (size_t b=b0; b<b1; ++b) {
+            const size_t first = b * kLanes, lanes = std::min<size_t>(kLanes, sources.size() - first);
+            for (size_t k=0; k<lanes; ++k) {
+                const uint32_t s = rankOf(sources[first + k]);
+                if (s == kNone) continue;
+                up[(size_t)s * kLanes + k] = 0.f;
+                for (uint32_t v=s; v!=kNone; v=ch.parent(v)) {
+                    const float dv = up[(size_t)v * kLanes + k];
+                    if (dv == kInf) continue;
+                    for (uint32_t a=ch.upFirst(v); a<ch.upFirst(v + 1); ++a) {
+                        float& d = up[(size_t)ch.upHead(a) * kLanes + k];
+                        d = std::min(d, dv + ch.upWeight(a));
+                    }
+                }
+            }
+            for (size_t i=0; i<selected.size(); ++i) {
+                float cur[kLanes];
+                const float* u = &up[(size_t)selected[i] * kLanes];
+                for (unsigned k=0; k<kLanes; ++k) cur[k] = u[k];
+                for (uint32_t a=selFirst[i]; a<selFirst[i + 1]; ++a) {
+                    const float* dh = &dist[(size_t)selHead[a] * kLanes]; const float w = selWeight[a];
+                    for (unsigned k=0; k<kLanes; ++k) cur[k] = std::min(cur[k], dh[k] + w);
+                }
+                for (unsigned k=0; k<kLanes; ++k) dist[i * kLanes + k] = cur[k];
+            }
+            for (size_t k=0; k<lanes; ++k) {
+                float* row = out + (first + k) * stride;
+                for (size_t j=0; j<targets.size(); ++j) row[j] = targetLocal[j] == kNone ? kInf : dist[(size_t)targetLocal[j] * kLanes + k];
+                const uint32_t s = rankOf(sources[first + k]);
+                for (uint32_t v=s; v!=kNone; v=ch.parent(v)) up[(size_t)v * kLanes + k] = kInf; // têtes montantes = ancêtres
+            }
+        }
+    });
+}
+
+void TravelTimeMatrix::setEndpoints(std::span<const uint32_t> sources, std::span<const uint32_t> targets) {
+    sources_.assign(sources.begin(), sources.end()); targets_.assign(targets.begin(), targets.end());
+    sourceIndex_.clear(); targetIndex_.clear();
+    for (uint32_t i=0; i<sources_.size(); ++i) sourceIndex_.try_emplace(sources_[i], i);
+    for (uint32_t j=0; j<targets_.size(); ++j) targetIndex_.try_emplace(targets_[j], j);
+    table_.assign(sources_.size() * targets_.size(), kInf);
+    computed_ = nullptr;
+}
+
+bool TravelTimeMatrix::valid(const ContractionHierarchy& ch) const {
+    return computed_ == &ch && buildId_ == ch.buildId() && customization_ == ch.customization();
+}
+
+size_t TravelTimeMatrix::refresh(const ContractionHierarchy& ch) { return refresh(ch, ThreadPool::Shared()); }
+
+size_t TravelTimeMatrix::refresh(const ContractionHierarchy& ch, ThreadPool& pool) {
+    PROFILE_ZONE("TravelTimeMatrix::refresh");
+    if (valid(ch)) return 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t cols = targets_.size();
+    stats_ = {};
+    if (computed_ != &ch || buildId_ != ch.buildId()) {
+        Compute(ch, sources_, targets_, table_.data(), cols, pool);
+        stats_.rows = sources_.size(); stats_.columns = cols; stats_.cells = table_.size();
+    } else {
+        // Ancêtre modifié depuis le calcul, propagé de la racine vers les feuilles (parent de rang supérieur)
+        const uint32_t n = (uint32_t)ch.nodeCount();
+        staleAncestor_.assign(n, 0);
+        for (uint32_t r=n; r-->0; ) staleAncestor_[r] = ch.changedAt(r) > customization_ || (ch.parent(r) != kNone && staleAncestor_[ch.parent(r)]);
+        auto stale = [&](uint32_t node) { return node < n && staleAncestor_[ch.rank(node)]; };
+        std::vector<uint32_t> rows, rowNodes, columns, columnNodes, freshRows, fresh;
+        for (uint32_t i=0; i<sources_.size(); ++i) if (stale(sources_[i])) rows.push_back(i);
+        for (uint32_t j=0; j<cols; ++j) if (stale(targets_[j])) { columns.push_back(j); columnNodes.push_back(targets_[j]); }
+        for (uint32_t i : rows) rowNodes.push_back(sources_[i]);
+        // Lignes périmées: toutes les cibles; colonnes périmées: sources restantes seulement
+        if (!rows.empty()) {
+            scratch_.resize(rows.size() * cols);
+            Compute(ch, rowNodes, targets_, scratch_.data(), cols, pool);
+            for (size_t k=0; k<rows.size(); ++k) std::copy_n(scratch_.data() + k * cols, cols, table_.data() + (size_t)rows[k] * cols);
+        }
+        if (!columns.empty()) {
+            for (uint32_t i=0, k=0; i<sources_.size(); ++i) { if (k < rows.size() && rows[k] == i) { ++k; continue; } freshRows.push_back(i); fresh.push_back(sources_[i]); }
+            scratch_.resize(fresh.size() * columns.size());
+            Compute(ch, fresh, columnNodes, scratch_.data(), columns.size(), pool);
+            for (size_t k=0; k<freshRows.size(); ++k)
+                for (size_t c=0; c<columns.size(); ++c) table_[(size_t)freshRows[k] * cols + columns[c]] = scratch_[k * columns.size() + c];
+        }
+        stats_.rows = rows.size(); stats_.columns = columns.size();
+        stats_.cells = rows.size() * cols + fresh.size() * columns.size();
+    }
+    computed_ = &ch; buildId_ = ch.buildId(); customization_ = ch.customization();
+    stats_.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return stats_.cells;
+}
+
+float TravelTimeMatrix::seconds(uint32_t fromNode, uint32_t toNode) const {
+    const auto s = sourceIndex_.find(fromNode), t = targetIndex_.find(toNode);
+    return s == sourceIndex_.end() || t == targetIndex_.end() ? -1.f : at(s->second, t->second);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "ContractionHierarchy.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+// Tables de temps de parcours plusieurs-à-plusieurs (capitales x villes) pour les délais des messagers, la diplomatie
+// et la carte des délais. Calcul par balayages descendants restreints de la hiérarchie de contraction (RPHAST):
+// les ancêtres des cibles sont sélectionnés une fois par table, puis chaque lot de kLanes sources fait une recherche
+// montante par source et un seul balayage linéaire de la sélection (kLanes distances par sommet, vectorisables).
+// Lots de sources répartis sur le ThreadPool. Temps en secondes de jeu, kInf si injoignable.
+//
+// Cache: refresh() ne recalcule que ce qui a changé depuis le calcul précédent. Une distance s-t ne dépend que des
+// arcs des ancêtres de s et t dans l'arbre d'élimination: après ContractionHierarchy::update, seules les lignes et
+// colonnes dont un ancêtre a un arc modifié sont recalculées; reconstruction de la hiérarchie -> table entière.
+class TravelTimeMatrix {
+public:
+    static constexpr float kInf = ContractionHierarchy::kInf;
+    static constexpr unsigned kLanes = 8;
+    struct Stats { size_t rows = 0, columns = 0, cells = 0; double ms = 0.0; }; // dernier refresh
+
+    // Calcul direct: out[i * stride + j] = temps de sources[i] à targets[j] (noeuds du RoadNetwork)
+    static void Compute(const ContractionHierarchy& ch, std::span<const uint32_t> sources, std::span<const uint32_t> targets,
+                        float* out, size_t stride, ThreadPool& pool);
+    static void Compute(const ContractionHierarchy& ch, std::span<const uint32_t> sources, std::span<const uint32_t> targets,
+                        float* out, size_t stride);
+
+    // Extrémités de la table (noeuds du RoadNetwork); invalide tout le cache
+    void setEndpoints(std::span<const uint32_t> sources, std::span<const uint32_t> targets);
+    // Met la table à jour pour l'état courant de ch; renvoie le nombre de cellules recalculées (0: cache valide)
+    size_t refresh(const ContractionHierarchy& ch, ThreadPool& pool);
+    size_t refresh(const ContractionHierarchy& ch);
+    bool valid(const ContractionHierarchy& ch) const;
+    void invalidate() { computed_ = nullptr; }
+
+    size_t sourceCount() const { return sources_.size(); }
+    size_t targetCount() const { return targets_.size(); }
+    const std::vector<uint32_t>& sources() const { return sources_; }
+    const std::vector<uint32_t>& targets() const { return targets_; }
+    float at(size_t source, size_t target) const { return table_[source * targets_.size() + target]; }
+    std::span<const float> row(size_t source) const { return { table_.data() + source * targets_.size(), targets_.size() }; }
+    // Par noeuds: -1 si la paire n'est pas dans la table
+    float seconds(uint32_t fromNode, uint32_t toNode) const;
+    const Stats& stats() const { return stats_; }
+
+private:
+    std::vector<uint32_t> sources_, targets_;
+    std::unordered_map<uint32_t, uint32_t> sourceIndex_, targetIndex_;
+    std::vector<float> table_;
+    const ContractionHierarchy* computed_ = nullptr;   // hiérarchie du dernier calcul (nullptr: à refaire)
+    uint64_t buildId_ = 0, customization_ = 0;
+    std::vector<uint8_t> staleAncestor_;               // par rang: un ancêtre (ou soi) modifié depuis le calcul
+    std::vector<float> scratch_;
+    Stats stats_;
+};
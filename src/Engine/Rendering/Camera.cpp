@@ -0,0 +1,185 @@
+#include "Camera.h"
+#include "GL/TileMap.h"
+#include "../../Platform/Input.h"
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+
+void Frustum::extract(const glm::mat4& m) {
+    // Lignes de la matrice (glm est column-major: m[col][row])
+    glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    planes[kLeft] = r3 + r0; planes[kRight] = r3 - r0;
+    planes[kBottom] = r3 + r1; planes[kTop] = r3 - r1;
+    planes[kNear] = r3 + r2; planes[kFar] = r3 - r2; // clip z dans [-w,w] (convention GL)
+    for (auto& p : planes) { float len = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z); if (len > 0.f) p = p / len; }
+}
+
+bool Frustum::containsPoint(const glm::vec3& p) const {
+    for (const auto& pl : planes) if (pl.x*p.x + pl.y*p.y + pl.z*p.z + pl.w < 0.f) return false;
+    return true;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& c, float r) const {
+    for (const auto& pl : planes) if (pl.x*c.x + pl.y*c.y + pl.z*c.z + pl.w < -r) return false;
+    return true;
+}
+
+bool Frustum::intersectsAABB(const glm::vec3& mn, const glm::vec3& mx) const {
+    for (const auto& pl : planes) {
+        float px = pl.x >= 0.f ? mx.x : mn.x, py = pl.y >= 0.f ? mx.y : mn.y, pz = pl.z >= 0.f ? mx.z : mn.z;
+        if (pl.x*px + pl.y*py + pl.z*pz + pl.w < 0.f) return false;
+    }
+    return true;
+}
+
+void Camera::setPose(const glm::vec3& eye, float yawRad, float pitchDeg) {
+    eye_ = eye; yaw_ = yawRad; pitchDeg_ = pitchDeg;
+    float pitch = glm::radians(pitchDeg);
+    forward_ = glm::vec3(std::sin(yawRad) * std::cos(pitch), -std::cos(yawRad) * std::cos(pitch), -std::sin(pitch));
+}
+
+void Camera::update() {
+    float aspect = height_ > 0 ? (float)width_ / (float)height_ : 1.f;
+    proj_ = glm::perspective(glm::radians(fovDeg_), aspect, near_, far_);
+    view_ = glm::lookAt(eye_, eye_ + forward_, glm::vec3(0, 0, 1));
+    viewProj_ = proj_ * view_;
+    frustum_.extract(viewProj_);
+
+    // Emprise au sol: les sommets de (frustum ∩ tranche Z) sont sur les 12 arêtes du frustum -> arêtes bornées à [slabMin,slabMax]
+    glm::mat4 inv = glm::inverse(viewProj_);
+    glm::vec3 corners[8];
+    for (int i=0; i<8; ++i) {
+        glm::vec4 c = inv * glm::vec4((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f, 1.f);
+        corners[i] = glm::vec3(c) / c.w;
+    }
+    groundVisible_ = false;
+    auto include = [&](const glm::vec3& p) {
+        if (!groundVisible_) { visibleMin_ = visibleMax_ = glm::vec2(p.x, p.y); groundVisible_ = true; return; }
+        visibleMin_ = glm::min(visibleMin_, glm::vec2(p.x, p.y)); visibleMax_ = glm::max(visibleMax_, glm::vec2(p.x, p.y));
+    };
+    for (int a=0; a<8; ++a) for (int bit=1; bit<8; bit<<=1) {
+        int b = a | bit; if (b == a) continue;
+        const glm::vec3 &pa = corners[a], &pb = corners[b];
+        float t0 = 0.f, t1 = 1.f, dz = pb.z - pa.z;
+        if (std::fabs(dz) < 1e-9f) { if (pa.z < slabMin_ || pa.z > slabMax_) continue; }
+        else {
+            float ta = (slabMin_ - pa.z) / dz, tb = (slabMax_ - pa.z) / dz;
+            t0 = std::max(t0, std::min(ta, tb)); t1 = std::min(t1, std::max(ta, tb));
+            if (t0 > t1) continue;
+        }
+        include(pa + (pb - pa) * t0); include(pa + (pb - pa) * t1);
+    }
+    if (!groundVisible_) visibleMin_ = visibleMax_ = glm::vec2(eye_.x, eye_.y);
+}
+
+bool Camera::project(const glm::vec3& p, glm::vec2& screen) const {
+    glm::vec4 clip = viewProj_ * glm::vec4(p, 1.f);
+    if (clip.w <= 0.00001f) return false; // derrière caméra
+    screen.x = (clip.x / clip.w * 0.5f + 0.5f) * (float)width_;
+    screen.y = (-clip.y / clip.w * 0.5f + 0.5f) * (float)height_; // y écran vers le bas
+    return true;
+}
+
+void Camera::tessRange(float& nearDist, float& farDist) const {
+    float span = visibleWidth(); if (span <= 0.f) span = far_;
+    nearDist = std::clamp(span * 0.15f, 10.f, 4000.f);
+    farDist = std::clamp(span * 1.50f, nearDist + 50.f, 20000.f);
+}
+
+void MapCameraController::update(Camera& cam, const TileMap& map, const Input& input, int w, int h, float heightScale, float step) {
+    const float mapWidthUnits = map.worldMaxX > 0 ? map.worldMaxX : (float)map.width;
+    const float mapHeightUnits = map.worldMaxY > 0 ? map.worldMaxY : (float)map.height;
+    // Première frame ou resize: zoom de base = carte entière en largeur, caméra centrée
+    if (lastW_ != w || lastH_ != h) {
+        baseZoom_ = mapWidthUnits > 0 ? (float)w / mapWidthUnits : 1.f;
+        lastW_ = w; lastH_ = h;
+        camX_ = mapWidthUnits * 0.5f; camY_ = mapHeightUnits * 0.5f;
+    }
+
+    // Échelle humaine: hauteur d'œil minimale en unités monde
+    float kmPerUnit = mapWidthUnits > 0 ? worldKmWidth / mapWidthUnits : 1.f;
+    float minHeight = kmPerUnit > 0.f ? (eyeHeightMeters / 1000.f) / kmPerUnit : 0.002f;
+    if (minHeight < 0.0001f) minHeight = 0.0001f;
+
+    // Hauteur caméra (relation inverse au zoom, courbe log + ease-out t' = 1-(1-t)^p)
+    float zf = std::clamp(zoomFactor_, 0.05f, 300.f);
+    float tLin = std::clamp(std::log(zf) / std::log(300.f), 0.f, 1.f);
+    float tHeight = std::clamp(1.f - std::pow(1.f - tLin, zoomEasePower), 0.f, 1.f);
+    float camHeight = kMaxHeight - tHeight * (kMaxHeight - minHeight);
+    // Plancher au-dessus du relief (sous la caméra et un peu devant pour anticiper la pente), cohérent avec le shader
+    float baseMin = map.landMinHeight;
+    auto groundZAt = [&](float wx, float wy){ return std::max(0.f, map.sampleHeight(wx, wy) - baseMin) * heightScale; };
+    float aheadDist = std::max(1.0f, 6.0f * minHeight);
+    float groundZ = std::max(groundZAt(camX_, camY_), groundZAt(camX_ + std::sin(yaw_) * aheadDist, camY_ - std::cos(yaw_) * aheadDist));
+    {
+        float eps = std::max(0.25f * minHeight, 0.05f);
+        float limitZ = groundZ + minHeight; float minCamZ = std::min(groundZ + eps, limitZ);
+        if (camHeight < limitZ) camHeight = std::max(camHeight, minCamZ);
+    }
+    if (camHeight < minHeight) camHeight = minHeight;
+    camHeight_ = camHeight;
+    float altitudeT = std::clamp((camHeight - minHeight) / (kMaxHeight - minHeight), 0.f, 1.f);
+
+    // Pitch cible selon l'altitude (haut -> vue de dessus); regard souris seulement sous la vue de dessus
+    float targetPitch = kPitchFPS + altitudeT * (kPitchTopDown - kPitchFPS);
+    const float yawSensitivity = 0.0030f, pitchSensitivity = 0.0020f * 57.2957795f;
+    double mx, my; input.mousePosition(mx, my);
+    if (!hadMouseLast_) { mouseLastX_ = (float)mx; mouseLastY_ = (float)my; hadMouseLast_ = true; }
+    bool allowYaw = targetPitch < kPitchTopDown - 5.f; // nord en haut en vue de dessus
+    bool dragging = input.isDown(GLFW_MOUSE_BUTTON_LEFT) && allowYaw;
+    if (dragging) {
+        yaw_ += ((float)mx - mouseLastX_) * yawSensitivity;
+        pitchDeg_ -= ((float)my - mouseLastY_) * pitchSensitivity; // souris haut -> regarde haut
+        if (yaw_ > 3.14159265f) yaw_ -= 6.2831853f; else if (yaw_ < -3.14159265f) yaw_ += 6.2831853f;
+    } else pitchDeg_ = pitchDeg_ * 0.90f + targetPitch * 0.10f;
+    mouseLastX_ = (float)mx; mouseLastY_ = (float)my;
+    pitchDeg_ = std::clamp(pitchDeg_, kPitchFPS, kPitchTopDown);
+    if (!allowYaw) yaw_ = 0.f;
+
+    // Déplacement ZQSD: marche humaine au ras du sol, vitesse vue d'ensemble en altitude
+    bool keyFwd = input.isDown(GLFW_KEY_W) || input.isDown(GLFW_KEY_Z), keyBack = input.isDown(GLFW_KEY_S);
+    bool keyLeft = input.isDown(GLFW_KEY_A) || input.isDown(GLFW_KEY_Q), keyRight = input.isDown(GLFW_KEY_D);
+    bool keySprint = input.isDown(GLFW_KEY_LEFT_SHIFT) || input.isDown(GLFW_KEY_RIGHT_SHIFT);
+    float humanSpeedKmPerSec = keySprint ? 0.0028f : 0.0010f; // ~2.8 m/s (Shift) / ~1.0 m/s
+    float humanSpeed = kmPerUnit > 0.f ? humanSpeedKmPerSec / kmPerUnit : 1.f;
+    float overviewSpeed = mapWidthUnits * 0.25f;
+    float groundT = std::clamp((camHeight - minHeight) / (minHeight * 1200.f + 0.0001f), 0.f, 1.f);
+    float nearGroundFactor = 0.03f + 0.97f * std::pow(groundT, 2.8f); // 3% de la marche au ras du sol
+    float moveSpeed = (humanSpeed * nearGroundFactor * (1.f - altitudeT) + overviewSpeed * altitudeT) * step;
+    if (topDown()) {
+        if (keyFwd) camY_ -= moveSpeed;
+        if (keyBack) camY_ += moveSpeed;
+        if (keyLeft) camX_ += moveSpeed; // X inversé: Q fait défiler la carte vers la gauche visuelle
+        if (keyRight) camX_ -= moveSpeed;
+    } else {
+        float fx = std::sin(yaw_), fy = -std::cos(yaw_);
+        glm::vec2 dir(0.f);
+        if (keyFwd) dir += glm::vec2(fx, fy);
+        if (keyBack) dir -= glm::vec2(fx, fy);
+        if (keyLeft) dir -= glm::vec2(fy, fx);
+        if (keyRight) dir += glm::vec2(fy, fx);
+        if (dir.x != 0 || dir.y != 0) { dir = glm::normalize(dir); camX_ += dir.x * moveSpeed; camY_ += dir.y * moveSpeed; }
+    }
+
+    // Molette: pas fin proche du sol, plus gros en altitude
+    double scroll = input.scrollDelta();
+    if (scroll != 0.0) {
+        float s = std::clamp(scrollMinStep + (scrollMaxStep - scrollMinStep) * altitudeT, 0.001f, 0.5f);
+        zoomFactor_ = std::clamp(zoomFactor_ * (scroll > 0.0 ? 1.f + s : 1.f - s), 0.05f, 300.f);
+    }
+
+    // Projection: FOV et plans de coupe dynamiques selon l'altitude
+    float fov = 58.f + (63.f - 58.f) * altitudeT;
+    float nearPlane = std::max({camHeight * 0.05f, minHeight * 0.02f, 0.0000005f});
+    float farPlane = 600.f + (20000.f - 600.f) * altitudeT;
+    cam.setViewport(w, h);
+    cam.setPerspective(fov, nearPlane, farPlane);
+    cam.setPose(glm::vec3(camX_, camY_, camHeight), yaw_, pitchDeg_);
+    // Tranche du relief: le maillage CPU descend sous 0 pour l'eau, la tessellation borne à 0
+    cam.setGroundSlab(std::min(0.f, map.waterMinHeight - map.landMinHeight) * heightScale, std::max(0.f, map.landMaxHeight - map.landMinHeight) * heightScale);
+    cam.update();
+}
@@ -1,4 +1,106 @@
 #pragma once
-// [5] TODO: Caméra: projection (persp/ortho), contrôles (pan/zoom/orbit), frustum culling
-// [5] TODO: Caméras dédiées: Map, City, Character
-struct Camera { /* ... */ };
+#include <algorithm>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// [5] TODO: Caméras dédiées: City, Character (la caméra carte est MapCameraController)
+class Input;
+struct TileMap;
+
+// Plans du frustum extraits de la matrice view-projection (Gribb/Hartmann), normales vers l'intérieur: dot(n,p)+d >= 0 dedans
+struct Frustum {
+    enum Plane { kLeft, kRight, kBottom, kTop, kNear, kFar, kPlaneCount };
+    glm::vec4 planes[kPlaneCount];
+
+    void extract(const glm::mat4& vp);
+    bool containsPoint(const glm::vec3& p) const;
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+    bool intersectsAABB(const glm::vec3& mn, const glm::vec3& mx) const; // conservatif (coin positif par plan)
+};
+
+// Caméra perspective partagée par tous les renderers (Z vers le haut, carte dans le plan XY).
+// update() calcule une fois par frame matrices, frustum et emprise au sol visible; les renderers ne font que lire.
+class Camera {
+public:
+    void setViewport(int w, int h) { width_ = w; height_ = h; }
+    void setPerspective(float fovDeg, float nearPlane, float farPlane) { fovDeg_ = fovDeg; near_ = nearPlane; far_ = farPlane; }
+    void setPose(const glm::vec3& eye, float yawRad, float pitchDeg); // yaw=0 regarde vers -Y, pitch 90 = vue de dessus
+    void setGroundSlab(float zMin, float zMax) { slabMin_ = zMin; slabMax_ = zMax; } // plage Z du relief (emprise au sol)
+    void update();
+
+    const glm::mat4& view() const { return view_; }
+    const glm::mat4& proj() const { return proj_; }
+    const glm::mat4& viewProj() const { return viewProj_; }
+    const Frustum& frustum() const { return frustum_; }
+    const glm::vec3& position() const { return eye_; }
+    const glm::vec3& forward() const { return forward_; }
+    float yaw() const { return yaw_; }
+    float pitchDeg() const { return pitchDeg_; }
+    float fovDeg() const { return fovDeg_; }
+    float nearPlane() const { return near_; }
+    float farPlane() const { return far_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // Emprise XY du frustum coupé par la tranche de relief (rectangle englobant, unités monde); vide si la caméra regarde le ciel
+    bool groundVisible() const { return groundVisible_; }
+    const glm::vec2& visibleMin() const { return visibleMin_; }
+    const glm::vec2& visibleMax() const { return visibleMax_; }
+    float visibleWidth() const { return groundVisible_ ? std::max(visibleMax_.x - visibleMin_.x, visibleMax_.y - visibleMin_.y) : 0.f; }
+    bool overlapsGround(const glm::vec2& mn, const glm::vec2& mx) const { return groundVisible_ && mx.x >= visibleMin_.x && mn.x <= visibleMax_.x && mx.y >= visibleMin_.y && mn.y <= visibleMax_.y; }
+    // Boîte monde: emprise au sol puis frustum
+    bool isVisible(const glm::vec3& mn, const glm::vec3& mx) const { return overlapsGround(glm::vec2(mn.x, mn.y), glm::vec2(mx.x, mx.y)) && frustum_.intersectsAABB(mn, mx); }
+    // Etiquettes: ancre (rayon monde) dans le frustum
+    bool isVisible(const glm::vec3& p, float radius) const { return frustum_.intersectsSphere(p, radius); }
+
+    // Monde -> pixels (origine haut-gauche); false si le point est derrière la caméra
+    bool project(const glm::vec3& p, glm::vec2& screen) const;
+    // Portée de tessellation (near/far) déduite de l'emprise visible
+    void tessRange(float& nearDist, float& farDist) const;
+
+private:
+    int width_ = 1, height_ = 1;
+    float fovDeg_ = 60.f, near_ = 0.1f, far_ = 1000.f;
+    glm::vec3 eye_{0.f, 0.f, 1.f}, forward_{0.f, 0.f, -1.f};
+    float yaw_ = 0.f, pitchDeg_ = 90.f;
+    float slabMin_ = 0.f, slabMax_ = 0.f;
+    glm::mat4 view_{1.f}, proj_{1.f}, viewProj_{1.f};
+    Frustum frustum_{};
+    bool groundVisible_ = false;
+    glm::vec2 visibleMin_{0.f, 0.f}, visibleMax_{0.f, 0.f};
+};
+
+// Contrôles de la caméra carte: zoom molette (hauteur sur courbe log), ZQSD, regard souris sous la vue de dessus,
+// plancher à hauteur d'œil au-dessus du relief (TileMap::sampleHeight). Remplit la Camera (pose + projection) puis update().
+class MapCameraController {
+public:
+    static constexpr float kPitchTopDown = 89.f;   // vue de dessus
+    static constexpr float kPitchFPS = 18.f;       // angle bas (marche)
+    static constexpr float kMaxHeight = 1200.f;    // altitude vue d'ensemble
+    static constexpr float kFpsPitchSwitch = 60.f; // sous ce pitch -> déplacement style FPS
+
+    // step = pas de déplacement (s), heightScale = échelle Z du maillage
+    void update(Camera& cam, const TileMap& map, const Input& input, int w, int h, float heightScale, float step);
+
+    float zoomFactor() const { return zoomFactor_; }
+    float totalZoom() const { return baseZoom_ * zoomFactor_; } // logique de couches (seuils renderers)
+    float height() const { return camHeight_; }
+    float pitchDeg() const { return pitchDeg_; }
+    bool topDown() const { return pitchDeg_ > kFpsPitchSwitch; }
+
+    // Réglages (UI)
+    float zoomEasePower = 2.2f;   // >1 -> ralentit fortement la descente proche du sol
+    float scrollMinStep = 0.010f; // multiplicateur molette proche du sol
+    float scrollMaxStep = 0.11f;  // multiplicateur molette en altitude
+    float worldKmWidth = 2700.f;  // largeur réelle carte (km)
+    float eyeHeightMeters = 1.70f;
+
+private:
+    float camX_ = 0.f, camY_ = 0.f, camHeight_ = kMaxHeight;
+    float baseZoom_ = 1.f, zoomFactor_ = 1.f;
+    float yaw_ = 0.f, pitchDeg_ = kPitchTopDown;
+    float mouseLastX_ = 0.f, mouseLastY_ = 0.f; bool hadMouseLast_ = false;
+    int lastW_ = 0, lastH_ = 0;
+};
@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// Raster 2D stocké par chunks 64x64 (ligne à l'intérieur du chunk), chunks rangés en ordre Morton (Z-order).
+// Un voisin vertical est à 64 éléments (même chunk) au lieu de width: les passes de voisinage restent dans le cache.
+// Les chunks de bord sont complets en mémoire (padding); itérateurs et accesseurs ne visitent que [0,w)x[0,h).
+namespace ChunkedLayout {
+    constexpr int    kShift = 6;
+    constexpr int    kSize  = 1 << kShift; // 64
+    constexpr int    kMask  = kSize - 1;
+    constexpr size_t kCells = (size_t)kSize * kSize;
+
+    inline uint32_t Part1By1(uint32_t v) { // bits 0..15 -> positions paires
+        v &= 0xFFFFu; v = (v | (v << 8)) & 0x00FF00FFu; v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u; v = (v | (v << 1)) & 0x55555555u; return v;
+    }
+    inline uint32_t Morton2(uint32_t x, uint32_t y) { return Part1By1(x) | (Part1By1(y) << 1); }
+}
+
+template<class T>
+class ChunkedRaster {
+private:
+    struct Geom { int cx, cy, x0, y0, w, h; };
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "ChunkedRaster: T doit être trivialement copiable");
+    using value_type = T;
+
+    ChunkedRaster() = default;
+    ChunkedRaster(int w, int h, T fill = T{}) { resize(w, h, fill); }
+
+    void resize(int w, int h, T fill = T{}) {
+        width_ = std::max(w, 0); height_ = std::max(h, 0);
+        chunksX_ = (width_ + ChunkedLayout::kMask) >> ChunkedLayout::kShift; chunksY_ = (height_ + ChunkedLayout::kMask) >> ChunkedLayout::kShift;
+        const size_t n = (size_t)chunksX_ * chunksY_;
+        // Rang Morton compact: pas de chunks fantômes quand la grille n'est pas une puissance de 2 carrée
+        std::vector<uint64_t> keys(n);
+        for (int cy=0; cy<chunksY_; ++cy) for (int cx=0; cx<chunksX_; ++cx)
+            keys[(size_t)cy*chunksX_ + cx] = ((uint64_t)ChunkedLayout::Morton2((uint32_t)cx, (uint32_t)cy) << 32) | (uint32_t)((size_t)cy*chunksX_ + cx);
+        std::sort(keys.begin(), keys.end());
+        slotOf_.assign(n, 0); coordOf_.assign(n, 0);
+        for (size_t r=0; r<n; ++r) {
+            uint32_t grid = (uint32_t)keys[r]; slotOf_[grid] = (uint32_t)r;
+            coordOf_[r] = (grid % (uint32_t)chunksX_) | ((grid / (uint32_t)chunksX_) << 16);
+        }
+        data_.assign(n * ChunkedLayout::kCells, fill);
+    }
+    void clear() { width_ = height_ = chunksX_ = chunksY_ = 0; slotOf_.clear(); coordOf_.clear(); data_.clear(); }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    bool empty() const { return data_.empty(); }
+    int chunksX() const { return chunksX_; }
+    int chunksY() const { return chunksY_; }
+    size_t chunkCount() const { return coordOf_.size(); }
+    size_t memoryBytes() const { return data_.size() * sizeof(T) + (slotOf_.size() + coordOf_.size()) * sizeof(uint32_t); }
+
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+    size_t index(int x, int y) const {
+        return (size_t)slotOf_[(size_t)(y >> ChunkedLayout::kShift) * chunksX_ + (x >> ChunkedLayout::kShift)] * ChunkedLayout::kCells
+             + ((size_t)(y & ChunkedLayout::kMask) << ChunkedLayout::kShift) + (x & ChunkedLayout::kMask);
+    }
+    T& at(int x, int y) { return data_[index(x, y)]; }
+    const T& at(int x, int y) const { return data_[index(x, y)]; }
+    T atClamped(int x, int y) const { return at(std::clamp(x, 0, width_ - 1), std::clamp(y, 0, height_ - 1)); }
+    T atOr(int x, int y, T outside) const { return inside(x, y) ? at(x, y) : outside; }
+
+    // Voisin (x+dx,y+dy) borné aux limites; évite la table de slots si le voisin reste dans le même chunk
+    T neighbor(int x, int y, int dx, int dy) const {
+        int nx = std::clamp(x + dx, 0, width_ - 1), ny = std::clamp(y + dy, 0, height_ - 1);
+        if (((nx ^ x) | (ny ^ y)) >> ChunkedLayout::kShift) return at(nx, ny);
+        const T* c = &at(x, y) - (((size_t)(y & ChunkedLayout::kMask) << ChunkedLayout::kShift) + (x & ChunkedLayout::kMask));
+        return c[((size_t)(ny & ChunkedLayout::kMask) << ChunkedLayout::kShift) + (nx & ChunkedLayout::kMask)];
+    }
+
+    // Chunk par rang Morton: origine cellule et étendue valide (chunks de bord partiels)
+    struct ChunkRef { int cx, cy, x0, y0, w, h; T* data; }; // data[ly*64+lx]
+    struct ConstChunkRef { int cx, cy, x0, y0, w, h; const T* data; };
+    ChunkRef chunk(size_t slot) { auto r = chunkGeom(slot); return { r.cx, r.cy, r.x0, r.y0, r.w, r.h, data_.data() + slot * ChunkedLayout::kCells }; }
+    ConstChunkRef chunk(size_t slot) const { auto r = chunkGeom(slot); return { r.cx, r.cy, r.x0, r.y0, r.w, r.h, data_.data() + slot * ChunkedLayout::kCells }; }
+    size_t slotAt(int cx, int cy) const { return slotOf_[(size_t)cy * chunksX_ + cx]; }
+
+    template<class F> void forEachChunk(F&& f) { for (size_t s=0; s<chunkCount(); ++s) f(chunk(s)); }
+    template<class F> void forEachChunk(F&& f) const { for (size_t s=0; s<chunkCount(); ++s) f(chunk(s)); }
+
+    // Visite [x0,x0+w)x[y0,y0+h) chunk par chunk (chunks ligne par ligne, puis lignes locales): f(x, y, T&).
+    // Première cellule visitée = (x0,y0); un rectangle d'une ligne ou d'une colonne garde l'ordre ligne.
+    template<class F> void forEachInRect(int x0, int y0, int w, int h, F&& f) { visitRect(*this, x0, y0, w, h, f); }
+    template<class F> void forEachInRect(int x0, int y0, int w, int h, F&& f) const { visitRect(*this, x0, y0, w, h, f); }
+
+    // Copie du chunk (cx,cy) avec une bordure de 'halo' cellules dans dst ((64+2*halo)^2, ligne);
+    // les cellules hors raster valent 'outside'.
+    void gatherHalo(int cx, int cy, int halo, T* dst, T outside) const {
+        const int side = ChunkedLayout::kSize + 2 * halo;
+        const int bx = (cx << ChunkedLayout::kShift) - halo, by = (cy << ChunkedLayout::kShift) - halo;
+        for (int ry=0; ry<side; ++ry) {
+            T* row = dst + (size_t)ry * side; const int y = by + ry;
+            if (y < 0 || y >= height_) { std::fill(row, row + side, outside); continue; }
+            int x = bx, rx = 0;
+            if (x < 0) { std::fill(row, row - x, outside); rx = -x; x = 0; }
+            const int xEnd = std::min(bx + side, width_);
+            while (x < xEnd) { // segments contigus par chunk
+                int segEnd = std::min(xEnd, ((x >> ChunkedLayout::kShift) + 1) << ChunkedLayout::kShift);
+                std::memcpy(row + rx, &at(x, y), (size_t)(segEnd - x) * sizeof(T));
+                rx += segEnd - x; x = segEnd;
+            }
+            if (rx < side) std::fill(row + rx, row + side, outside);
+        }
+    }
+
+    // Compatibilité disposition ligne (TileMap, GPU, fichiers)
+    void importRowMajor(const T* src, int w, int h) {
+        resize(w, h);
+        for (size_t s=0; s<chunkCount(); ++s) {
+            ChunkRef c = chunk(s);
+            for (int ly=0; ly<c.h; ++ly) std::memcpy(c.data + ((size_t)ly << ChunkedLayout::kShift), src + (size_t)(c.y0 + ly) * w + c.x0, (size_t)c.w * sizeof(T));
+        }
+    }
+    void importRowMajor(const std::vector<T>& src, int w, int h) { if (src.size() >= (size_t)w * h) importRowMajor(src.data(), w, h); else resize(w, h); }
+    void exportRowMajor(T* dst) const {
+        for (size_t s=0; s<chunkCount(); ++s) {
+            ConstChunkRef c = chunk(s);
+            for (int ly=0; ly<c.h; ++ly) std::memcpy(dst + (size_t)(c.y0 + ly) * width_ + c.x0, c.data + ((size_t)ly << ChunkedLayout::kShift), (size_t)c.w * sizeof(T));
+        }
+    }
+    std::vector<T> exportRowMajor() const { std::vector<T> v((size_t)width_ * height_); if (!v.empty()) exportRowMajor(v.data()); return v; }
+
+    // Itération typée en ordre de stockage (Morton puis ligne locale), cellules de padding exclues
+    template<bool Const>
+    class CellIterator {
+    public:
+        using Raster = std::conditional_t<Const, const ChunkedRaster, ChunkedRaster>;
+        using Ref = std::conditional_t<Const, const T&, T&>;
+        struct Cell { int x, y; Ref value; };
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Cell; using difference_type = std::ptrdiff_t; using pointer = void; using reference = Cell;
+
+        CellIterator() = default;
+        CellIterator(Raster* r, size_t slot) : r_(r), slot_(slot) { enter(); }
+        Cell operator*() const { return { geom_.x0 + lx_, geom_.y0 + ly_, r_->data_[slot_ * ChunkedLayout::kCells + ((size_t)ly_ << ChunkedLayout::kShift) + lx_] }; }
+        CellIterator& operator++() {
+            if (++lx_ < geom_.w) return *this;
+            lx_ = 0; if (++ly_ < geom_.h) return *this;
+            ++slot_; enter(); return *this;
+        }
+        CellIterator operator++(int) { CellIterator t = *this; ++*this; return t; }
+        bool operator==(const CellIterator& o) const { return slot_ == o.slot_ && lx_ == o.lx_ && ly_ == o.ly_; }
+        bool operator!=(const CellIterator& o) const { return !(*this == o); }
+    private:
+        void enter() { lx_ = ly_ = 0; if (r_ && slot_ < r_->chunkCount()) geom_ = r_->chunkGeom(slot_); }
+        Raster* r_ = nullptr; size_t slot_ = 0; int lx_ = 0, ly_ = 0; Geom geom_{};
+    };
+    using iterator = CellIterator<false>;
+    using const_iterator = CellIterator<true>;
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, chunkCount()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, chunkCount()); }
+
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+private:
+    Geom chunkGeom(size_t slot) const {
+        int cx = (int)(coordOf_[slot] & 0xFFFFu), cy = (int)(coordOf_[slot] >> 16);
+        int x0 = cx << ChunkedLayout::kShift, y0 = cy << ChunkedLayout::kShift;
+        return { cx, cy, x0, y0, std::min(ChunkedLayout::kSize, width_ - x0), std::min(ChunkedLayout::kSize, height_ - y0) };
+    }
+    template<class Self, class F> static void visitRect(Self& self, int x0, int y0, int w, int h, F& f) {
+        int xa = std::max(x0, 0), ya = std::max(y0, 0), xb = std::min(x0 + w, self.width_), yb = std::min(y0 + h, self.height_);
+        if (xa >= xb || ya >= yb) return;
+        for (int cy = ya >> ChunkedLayout::kShift; cy <= (yb - 1) >> ChunkedLayout::kShift; ++cy) {
+            int cyA = std::max(ya, cy << ChunkedLayout::kShift), cyB = std::min(yb, (cy + 1) << ChunkedLayout::kShift);
+            for (int cx = xa >> ChunkedLayout::kShift; cx <= (xb - 1) >> ChunkedLayout::kShift; ++cx) {
+                int cxA = std::max(xa, cx << ChunkedLayout::kShift), cxB = std::min(xb, (cx + 1) << ChunkedLayout::kShift);
+                auto* base = &self.at(cxA, cyA);
+                for (int y=cyA; y<cyB; ++y, base += ChunkedLayout::kSize)
+                    for (int x=cxA; x<cxB; ++x) f(x, y, base[x - cxA]);
+            }
+        }
+    }
+
+    int width_ = 0, height_ = 0, chunksX_ = 0, chunksY_ = 0;
+    std::vector<uint32_t> slotOf_;  // (cy*chunksX+cx) -> rang Morton
+    std::vector<uint32_t> coordOf_; // rang -> cx | cy<<16
+    std::vector<T> data_;           // chunkCount * 64*64
+};
@@ -0,0 +1,89 @@
+#include "HeightCodec.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WARLAND_HEIGHT_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define WARLAND_HEIGHT_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace HeightCodec {
+
+static inline uint16_t EncodeOne(float h, float inv, float offset) {
+    // NaN -> 0 comme maxps (SSE2) et vcvtq_u32_f32 (NEON); std::max le laisserait passer jusqu'au cast
+    const float q = (h - offset) * inv + 0.5f; return (uint16_t)(int)(!(q > 0.f) ? 0.f : std::min(q, 65535.f));
+}
+
+void RangeFor(float lo, float hi, float& scale, float& offset) {
+    if (!(hi > lo)) hi = lo + 1.f; // plage dégénérée: pas quelconque > 0
+    offset = lo; scale = (hi - lo) / 65535.f;
+}
+
+void MinMax(const float* src, size_t n, float& lo, float& hi) {
+    size_t i = 0; lo = n ? src[0] : 0.f; hi = lo;
+#if WARLAND_HEIGHT_SSE2
+    if (n >= 4) {
+        __m128 vlo = _mm_loadu_ps(src), vhi = vlo;
+        for (i=4; i+4<=n; i+=4) { __m128 v = _mm_loadu_ps(src + i); vlo = _mm_min_ps(vlo, v); vhi = _mm_max_ps(vhi, v); }
+        alignas(16) float a[4], b[4]; _mm_store_ps(a, vlo); _mm_store_ps(b, vhi);
+        for (int k=0; k<4; ++k) { lo = std::min(lo, a[k]); hi = std::max(hi, b[k]); }
+    }
+#elif WARLAND_HEIGHT_NEON
+    if (n >= 4) {
+        float32x4_t vlo = vld1q_f32(src), vhi = vlo;
+        for (i=4; i+4<=n; i+=4) { float32x4_t v = vld1q_f32(src + i); vlo = vminq_f32(vlo, v); vhi = vmaxq_f32(vhi, v); }
+        float a[4], b[4]; vst1q_f32(a, vlo); vst1q_f32(b, vhi);
+        for (int k=0; k<4; ++k) { lo = std::min(lo, a[k]); hi = std::max(hi, b[k]); }
+    }
+#endif
+    for (; i<n; ++i) { lo = std::min(lo, src[i]); hi = std::max(hi, src[i]); }
+}
+
+void Encode(const float* src, uint16_t* dst, size_t n, float scale, float offset) {
+    const float inv = scale > 0.f ? 1.f / scale : 0.f; size_t i = 0;
+#if WARLAND_HEIGHT_SSE2
+    // SSE2 n'a pas de pack non signé 32->16: on recentre sur [-32768,32767] puis pack signé et xor 0x8000
+    const __m128 vinv = _mm_set1_ps(inv), voff = _mm_set1_ps(offset), vhalf = _mm_set1_ps(0.5f), vzero = _mm_setzero_ps(), vmax = _mm_set1_ps(65535.f);
+    const __m128i bias = _mm_set1_epi32(32768), flip = _mm_set1_epi16((short)0x8000);
+    for (; i+8<=n; i+=8) {
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i), voff), vinv), vhalf);
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i + 4), voff), vinv), vhalf);
+        a = _mm_min_ps(_mm_max_ps(a, vzero), vmax); b = _mm_min_ps(_mm_max_ps(b, vzero), vmax);
+        __m128i ia = _mm_sub_epi32(_mm_cvttps_epi32(a), bias), ib = _mm_sub_epi32(_mm_cvttps_epi32(b), bias);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(_mm_packs_epi32(ia, ib), flip));
+    }
+#elif WARLAND_HEIGHT_NEON
+    const float32x4_t vinv = vdupq_n_f32(inv), voff = vdupq_n_f32(offset), vhalf = vdupq_n_f32(0.5f), vmax = vdupq_n_f32(65535.f);
+    for (; i+8<=n; i+=8) {
+        float32x4_t a = vaddq_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i), voff), vinv), vhalf);
+        float32x4_t b = vaddq_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i + 4), voff), vinv), vhalf);
+        a = vminq_f32(a, vmax); b = vminq_f32(b, vmax); // vcvtq_u32_f32 sature déjà les négatifs à 0
+        vst1q_u16(dst + i, vcombine_u16(vqmovn_u32(vcvtq_u32_f32(a)), vqmovn_u32(vcvtq_u32_f32(b))));
+    }
+#endif
+    for (; i<n; ++i) dst[i] = EncodeOne(src[i], inv, offset);
+}
+
+void Decode(const uint16_t* src, float* dst, size_t n, float scale, float offset) {
+    size_t i = 0;
+#if WARLAND_HEIGHT_SSE2
+    const __m128 vs = _mm_set1_ps(scale), voff = _mm_set1_ps(offset); const __m128i zero = _mm_setzero_si128();
+    for (; i+8<=n; i+=8) {
+        __m128i q = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_ps(dst + i,     _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero)), vs), voff));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(q, zero)), vs), voff));
+    }
+#elif WARLAND_HEIGHT_NEON
+    const float32x4_t vs = vdupq_n_f32(scale), voff = vdupq_n_f32(offset);
+    for (; i+8<=n; i+=8) {
+        uint16x8_t q = vld1q_u16(src + i);
+        vst1q_f32(dst + i,     vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(q))), vs), voff));
+        vst1q_f32(dst + i + 4, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(q))), vs), voff));
+    }
+#endif
+    for (; i<n; ++i) dst[i] = offset + (float)src[i] * scale; // même ordre mul puis add que le chemin SIMD
+}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Quantification 16 bits des hauteurs: h = offset + q * scale, q dans [0,65535].
+// Chemins SIMD (SSE2 / NEON) avec repli scalaire; résultats identiques bit à bit entre chemins.
+namespace HeightCodec {
+    // Calcule scale/offset couvrant [lo,hi] (scale > 0 même si lo == hi)
+    void RangeFor(float lo, float hi, float& scale, float& offset);
+    // Min/max d'un tableau de hauteurs (n > 0)
+    void MinMax(const float* src, size_t n, float& lo, float& hi);
+    // Arrondi au plus proche, saturé à [0,65535]
+    void Encode(const float* src, uint16_t* dst, size_t n, float scale, float offset);
+    void Decode(const uint16_t* src, float* dst, size_t n, float scale, float offset);
+}
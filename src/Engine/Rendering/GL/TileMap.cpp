@@ -1,4 +1,6 @@
 #include "TileMap.h"
+#include "HeightCodec.h"
+#include <algorithm>
 #include <nlohmann/json.hpp>
 #include <fstream>
 
@@ -14,15 +16,12 @@ bool TileMap::loadFromFile(const std::string& path) {
     atlasImagePath = j.value("atlasImage", std::string(""));
     if (j.contains("tiles")) tiles = j["tiles"].get<std::vector<uint16_t>>();
 
-    places.clear();
+    places.clear(); strings.clear();
     if (j.contains("places")) {
+        places.reserve(j["places"].size());
         for (auto& p : j["places"]) {
-            Place pl;
-            pl.name = p.value("name", std::string(""));
-            pl.type = p.value("type", std::string(""));
-            pl.x = p.value("x", 0);
-            pl.y = p.value("y", 0);
-            places.push_back(std::move(pl));
+            auto str = [&](const char* key) -> std::string_view { auto it = p.find(key); return (it != p.end() && it->is_string()) ? std::string_view(it->get_ref<const std::string&>()) : std::string_view(); };
+            places.add(p.value("x", 0), p.value("y", 0), strings.intern(str("type")), strings.intern(str("name")));
         }
     }
 
@@ -49,15 +48,64 @@ bool TileMap::loadFromFile(const std::string& path) {
     roads.clear();
     if (j.contains("roads")) {
         for (auto& r : j["roads"]) {
-            Road rd; 
-            if (r.contains("points")) {
-                for (auto& pt : r["points"]) {
-                    RoadSegment seg{ pt.value("x",0), pt.value("y",0) }; 
-                    rd.points.push_back(seg);
-                }
-            }
-            roads.push_back(std::move(rd));
+            if (r.contains("points")) for (auto& pt : r["points"]) roads.addPoint(pt.value("x",0), pt.value("y",0));
+            roads.commitRoad(0); // index stables (RoadNetwork, sauvegardes): routes vides conservées
         }
     }
     return true;
 }
+
+const float* TileMap::heightData(std::vector<float>& scratch) const {
+    if (!tileHeights.empty() || tileHeightsQ.empty()) return tileHeights.data();
+    scratch.resize(tileHeightsQ.size());
+    HeightCodec::Decode(tileHeightsQ.data(), scratch.data(), tileHeightsQ.size(), heightQScale, heightQOffset);
+    return scratch.data();
+}
+
+float TileMap::sampleHeight(float wx, float wy) const {
+    if (width <= 0 || height <= 0 || !hasHeights()) return 0.f;
+    float gx = worldMaxX > 0 ? wx / worldMaxX * (float)(width - 1) : wx;
+    float gy = worldMaxY > 0 ? wy / worldMaxY * (float)(height - 1) : wy;
+    gx = std::clamp(gx, 0.f, (float)(width - 1)); gy = std::clamp(gy, 0.f, (float)(height - 1));
+    int x0 = (int)gx, y0 = (int)gy; int x1 = std::min(x0 + 1, width - 1), y1 = std::min(y0 + 1, height - 1);
+    float tx = gx - (float)x0, ty = gy - (float)y0;
+    float h0 = heightAt(x0, y0) + (heightAt(x1, y0) - heightAt(x0, y0)) * tx;
+    float h1 = heightAt(x0, y1) + (heightAt(x1, y1) - heightAt(x0, y1)) * tx;
+    return h0 + (h1 - h0) * ty;
+}
+
+void TileMap::quantizeHeights(bool releaseFloat) {
+    if (tileHeights.empty()) return;
+    // Plage issue des stats land/water; étendue aux valeurs réelles si les stats sont périmées (pas de saturation)
+    float lo = std::min(landMinHeight, waterMinHeight), hi = std::max(landMaxHeight, waterMaxHeight);
+    float mn, mx; HeightCodec::MinMax(tileHeights.data(), tileHeights.size(), mn, mx);
+    lo = std::min(lo, mn); hi = std::max(hi, mx);
+    HeightCodec::RangeFor(lo, hi, heightQScale, heightQOffset);
+    tileHeightsQ.resize(tileHeights.size());
+    HeightCodec::Encode(tileHeights.data(), tileHeightsQ.data(), tileHeights.size(), heightQScale, heightQOffset);
+    if (releaseFloat) std::vector<float>().swap(tileHeights);
+}
+
+void TileMap::unpackHeights() {
+    if (tileHeightsQ.empty()) return;
+    if (tileHeights.empty()) {
+        tileHeights.resize(tileHeightsQ.size());
+        HeightCodec::Decode(tileHeightsQ.data(), tileHeights.data(), tileHeightsQ.size(), heightQScale, heightQOffset);
+    }
+    std::vector<uint16_t>().swap(tileHeightsQ); // la couche float redevient la référence
+}
+
+void TileMap::exportChunked(TileMapChunkedLayers& out) const {
+    const size_t total = (size_t)std::max(width, 0) * std::max(height, 0);
+    auto layer = [&](auto& dst, const auto& src) { if (src.size() == total && total) dst.importRowMajor(src, width, height); else dst.clear(); };
+    layer(out.tiles, tiles); layer(out.countries, countries); layer(out.paletteIndices, paletteIndices);
+    std::vector<float> scratch; const float* h = heightData(scratch);
+    const size_t hn = heightsQuantized() ? tileHeightsQ.size() : tileHeights.size();
+    if (hn == total && total) out.heights.importRowMajor(h, width, height); else out.heights.clear();
+}
+
+void TileMap::importChunked(const TileMapChunkedLayers& in) {
+    auto layer = [&](auto& dst, const auto& src) { if (!src.empty() && src.width() == width && src.height() == height) dst = src.exportRowMajor(); };
+    layer(tiles, in.tiles); layer(countries, in.countries); layer(paletteIndices, in.paletteIndices);
+    if (!in.heights.empty() && in.heights.width() == width && in.heights.height() == height) { tileHeights = in.heights.exportRowMajor(); tileHeightsQ.clear(); }
+}
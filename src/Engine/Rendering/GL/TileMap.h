@@ -3,16 +3,47 @@
 #include <string>
 #include <vector>
 #include <glm/vec2.hpp>
+#include "ChunkedRaster.h"
+#include "../../../Core/StringPool.h"
 
-struct Place {
-    std::string name;
-    std::string type; // ex: city, landmark, region
-    int x = 0; // pixels (ou unités carte) depuis l'origine (discrete grid)
-    int y = 0;
+struct RoadSegment { int x, y; }; // point discret sur la grille
+
+// Lieux nommés en colonnes (SoA); nameId/typeId = ids du StringPool de la carte (types: city, landmark, region...)
+struct PlaceTable {
+    std::vector<int32_t>  x, y;     // pixels (ou unités carte) depuis l'origine (discrete grid)
+    std::vector<uint32_t> typeId;
+    std::vector<uint32_t> nameId;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear() { x.clear(); y.clear(); typeId.clear(); nameId.clear(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); typeId.reserve(n); nameId.reserve(n); }
+    uint32_t add(int32_t px, int32_t py, uint32_t type, uint32_t name) {
+        x.push_back(px); y.push_back(py); typeId.push_back(type); nameId.push_back(name); return (uint32_t)x.size() - 1;
+    }
 };
 
-struct RoadSegment { int x, y; }; // point discret sur la grille
-struct Road { std::vector<RoadSegment> points; };
+// Routes à plat: tous les points contigus, route i = points[offsets[i], offsets[i+1])
+struct RoadTable {
+    struct View { const RoadSegment* points; uint32_t count; const RoadSegment* begin() const { return points; } const RoadSegment* end() const { return points + count; } };
+    std::vector<RoadSegment> points;
+    std::vector<uint32_t> offsets{0u};
+
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return offsets.size() <= 1; }
+    View road(size_t i) const { return { points.data() + offsets[i], offsets[i + 1] - offsets[i] }; }
+    void clear() { points.clear(); offsets.assign(1, 0u); }
+    void reserve(size_t roads, size_t pts) { offsets.reserve(roads + 1); points.reserve(pts); }
+    // Construction: addPoint() puis commitRoad(); une route de moins de minPoints points est abandonnée
+    // (minPoints = 0: route vide conservée, les index des routes suivantes restent ceux de la source)
+    void addPoint(int px, int py) { points.push_back({ px, py }); }
+    size_t pendingPoints() const { return points.size() - offsets.back(); }
+    bool commitRoad(size_t minPoints = 1) {
+        if (pendingPoints() < minPoints) { points.resize(offsets.back()); return false; }
+        offsets.push_back((uint32_t)points.size()); return true;
+    }
+};
+struct River { std::vector<RoadSegment> points; uint32_t flow = 0; uint32_t watershed = 0; }; // polyligne amont -> aval, flow = cellules drainées à l'aval
 
 // New: raw polygon vertex (float world space)
 struct PolyVertex { float x,y; uint16_t country; };
@@ -23,6 +54,13 @@ struct AdaptiveCell { float x,y,w,h; uint16_t paletteIndex; float meanHeight; };
 
 struct CountryInfo { int id = 0; std::string name; float x = 0.f; float y = 0.f; }; // position représentative (centroïde)
 
+// Disposition optionnelle des rasters TileMap en chunks 64x64 Z-order (passes de voisinage);
+// les vecteurs ligne de TileMap restent la référence (GPU, fichiers, importeurs)
+struct TileMapChunkedLayers {
+    ChunkedRaster<uint16_t> tiles, countries, paletteIndices;
+    ChunkedRaster<float> heights;
+};
+
 // Minimal 2D tile map for far zoom (top-down world view)
 struct TileMap {
     int width = 0;   // in tiles (discrete grid width for index texture fallback)
@@ -32,14 +70,19 @@ struct TileMap {
     std::vector<uint16_t> tiles; // index into atlas regions OR biome id raster (importer populates)
     std::vector<uint16_t> countries; // id de pays par tuile (facultatif)
     std::vector<uint32_t> countryColorsRGB; // couleur politique par countryId (packed 0xRRGGBB), index 0 réservé
-    std::vector<Place> places;   // lieux nommés optionnels
-    std::vector<Road> roads;     // routes (liste de points discrétisés)
+    StringPool strings;          // noms et types internés (lieux...)
+    PlaceTable places;           // lieux nommés optionnels
+    RoadTable roads;             // routes (points discrétisés contigus)
     std::vector<std::string> biomeNames; // indexé par biomeId, pour debug (peut être vide si non fourni)
     std::vector<uint32_t> biomeColorsRGB; // couleur originale du biome (0xRRGGBB) indexé par biomeId
     std::vector<uint64_t> biomeSeeds; // seed procédurale par biome (0 = non initialisé)
-    std::vector<float> tileHeights; // hauteur normalisée par cellule raster (width*height)
+    std::vector<float> tileHeights; // hauteur normalisée par cellule raster (width*height), vide si quantifiée seule
+    std::vector<uint16_t> tileHeightsQ; // hauteurs quantifiées 16 bits (optionnel): h = heightQOffset + q*heightQScale
+    float heightQScale = 0.f, heightQOffset = 0.f;
     std::vector<uint16_t> paletteIndices; // palette index par pixel (0 deep,1 shallow, >=2 biome+2)
     std::vector<CountryInfo> countryInfos; // infos pays (id interne, nom, position)
+    std::vector<River> rivers;   // fleuves (Hydrology::Generate)
+    std::vector<uint32_t> watersheds; // ID bassin versant par cellule (width*height), 0 = mer
 
     // New polygonal data (world space continuous coordinates)
     float worldMaxX = 0.f; // original Azgaar maxX
@@ -51,4 +94,26 @@ struct TileMap {
     std::vector<AdaptiveCell> adaptiveCells; // adaptive coarse cells for L1 political rendering
 
     bool loadFromFile(const std::string& path); // parses a simple text or json map
+
+    std::string_view placeName(size_t i) const { return strings.view(places.nameId[i]); }
+    std::string_view placeType(size_t i) const { return strings.view(places.typeId[i]); }
+    uint32_t addPlace(int x, int y, std::string_view type, std::string_view name) { return places.add(x, y, strings.intern(type), strings.intern(name)); }
+
+    // Accès uniforme aux hauteurs (float prioritaire, sinon couche quantifiée)
+    bool hasHeights() const { return !tileHeights.empty() || !tileHeightsQ.empty(); }
+    bool heightsQuantized() const { return tileHeights.empty() && !tileHeightsQ.empty(); }
+    float heightAt(size_t idx) const {
+        if (idx < tileHeights.size()) return tileHeights[idx];
+        if (idx < tileHeightsQ.size()) return heightQOffset + (float)tileHeightsQ[idx] * heightQScale;
+        return 0.f;
+    }
+    float heightAt(int x, int y) const { return heightAt((size_t)y * width + x); }
+    float sampleHeight(float wx, float wy) const; // bilinéaire en coordonnées monde (bornée à la grille), 0 sans hauteurs
+    const float* heightData(std::vector<float>& scratch) const; // tileHeights.data() ou décodage dans scratch
+    void quantizeHeights(bool releaseFloat = true); // encode tileHeights (plage land/water min..max) -> tileHeightsQ
+    void unpackHeights(); // restaure tileHeights depuis tileHeightsQ (avant écriture)
+
+    // Conversion disposition ligne <-> chunks (couches vides ou de taille incohérente ignorées)
+    void exportChunked(TileMapChunkedLayers& out) const;
+    void importChunked(const TileMapChunkedLayers& in); // écrit tileHeights (float), la couche quantifiée est invalidée
 };
@@ -1,6 +1,9 @@
 #include "FarMapRenderer.h"
+#include "../Camera.h"
+#include "../../../Core/Profiler.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <cmath>
 #include <random>
 #include <array>
@@ -46,6 +49,7 @@ void FarMapRenderer::shutdown() {
 }
 
 void FarMapRenderer::rebuild(const TileMap* map) {
+    PROFILE_ZONE("FarMap::rebuild");
     buildPalette(map);
     buildCountryIndexTexture(map);
     buildRoadBuffers(map);
@@ -142,10 +146,13 @@ void FarMapRenderer::buildRoadBuffers(const TileMap* map) {
     float sx = (map->width>1 && map->worldMaxX>0)? map->worldMaxX / (float)(map->width -1) : 1.f;
     float sy = (map->height>1 && map->worldMaxY>0)? map->worldMaxY / (float)(map->height-1) : 1.f;
     std::vector<glm::vec2> verts; std::vector<unsigned int> indices; const unsigned int restart = 0xFFFFFFFFu;
-    for (auto& r : map->roads) {
-        if (r.points.size()<2) continue; unsigned int base = (unsigned int)verts.size();
-        for (auto& p : r.points) verts.emplace_back(p.x * sx, p.y * sy);
-        for (size_t i=0;i<r.points.size(); ++i) indices.push_back(base + (unsigned int)i);
+    const RoadTable& roads = map->roads;
+    verts.reserve(roads.points.size()); indices.reserve(roads.points.size() + roads.size());
+    for (size_t r=0; r<roads.size(); ++r) {
+        RoadTable::View rv = roads.road(r);
+        if (rv.count<2) continue; unsigned int base = (unsigned int)verts.size();
+        for (auto& p : rv) verts.emplace_back(p.x * sx, p.y * sy);
+        for (uint32_t i=0;i<rv.count; ++i) indices.push_back(base + i);
         indices.push_back(restart);
     }
     if (verts.empty()) return;
@@ -174,8 +181,9 @@ void FarMapRenderer::buildCrossesBuffer(const TileMap* map) {
     float sx = (map->width>1 && map->worldMaxX>0)? map->worldMaxX / (float)(map->width -1) : 1.f;
     float sy = (map->height>1 && map->worldMaxY>0)? map->worldMaxY / (float)(map->height-1) : 1.f;
     std::vector<glm::vec2> lines; lines.reserve(map->places.size()*4*2);
-    for (auto& plc : map->places) {
-        float x = plc.x * sx; float y = plc.y * sy;
+    const PlaceTable& places = map->places;
+    for (size_t i=0; i<places.size(); ++i) {
+        float x = places.x[i] * sx; float y = places.y[i] * sy;
         lines.emplace_back(x-2,y); lines.emplace_back(x+2,y);
         lines.emplace_back(x,y-2); lines.emplace_back(x,y+2);
     }
@@ -201,23 +209,46 @@ void FarMapRenderer::rebuildDynamicGrid(const TileMap* /*map*/, float /*zoom*/)
 
 void FarMapRenderer::buildAdaptiveCellsBuffer(const TileMap* map) {
     if (adaptiveVao_) { glDeleteBuffers(1,&adaptiveVbo_); glDeleteVertexArrays(1,&adaptiveVao_); adaptiveVao_=adaptiveVbo_=0; adaptiveInstanceCount_=0; }
+    adaptiveBins_.clear();
     if (!map || map->adaptiveCells.empty()) return;
-    struct Inst { float x,y,w,h; unsigned short idx; unsigned short pad; };
-    std::vector<Inst> inst; inst.reserve(map->adaptiveCells.size());
-    for (auto &c : map->adaptiveCells) inst.push_back({c.x,c.y,c.w,c.h,c.paletteIndex,0});
+    // Instances rangées par case d'une grille kAdaptiveBins^2 (centre de cellule) -> une plage contiguë par case pour le culling
+    const float ww = map->worldMaxX>0? map->worldMaxX : (float)map->width, wh = map->worldMaxY>0? map->worldMaxY : (float)map->height;
+    auto binOf = [&](const AdaptiveCell& c){
+        int bx = std::clamp((int)((c.x + c.w*0.5f) / ww * kAdaptiveBins), 0, kAdaptiveBins-1);
+        int by = std::clamp((int)((c.y + c.h*0.5f) / wh * kAdaptiveBins), 0, kAdaptiveBins-1);
+        return by*kAdaptiveBins + bx;
+    };
+    std::vector<uint32_t> start(kAdaptiveBins*kAdaptiveBins + 1, 0);
+    for (auto &c : map->adaptiveCells) start[binOf(c)+1]++;
+    for (size_t b=1; b<start.size(); ++b) start[b] += start[b-1];
+    struct Inst { float x,y,w,h; float mean; unsigned short idx; unsigned short pad; };
+    std::vector<Inst> inst(map->adaptiveCells.size());
+    adaptiveBins_.resize(kAdaptiveBins*kAdaptiveBins);
+    std::vector<uint32_t> fill(start.begin(), start.end()-1);
+    for (auto &c : map->adaptiveCells) {
+        int b = binOf(c); inst[fill[b]++] = {c.x,c.y,c.w,c.h,c.meanHeight,c.paletteIndex,0};
+        AdaptiveBin& bin = adaptiveBins_[b];
+        glm::vec2 mn(c.x, c.y), mx(c.x + c.w, c.y + c.h);
+        if (bin.count == 0) { bin.mn = mn; bin.mx = mx; } else { bin.mn = glm::min(bin.mn, mn); bin.mx = glm::max(bin.mx, mx); }
+        bin.count++;
+    }
+    for (size_t b=0; b<adaptiveBins_.size(); ++b) adaptiveBins_[b].first = start[b];
     glGenVertexArrays(1,&adaptiveVao_); glBindVertexArray(adaptiveVao_);
     glGenBuffers(1,&adaptiveVbo_); glBindBuffer(GL_ARRAY_BUFFER, adaptiveVbo_);
     glBufferData(GL_ARRAY_BUFFER, inst.size()*sizeof(Inst), inst.data(), GL_STATIC_DRAW);
     glEnableVertexAttribArray(0); glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,sizeof(Inst),(void*)0);
-    glEnableVertexAttribArray(1); glVertexAttribIPointer(1,1,GL_UNSIGNED_SHORT,sizeof(Inst),(void*)(4*sizeof(float)));
-    glVertexAttribDivisor(0,1); glVertexAttribDivisor(1,1);
+    glEnableVertexAttribArray(1); glVertexAttribIPointer(1,1,GL_UNSIGNED_SHORT,sizeof(Inst),(void*)(5*sizeof(float)));
+    glEnableVertexAttribArray(2); glVertexAttribPointer(2,1,GL_FLOAT,GL_FALSE,sizeof(Inst),(void*)(4*sizeof(float)));
+    glVertexAttribDivisor(0,1); glVertexAttribDivisor(1,1); glVertexAttribDivisor(2,1);
     glBindVertexArray(0);
     adaptiveInstanceCount_ = (int)inst.size();
 }
 
-void FarMapRenderer::render(const TileMap* map, const glm::mat4& vp, float zoom) {
+void FarMapRenderer::render(const TileMap* map, const Camera& cam, float zoom) {
     static constexpr float kFarMapMaxZoom = 7.5f;
     if (!map) return; if (zoom > kFarMapMaxZoom) return;
+    PROFILE_ZONE("FarMap::render");
+    const glm::mat4& vp = cam.viewProj();
     if (adaptiveVao_==0 && map && !map->adaptiveCells.empty()) buildAdaptiveCellsBuffer(map);
 
     // Construire palettes pays si besoin
@@ -256,22 +287,6 @@ void main(){ vec4 base = biomeColor(vIdx); base.rgb = applyHeight(base.rgb, vIdx
     if(map){
         // paletteUBO déjà contient les bonnes couleurs; rien à refaire sauf si biomes > 254
     }
-    // Rebuild adaptive buffer with meanHeight attribute if not yet (add new attribute)
-    if (adaptiveVao_ && map && !map->adaptiveCells.empty()) {
-        // Recreate buffer with extended Inst struct if missing attribute 2
-        glDeleteBuffers(1,&adaptiveVbo_); glDeleteVertexArrays(1,&adaptiveVao_); adaptiveVbo_=adaptiveVao_=0; adaptiveInstanceCount_=0;
-        struct Inst { float x,y,w,h; float mean; unsigned short idx; unsigned short pad; };
-        std::vector<Inst> inst; inst.reserve(map->adaptiveCells.size());
-        for(auto &c: map->adaptiveCells){ inst.push_back({c.x,c.y,c.w,c.h,c.meanHeight,c.paletteIndex,0}); }
-        glGenVertexArrays(1,&adaptiveVao_); glBindVertexArray(adaptiveVao_);
-        glGenBuffers(1,&adaptiveVbo_); glBindBuffer(GL_ARRAY_BUFFER, adaptiveVbo_);
-        glBufferData(GL_ARRAY_BUFFER, inst.size()*sizeof(Inst), inst.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0); glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,sizeof(Inst),(void*)0);
-        glEnableVertexAttribArray(1); glVertexAttribIPointer(1,1,GL_UNSIGNED_SHORT,sizeof(Inst),(void*)(5*sizeof(float)));
-        glEnableVertexAttribArray(2); glVertexAttribPointer(2,1,GL_FLOAT,GL_FALSE,sizeof(Inst),(void*)(4*sizeof(float)));
-        glVertexAttribDivisor(0,1); glVertexAttribDivisor(1,1); glVertexAttribDivisor(2,1);
-        glBindVertexArray(0); adaptiveInstanceCount_=(int)inst.size();
-    }
     if (adaptiveVao_ && adaptiveInstanceCount_>0) {
         glUseProgram(adaptProg2);
         glUniformMatrix4fv(glGetUniformLocation(adaptProg2,"uMVP"),1,GL_FALSE,&vp[0][0]);
@@ -284,7 +299,18 @@ void main(){ vec4 base = biomeColor(vIdx); base.rgb = applyHeight(base.rgb, vIdx
         glUniform2i(glGetUniformLocation(adaptProg2,"uGridSize"), map->width, map->height);
         glUniform2f(glGetUniformLocation(adaptProg2,"uWorldSize"), map->worldMaxX, map->worldMaxY);
         if (countryIndexTex_) { glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D,countryIndexTex_); glUniform1i(glGetUniformLocation(adaptProg2,"uCountryTex"),0); }
-        glBindVertexArray(adaptiveVao_); glDrawArraysInstanced(GL_TRIANGLES,0,6,adaptiveInstanceCount_); glBindVertexArray(0);
+        // Cases hors caméra ignorées (carte à plat z=0), plages contiguës fusionnées
+        glBindVertexArray(adaptiveVao_); visibleAdaptive_ = 0;
+        uint32_t runFirst = 0, runCount = 0;
+        for (const AdaptiveBin& bin : adaptiveBins_) {
+            if (bin.count == 0 || !cam.isVisible(glm::vec3(bin.mn.x, bin.mn.y, 0.f), glm::vec3(bin.mx.x, bin.mx.y, 0.f))) continue;
+            visibleAdaptive_ += (int)bin.count;
+            if (runCount && runFirst + runCount == bin.first) { runCount += bin.count; continue; }
+            if (runCount) glDrawArraysInstancedBaseInstance(GL_TRIANGLES,0,6,(GLsizei)runCount,runFirst);
+            runFirst = bin.first; runCount = bin.count;
+        }
+        if (runCount) glDrawArraysInstancedBaseInstance(GL_TRIANGLES,0,6,(GLsizei)runCount,runFirst);
+        glBindVertexArray(0);
     }
 
     // Routes
@@ -3,9 +3,12 @@
 #include <cstdint>
 #include <array> // added for std::array
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include "../GL/TileMap.h"
 
+class Camera;
+
 // Rend la carte lointaine (niveau 1) optimisée: texture d'indices pays (R8), palette GPU, VBO routes/croix batchés.
 class FarMapRenderer {
 public:
@@ -13,7 +16,8 @@ public:
     void shutdown();
     void rebuild(const TileMap* map); // si la carte change (regen)
 
-    void render(const TileMap* map, const glm::mat4& vp, float zoom);
+    void render(const TileMap* map, const Camera& cam, float zoom);
+    int visibleAdaptiveCells() const { return visibleAdaptive_; } // dernière frame (après culling)
 
     void setShowGrid(bool v) { showGrid_ = v; }
     bool showGrid() const { return showGrid_; }
@@ -62,6 +66,10 @@ private:
     int polyVertexCount_ = 0; // NEW
     int gridVertexCount_ = 0; // NEW
     int adaptiveInstanceCount_ = 0; // number of adaptive cells
+    static constexpr int kAdaptiveBins = 32; // grille de culling des cellules adaptatives (par côté)
+    struct AdaptiveBin { uint32_t first = 0, count = 0; glm::vec2 mn{0.f}, mx{0.f}; };
+    std::vector<AdaptiveBin> adaptiveBins_; // plages d'instances par case (VBO trié par case)
+    int visibleAdaptive_ = 0;
     float lastGridStep_ = -1.f; // NEW
     std::vector<glm::vec3> countryColors_; // CPU palette
     bool showGrid_ = true; // (legacy, unused visually)
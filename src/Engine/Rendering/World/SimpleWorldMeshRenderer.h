@@ -8,22 +8,28 @@
 #include <cstdint>
 #include <vector>
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include "../GL/TileMap.h"
 
+class Camera;
+
 class SimpleWorldMeshRenderer {
 public:
 	bool init(const TileMap* map);
 	void shutdown();
 	void rebuild(const TileMap* map); // re-génère le mesh (si map changée)
-	void render(const TileMap* map, const glm::mat4& vp, float zoom, bool force = false);
+	void render(const TileMap* map, const Camera& cam, float zoom, bool force = false); // chunks hors frustum ignorés
 
 	void setHeightShading(bool v){ heightShading_ = v; }
 	bool heightShading() const { return heightShading_; }
 	void setHeightScale(float s){ heightScale_ = s; }
 	float heightScale() const { return heightScale_; }
 
-	// Adaptive refinement near camera
-	void setCamera(float x, float y){ camX_ = x; camY_ = y; }
+	// Culling par chunk (stats de la dernière frame)
+	int chunkCount() const { return (int)(useTess_? chunksT_.size() : chunks_.size()); }
+	int visibleChunks() const { return visibleChunks_; }
+
+	// Adaptive refinement near camera (position prise sur la Camera au rendu)
 	void setAdaptive(bool enabled, float radiusUnits, int refineFactor, int outerStep){ adaptiveEnabled_ = enabled; adaptiveRadius_ = radiusUnits; refineFactor_ = refineFactor; outerStep_ = outerStep; needsRebuild_ = true; }
 
 private:
@@ -31,14 +37,22 @@ private:
 	void buildMesh(const TileMap* map);
 	void buildAdaptiveMesh(const TileMap* map);
 	void ensureProgram();
+	// Sous-plage d'indices couvrant un bloc de la grille, boîte XY + hauteurs brutes min/max (Z dépend de heightScale_)
+	struct DrawChunk { uint32_t first = 0, count = 0; glm::vec2 mn{0.f}, mx{0.f}; float hMin = 0.f, hMax = 0.f; };
+	static DrawChunk MakeChunk(const TileMap* map, int x0, int y0, int x1, int y1, float sx, float sy, uint32_t first, uint32_t count);
+	void drawVisible(const std::vector<DrawChunk>& chunks, unsigned int mode, const TileMap* map, const Camera& cam);
 
 private:
 	unsigned int vao_ = 0, vbo_ = 0, ibo_ = 0;
 	unsigned int program_ = 0;    // shader mesh
 	int indexCount_ = 0;
+	std::vector<DrawChunk> chunks_; // maillage CPU: blocs de kMeshChunkCells cellules
 	// Tessellation buffers
 	unsigned int vaoT_ = 0, vboT_ = 0, iboT_ = 0;
 	int indexCountT_ = 0;
+	std::vector<DrawChunk> chunksT_; // grille de patches: blocs de kTessChunkPatches patches
+	std::vector<int> drawCounts_; std::vector<const void*> drawOffsets_; // plages visibles fusionnées (glMultiDrawElements)
+	int visibleChunks_ = 0;
 	bool heightShading_ = true;
 	float heightScale_ = 20.0f; // Z scale for aH (default)
 	// Stats build
@@ -58,6 +72,6 @@ private:
 	void uploadHeightTex(const TileMap* map);
 
 	unsigned int programTess_ = 0; // tessellation pipeline program
-	unsigned int heightTex_ = 0; int hmW_ = 0, hmH_ = 0; // heightmap texture
+	unsigned int heightTex_ = 0; int hmW_ = 0, hmH_ = 0; bool hmQuant_ = false; // heightmap texture (R32F ou R16 si hauteurs quantifiées)
 	bool useTess_ = true; float tessNear_ = 250.f; float tessFar_ = 3000.f; int tessMin_ = 1; int tessMax_ = 16; int tessBaseStep_ = 8;
 };
@@ -0,0 +1,158 @@
+#include "Autosave.h"
+#include "../Rendering/GL/TileMap.h"
+#include "../../Core/Profiler.h"
+#include "../../Core/StringPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+
+Autosave::Autosave(std::string dir, std::string name, AutosavePolicy policy) : dir_(std::move(dir)), name_(std::move(name)), policy_(std::move(policy)) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    // Reprise dans un dossier existant: numérotation après les fichiers présents (le premier appel écrit un checkpoint)
+    for (const File& f : List(dir_, name_)) seq_ = std::max(seq_, f.seq);
+}
+
+std::string Autosave::Path(const std::string& dir, const std::string& name, uint64_t seq, bool full) {
+    char file[64];
+    std::snprintf(file, sizeof(file), "-%08" PRIu64 ".%s.wsav", seq, full ? "full" : "delta");
+    return (std::filesystem::path(dir) / (name + file)).string();
+}
+
+std::vector<Autosave::File> Autosave::List(const std::string& dir, const std::string& name) {
+    std::vector<File> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string f = entry.path().filename().string();
+        if (f.size() <= name.size() + 1 || f.compare(0, name.size() + 1, name + "-") != 0) continue;
+        char kind[8] = {}; unsigned long long seq = 0; int end = 0;
+        if (std::sscanf(f.c_str() + name.size() + 1, "%llu.%5[a-z].wsav%n", &seq, kind, &end) != 2 || f[name.size() + 1 + end] != '\0') continue;
+        const std::string k = kind;
+        if (k == "full" || k == "delta") files.push_back({ (uint64_t)seq, k == "full", entry.path().string() });
+    }
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.seq != b.seq ? a.seq < b.seq : a.full > b.full; });
+    return files;
+}
+
+void Autosave::markTiles(std::string_view layer, int x0, int y0, int x1, int y1) {
+    if (x1 <= x0 || y1 <= y0) return;
+    const std::string key(layer);
+    if (!SaveGame::IsRasterLayer(layer)) { markLayer(layer); return; }
+    staleLayers_.insert(key);
+    std::unordered_set<uint32_t>& chunks = dirtyChunks_[key];
+    const int k = SaveGame::kMapChunk;
+    for (int cy=std::max(0, y0) / k; cy<=(y1 - 1) / k; ++cy) for (int cx=std::max(0, x0) / k; cx<=(x1 - 1) / k; ++cx) chunks.insert(((uint32_t)cy << 16) | (uint32_t)cx);
+}
+
+void Autosave::markLayer(std::string_view layer) {
+    dirtyLayers_.emplace(layer); staleLayers_.emplace(layer);
+}
+
+void Autosave::prune() {
+    // Conserve les keepCheckpoints derniers checkpoints et tout ce qui les suit
+    const std::vector<File> files = List(dir_, name_);
+    std::vector<uint64_t> fulls;
+    for (const File& f : files) if (f.full) fulls.push_back(f.seq);
+    if (fulls.size() <= std::max<size_t>(policy_.keepCheckpoints, 1)) return;
+    const uint64_t keepFrom = fulls[fulls.size() - std::max<size_t>(policy_.keepCheckpoints, 1)];
+    std::error_code ec;
+    for (const File& f : files) if (f.seq < keepFrom) std::filesystem::remove(f.path, ec);
+}
+
+bool Autosave::save(Registry& reg, const TileMap* map, uint64_t tick, const StringPool* strings, bool forceFull) {
+    if (writer_.busy()) return false;
+    if (!writer_.wait()) chained_ = false; // écriture précédente en échec: la chaîne repart d'un checkpoint
+    PROFILE_ZONE("Autosave::save");
+    const auto t0 = std::chrono::steady_clock::now();
+    SaveGame::TrackRemovals(reg);
+    prune();
+    const uint64_t seq = seq_ + 1;
+    const bool mapMoved = map && (map != cachedMap_ || map->width != cachedW_ || map->height != cachedH_);
+    bool full = forceFull || !chained_ || deltas_ >= policy_.fullEvery || reg.removalHorizon() > cursor_.last || mapMoved;
+    SaveGame::Snapshot snap;
+    if (!full) {
+        SaveGame::CaptureMeta(tick, snap);
+        SaveGame::CaptureChain({ true, seq, seq_ }, snap);
+        SaveGame::CaptureEntityDelta(reg, cursor_.last, snap);
+        if (map) {
+            for (const std::string& l : dirtyLayers_) SaveGame::CaptureMapLayer(*map, l, snap);
+            for (const auto& [layer, set] : dirtyChunks_) {
+                if (dirtyLayers_.count(layer)) continue;
+                std::vector<uint32_t> chunks(set.begin(), set.end());
+                std::sort(chunks.begin(), chunks.end());
+                if (!SaveGame::CaptureMapChunks(*map, layer, chunks, snap)) SaveGame::CaptureMapLayer(*map, layer, snap);
+            }
+        }
+        if (strings) SaveGame::CaptureStringsSince(*strings, stringsSaved_, snap);
+        full = (double)snap.rawBytes() > policy_.fullRatio * (double)checkpointRaw_;
+    }
+    if (full) {
+        snap = SaveGame::Snapshot{};
+        SaveGame::CaptureMeta(tick, snap);
+        SaveGame::CaptureChain({ false, seq, 0 }, snap);
+        if (map) {
+            // Couches inchangées depuis le checkpoint précédent: sections partagées, pas recopiées
+            if (mapMoved || mapCache_.sections.empty()) { mapCache_ = SaveGame::Snapshot{}; SaveGame::CaptureMap(*map, mapCache_); }
+            else for (const std::string& l : staleLayers_) SaveGame::CaptureMapLayer(*map, l, mapCache_);
+            staleLayers_.clear(); cachedMap_ = map; cachedW_ = map->width; cachedH_ = map->height;
+            for (const SaveGame::Section& s : mapCache_.sections) snap.put(s);
+        }
+        SaveGame::CaptureEntities(reg, snap);
+        if (strings) SaveGame::CaptureStrings(*strings, snap);
+        checkpointRaw_ = snap.rawBytes(); deltas_ = 0;
+    } else ++deltas_;
+    cursor_.since(reg); // clôt la période; curseur enregistré: le Registry garde les retraits jusqu'à la prochaine sauvegarde
+    dirtyChunks_.clear(); dirtyLayers_.clear();
+    stringsSaved_ = strings ? (uint32_t)strings->size() : 0;
+    seq_ = seq; chained_ = true; lastFull_ = full; lastRaw_ = snap.rawBytes();
+    lastCaptureMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return writer_.begin(std::move(snap), Path(dir_, name_, seq, full), policy_.write);
+}
+
+std::vector<std::string> Autosave::FindChain(const std::string& dir, const std::string& name) {
+    const std::vector<File> files = List(dir, name);
+    std::vector<std::string> chain;
+    size_t start = files.size();
+    for (size_t i=files.size(); i-- > 0; ) if (files[i].full) { start = i; break; }
+    if (start == files.size()) return chain;
+    chain.push_back(files[start].path);
+    uint64_t seq = files[start].seq;
+    for (size_t i=start+1; i<files.size(); ++i) {
+        if (files[i].full || files[i].seq == files[start].seq) continue;
+        if (files[i].seq != seq + 1) break; // trou: deltas suivants orphelins
+        chain.push_back(files[i].path); seq = files[i].seq;
+    }
+    return chain;
+}
+
+bool Autosave::LoadLatest(const std::string& dir, const std::string& name, Registry* reg, TileMap* map, const SaveGame::LoadOptions& opt) {
+    const std::vector<std::string> chain = FindChain(dir, name);
+    if (chain.empty()) { std::fprintf(stderr, "[Autosave] Aucun checkpoint %s dans %s\n", name.c_str(), dir.c_str()); return false; }
+    return SaveGame::LoadChain(chain, reg, map, opt);
+}
+
+bool Autosave::Compact(const std::string& dir, const std::string& name, const SaveGame::WriteOptions& opt) {
+    PROFILE_ZONE("Autosave::Compact");
+    const std::vector<std::string> chain = FindChain(dir, name);
+    if (chain.size() <= 1) return !chain.empty();
+    SaveGame::FileIndex first, last; SaveGame::ChainInfo tail;
+    if (!SaveGame::ReadIndex(chain.front(), first) || !SaveGame::ReadIndex(chain.back(), last) || !SaveGame::ReadChain(chain.back(), tail)) return false;
+    const bool hasMap = first.find("MAP.header") != nullptr, hasStrings = first.find("STRS") != nullptr;
+    Registry reg; TileMap map; StringPool strings;
+    SaveGame::LoadOptions lo; lo.strings = hasStrings ? &strings : nullptr;
+    if (!SaveGame::LoadChain(chain, &reg, hasMap ? &map : nullptr, lo)) return false;
+    SaveGame::Snapshot snap;
+    SaveGame::CaptureMeta(last.tick, snap);
+    SaveGame::CaptureChain({ false, tail.seq, 0 }, snap);
+    if (hasMap) SaveGame::CaptureMap(map, snap);
+    SaveGame::CaptureEntities(reg, snap);
+    if (hasStrings) SaveGame::CaptureStrings(strings, snap);
+    const std::string out = Path(dir, name, tail.seq, true);
+    if (!SaveGame::Write(snap, out, opt)) return false;
+    std::error_code ec;
+    for (const std::string& f : chain) if (f != out) std::filesystem::remove(f, ec);
+    std::printf("[Autosave] %s: %zu fichiers compactés en %s\n", name.c_str(), chain.size(), out.c_str());
+    return true;
+}
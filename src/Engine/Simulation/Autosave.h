@@ -0,0 +1,72 @@
+#pragma once
+#include "SaveGame.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Sauvegardes automatiques incrémentales: une sauvegarde complète (checkpoint) puis des deltas qui n'écrivent que
+// les colonnes/lignes de composants et les chunks de carte modifiés depuis la sauvegarde précédente.
+// Fichiers: <dir>/<name>-<séquence>.full.wsav | .delta.wsav; chargement = dernier checkpoint + deltas suivants.
+// Checkpoint forcé: premier appel, fullEvery deltas, delta plus gros que fullRatio x le checkpoint, écriture
+// précédente en échec, ou journaux de retraits du Registry incomplets (clear, chargement; l'Autosave garde un
+// ChangeCursor, donc pas de purge entre deux sauvegardes). Les modifications de carte ne sont pas détectées:
+// les signaler par markTiles/markLayer.
+struct AutosavePolicy {
+    uint32_t fullEvery = 16;        // deltas entre deux checkpoints
+    double fullRatio = 0.5;         // delta > ratio x checkpoint brut -> checkpoint
+    uint32_t keepCheckpoints = 2;   // chaînes conservées sur disque
+    SaveGame::WriteOptions write;   // niveau zstd, dictionnaire
+};
+
+class Autosave {
+public:
+    explicit Autosave(std::string dir, std::string name = "autosave", AutosavePolicy policy = {});
+
+    // Modifications de carte depuis la dernière sauvegarde: rectangle [x0,x1) x [y0,y1) d'une couche raster,
+    // ou couche entière (non raster, ou raster redimensionné)
+    void markTiles(std::string_view layer, int x0, int y0, int x1, int y1);
+    void markLayer(std::string_view layer);
+
+    // Capture sur le thread appelant puis écriture en tâche de fond; false si l'écriture précédente est en cours
+    bool save(Registry& reg, const TileMap* map, uint64_t tick, const StringPool* strings = nullptr, bool forceFull = false);
+    bool busy() const { return writer_.busy(); }
+    bool wait() { return writer_.wait(); }
+
+    uint64_t sequence() const { return seq_; }
+    bool lastWasFull() const { return lastFull_; }
+    size_t lastRawBytes() const { return lastRaw_; }
+    double lastCaptureMs() const { return lastCaptureMs_; }
+    double lastWriteMs() const { return writer_.lastWriteMs(); }
+
+    // Dernier checkpoint de dir/name et deltas consécutifs qui le suivent (vide si aucun)
+    static std::vector<std::string> FindChain(const std::string& dir, const std::string& name);
+    static bool LoadLatest(const std::string& dir, const std::string& name, Registry* reg, TileMap* map, const SaveGame::LoadOptions& opt = {});
+    // Rejoue la dernière chaîne et la remplace par un checkpoint de même séquence (les deltas suivants s'y rattachent)
+    static bool Compact(const std::string& dir, const std::string& name, const SaveGame::WriteOptions& opt = {});
+
+private:
+    static std::string Path(const std::string& dir, const std::string& name, uint64_t seq, bool full);
+    struct File { uint64_t seq; bool full; std::string path; };
+    static std::vector<File> List(const std::string& dir, const std::string& name); // triés par séquence
+    void prune();
+
+    std::string dir_, name_;
+    AutosavePolicy policy_;
+    SaveGame::AsyncWriter writer_;
+    uint64_t seq_ = 0;
+    bool chained_ = false, lastFull_ = false;
+    ECS::ChangeCursor cursor_;      // last = tick clos à la sauvegarde précédente
+    uint32_t deltas_ = 0;
+    size_t checkpointRaw_ = 0, lastRaw_ = 0;
+    double lastCaptureMs_ = 0.0;
+    uint32_t stringsSaved_ = 0;
+    // Carte: chunks et couches modifiés depuis la dernière sauvegarde; couches périmées dans mapCache_ (sections
+    // du dernier checkpoint, réutilisées telles quelles par le suivant si la couche n'a pas bougé)
+    std::unordered_map<std::string, std::unordered_set<uint32_t>> dirtyChunks_;
+    std::unordered_set<std::string> dirtyLayers_, staleLayers_;
+    SaveGame::Snapshot mapCache_;
+    const TileMap* cachedMap_ = nullptr;
+    int cachedW_ = 0, cachedH_ = 0;
+};
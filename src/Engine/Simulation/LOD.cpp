@@ -0,0 +1,43 @@
+#include "LOD.h"
+#include "Scheduler.h"
+
+namespace SimLOD {
+
+const char* LevelName(Level level) {
+    switch (level) { case Level::World: return "World"; case Level::City: return "City"; case Level::Character: return "Character"; }
+    return "?";
+}
+
+void Policy::set(const std::string& system, double worldHz, double cityHz, double characterHz) {
+    Rule* r = nullptr;
+    for (auto& it : rules_) if (it.system == system) { r = &it; break; }
+    if (!r) { rules_.push_back(Rule{}); r = &rules_.back(); r->system = system; }
+    r->hz[0] = worldHz; r->hz[1] = cityHz; r->hz[2] = characterHz;
+}
+
+size_t Policy::apply(Scheduler& scheduler, Level level) const {
+    size_t found = 0;
+    for (auto& r : rules_) {
+        size_t idx = scheduler.find(r.system); if (idx == Scheduler::npos) continue;
+        double hz = r.hz[(int)level];
+        scheduler.setEnabled(idx, hz != kOff);
+        if (hz != kOff) scheduler.setRate(idx, hz);
+        ++found;
+    }
+    return found;
+}
+
+Policy Policy::Default() {
+    Policy p;
+    //       système        monde   ville   personnage
+    p.set("Diplomacy",      0.1,    0.1,    0.1);
+    p.set("Economy",        1.0,    1.0,    1.0);
+    p.set("Fog",            1.0,    10.0,   10.0);
+    p.set("Population",     0.1,    1.0,    1.0);
+    p.set("AI",             1.0,    10.0,   kEveryTick);
+    p.set("Movement",       10.0,   kEveryTick, kEveryTick);
+    p.set("Combat",         kOff,   10.0,   kEveryTick);
+    return p;
+}
+
+}
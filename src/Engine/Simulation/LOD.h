@@ -1,3 +1,39 @@
 #pragma once
-// [6][14] TODO: Règles LOD sim/rendu, activation/désactivation de systèmes selon niveau/caméra
-namespace SimLOD { /* ... */ }
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Scheduler;
+
+// [6][14] LOD simulation: fréquence de chaque système selon le niveau de jeu (monde agrégé, ville, personnage).
+// Changer de niveau applique les fréquences au Scheduler (effectif au tick suivant, phase conservée).
+namespace SimLOD {
+
+enum class Level { World = 0, City = 1, Character = 2 };
+constexpr int kLevelCount = 3;
+const char* LevelName(Level level);
+
+constexpr double kEveryTick = 0.0;   // fréquence du pas fixe
+constexpr double kOff = -1.0;        // système désactivé à ce niveau
+
+struct Rule {
+    std::string system;              // nom du SystemDesc
+    double hz[kLevelCount] = { kEveryTick, kEveryTick, kEveryTick };
+};
+
+class Policy {
+public:
+    void set(const std::string& system, double worldHz, double cityHz, double characterHz);
+    const std::vector<Rule>& rules() const { return rules_; }
+
+    // Applique les règles du niveau; retourne le nombre de systèmes trouvés dans le scheduler
+    size_t apply(Scheduler& scheduler, Level level) const;
+
+    // Préréglage: diplomatie/économie/brouillard lents au niveau monde, IA et déplacements rapides en gros plan
+    static Policy Default();
+
+private:
+    std::vector<Rule> rules_;
+};
+
+}
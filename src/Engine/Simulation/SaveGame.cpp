@@ -0,0 +1,926 @@
+#include "SaveGame.h"
+#include "../Rendering/GL/TileMap.h"
+#include "../ECS/Components/Transform.h"
+#include "../ECS/Components/Name.h"
+#include "../ECS/Components/Residence.h"
+#include "../Gameplay/City/Building.h"
+#include "../Gameplay/WorldMap/Country.h"
+#include "../Gameplay/Character/Item.h"
+#include "../../Core/Profiler.h"
+#include "../../Core/StringPool.h"
+#include <zstd.h>
+#include <zdict.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace SaveGame {
+
+namespace {
+
+// ---- Sérialisation binaire ----
+
+struct Out {
+    Bytes& b;
+    void raw(const void* p, size_t n) { const size_t at = b.size(); b.resize(at + n); if (n) std::memcpy(b.data() + at, p, n); }
+    template<class T> void pod(const T& v) { static_assert(std::is_trivially_copyable_v<T>); raw(&v, sizeof(T)); }
+    template<class T> void array(const std::vector<T>& v) { pod<uint64_t>(v.size()); raw(v.data(), v.size() * sizeof(T)); }
+    void str(std::string_view s) { pod<uint32_t>((uint32_t)s.size()); raw(s.data(), s.size()); }
+};
+
+// Lecture bornée: toute lecture hors limites met ok à false et renvoie des valeurs nulles
+struct In {
+    const std::byte* p; const std::byte* end; bool ok = true;
+    const std::byte* take(size_t n) { if (!ok || (size_t)(end - p) < n) { ok = false; return nullptr; } const std::byte* r = p; p += n; return r; }
+    template<class T> T pod() { T v{}; if (const std::byte* s = take(sizeof(T))) std::memcpy(&v, s, sizeof(T)); return v; }
+    template<class T> void array(std::vector<T>& v) {
+        const uint64_t n = pod<uint64_t>();
+        if (!ok || n > (uint64_t)(end - p) / std::max<size_t>(sizeof(T), 1)) { ok = false; v.clear(); return; }
+        v.resize((size_t)n);
+        if (const std::byte* s = take((size_t)n * sizeof(T)); s && n) std::memcpy(v.data(), s, (size_t)n * sizeof(T));
+    }
+    std::string str() { const uint32_t n = pod<uint32_t>(); const std::byte* s = take(n); return s ? std::string(reinterpret_cast<const char*>(s), n) : std::string(); }
+};
+
+// Chaînes 1..size()-1 (id 0 = vide implicite), concaténées avec leur '\0'
+void WriteStrings(const StringPool& pool, Out& o) {
+    o.pod<uint32_t>((uint32_t)pool.size());
+    for (uint32_t i=1; i<pool.size(); ++i) { std::string_view s = pool.view(i); o.raw(s.data(), s.size()); o.pod<char>('\0'); }
+}
+
+// Interne dans l'ordre sauvé; false si un id obtenu diffère de l'id sauvé (pool cible déjà rempli autrement)
+bool ReadStrings(In& in, StringPool& pool) {
+    const uint32_t n = in.pod<uint32_t>();
+    bool same = true;
+    for (uint32_t i=1; i<n && in.ok; ++i) {
+        const char* s = reinterpret_cast<const char*>(in.p);
+        const void* nul = std::memchr(s, 0, (size_t)(in.end - in.p));
+        if (!nul) { in.ok = false; break; }
+        const size_t len = (size_t)(static_cast<const char*>(nul) - s);
+        same = pool.intern(std::string_view(s, len)) == i && same;
+        in.p += len + 1;
+    }
+    return same;
+}
+
+std::shared_ptr<const Bytes> Make(Bytes&& b) { return std::make_shared<const Bytes>(std::move(b)); }
+
+// ---- Couches TileMap: une section chacune, chargée dans une carte intermédiaire puis déplacée ----
+
+struct MapLayer {
+    const char* name;
+    void (*save)(const TileMap&, Out&);
+    void (*load)(In&, TileMap&);
+    void (*move)(TileMap& dst, TileMap& src);
+};
+
+const MapLayer kMapLayers[] = {
+    { "header",
+      [](const TileMap& m, Out& o) {
+          o.pod<int32_t>(m.width); o.pod<int32_t>(m.height); o.pod<int32_t>(m.tileSize);
+          o.pod(m.heightQScale); o.pod(m.heightQOffset); o.pod(m.worldMaxX); o.pod(m.worldMaxY); o.pod(m.kmPerUnit);
+          o.pod(m.landMinHeight); o.pod(m.landMaxHeight); o.pod(m.waterMinHeight); o.pod(m.waterMaxHeight);
+          o.str(m.atlasImagePath);
+      },
+      [](In& in, TileMap& m) {
+          m.width = in.pod<int32_t>(); m.height = in.pod<int32_t>(); m.tileSize = in.pod<int32_t>();
+          m.heightQScale = in.pod<float>(); m.heightQOffset = in.pod<float>(); m.worldMaxX = in.pod<float>(); m.worldMaxY = in.pod<float>(); m.kmPerUnit = in.pod<float>();
+          m.landMinHeight = in.pod<float>(); m.landMaxHeight = in.pod<float>(); m.waterMinHeight = in.pod<float>(); m.waterMaxHeight = in.pod<float>();
+          m.atlasImagePath = in.str();
+      },
+      [](TileMap& d, TileMap& s) {
+          d.width = s.width; d.height = s.height; d.tileSize = s.tileSize; d.heightQScale = s.heightQScale; d.heightQOffset = s.heightQOffset;
+          d.worldMaxX = s.worldMaxX; d.worldMaxY = s.worldMaxY; d.kmPerUnit = s.kmPerUnit;
+          d.landMinHeight = s.landMinHeight; d.landMaxHeight = s.landMaxHeight; d.waterMinHeight = s.waterMinHeight; d.waterMaxHeight = s.waterMaxHeight;
+          d.atlasImagePath = std::move(s.atlasImagePath);
+      } },
+    { "tiles", [](const TileMap& m, Out& o) { o.array(m.tiles); }, [](In& in, TileMap& m) { in.array(m.tiles); }, [](TileMap& d, TileMap& s) { d.tiles = std::move(s.tiles); } },
+    { "countries", [](const TileMap& m, Out& o) { o.array(m.countries); }, [](In& in, TileMap& m) { in.array(m.countries); }, [](TileMap& d, TileMap& s) { d.countries = std::move(s.countries); } },
+    { "heights", [](const TileMap& m, Out& o) { o.array(m.tileHeights); }, [](In& in, TileMap& m) { in.array(m.tileHeights); }, [](TileMap& d, TileMap& s) { d.tileHeights = std::move(s.tileHeights); } },
+    { "heightsQ", [](const TileMap& m, Out& o) { o.array(m.tileHeightsQ); }, [](In& in, TileMap& m) { in.array(m.tileHeightsQ); }, [](TileMap& d, TileMap& s) { d.tileHeightsQ = std::move(s.tileHeightsQ); } },
+    { "palette", [](const TileMap& m, Out& o) { o.array(m.paletteIndices); }, [](In& in, TileMap& m) { in.array(m.paletteIndices); }, [](TileMap& d, TileMap& s) { d.paletteIndices = std::move(s.paletteIndices); } },
+    { "watersheds", [](const TileMap& m, Out& o) { o.array(m.watersheds); }, [](In& in, TileMap& m) { in.array(m.watersheds); }, [](TileMap& d, TileMap& s) { d.watersheds = std::move(s.watersheds); } },
+    { "colors",
+      [](const TileMap& m, Out& o) {
+          o.array(m.countryColorsRGB); o.array(m.biomeColorsRGB); o.array(m.biomeSeeds);
+          o.pod<uint32_t>((uint32_t)m.biomeNames.size()); for (const std::string& s : m.biomeNames) o.str(s);
+      },
+      [](In& in, TileMap& m) {
+          in.array(m.countryColorsRGB); in.array(m.biomeColorsRGB); in.array(m.biomeSeeds);
+          const uint32_t n = in.pod<uint32_t>(); m.biomeNames.clear();
+          for (uint32_t i=0; i<n && in.ok; ++i) m.biomeNames.push_back(in.str());
+      },
+      [](TileMap& d, TileMap& s) { d.countryColorsRGB = std::move(s.countryColorsRGB); d.biomeColorsRGB = std::move(s.biomeColorsRGB); d.biomeSeeds = std::move(s.biomeSeeds); d.biomeNames = std::move(s.biomeNames); } },
+    { "strings", [](const TileMap& m, Out& o) { WriteStrings(m.strings, o); }, [](In& in, TileMap& m) { m.strings.clear(); ReadStrings(in, m.strings); }, [](TileMap& d, TileMap& s) { d.strings = std::move(s.strings); } },
+    { "places",
+      [](const TileMap& m, Out& o) { o.array(m.places.x); o.array(m.places.y); o.array(m.places.typeId); o.array(m.places.nameId); },
+      [](In& in, TileMap& m) {
+          PlaceTable& p = m.places; in.array(p.x); in.array(p.y); in.array(p.typeId); in.array(p.nameId);
+          if (p.y.size() != p.x.size() || p.typeId.size() != p.x.size() || p.nameId.size() != p.x.size()) in.ok = false;
+      },
+      [](TileMap& d, TileMap& s) { d.places = std::move(s.places); } },
+    { "roads",
+      [](const TileMap& m, Out& o) { o.array(m.roads.points); o.array(m.roads.offsets); },
+      [](In& in, TileMap& m) {
+          RoadTable& r = m.roads; in.array(r.points); in.array(r.offsets);
+          if (r.offsets.empty() || r.offsets.front() != 0 || r.offsets.back() != r.points.size() || !std::is_sorted(r.offsets.begin(), r.offsets.end())) in.ok = false;
+      },
+      [](TileMap& d, TileMap& s) { d.roads = std::move(s.roads); } },
+    { "rivers",
+      [](const TileMap& m, Out& o) { o.pod<uint32_t>((uint32_t)m.rivers.size()); for (const River& r : m.rivers) { o.array(r.points); o.pod(r.flow); o.pod(r.watershed); } },
+      [](In& in, TileMap& m) {
+          const uint32_t n = in.pod<uint32_t>(); m.rivers.clear();
+          for (uint32_t i=0; i<n && in.ok; ++i) { River r; in.array(r.points); r.flow = in.pod<uint32_t>(); r.watershed = in.pod<uint32_t>(); m.rivers.push_back(std::move(r)); }
+      },
+      [](TileMap& d, TileMap& s) { d.rivers = std::move(s.rivers); } },
+    { "countryInfos",
+      [](const TileMap& m, Out& o) { o.pod<uint32_t>((uint32_t)m.countryInfos.size()); for (const CountryInfo& c : m.countryInfos) { o.pod<int32_t>(c.id); o.str(c.name); o.pod(c.x); o.pod(c.y); } },
+      [](In& in, TileMap& m) {
+          const uint32_t n = in.pod<uint32_t>(); m.countryInfos.clear();
+          for (uint32_t i=0; i<n && in.ok; ++i) { CountryInfo c; c.id = in.pod<int32_t>(); c.name = in.str(); c.x = in.pod<float>(); c.y = in.pod<float>(); m.countryInfos.push_back(std::move(c)); }
+      },
+      [](TileMap& d, TileMap& s) { d.countryInfos = std::move(s.countryInfos); } },
+    { "polygons",
+      [](const TileMap& m, Out& o) { o.array(m.polygonVertices); o.array(m.cellPolys); o.array(m.adaptiveCells); },
+      [](In& in, TileMap& m) { in.array(m.polygonVertices); in.array(m.cellPolys); in.array(m.adaptiveCells); },
+      [](TileMap& d, TileMap& s) { d.polygonVertices = std::move(s.polygonVertices); d.cellPolys = std::move(s.cellPolys); d.adaptiveCells = std::move(s.adaptiveCells); } },
+};
+constexpr uint16_t kMapLayerVersion = 1;
+constexpr uint16_t kEntsVersion = 1;
+
+// ---- Composants enregistrés ----
+
+std::mutex gSaverMutex;
+std::vector<ComponentSaver> gSavers;
+
+void AddSaver(const ComponentSaver& s) {
+    for (ComponentSaver& o : gSavers) if (o.name == s.name) { o = s; return; }
+    gSavers.push_back(s);
+}
+
+std::vector<ComponentSaver> Savers() {
+    static std::once_flag builtins;
+    std::call_once(builtins, [] {
+        std::lock_guard<std::mutex> lk(gSaverMutex);
+        AddSaver(MakeSaver<Transform>("Transform", 1, nullptr));
+        AddSaver(MakeSaver<Name>("Name", 1, nullptr));
+        AddSaver(MakeSaver<Residence>("Residence", 1, nullptr));
+        AddSaver(MakeSaver<Building>("Building", 1, nullptr));
+        AddSaver(MakeSaver<Country>("Country", 1, nullptr));
+        AddSaver(MakeSaver<Item>("Item", 1, nullptr));
+    });
+    std::lock_guard<std::mutex> lk(gSaverMutex);
+    return gSavers;
+}
+
+// ---- Fichier ----
+
+struct FileHeader {
+    uint32_t magic = kMagic, version = kFormatVersion;
+    uint64_t tick = 0;
+    uint64_t tableOffset = 0;
+    uint32_t sectionCount = 0, reserved = 0;
+};
+static_assert(sizeof(FileHeader) == 32);
+
+bool ReadAt(std::ifstream& f, uint64_t offset, void* dst, size_t n) {
+    f.clear(); f.seekg((std::streamoff)offset);
+    return f.read(static_cast<char*>(dst), (std::streamsize)n) && (size_t)f.gcount() == n;
+}
+
+// Contexte de lecture: fichier + index + dictionnaire chargé à la première section qui en a besoin
+struct Reader {
+    std::string path;
+    std::ifstream file;
+    FileIndex index;
+    ZSTD_DCtx* dctx = nullptr;
+    ZSTD_DDict* ddict = nullptr;
+    bool dictLoaded = false;
+
+    ~Reader() { ZSTD_freeDDict(ddict); ZSTD_freeDCtx(dctx); }
+
+    bool open(const std::string& p) {
+        path = p;
+        file.open(p, std::ios::binary);
+        if (!file) { std::fprintf(stderr, "[SaveGame] Impossible d'ouvrir %s\n", p.c_str()); return false; }
+        FileHeader h;
+        if (!ReadAt(file, 0, &h, sizeof(h)) || h.magic != kMagic) { std::fprintf(stderr, "[SaveGame] %s: pas une sauvegarde\n", p.c_str()); return false; }
+        if (h.version > kFormatVersion) { std::fprintf(stderr, "[SaveGame] %s: format %u plus récent que %u\n", p.c_str(), h.version, kFormatVersion); return false; }
+        file.seekg(0, std::ios::end);
+        const uint64_t fileSize = (uint64_t)file.tellg();
+        if (h.tableOffset < sizeof(h) || h.tableOffset > fileSize) { std::fprintf(stderr, "[SaveGame] %s: table des sections hors fichier\n", p.c_str()); return false; }
+        Bytes table((size_t)(fileSize - h.tableOffset));
+        if (!ReadAt(file, h.tableOffset, table.data(), table.size())) { std::fprintf(stderr, "[SaveGame] %s: table des sections illisible\n", p.c_str()); return false; }
+        In in{ table.data(), table.data() + table.size() };
+        index.formatVersion = h.version; index.tick = h.tick; index.sections.clear();
+        for (uint32_t i=0; i<h.sectionCount && in.ok; ++i) {
+            SectionInfo s;
+            s.name = in.str(); s.schemaId = in.pod<uint32_t>(); s.schemaVersion = in.pod<uint16_t>(); s.codec = (Codec)in.pod<uint8_t>(); in.pod<uint8_t>();
+            s.offset = in.pod<uint64_t>(); s.packedSize = in.pod<uint64_t>(); s.rawSize = in.pod<uint64_t>();
+            if (s.offset < sizeof(h) || s.offset + s.packedSize > h.tableOffset || s.codec > Codec::ZstdDict) in.ok = false;
+            index.sections.push_back(std::move(s));
+        }
+        if (!in.ok) { std::fprintf(stderr, "[SaveGame] %s: table des sections corrompue\n", p.c_str()); return false; }
+        return true;
+    }
+
+    bool read(const SectionInfo& s, Bytes& out) {
+        PROFILE_ZONE("SaveGame::readSection");
+        Bytes packed((size_t)s.packedSize);
+        if (!ReadAt(file, s.offset, packed.data(), packed.size())) { std::fprintf(stderr, "[SaveGame] %s: section %s tronquée\n", path.c_str(), s.name.c_str()); return false; }
+        if (s.codec == Codec::Raw) { out = std::move(packed); return out.size() == s.rawSize; }
+        if (s.codec == Codec::ZstdDict && !dictLoaded) {
+            dictLoaded = true;
+            const SectionInfo* d = index.find("DICT");
+            Bytes dict;
+            if (!d || !read(*d, dict)) { std::fprintf(stderr, "[SaveGame] %s: dictionnaire absent\n", path.c_str()); return false; }
+            ddict = ZSTD_createDDict(dict.data(), dict.size());
+        }
+        if (s.codec == Codec::ZstdDict && !ddict) return false;
+        if (!dctx) dctx = ZSTD_createDCtx();
+        out.resize((size_t)s.rawSize);
+        const size_t n = s.codec == Codec::ZstdDict ? ZSTD_decompress_usingDDict(dctx, out.data(), out.size(), packed.data(), packed.size(), ddict)
+                                                    : ZSTD_decompressDCtx(dctx, out.data(), out.size(), packed.data(), packed.size());
+        if (ZSTD_isError(n) || n != s.rawSize) {
+            std::fprintf(stderr, "[SaveGame] %s: section %s: %s\n", path.c_str(), s.name.c_str(), ZSTD_isError(n) ? ZSTD_getErrorName(n) : "taille inattendue");
+            return false;
+        }
+        return true;
+    }
+};
+
+bool Contains(const std::vector<std::string>& v, std::string_view s) { return std::find(v.begin(), v.end(), s) != v.end(); }
+
+} // namespace
+
+// ---- Snapshot / index ----
+
+void Snapshot::put(Section s) {
+    for (Section& o : sections) if (o.name == s.name) { o = std::move(s); return; }
+    sections.push_back(std::move(s));
+}
+
+const Section* Snapshot::find(std::string_view name) const {
+    for (const Section& s : sections) if (s.name == name) return &s;
+    return nullptr;
+}
+
+size_t Snapshot::rawBytes() const {
+    size_t n = 0; for (const Section& s : sections) n += s.data ? s.data->size() : 0;
+    return n;
+}
+
+const SectionInfo* FileIndex::find(std::string_view name) const {
+    for (const SectionInfo& s : sections) if (s.name == name) return &s;
+    return nullptr;
+}
+
+uint32_t SchemaId(std::string_view name) {
+    uint32_t h = 2166136261u;
+    for (char c : name) { h ^= (uint8_t)c; h *= 16777619u; }
+    return h;
+}
+
+void RegisterSaver(const ComponentSaver& saver) {
+    Savers(); // enregistrements d'office d'abord: un type utilisateur peut les remplacer
+    std::lock_guard<std::mutex> lk(gSaverMutex);
+    AddSaver(saver);
+}
+
+// ---- Capture ----
+
+void CaptureMeta(uint64_t tick, Snapshot& out) {
+    Bytes b; Out o{ b };
+    o.pod<uint64_t>(tick); o.pod<uint32_t>(kFormatVersion);
+    out.tick = tick;
+    out.put({ "META", 0, 1, Make(std::move(b)) });
+}
+
+void CaptureMap(const TileMap& map, Snapshot& out) {
+    PROFILE_ZONE("SaveGame::CaptureMap");
+    for (const MapLayer& l : kMapLayers) {
+        Bytes b; Out o{ b };
+        l.save(map, o);
+        const std::string name = std::string("MAP.") + l.name;
+        out.put({ name, SchemaId(name), kMapLayerVersion, Make(std::move(b)) });
+    }
+}
+
+void CaptureStrings(const StringPool& strings, Snapshot& out) {
+    Bytes b; Out o{ b };
+    WriteStrings(strings, o);
+    out.put({ "STRS", 0, 1, Make(std::move(b)) });
+}
+
+void CaptureEntities(Registry& reg, Snapshot& out) {
+    PROFILE_ZONE("SaveGame::CaptureEntities");
+    const std::vector<ComponentSaver> savers = Savers();
+    std::array<int, ECS::kMaxComponents> saverOf; saverOf.fill(-1);
+    for (size_t i=0; i<savers.size(); ++i) saverOf[savers[i].id] = (int)i;
+
+    // ENTS: versions des slots puis un groupe par archétype non vide (ids de schéma sauvés + index des entités)
+    Bytes ents; Out e{ ents };
+    const uint32_t slots = (uint32_t)reg.slotCount();
+    e.pod<uint32_t>(slots);
+    ents.reserve(ents.size() + (size_t)slots * 4 + reg.alive() * 4 + 64 * reg.archetypeSlots());
+    for (uint32_t i=0; i<slots; ++i) e.pod<uint32_t>(reg.slotVersion(i));
+    std::vector<size_t> rows(savers.size(), 0);
+    uint32_t groups = 0;
+    for (size_t i=0; i<reg.archetypeSlots(); ++i) if (reg.archetype(i).size()) ++groups;
+    e.pod<uint32_t>(groups);
+    for (size_t i=0; i<reg.archetypeSlots(); ++i) {
+        ECS::Archetype& a = reg.archetype(i);
+        if (!a.size()) continue;
+        uint32_t k = 0; for (ECS::ComponentId id : a.types) k += saverOf[id] >= 0;
+        e.pod<uint32_t>(k);
+        for (ECS::ComponentId id : a.types) if (saverOf[id] >= 0) { e.pod<uint32_t>(savers[saverOf[id]].schemaId); rows[saverOf[id]] += a.size(); }
+        e.pod<uint32_t>((uint32_t)a.size());
+        for (Entity en : a.entities) e.pod<uint32_t>(en.index);
+    }
+    out.put({ "ENTS", 0, kEntsVersion, Make(std::move(ents)) });
+
+    // Une colonne par composant: copie à plat des colonnes des archétypes, dans l'ordre des groupes
+    for (size_t s=0; s<savers.size(); ++s) {
+        const ComponentSaver& sv = savers[s];
+        Bytes b; b.reserve(16 + rows[s] * sv.size); Out o{ b };
+        o.pod<uint32_t>((uint32_t)sv.size); o.pod<uint32_t>(0); o.pod<uint64_t>(rows[s]);
+        for (size_t i=0; i<reg.archetypeSlots(); ++i) {
+            ECS::Archetype& a = reg.archetype(i);
+            if (a.size() && a.has(sv.id)) o.raw(a.column(sv.id).data, a.size() * sv.size);
+        }
+        out.put({ "C." + sv.name, sv.schemaId, sv.version, Make(std::move(b)) });
+    }
+}
+
+// ---- Écriture ----
+
+bool Write(const Snapshot& snap, const std::string& path, const WriteOptions& opt) {
+    PROFILE_ZONE("SaveGame::Write");
+    const std::string tmp = path + ".tmp";
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    if (!f) { std::fprintf(stderr, "[SaveGame] Impossible d'écrire %s\n", tmp.c_str()); return false; }
+    FileHeader h; h.tick = snap.tick;
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    ZSTD_CCtx* cctx = opt.level > 0 ? ZSTD_createCCtx() : nullptr;
+    ZSTD_CDict* cdict = nullptr;
+    if (cctx) {
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, opt.level);
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+        if (opt.dictionary && !opt.dictionary->empty()) cdict = ZSTD_createCDict(opt.dictionary->data(), opt.dictionary->size(), opt.level);
+    }
+    std::vector<SectionInfo> table;
+    uint64_t offset = sizeof(h);
+    Bytes packed;
+    auto emit = [&](const std::string& name, uint32_t schemaId, uint16_t version, const Bytes& raw, bool allowDict) {
+        SectionInfo s; s.name = name; s.schemaId = schemaId; s.schemaVersion = version; s.offset = offset; s.rawSize = raw.size();
+        const void* data = raw.data(); size_t size = raw.size();
+        if (cctx && !raw.empty()) {
+            const bool dict = allowDict && cdict && raw.size() <= kDictMaxSection;
+            ZSTD_CCtx_refCDict(cctx, dict ? cdict : nullptr);
+            packed.resize(ZSTD_compressBound(raw.size()));
+            const size_t n = ZSTD_compress2(cctx, packed.data(), packed.size(), raw.data(), raw.size());
+            if (ZSTD_isError(n)) { std::fprintf(stderr, "[SaveGame] %s: section %s: %s\n", path.c_str(), name.c_str(), ZSTD_getErrorName(n)); return false; }
+            if (n < raw.size()) { s.codec = dict ? Codec::ZstdDict : Codec::Zstd; data = packed.data(); size = n; } // sinon brute (incompressible)
+        }
+        s.packedSize = size;
+        f.write(static_cast<const char*>(data), (std::streamsize)size);
+        offset += size;
+        table.push_back(std::move(s));
+        return (bool)f;
+    };
+    bool ok = true;
+    if (cdict) ok = emit("DICT", 0, 1, *opt.dictionary, false);
+    for (const Section& s : snap.sections) if (ok && s.data && s.name != "DICT") ok = emit(s.name, s.schemaId, s.schemaVersion, *s.data, true);
+    ZSTD_freeCDict(cdict); ZSTD_freeCCtx(cctx);
+
+    Bytes tb; Out t{ tb };
+    for (const SectionInfo& s : table) {
+        t.str(s.name); t.pod(s.schemaId); t.pod(s.schemaVersion); t.pod<uint8_t>((uint8_t)s.codec); t.pod<uint8_t>(0);
+        t.pod(s.offset); t.pod(s.packedSize); t.pod(s.rawSize);
+    }
+    f.write(reinterpret_cast<const char*>(tb.data()), (std::streamsize)tb.size());
+    h.tableOffset = offset; h.sectionCount = (uint32_t)table.size();
+    f.seekp(0); f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.close();
+    std::error_code ec;
+    if (!ok || !f) { std::fprintf(stderr, "[SaveGame] Échec d'écriture %s\n", tmp.c_str()); std::filesystem::remove(tmp, ec); return false; }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) { std::fprintf(stderr, "[SaveGame] %s -> %s: %s\n", tmp.c_str(), path.c_str(), ec.message().c_str()); return false; }
+    return true;
+}
+
+bool TrainDictionary(const std::vector<Snapshot>& samples, Bytes& out, size_t capacity) {
+    PROFILE_ZONE("SaveGame::TrainDictionary");
+    // Échantillons: petites sections (celles qui utiliseront le dictionnaire), découpées en morceaux de 16 Ko
+    constexpr size_t kPiece = 16 * 1024;
+    Bytes buffer; std::vector<size_t> sizes;
+    for (const Snapshot& snap : samples) for (const Section& s : snap.sections) {
+        if (!s.data || s.name == "DICT" || s.data->size() > kDictMaxSection) continue;
+        for (size_t at=0; at<s.data->size(); at += kPiece) {
+            const size_t n = std::min(kPiece, s.data->size() - at);
+            buffer.insert(buffer.end(), s.data->begin() + at, s.data->begin() + at + n); sizes.push_back(n);
+        }
+    }
+    out.resize(capacity);
+    const size_t n = ZDICT_trainFromBuffer(out.data(), out.size(), buffer.data(), sizes.data(), (unsigned)sizes.size());
+    if (ZDICT_isError(n)) {
+        std::fprintf(stderr, "[SaveGame] Dictionnaire: %s (%zu échantillons, %zu octets)\n", ZDICT_getErrorName(n), sizes.size(), buffer.size());
+        out.clear(); return false;
+    }
+    out.resize(n);
+    return true;
+}
+
+bool AsyncWriter::begin(Snapshot snap, std::string path, WriteOptions opt) {
+    if (busy()) return false;
+    if (thread_.joinable()) thread_.join();
+    busy_.store(true, std::memory_order_release);
+    thread_ = std::thread([this, snap = std::move(snap), path = std::move(path), opt = std::move(opt)] {
+        const auto t0 = std::chrono::steady_clock::now();
+        ok_.store(Write(snap, path, opt), std::memory_order_relaxed);
+        lastMs_.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(), std::memory_order_release);
+        busy_.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+bool AsyncWriter::wait() {
+    if (thread_.joinable()) thread_.join();
+    return ok_.load(std::memory_order_acquire);
+}
+
+// ---- Chargement ----
+
+bool ReadIndex(const std::string& path, FileIndex& out) {
+    Reader r;
+    if (!r.open(path)) return false;
+    out = std::move(r.index);
+    return true;
+}
+
+namespace {
+
+bool LoadMap(Reader& r, TileMap& map, const LoadOptions& opt) {
+    PROFILE_ZONE("SaveGame::LoadMap");
+    TileMap staged; // couches lues ici puis déplacées: une couche corrompue ne laisse pas la carte à moitié écrite
+    std::vector<const MapLayer*> loaded;
+    for (const MapLayer& l : kMapLayers) {
+        if (!opt.mapLayers.empty() && !Contains(opt.mapLayers, l.name)) continue;
+        const SectionInfo* s = r.index.find(std::string("MAP.") + l.name);
+        if (!s) continue;
+        if (s->schemaVersion > kMapLayerVersion) { std::fprintf(stderr, "[SaveGame] %s: couche %s en version %u inconnue, ignorée\n", r.path.c_str(), l.name, s->schemaVersion); continue; }
+        Bytes raw;
+        if (!r.read(*s, raw)) return false;
+        In in{ raw.data(), raw.data() + raw.size() };
+        l.load(in, staged);
+        if (!in.ok) { std::fprintf(stderr, "[SaveGame] %s: couche %s corrompue\n", r.path.c_str(), l.name); return false; }
+        loaded.push_back(&l);
+    }
+    for (const MapLayer* l : loaded) l->move(map, staged);
+    return true;
+}
+
+// Couches raster de TileMap (deltas par chunks); B = const std::byte pour une carte const
+template<class M, class B>
+bool RasterSpan(M& m, std::string_view layer, B*& data, size_t& elem, size_t& count) {
+    auto set = [&](auto& v) { data = reinterpret_cast<B*>(v.data()); elem = sizeof(v[0]); count = v.size(); return true; };
+    if (layer == "tiles") return set(m.tiles);
+    if (layer == "countries") return set(m.countries);
+    if (layer == "heights") return set(m.tileHeights);
+    if (layer == "heightsQ") return set(m.tileHeightsQ);
+    if (layer == "palette") return set(m.paletteIndices);
+    if (layer == "watersheds") return set(m.watersheds);
+    return false;
+}
+
+// Colonnes de composants d'un fichier ("C." ou "D.C."): sauveur courant, section décompressée à la demande,
+// curseur sur les lignes complètes. En-tête: taille de ligne u32, 0 u32, lignes u64, puis les lignes.
+struct Columns {
+    struct Col {
+        const ComponentSaver* saver = nullptr; const SectionInfo* info = nullptr;
+        Bytes data; size_t rowSize = 0, rows = 0, cursor = 0;
+        bool usable = false, read = false;
+        bool exact() const { return info->schemaVersion == saver->version && rowSize == saver->size; }
+    };
+    Reader& r;
+    const std::vector<ComponentSaver>& savers;
+    std::string prefix;
+    std::unordered_map<uint32_t, Col> cols;
+
+    Col& get(uint32_t schema) {
+        auto [it, inserted] = cols.try_emplace(schema);
+        Col& c = it->second;
+        if (!inserted) return c;
+        for (const ComponentSaver& s : savers) if (s.schemaId == schema) c.saver = &s;
+        for (const SectionInfo& s : r.index.sections) if (s.schemaId == schema && s.name.compare(0, prefix.size(), prefix) == 0) c.info = &s;
+        if (c.info && !c.saver) std::fprintf(stderr, "[SaveGame] %s: composant %s non enregistré, ignoré\n", r.path.c_str(), c.info->name.c_str() + prefix.size());
+        return c;
+    }
+    bool load(Col& c) {
+        if (c.read || !c.saver || !c.info) return true;
+        c.read = true;
+        if (!r.read(*c.info, c.data)) return false;
+        In ci{ c.data.data(), c.data.data() + c.data.size() };
+        c.rowSize = ci.pod<uint32_t>(); ci.pod<uint32_t>(); c.rows = (size_t)ci.pod<uint64_t>();
+        c.cursor = 16;
+        if (!ci.ok || (c.rowSize && c.rows > (c.data.size() - 16) / c.rowSize)) { std::fprintf(stderr, "[SaveGame] %s: %s corrompu\n", r.path.c_str(), c.info->name.c_str()); return false; }
+        c.usable = c.exact() || c.saver->migrate;
+        if (!c.usable) std::fprintf(stderr, "[SaveGame] %s: %s v%u (%zu o) incompatible avec v%u (%zu o), valeurs par défaut\n",
+                                    r.path.c_str(), c.info->name.c_str(), c.info->schemaVersion, c.rowSize, c.saver->version, c.saver->size);
+        return true;
+    }
+    // n lignes depuis src (copie, migration ou valeurs par défaut) vers dst
+    static void Convert(const Col& c, const std::byte* src, size_t n, void* dst) {
+        bool done = false;
+        if (src && c.usable && c.exact()) { std::memcpy(dst, src, n * c.rowSize); done = true; }
+        else if (src && c.usable) done = c.saver->migrate(c.info->schemaVersion, src, c.rowSize, n, dst);
+        if (!done) c.saver->construct(dst, n);
+    }
+    // Construit les n lignes suivantes dans dst et avance le curseur
+    void fill(Col& c, void* dst, size_t n) {
+        const bool have = c.read && c.cursor + n * c.rowSize <= 16 + c.rows * c.rowSize;
+        Convert(c, have ? c.data.data() + c.cursor : nullptr, n, dst);
+        skip(c, n);
+    }
+    void skip(Col& c, size_t n) { if (c.read) c.cursor += n * c.rowSize; }
+};
+
+struct Group { std::vector<uint32_t> schemas; std::vector<Entity> handles; bool keep = true; };
+
+// Groupes d'entités de ENTS / D.ENTS: k ids de schéma, nombre, handles (index seuls si versions fournies, sinon bits 64)
+bool ReadGroups(In& in, const std::vector<uint32_t>* versions, const std::unordered_set<uint32_t>& skip, std::vector<Group>& out) {
+    out.resize(in.pod<uint32_t>());
+    for (Group& g : out) {
+        g.schemas.resize(in.pod<uint32_t>());
+        for (uint32_t& s : g.schemas) s = in.pod<uint32_t>();
+        const uint32_t count = in.pod<uint32_t>();
+        const std::byte* at = in.take((size_t)count * (versions ? 4 : 8));
+        if (!in.ok) return false;
+        g.handles.resize(count);
+        for (uint32_t i=0; i<count; ++i) {
+            if (versions) {
+                uint32_t idx; std::memcpy(&idx, at + (size_t)i * 4, 4);
+                if (idx >= versions->size()) return false;
+                g.handles[i] = Entity{ idx, (*versions)[idx] };
+            } else { uint64_t b; std::memcpy(&b, at + (size_t)i * 8, 8); g.handles[i] = Entity::FromBits(b); }
+        }
+        g.keep = std::none_of(g.schemas.begin(), g.schemas.end(), [&](uint32_t s) { return skip.count(s) != 0; });
+    }
+    return true;
+}
+
+// Crée les groupes retenus à leurs handles, composants lus colonne par colonne (curseurs avancés aussi sur les écartés)
+void BuildGroups(Registry& reg, Columns& cols, const std::vector<Group>& groups) {
+    for (const Group& g : groups) {
+        if (g.keep && !g.handles.empty()) {
+            ECS::ComponentMask mask = 0;
+            for (uint32_t s : g.schemas) if (const Columns::Col& c = cols.get(s); c.saver) mask |= ECS::ComponentMask{1} << c.saver->id;
+            ECS::Archetype& a = reg.createAt(mask, g.handles.data(), g.handles.size());
+            const size_t first = a.size() - g.handles.size();
+            for (uint32_t s : g.schemas) { Columns::Col& c = cols.get(s); if (c.saver) cols.fill(c, a.column(c.saver->id).at(first), g.handles.size()); }
+        } else for (uint32_t s : g.schemas) cols.skip(cols.get(s), g.handles.size());
+    }
+}
+
+std::unordered_set<uint32_t> SkipSet(const LoadOptions& opt) {
+    std::unordered_set<uint32_t> skip;
+    for (const std::string& n : opt.skipComponents) skip.insert(SchemaId(n));
+    return skip;
+}
+
+bool LoadEntities(Reader& r, Registry& reg, const LoadOptions& opt) {
+    PROFILE_ZONE("SaveGame::LoadEntities");
+    const SectionInfo* es = r.index.find("ENTS");
+    if (!es) { std::fprintf(stderr, "[SaveGame] %s: pas d'entités\n", r.path.c_str()); return false; }
+    if (es->schemaVersion > kEntsVersion) { std::fprintf(stderr, "[SaveGame] %s: ENTS en version %u inconnue\n", r.path.c_str(), es->schemaVersion); return false; }
+    Bytes ents;
+    if (!r.read(*es, ents)) return false;
+    In in{ ents.data(), ents.data() + ents.size() };
+    const uint32_t slots = in.pod<uint32_t>();
+    const std::byte* versionsAt = in.take((size_t)slots * 4);
+    std::vector<uint32_t> versions(versionsAt ? slots : 0);
+    if (versionsAt && slots) std::memcpy(versions.data(), versionsAt, (size_t)slots * 4);
+    std::vector<Group> groups;
+    if (!versionsAt || !ReadGroups(in, &versions, SkipSet(opt), groups)) { std::fprintf(stderr, "[SaveGame] %s: ENTS corrompu\n", r.path.c_str()); return false; }
+
+    // Sections exclues (skipComponents) jamais décompressées. Les entités écartées gardent un slot mort de version
+    // incrémentée, pour que les références vers elles ne désignent jamais une future entité
+    const std::vector<ComponentSaver> savers = Savers();
+    Columns cols{ r, savers, "C.", {} };
+    for (const Group& g : groups) {
+        if (g.keep) { for (uint32_t s : g.schemas) if (!cols.load(cols.get(s))) return false; }
+        else for (Entity e : g.handles) ++versions[e.index];
+    }
+    for (Group& g : groups) if (g.keep) for (Entity& e : g.handles) e.version = versions[e.index];
+    reg.clear();
+    reg.restoreSlots(versions.data(), versions.size());
+    BuildGroups(reg, cols, groups);
+    reg.finishRestore();
+    return true;
+}
+
+bool LoadStrings(Reader& r, StringPool& strings) {
+    const SectionInfo* s = r.index.find("STRS");
+    if (!s) return true;
+    Bytes raw;
+    if (!r.read(*s, raw)) return false;
+    In in{ raw.data(), raw.data() + raw.size() };
+    if (!ReadStrings(in, strings)) std::fprintf(stderr, "[SaveGame] %s: ids de chaînes décalés dans le pool cible\n", r.path.c_str());
+    if (!in.ok) { std::fprintf(stderr, "[SaveGame] %s: STRS corrompu\n", r.path.c_str()); return false; }
+    return true;
+}
+
+bool LoadFull(Reader& r, Registry* reg, TileMap* map, const LoadOptions& opt) {
+    if (map && opt.map && !LoadMap(r, *map, opt)) return false;
+    if (opt.strings && !LoadStrings(r, *opt.strings)) return false;
+    if (reg && opt.entities && !LoadEntities(r, *reg, opt)) return false;
+    return true;
+}
+
+bool ReadChainInfo(Reader& r, ChainInfo& out) {
+    out = ChainInfo{};
+    const SectionInfo* s = r.index.find("CHAIN");
+    if (!s) return true; // sauvegarde isolée: complète, hors chaîne
+    Bytes raw;
+    if (!r.read(*s, raw)) return false;
+    In in{ raw.data(), raw.data() + raw.size() };
+    out.delta = in.pod<uint8_t>() != 0; out.seq = in.pod<uint64_t>(); out.parent = in.pod<uint64_t>();
+    return in.ok;
+}
+
+// Applique un delta sur l'état chargé (slots libres reconstruits par l'appelant)
+bool ApplyDelta(Reader& r, Registry* reg, TileMap* map, const LoadOptions& opt) {
+    PROFILE_ZONE("SaveGame::ApplyDelta");
+    if (map && opt.map) {
+        if (!LoadMap(r, *map, opt)) return false; // couches entières (non raster, redimensionnées)
+        for (const SectionInfo& s : r.index.sections) {
+            if (s.name.compare(0, 6, "D.MAP.") != 0) continue;
+            const std::string layer = s.name.substr(6);
+            if (!opt.mapLayers.empty() && !Contains(opt.mapLayers, layer)) continue;
+            Bytes raw;
+            if (!r.read(s, raw)) return false;
+            In in{ raw.data(), raw.data() + raw.size() };
+            const int32_t w = in.pod<int32_t>(), h = in.pod<int32_t>(); const uint32_t cs = in.pod<uint32_t>(), count = in.pod<uint32_t>();
+            const std::byte* keys = in.take((size_t)count * 4);
+            std::byte* dst; size_t elem = 0, n = 0;
+            if (!in.ok || !RasterSpan(*map, layer, dst, elem, n) || w != map->width || h != map->height || n != (size_t)w * h || cs == 0) {
+                std::fprintf(stderr, "[SaveGame] %s: chunks %s incompatibles avec la carte, ignorés\n", r.path.c_str(), layer.c_str());
+                continue;
+            }
+            for (uint32_t k=0; k<count && in.ok; ++k) {
+                uint32_t key; std::memcpy(&key, keys + (size_t)k * 4, 4);
+                const int x0 = (int)(key & 0xFFFFu) * (int)cs, y0 = (int)(key >> 16) * (int)cs;
+                const int x1 = std::min<int>(w, x0 + (int)cs), y1 = std::min<int>(h, y0 + (int)cs);
+                for (int y=y0; y<y1 && x0<x1; ++y) if (const std::byte* row = in.take((size_t)(x1 - x0) * elem)) std::memcpy(dst + ((size_t)y * w + x0) * elem, row, (size_t)(x1 - x0) * elem);
+            }
+            if (!in.ok) { std::fprintf(stderr, "[SaveGame] %s: %s corrompu\n", r.path.c_str(), s.name.c_str()); return false; }
+        }
+    }
+    if (opt.strings) if (const SectionInfo* s = r.index.find("D.STRS")) {
+        Bytes raw;
+        if (!r.read(*s, raw)) return false;
+        In in{ raw.data(), raw.data() + raw.size() };
+        const uint32_t first = in.pod<uint32_t>(), n = in.pod<uint32_t>();
+        bool same = true;
+        for (uint32_t i=0; i<n && in.ok; ++i) same = opt.strings->intern(in.str()) == first + i && same;
+        if (!same) std::fprintf(stderr, "[SaveGame] %s: ids de chaînes décalés dans le pool cible\n", r.path.c_str());
+        if (!in.ok) return false;
+    }
+    if (!reg || !opt.entities) return true;
+
+    // Slots morts, puis entités recréées (lignes complètes), puis écritures en place
+    Bytes slotsRaw, entsRaw;
+    const SectionInfo* ss = r.index.find("D.SLOTS"); const SectionInfo* es = r.index.find("D.ENTS");
+    if (!ss || !es || !r.read(*ss, slotsRaw) || !r.read(*es, entsRaw)) { std::fprintf(stderr, "[SaveGame] %s: delta sans D.SLOTS/D.ENTS\n", r.path.c_str()); return false; }
+    In si{ slotsRaw.data(), slotsRaw.data() + slotsRaw.size() };
+    const uint32_t slotCount = si.pod<uint32_t>();
+    const uint32_t dead = si.pod<uint32_t>();
+    const std::byte* deadAt = si.take((size_t)dead * 8);
+    In ei{ entsRaw.data(), entsRaw.data() + entsRaw.size() };
+    std::vector<Group> groups;
+    if (!deadAt || !ReadGroups(ei, nullptr, SkipSet(opt), groups)) { std::fprintf(stderr, "[SaveGame] %s: D.ENTS corrompu\n", r.path.c_str()); return false; }
+    const std::vector<ComponentSaver> savers = Savers();
+    Columns cols{ r, savers, "D.C.", {} };
+    for (const SectionInfo& s : r.index.sections) if (s.name.compare(0, 4, "D.C.") == 0) { Columns::Col& c = cols.get(s.schemaId); if (c.saver && !cols.load(c)) return false; }
+
+    reg->restoreSlotCount(slotCount); // slots jamais occupés d'ici la sauvegarde: morts, version 0
+    for (uint32_t i=0; i<dead; ++i) { uint32_t iv[2]; std::memcpy(iv, deadAt + (size_t)i * 8, 8); reg->restoreSlot(iv[0], iv[1]); }
+    for (const Group& g : groups) for (Entity e : g.handles) reg->restoreSlot(e.index, g.keep ? e.version : e.version + 1);
+    BuildGroups(*reg, cols, groups);
+    for (auto& [schema, c] : cols.cols) {
+        if (!c.read) continue;
+        In pi{ c.data.data() + 16 + c.rows * c.rowSize, c.data.data() + c.data.size() };
+        const uint64_t patches = pi.pod<uint64_t>();
+        const std::byte* handles = pi.take((size_t)patches * 8);
+        const std::byte* rows = pi.take((size_t)patches * c.rowSize);
+        if (!pi.ok) { std::fprintf(stderr, "[SaveGame] %s: %s corrompu\n", r.path.c_str(), c.info->name.c_str()); return false; }
+        for (uint64_t i=0; i<patches; ++i) {
+            uint64_t bits; std::memcpy(&bits, handles + i * 8, 8);
+            uint32_t ai, row;
+            if (!reg->locate(Entity::FromBits(bits), ai, row)) continue; // entité écartée au chargement
+            ECS::Archetype& a = reg->archetype(ai);
+            if (!a.has(c.saver->id)) continue;
+            ECS::Column& col = a.column(c.saver->id);
+            Columns::Convert(c, rows + i * c.rowSize, 1, col.at(row));
+            col.markChanged(row, reg->tick());
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool Load(const std::string& path, Registry* reg, TileMap* map, const LoadOptions& opt) {
+    PROFILE_ZONE("SaveGame::Load");
+    Reader r;
+    if (!r.open(path)) return false;
+    ChainInfo chain;
+    if (!ReadChainInfo(r, chain)) return false;
+    if (chain.delta) { std::fprintf(stderr, "[SaveGame] %s: delta, à charger avec LoadChain\n", path.c_str()); return false; }
+    return LoadFull(r, reg, map, opt);
+}
+
+bool ReadSection(const std::string& path, std::string_view name, Bytes& out) {
+    Reader r;
+    if (!r.open(path)) return false;
+    const SectionInfo* s = r.index.find(name);
+    return s && r.read(*s, out);
+}
+
+bool ReadChain(const std::string& path, ChainInfo& out) {
+    Reader r;
+    return r.open(path) && ReadChainInfo(r, out);
+}
+
+bool LoadChain(const std::vector<std::string>& files, Registry* reg, TileMap* map, const LoadOptions& opt) {
+    PROFILE_ZONE("SaveGame::LoadChain");
+    if (files.empty()) return false;
+    ChainInfo prev;
+    {
+        Reader r;
+        if (!r.open(files[0]) || !ReadChainInfo(r, prev)) return false;
+        if (prev.delta) { std::fprintf(stderr, "[SaveGame] %s: la chaîne doit commencer par une sauvegarde complète\n", files[0].c_str()); return false; }
+        if (!LoadFull(r, reg, map, opt)) return false;
+    }
+    bool ok = true;
+    for (size_t i=1; i<files.size() && ok; ++i) {
+        Reader r; ChainInfo ci;
+        if (!r.open(files[i]) || !ReadChainInfo(r, ci)) { ok = false; break; }
+        if (!ci.delta || ci.parent != prev.seq) { std::fprintf(stderr, "[SaveGame] %s: maillon %llu inattendu après %llu\n", files[i].c_str(), (unsigned long long)ci.seq, (unsigned long long)prev.seq); ok = false; break; }
+        ok = ApplyDelta(r, reg, map, opt);
+        prev = ci;
+    }
+    if (reg && opt.entities) reg->finishRestore();
+    return ok;
+}
+
+// ---- Deltas ----
+
+void TrackRemovals(Registry& reg) {
+    ECS::ComponentMask mask = 0;
+    for (const ComponentSaver& s : Savers()) mask |= ECS::ComponentMask{1} << s.id;
+    reg.trackRemovals(mask);
+    reg.trackDestroys();
+}
+
+void CaptureChain(const ChainInfo& chain, Snapshot& out) {
+    Bytes b; Out o{ b };
+    o.pod<uint8_t>(chain.delta ? 1 : 0); o.pod(chain.seq); o.pod(chain.parent);
+    out.put({ "CHAIN", 0, 1, Make(std::move(b)) });
+}
+
+bool IsRasterLayer(std::string_view layer) {
+    TileMap empty; const std::byte* d; size_t e, n;
+    return RasterSpan(empty, layer, d, e, n);
+}
+
+void CaptureMapLayer(const TileMap& map, std::string_view layer, Snapshot& out) {
+    for (const MapLayer& l : kMapLayers) {
+        if (layer != l.name) continue;
+        Bytes b; Out o{ b };
+        l.save(map, o);
+        const std::string name = std::string("MAP.") + l.name;
+        out.put({ name, SchemaId(name), kMapLayerVersion, Make(std::move(b)) });
+    }
+}
+
+bool CaptureMapChunks(const TileMap& map, std::string_view layer, const std::vector<uint32_t>& chunks, Snapshot& out) {
+    const std::byte* src; size_t elem = 0, n = 0;
+    if (!RasterSpan(map, layer, src, elem, n) || n != (size_t)map.width * map.height) return false;
+    Bytes b; Out o{ b };
+    o.pod<int32_t>(map.width); o.pod<int32_t>(map.height); o.pod<uint32_t>((uint32_t)kMapChunk);
+    std::vector<uint32_t> keys;
+    for (uint32_t k : chunks) if ((int)(k & 0xFFFFu) * kMapChunk < map.width && (int)(k >> 16) * kMapChunk < map.height) keys.push_back(k);
+    o.pod<uint32_t>((uint32_t)keys.size());
+    o.raw(keys.data(), keys.size() * 4);
+    for (uint32_t k : keys) {
+        const int x0 = (int)(k & 0xFFFFu) * kMapChunk, y0 = (int)(k >> 16) * kMapChunk;
+        const int x1 = std::min(map.width, x0 + kMapChunk), y1 = std::min(map.height, y0 + kMapChunk);
+        for (int y=y0; y<y1; ++y) o.raw(src + ((size_t)y * map.width + x0) * elem, (size_t)(x1 - x0) * elem);
+    }
+    const std::string name = "D.MAP." + std::string(layer);
+    out.put({ name, SchemaId(name), kMapLayerVersion, Make(std::move(b)) });
+    return true;
+}
+
+void CaptureStringsSince(const StringPool& strings, uint32_t firstId, Snapshot& out) {
+    Bytes b; Out o{ b };
+    firstId = std::max<uint32_t>(firstId, 1);
+    const uint32_t n = (uint32_t)strings.size() > firstId ? (uint32_t)strings.size() - firstId : 0;
+    o.pod<uint32_t>(firstId); o.pod<uint32_t>(n);
+    for (uint32_t i=0; i<n; ++i) o.str(strings.view(firstId + i));
+    out.put({ "D.STRS", 0, 1, Make(std::move(b)) });
+}
+
+void CaptureEntityDelta(Registry& reg, uint32_t since, Snapshot& out) {
+    PROFILE_ZONE("SaveGame::CaptureEntityDelta");
+    const std::vector<ComponentSaver> savers = Savers();
+    std::array<int, ECS::kMaxComponents> saverOf; saverOf.fill(-1);
+    for (size_t i=0; i<savers.size(); ++i) saverOf[savers[i].id] = (int)i;
+
+    // Retraits depuis since: entité vivante (composant retiré, ou slot réutilisé) -> ligne complète, sinon slot mort
+    std::unordered_set<uint32_t> touched;
+    std::vector<std::vector<uint32_t>> full(reg.archetypeSlots()); // lignes complètes par archétype
+    std::vector<uint32_t> dead;
+    auto removed = [&](Entity e) {
+        if (!touched.insert(e.index).second) return;
+        uint32_t a, row;
+        if (reg.locate(Entity{ e.index, reg.slotVersion(e.index) }, a, row)) full[a].push_back(row);
+        else dead.push_back(e.index);
+    };
+    for (const ComponentSaver& s : savers) reg.eachRemoved(s.id, since, removed);
+    reg.eachDestroyed(since, removed); // slots détruits sans composant sauvé: leur version doit suivre aussi
+    // Créations et changements d'archétype: tick d'ajout récent sur une colonne (archétypes puis blocs anciens sautés)
+    for (size_t ai=0; ai<reg.archetypeSlots(); ++ai) {
+        ECS::Archetype& a = reg.archetype(ai);
+        if (!a.size() || std::none_of(a.columns.begin(), a.columns.end(), [&](const ECS::Column& c) { return c.lastAdded > since; })) continue;
+        for (size_t b=0; b*ECS::kTickBlockRows<a.size(); ++b) {
+            if (std::none_of(a.columns.begin(), a.columns.end(), [&](const ECS::Column& c) { return c.addedBlock[b] > since; })) continue;
+            for (size_t row=b*ECS::kTickBlockRows, end=std::min(a.size(), row + ECS::kTickBlockRows); row<end; ++row) {
+                if (std::none_of(a.columns.begin(), a.columns.end(), [&](const ECS::Column& c) { return c.addedTick[row] > since; })) continue;
+                if (!touched.count(a.entities[row].index)) full[ai].push_back((uint32_t)row);
+            }
+        }
+        std::sort(full[ai].begin(), full[ai].end());
+    }
+
+    Bytes slotsB; Out so{ slotsB };
+    so.pod<uint32_t>((uint32_t)reg.slotCount()); so.pod<uint32_t>((uint32_t)dead.size());
+    for (uint32_t idx : dead) { so.pod<uint32_t>(idx); so.pod<uint32_t>(reg.slotVersion(idx)); }
+    out.put({ "D.SLOTS", 0, kEntsVersion, Make(std::move(slotsB)) });
+
+    std::vector<Bytes> rowsB(savers.size()), patchH(savers.size()), patchB(savers.size());
+    std::vector<uint64_t> rows(savers.size(), 0), patches(savers.size(), 0);
+    Bytes entsB; Out eo{ entsB };
+    uint32_t groups = 0;
+    for (const auto& f : full) groups += !f.empty();
+    eo.pod<uint32_t>(groups);
+    for (size_t ai=0; ai<reg.archetypeSlots(); ++ai) {
+        ECS::Archetype& a = reg.archetype(ai);
+        const std::vector<uint32_t>& fr = full[ai];
+        if (!fr.empty()) {
+            uint32_t k = 0; for (ECS::ComponentId id : a.types) k += saverOf[id] >= 0;
+            eo.pod<uint32_t>(k);
+            for (ECS::ComponentId id : a.types) if (saverOf[id] >= 0) eo.pod<uint32_t>(savers[saverOf[id]].schemaId);
+            eo.pod<uint32_t>((uint32_t)fr.size());
+            for (uint32_t row : fr) eo.pod<uint64_t>(a.entities[row].bits());
+            for (ECS::ComponentId id : a.types) {
+                const int s = saverOf[id]; if (s < 0) continue;
+                Out ro{ rowsB[s] }; const ECS::Column& col = a.column(id);
+                for (uint32_t row : fr) ro.raw(col.at(row), savers[s].size);
+                rows[s] += fr.size();
+            }
+        }
+        // Écritures en place: lignes modifiées hors lignes complètes, colonne par colonne
+        for (ECS::ComponentId id : a.types) {
+            const int s = saverOf[id]; const ECS::Column& col = a.column(id);
+            if (s < 0 || col.lastChanged <= since) continue;
+            Out ho{ patchH[s] }, po{ patchB[s] };
+            for (size_t b=0; b*ECS::kTickBlockRows<a.size(); ++b) {
+                if (col.changedBlock[b] <= since) continue;
+                for (size_t row=b*ECS::kTickBlockRows, end=std::min(a.size(), row + ECS::kTickBlockRows); row<end; ++row) {
+                    if (col.changedTick[row] <= since || std::binary_search(fr.begin(), fr.end(), (uint32_t)row)) continue;
+                    ho.pod<uint64_t>(a.entities[row].bits()); po.raw(col.at(row), savers[s].size); ++patches[s];
+                }
+            }
+        }
+    }
+    out.put({ "D.ENTS", 0, kEntsVersion, Make(std::move(entsB)) });
+    for (size_t s=0; s<savers.size(); ++s) {
+        if (!rows[s] && !patches[s]) continue;
+        Bytes b; b.reserve(24 + rowsB[s].size() + patchH[s].size() + patchB[s].size()); Out o{ b };
+        o.pod<uint32_t>((uint32_t)savers[s].size); o.pod<uint32_t>(0); o.pod<uint64_t>(rows[s]);
+        o.raw(rowsB[s].data(), rowsB[s].size());
+        o.pod<uint64_t>(patches[s]); o.raw(patchH[s].data(), patchH[s].size()); o.raw(patchB[s].data(), patchB[s].size());
+        out.put({ "D.C." + savers[s].name, savers[s].schemaId, savers[s].version, Make(std::move(b)) });
+    }
+}
+
+} // namespace SaveGame
@@ -1,3 +1,202 @@
 #pragma once
-// [6] TODO: Save/Load JSON versionné, compression zstd, sélection partielle
-namespace SaveGame { /* ... */ }
+#include "../ECS/Registry.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct TileMap;
+class StringPool;
+
+// Sauvegarde binaire en sections versionnées, compressées zstd (dictionnaire entraîné optionnel).
+//
+// Fichier: en-tête (magic "WSAV", version de format, position de la table) | sections compressées | table des sections.
+// Chaque section porte un nom, un id de schéma (hash du nom) + version de schéma, sa position et ses tailles:
+// un chargement partiel ne lit et ne décompresse que les sections voulues (ex. monde sans les villes).
+//   META               tick, compteurs
+//   DICT               dictionnaire zstd (brut) utilisé par les petites sections
+//   MAP.<couche>       couches TileMap (header, tiles, countries, heights, heightsQ, palette, watersheds, colors,
+//                      strings, places, roads, rivers, countryInfos, polygons)
+//   ENTS               versions des slots + groupes d'entités (composants sauvés, index des entités)
+//   C.<Composant>      colonne brute du composant, groupes concaténés dans l'ordre de ENTS
+//   STRS               StringPool externe (ids de Name/Building des prefabs)
+//   NET.<nom>          données dérivées compilées par leur module (graphe routier...), lues par ReadSection
+// Les handles d'entités sont restaurés à l'identique (index + version): les références entre composants restent valides.
+// Données en petit-boutiste natif (x86/ARM), pas de conversion.
+//
+// Sauvegarde en tâche de fond: Capture*() copie les données sur le thread appelant dans des sections immuables
+// partagées (copie à la section: une section inchangée, ex. les couches monde, peut être réutilisée d'une sauvegarde
+// à l'autre sans recopie), puis AsyncWriter compresse et écrit sur son propre thread pendant que la simulation continue.
+namespace SaveGame {
+
+constexpr uint32_t kMagic = 0x56415357u; // "WSAV"
+constexpr uint32_t kFormatVersion = 1;
+
+enum class Codec : uint8_t { Raw = 0, Zstd = 1, ZstdDict = 2 };
+
+using Bytes = std::vector<std::byte>;
+
+struct Section {
+    std::string name;
+    uint32_t schemaId = 0;       // SchemaId(nom) pour les composants, 0 sinon
+    uint16_t schemaVersion = 1;
+    std::shared_ptr<const Bytes> data;
+};
+
+// Ensemble de sections prêtes à écrire; copier un Snapshot ne copie que les pointeurs
+struct Snapshot {
+    uint64_t tick = 0;
+    std::vector<Section> sections;
+    void put(Section s); // remplace la section de même nom
+    const Section* find(std::string_view name) const;
+    size_t rawBytes() const;
+};
+
+// Entrée de la table d'un fichier
+struct SectionInfo {
+    std::string name;
+    uint32_t schemaId = 0;
+    uint16_t schemaVersion = 1;
+    Codec codec = Codec::Raw;
+    uint64_t offset = 0, packedSize = 0, rawSize = 0;
+};
+
+struct FileIndex {
+    uint32_t formatVersion = 0;
+    uint64_t tick = 0;
+    std::vector<SectionInfo> sections;
+    const SectionInfo* find(std::string_view name) const;
+};
+
+// ---- Composants sauvés ----
+
+// Conversion d'une colonne d'une version de schéma antérieure: rows lignes de srcRowSize octets -> dst (T construits)
+using Migrate = bool(*)(uint16_t fromVersion, const std::byte* src, size_t srcRowSize, size_t rows, void* dst);
+
+uint32_t SchemaId(std::string_view name); // FNV-1a 32 bits
+
+struct ComponentSaver {
+    std::string name;
+    uint32_t schemaId = 0;
+    uint16_t version = 1;
+    ECS::ComponentId id = 0;
+    size_t size = 0;
+    void (*construct)(void* dst, size_t n) = nullptr; // construction par défaut (section absente ou illisible)
+    Migrate migrate = nullptr;
+};
+void RegisterSaver(const ComponentSaver& saver);
+template<class T> ComponentSaver MakeSaver(const char* name, uint16_t version, Migrate migrate);
+// Composants trivialement copiables uniquement (colonnes copiées à plat); Transform, Name, Residence, Building,
+// Country et Item sont enregistrés d'office. Changer la disposition d'un type = incrémenter version (+ migrate).
+template<class T> void RegisterComponent(const char* name, uint16_t version = 1, Migrate migrate = nullptr);
+
+// ---- Capture (thread appelant) ----
+
+void CaptureMap(const TileMap& map, Snapshot& out);
+void CaptureEntities(Registry& reg, Snapshot& out);
+void CaptureStrings(const StringPool& strings, Snapshot& out);
+void CaptureMeta(uint64_t tick, Snapshot& out);
+
+// ---- Écriture ----
+
+struct WriteOptions {
+    int level = 3;                       // niveau zstd (0 = sections brutes)
+    std::shared_ptr<const Bytes> dictionary; // TrainDictionary(); sections <= kDictMaxSection compressées avec
+};
+constexpr size_t kDictMaxSection = 256 * 1024;
+
+// Écrit dans path.tmp puis renomme (un fichier existant n'est jamais laissé à moitié écrit)
+bool Write(const Snapshot& snap, const std::string& path, const WriteOptions& opt = {});
+
+// Dictionnaire entraîné sur les petites sections de sauvegardes représentatives (false si échantillons insuffisants)
+bool TrainDictionary(const std::vector<Snapshot>& samples, Bytes& out, size_t capacity = 64 * 1024);
+
+// Écriture sur un thread dédié; un seul travail à la fois
+class AsyncWriter {
+public:
+    AsyncWriter() = default;
+    ~AsyncWriter() { wait(); }
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    bool begin(Snapshot snap, std::string path, WriteOptions opt = {}); // false si une écriture est en cours
+    bool busy() const { return busy_.load(std::memory_order_acquire); }
+    bool wait();                          // attend la fin, renvoie le résultat de la dernière écriture
+    double lastWriteMs() const { return lastMs_.load(std::memory_order_acquire); } // lisible pendant une écriture
+
+private:
+    std::thread thread_;
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> ok_{true};          // écrits par le thread d'écriture, lus sans join
+    std::atomic<double> lastMs_{0.0};
+};
+
+// ---- Chargement ----
+
+struct LoadOptions {
+    bool map = true;                          // couches TileMap (si map non nul)
+    bool entities = true;                     // entités (si reg non nul)
+    std::vector<std::string> mapLayers;       // vide = toutes, sinon ex. {"header","tiles","heightsQ"}
+    // Entités portant l'un de ces composants non chargées, et leurs sections pas lues:
+    // {"Building","Residence"} = niveau monde sans les villes
+    std::vector<std::string> skipComponents;
+    StringPool* strings = nullptr;            // cible de STRS (ids internés dans l'ordre sauvé)
+};
+
+bool ReadIndex(const std::string& path, FileIndex& out);
+// Section brute décompressée (sections propres à un module, ex. NET.roads); false si absente ou illisible
+bool ReadSection(const std::string& path, std::string_view name, Bytes& out);
+// Registre vidé puis restauré (handles identiques); carte: seules les couches chargées sont remplacées
+bool Load(const std::string& path, Registry* reg, TileMap* map, const LoadOptions& opt = {});
+
+// ---- Deltas (voir Autosave) ----
+// Un delta ne contient que ce qui a changé depuis la sauvegarde précédente de sa chaîne:
+//   CHAIN              complet/delta, numéro de séquence, parent
+//   D.SLOTS            nombre de slots, puis slots morts depuis (index, version), entités sans composant sauvé comprises
+//   D.ENTS             entités créées, changées d'archétype ou ayant perdu un composant: groupes de lignes complètes
+//   D.C.<Composant>    lignes complètes des groupes, puis écritures en place (handle + valeur) des autres lignes
+//   D.MAP.<couche>     chunks kMapChunk x kMapChunk modifiés d'une couche raster; MAP.<couche> = couche entière
+//   D.STRS             chaînes internées depuis
+// Les entités sans composant sauvé ne sont suivies que par les sauvegardes complètes.
+constexpr int kMapChunk = 64;
+
+struct ChainInfo { bool delta = false; uint64_t seq = 0, parent = 0; };
+void CaptureChain(const ChainInfo& chain, Snapshot& out);
+bool ReadChain(const std::string& path, ChainInfo& out); // fichier hors chaîne: complet, seq 0
+
+// Journaux de retraits des composants sauvés et des destructions (avant la période couverte par le delta suivant)
+void TrackRemovals(Registry& reg);
+// Changements postérieurs au tick since: coût proportionnel aux lignes changées (archétypes et blocs de
+// ECS::kTickBlockRows lignes sans tick récent sautés). since doit être >= reg.removalHorizon().
+void CaptureEntityDelta(Registry& reg, uint32_t since, Snapshot& out);
+// Couches raster: "tiles", "countries", "heights", "heightsQ", "palette", "watersheds"; chunks en clés (cy << 16) | cx
+bool IsRasterLayer(std::string_view layer);
+bool CaptureMapChunks(const TileMap& map, std::string_view layer, const std::vector<uint32_t>& chunks, Snapshot& out);
+void CaptureMapLayer(const TileMap& map, std::string_view layer, Snapshot& out);
+void CaptureStringsSince(const StringPool& strings, uint32_t firstId, Snapshot& out);
+
+// Sauvegarde complète puis deltas, chacun ayant pour parent le précédent. Au premier maillon invalide: false, l'état
+// rejoué jusque-là reste chargé.
+bool LoadChain(const std::vector<std::string>& files, Registry* reg, TileMap* map, const LoadOptions& opt = {});
+
+// ---- Implémentation des templates ----
+
+template<class T>
+ComponentSaver MakeSaver(const char* name, uint16_t version, Migrate migrate) {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "SaveGame: composant trivialement copiable requis");
+    ComponentSaver s;
+    s.name = name; s.schemaId = SchemaId(name); s.version = version; s.id = ECS::TypeId<T>(); s.size = sizeof(T);
+    s.construct = [](void* dst, size_t n) { for (size_t i=0; i<n; ++i) new (static_cast<T*>(dst) + i) T(); };
+    s.migrate = migrate;
+    return s;
+}
+
+template<class T>
+void RegisterComponent(const char* name, uint16_t version, Migrate migrate) { RegisterSaver(MakeSaver<T>(name, version, migrate)); }
+
+} // namespace SaveGame
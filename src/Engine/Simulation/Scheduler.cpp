@@ -1,25 +1,306 @@
 #include "Scheduler.h"
+#include "../../Platform/ThreadPool.h"
+#include "../../Core/Profiler.h"
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
-struct SystemEntry { int order; std::function<void(double)> tick; bool enabled; };
+struct SystemEntry {
+    SystemDesc desc;
+    std::vector<int> reads, writes; // ids de ressources triés
+    bool exclusive = false;         // aucune déclaration -> conflit avec tous
+    const char* zone = nullptr;     // nom de zone profileur (interné)
+    // Multi-fréquence: temps accumulé dans la période courante, tranches déjà faites
+    double acc = 0.0;
+    size_t sliceCount = 0, slicesDone = 0;
+    // Plan du tick courant (calculé avant l'exécution, sur le thread appelant)
+    int runs = 0; double runDt = 0.0;
+    size_t sliceBegin = 0, sliceEnd = 0;
+    int batchTicks = 0;             // lot: un appel tickBatch(runDt, batchTicks)
+    bool batchNow = false;          // updateFixedBatch: avance en un appel (aucun conflit avec un système tick par tick)
+
+    bool sliced() const { return desc.tickSlice && desc.rateHz > 0.0; }
+};
 
 struct SchedulerImpl {
 public:
     std::vector<SystemEntry> systems;
+    std::unordered_map<std::string, int> resourceIds; std::vector<std::string> resourceNames;
+    bool parallel = true;
+    double lastDt = 0.0;
+    std::mutex pendingM; std::vector<std::function<void()>> pending; // setEnabled/setRate différés
+
+    // Graphe (reconstruit seulement quand la liste de systèmes change)
+    struct Graph {
+        std::vector<size_t> topo;              // ordre séquentiel de référence (order, enregistrement)
+        std::vector<std::vector<size_t>> succ; // arêtes directes après réduction transitive
+        std::vector<std::vector<size_t>> pred;
+        std::vector<int> level;                // profondeur dans le DAG
+    };
+    bool dirty = true;
+    Graph graph;
+    std::unique_ptr<std::atomic<int>[]> remaining;
+
+    int resourceId(const std::string& name) {
+        auto it = resourceIds.find(name); if (it != resourceIds.end()) return it->second;
+        int id = (int)resourceNames.size(); resourceIds.emplace(name, id); resourceNames.push_back(name); return id;
+    }
+    static bool Intersects(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>* out) {
+        bool any = false;
+        for (size_t i=0, j=0; i<a.size() && j<b.size(); ) {
+            if (a[i] < b[j]) ++i; else if (b[j] < a[i]) ++j; else { any = true; if (!out) return true; out->push_back(a[i]); ++i; ++j; }
+        }
+        return any;
+    }
+    // Ressources en conflit entre a et b (lecture/écriture ou écriture/écriture); -1 = exclusif
+    bool conflict(const SystemEntry& a, const SystemEntry& b, std::vector<int>* on = nullptr) const {
+        if (a.exclusive || b.exclusive) { if (on) on->push_back(-1); return true; }
+        bool c = Intersects(a.writes, b.writes, on);
+        if (c && !on) return true;
+        c |= Intersects(a.writes, b.reads, on); if (c && !on) return true;
+        c |= Intersects(a.reads, b.writes, on);
+        return c;
+    }
+
+    Graph computeGraph() const {
+        const size_t n = systems.size();
+        Graph g; auto& topo = g.topo; auto& succ = g.succ; auto& pred = g.pred; auto& level = g.level;
+        topo.resize(n); for (size_t i=0; i<n; ++i) topo[i] = i;
+        std::stable_sort(topo.begin(), topo.end(), [&](size_t a, size_t b){ return systems[a].desc.order < systems[b].desc.order; });
+        succ.assign(n, {}); pred.assign(n, {}); level.assign(n, 0);
+        // Ancêtres par bitset: une arête p->j est redondante si p est déjà ancêtre d'un prédécesseur gardé
+        const size_t words = (n + 63) / 64;
+        std::vector<uint64_t> anc(n * words, 0);
+        std::vector<size_t> pos(n); for (size_t k=0; k<n; ++k) pos[topo[k]] = k;
+        for (size_t pj=0; pj<n; ++pj) {
+            const size_t j = topo[pj]; uint64_t* aj = &anc[j * words];
+            for (size_t pp=pj; pp-- > 0; ) {
+                const size_t p = topo[pp];
+                if (!conflict(systems[p], systems[j])) continue;
+                if (aj[p / 64] & (1ull << (p % 64))) continue;
+                succ[p].push_back(j); pred[j].push_back(p);
+                const uint64_t* ap = &anc[p * words];
+                for (size_t w=0; w<words; ++w) aj[w] |= ap[w];
+                aj[p / 64] |= 1ull << (p % 64);
+                level[j] = std::max(level[j], level[p] + 1);
+            }
+            std::sort(pred[j].begin(), pred[j].end(), [&](size_t a, size_t b){ return pos[a] < pos[b]; });
+        }
+        return g;
+    }
+
+    void build() {
+        graph = computeGraph();
+        remaining.reset(new std::atomic<int>[systems.size()]);
+        dirty = false;
+    }
+
+    // Phase initiale des systèmes lents non découpés (suite de Weyl: décalages bien répartis)
+    static double Phase(size_t index) { double p = (double)index * 0.6180339887498949; return p - std::floor(p); }
+
+    void resetRate(SystemEntry& e, size_t index) {
+        e.sliceCount = 0; e.slicesDone = 0;
+        e.acc = (e.desc.rateHz > 0.0 && !e.sliced()) ? Phase(index) / e.desc.rateHz : 0.0;
+    }
+
+    void setRate(size_t i, double hz) {
+        SystemEntry& e = systems[i]; hz = std::max(0.0, hz);
+        if (hz == e.desc.rateHz) return;
+        if (e.desc.rateHz <= 0.0 || hz <= 0.0) { e.desc.rateHz = hz; resetRate(e, i); return; }
+        // Même position relative dans la nouvelle période
+        const double frac = std::min(1.0, e.acc * e.desc.rateHz);
+        e.desc.rateHz = hz; e.acc = frac / hz;
+        if (e.sliced()) { e.sliceCount = SliceCountFor(e, lastDt); e.slicesDone = std::min(e.sliceCount, (size_t)(frac * (double)e.sliceCount)); }
+    }
+
+    static size_t SliceCountFor(const SystemEntry& e, double dt) {
+        if (e.desc.slices > 0) return e.desc.slices;
+        if (dt <= 0.0) return 1;
+        return (size_t)std::max(1.0, std::round(1.0 / (e.desc.rateHz * dt)));
+    }
+
+    static void Unplan(SystemEntry& e) { e.runs = 0; e.sliceBegin = e.sliceEnd = 0; e.batchTicks = 0; }
+
+    // Ce qui doit tourner ce tick (déterministe, avant l'exécution parallèle)
+    static void Plan(SystemEntry& e, double dt) {
+        Unplan(e);
+        if (!e.desc.enabled || (!e.desc.tick && !e.desc.tickSlice)) return;
+        if (e.desc.rateHz <= 0.0) { e.runs = 1; e.runDt = dt; return; }
+        const double period = 1.0 / e.desc.rateHz, eps = 1e-9;
+        e.acc += dt; e.runDt = period;
+        if (!e.sliced()) {
+            while (e.acc + eps >= period && e.runs < 64) { e.acc -= period; ++e.runs; }
+            return;
+        }
+        if (e.sliceCount == 0) e.sliceCount = SliceCountFor(e, dt);
+        size_t target = std::min(e.sliceCount, (size_t)(e.acc / period * (double)e.sliceCount + 1e-6));
+        e.sliceBegin = e.slicesDone; e.sliceEnd = std::max(target, e.slicesDone); e.slicesDone = e.sliceEnd;
+        if (e.slicesDone >= e.sliceCount) { e.acc = std::max(0.0, e.acc - period); e.slicesDone = 0; e.sliceCount = SliceCountFor(e, dt); }
+    }
+
+    // Lot pour un système avec tickBatch: périodes entières écoulées sur ticks*dt (tranches en cours abandonnées)
+    static void PlanBatch(SystemEntry& e, double dt, int ticks) {
+        Unplan(e);
+        if (!e.desc.enabled || !e.desc.tickBatch) return;
+        if (e.desc.rateHz <= 0.0) { e.batchTicks = ticks; e.runDt = dt; return; }
+        const double period = 1.0 / e.desc.rateHz;
+        e.acc += dt * (double)ticks; e.runDt = period;
+        const double k = std::floor((e.acc + 1e-9) / period);
+        e.acc = std::max(0.0, e.acc - k * period); e.batchTicks = (int)k; e.slicesDone = 0;
+    }
+
+    void runSystem(size_t i) {
+        SystemEntry& e = systems[i];
+        Profiler::Zone zone(e.zone);
+        if (e.batchTicks > 0) { e.desc.tickBatch(e.runDt, e.batchTicks); return; }
+        for (int r=0; r<e.runs; ++r) { if (e.desc.tick) e.desc.tick(e.runDt); else e.desc.tickSlice(e.runDt, 0, 1); }
+        for (size_t k=e.sliceBegin; k<e.sliceEnd; ++k) e.desc.tickSlice(e.runDt, k, e.sliceCount);
+    }
+
+    bool idle(size_t i) const { const SystemEntry& e = systems[i]; return e.runs == 0 && e.sliceBegin == e.sliceEnd && e.batchTicks == 0; }
+
+    void applyPending() {
+        std::vector<std::function<void()>> changes;
+        { std::lock_guard<std::mutex> lk(pendingM); changes.swap(pending); }
+        for (auto& c : changes) c();
+        if (dirty) build();
+    }
+
+    // Exécute le plan courant: DAG sur le pool, ou séquentiel dans l'ordre topologique
+    void execute() {
+        const size_t n = systems.size();
+        size_t active = 0; for (size_t i=0; i<n; ++i) active += idle(i) ? 0 : 1;
+        if (active == 0) return;
+        ThreadPool& pool = ThreadPool::Shared();
+        const auto& topo = graph.topo; const auto& succ = graph.succ; const auto& pred = graph.pred;
+        if (!parallel || pool.workerCount() == 0 || active == 1) { for (size_t i : topo) if (!idle(i)) runSystem(i); return; }
+
+        for (size_t i=0; i<n; ++i) remaining[i].store((int)pred[i].size(), std::memory_order_relaxed);
+        ThreadPool::TaskGroup group(pool);
+        // Un système terminé libère ses successeurs: le premier prêt continue sur le même thread, les autres sont publiés
+        std::function<void(size_t)> run = [&](size_t i) {
+            for (;;) {
+                if (!idle(i)) runSystem(i);
+                size_t next = (size_t)-1;
+                for (size_t j : succ[i]) {
+                    if (remaining[j].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                    if (next == (size_t)-1) next = j; else group.run([&run, j]{ run(j); });
+                }
+                if (next == (size_t)-1) return;
+                i = next;
+            }
+        };
+        for (size_t i : topo) if (pred[i].empty()) group.run([&run, i]{ run(i); });
+        group.wait();
+    }
 };
 
 Scheduler::Scheduler() : impl_(new SchedulerImpl) {}
 Scheduler::~Scheduler() { delete impl_; }
 
-void Scheduler::addSystem(int order, std::function<void(double)> onFixedUpdate, bool enabled) {
-    impl_->systems.push_back({order, std::move(onFixedUpdate), enabled});
+size_t Scheduler::addSystem(SystemDesc desc) {
+    SystemEntry e; e.exclusive = desc.reads.empty() && desc.writes.empty();
+    for (auto& r : desc.reads) e.reads.push_back(impl_->resourceId(r));
+    for (auto& w : desc.writes) e.writes.push_back(impl_->resourceId(w));
+    for (auto* v : { &e.reads, &e.writes }) { std::sort(v->begin(), v->end()); v->erase(std::unique(v->begin(), v->end()), v->end()); }
+    if (desc.name.empty()) desc.name = "system#" + std::to_string(impl_->systems.size());
+    e.zone = Profiler::Intern(desc.name);
+    e.desc = std::move(desc); e.desc.rateHz = std::max(0.0, e.desc.rateHz);
+    impl_->resetRate(e, impl_->systems.size());
+    impl_->systems.push_back(std::move(e)); impl_->dirty = true;
+    return impl_->systems.size() - 1;
+}
+
+size_t Scheduler::addSystem(int order, std::function<void(double)> onFixedUpdate, bool enabled) {
+    SystemDesc d; d.order = order; d.tick = std::move(onFixedUpdate); d.enabled = enabled;
+    return addSystem(std::move(d));
+}
+
+void Scheduler::setEnabled(size_t idx, bool e) {
+    std::lock_guard<std::mutex> lk(impl_->pendingM);
+    impl_->pending.push_back([this, idx, e]{ if (idx < impl_->systems.size()) impl_->systems[idx].desc.enabled = e; });
 }
 
-void Scheduler::setEnabled(size_t idx, bool e) { if (idx < impl_->systems.size()) impl_->systems[idx].enabled = e; }
+void Scheduler::setRate(size_t idx, double rateHz) {
+    std::lock_guard<std::mutex> lk(impl_->pendingM);
+    impl_->pending.push_back([this, idx, rateHz]{ if (idx < impl_->systems.size()) impl_->setRate(idx, rateHz); });
+}
+
+size_t Scheduler::systemCount() const { return impl_->systems.size(); }
+
+size_t Scheduler::find(const std::string& name) const {
+    for (size_t i=0; i<impl_->systems.size(); ++i) if (impl_->systems[i].desc.name == name) return i;
+    return npos;
+}
+void Scheduler::setParallel(bool parallel) { impl_->parallel = parallel; }
 
 void Scheduler::updateFixed(double dt) {
-    std::stable_sort(impl_->systems.begin(), impl_->systems.end(), [](const auto& a, const auto& b){ return a.order < b.order; });
-    for (auto& s : impl_->systems) if (s.enabled && s.tick) s.tick(dt);
+    PROFILE_ZONE("Scheduler::updateFixed");
+    SchedulerImpl& s = *impl_;
+    s.applyPending();
+    if (s.systems.empty()) return;
+    s.lastDt = dt;
+    for (auto& e : s.systems) SchedulerImpl::Plan(e, dt);
+    s.execute();
+}
+
+void Scheduler::updateFixedBatch(double dt, int ticks) {
+    if (ticks <= 1) { if (ticks == 1) updateFixed(dt); return; }
+    PROFILE_ZONE("Scheduler::updateFixedBatch");
+    SchedulerImpl& s = *impl_;
+    s.applyPending();
+    if (s.systems.empty()) return;
+    s.lastDt = dt;
+    // Un système n'avance en un appel que s'il n'est en conflit avec aucun système qui tourne tick par tick
+    // (sinon l'entrelacement changerait); point fixe car un système rétrogradé peut en bloquer d'autres.
+    for (auto& e : s.systems) e.batchNow = e.desc.enabled && e.desc.tickBatch;
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (auto& b : s.systems) {
+            if (!b.batchNow) continue;
+            for (auto& o : s.systems) if (&o != &b && o.desc.enabled && !o.batchNow && (o.desc.tick || o.desc.tickSlice || o.desc.tickBatch) && s.conflict(b, o)) { b.batchNow = false; changed = true; break; }
+        }
+    }
+    bool anyBatched = false, anyPerTick = false;
+    for (auto& e : s.systems) { if (!e.desc.enabled) continue; (e.batchNow ? anyBatched : anyPerTick) = true; }
+    if (anyPerTick) for (int t=0; t<ticks; ++t) {
+        for (auto& e : s.systems) {
+            if (e.batchNow) SchedulerImpl::Unplan(e);
+            else if (!e.desc.tick && !e.desc.tickSlice) SchedulerImpl::PlanBatch(e, dt, 1); // tickBatch seul, rétrogradé
+            else SchedulerImpl::Plan(e, dt);
+        }
+        s.execute();
+    }
+    if (anyBatched) { for (auto& e : s.systems) { if (e.batchNow) SchedulerImpl::PlanBatch(e, dt, ticks); else SchedulerImpl::Unplan(e); } s.execute(); }
+}
+
+std::string Scheduler::dumpSchedule() const {
+    const SchedulerImpl& s = *impl_;
+    // Graphe courant, ou calculé à part s'il est périmé (le thread de simulation reconstruit le sien dans applyPending)
+    const SchedulerImpl::Graph fresh = s.dirty ? s.computeGraph() : SchedulerImpl::Graph{};
+    const SchedulerImpl::Graph& g = s.dirty ? fresh : s.graph;
+    int levels = 0; for (int l : g.level) levels = std::max(levels, l + 1);
+    std::ostringstream o;
+    o << "Schedule: " << s.systems.size() << " systems, " << levels << " levels, " << (s.parallel ? "parallel" : "sequential")
+      << ", workers=" << ThreadPool::Shared().workerCount() << "\n";
+    auto names = [&](const std::vector<int>& ids) { std::string r; for (int id : ids) { if (!r.empty()) r += ","; r += id < 0 ? "*" : s.resourceNames[id]; } return r; };
+    for (int l=0; l<levels; ++l) {
+        o << "L" << l << ":\n";
+        for (size_t i : g.topo) {
+            if (g.level[i] != l) continue;
+            const SystemEntry& e = s.systems[i];
+            o << "  #" << i << " " << e.desc.name << " order=" << e.desc.order << (e.desc.enabled ? "" : " (disabled)");
+            if (e.desc.rateHz > 0.0) { o << " rate=" << e.desc.rateHz << "Hz"; if (e.sliced()) o << " slices=" << (e.sliceCount ? e.sliceCount : SchedulerImpl::SliceCountFor(e, s.lastDt)); }
+            if (e.exclusive) o << " exclusive"; else o << " reads=[" << names(e.reads) << "] writes=[" << names(e.writes) << "]";
+            o << "\n";
+            for (size_t p : g.pred[i]) { std::vector<int> on; s.conflict(s.systems[p], e, &on); std::sort(on.begin(), on.end()); on.erase(std::unique(on.begin(), on.end()), on.end()); o << "      after " << s.systems[p].desc.name << " on [" << names(on) << "]\n"; }
+        }
+    }
+    return o.str();
 }
@@ -1,21 +1,69 @@
 #pragma once
 #include <cstddef>
 #include <functional>
+#include <string>
+#include <vector>
 
-// [7] Minimal fixed-timestep scheduler to orchestrate systems.
+// Déclaration d'un système: accès aux ressources (composants, "TileMap", "Economy"...) par nom.
+// Deux systèmes sont en conflit si l'un écrit une ressource que l'autre lit ou écrit; sans conflit ils peuvent
+// s'exécuter en parallèle. Un système sans aucune déclaration est exclusif (conflit avec tous).
+struct SystemDesc {
+    std::string name;
+    int order = 0;                       // entre systèmes en conflit: plus petit d'abord (puis ordre d'enregistrement)
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+    std::function<void(double)> tick;
+    bool enabled = true;
+
+    // Fréquence propre (Hz): 0 = chaque tick fixe. Un système à 1 Hz reçoit dt = 1 s une fois par seconde,
+    // avec une phase décalée pour que les systèmes lents ne tombent pas tous sur le même tick.
+    double rateHz = 0.0;
+    // Travail découpé par paquets d'entités: tickSlice(dt, slice, sliceCount) est appelé pour chaque tranche,
+    // réparties sur la période (1 Hz à 60 Hz -> 60 tranches, une par tick). dt = période complète.
+    std::function<void(double dt, size_t slice, size_t sliceCount)> tickSlice;
+    size_t slices = 0;                   // 0 = une tranche par tick fixe sur la période
+    // Optionnel (timewarp): avance de 'ticks' pas de dt en un appel. Sans lui, un lot rejoue les ticks un par un.
+    std::function<void(double dt, int ticks)> tickBatch;
+};
+
+// [7] Fixed-timestep scheduler: graphe de dépendances construit à l'enregistrement, exécution sur le pool
+// à vol de travail. Déterministe: tout couple en conflit garde l'ordre (order, enregistrement).
 class Scheduler {
   public:
     Scheduler();
     ~Scheduler();
 
-    // Register a system callback with an execution order. Lower order runs first.
-    void addSystem(int order, std::function<void(double)> onFixedUpdate,
+    // Register a system; returns its index (registration order).
+    size_t addSystem(SystemDesc desc);
+    // Compat: système exclusif sans déclaration d'accès. Lower order runs first.
+    size_t addSystem(int order, std::function<void(double)> onFixedUpdate,
                    bool enabled = true);
     // Enable/disable a previously registered system by index (in registration order).
     void setEnabled(size_t idx, bool enabled);
+    // Changement de fréquence à chaud (changement de niveau monde/ville/personnage); la phase dans la période
+    // est conservée. setEnabled/setRate peuvent venir d'un autre thread: appliqués au début du tick suivant.
+    void setRate(size_t idx, double rateHz);
+    size_t systemCount() const;
+    static constexpr size_t npos = (size_t)-1;
+    size_t find(const std::string& name) const;
 
-    // Execute all enabled systems in order with the given fixed delta time.
+    // Plage [begin,end) de la tranche 'slice' sur 'count' éléments (tranches de tailles quasi égales)
+    static void SliceRange(size_t count, size_t slice, size_t sliceCount, size_t& begin, size_t& end) {
+        begin = count * slice / sliceCount; end = count * (slice + 1) / sliceCount;
+    }
+
+    // false: exécution séquentielle dans l'ordre topologique (debug, comparaison)
+    void setParallel(bool parallel);
+
+    // Execute all enabled systems with the given fixed delta time.
     void updateFixed(double dt);
+    // Lot de 'ticks' pas (timewarp): les systèmes sans tickBatch tournent tick par tick comme updateFixed,
+    // puis chaque système avec tickBatch avance en un seul appel. Un système avec tickBatch en conflit avec un
+    // système tick par tick est rétrogradé (tick par tick lui aussi) pour garder l'entrelacement de updateFixed.
+    void updateFixedBatch(double dt, int ticks);
+
+    // Ordre, niveaux (systèmes d'un même niveau peuvent tourner ensemble), dépendances et ressources en conflit
+    std::string dumpSchedule() const;
 
   private:
     struct SchedulerImpl* impl_;
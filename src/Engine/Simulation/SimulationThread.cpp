@@ -0,0 +1,177 @@
+#include "SimulationThread.h"
+#include "TripleBuffer.h"
+#include "../../Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+constexpr double kEma = 0.05; // poids des moyennes glissantes
+inline void Ema(double& avg, double v) { avg = avg == 0.0 ? v : avg + (v - avg) * kEma; }
+}
+
+struct SimulationThreadImpl {
+    std::function<void(double)> fixedUpdate;
+    double step = 1.0 / 60.0;
+    SimulationThread::SnapshotWriter writer;
+    std::function<void(double, int)> batchUpdate;
+    int maxCatchUp = 8;
+
+    mutable std::mutex settingsMutex; Timewarp::Settings warp; int pendingSteps = 0;
+    double tickCostMs = 0.0;       // coût estimé d'un tick (lots compris), pour dimensionner les lots au budget
+
+    TripleBuffer<SimSnapshot> buffer;
+    SimSnapshot previous;          // côté rendu: front précédent (échangé à l'acquire, pas de copie)
+
+    // Côté simulation
+    double last = 0.0, accumulator = 0.0, simTime = 0.0; uint64_t tick = 0; bool clockStarted = false;
+
+    std::thread thread;
+    std::atomic<bool> stopRequested{false}, running{false};
+
+    mutable std::mutex statsMutex; SimStats stats;
+
+    void advance(double now) {
+        Timewarp::Settings tw; int steps;
+        { std::lock_guard<std::mutex> lk(settingsMutex); tw = warp; steps = pendingSteps; pendingSteps = 0; }
+        if (!clockStarted) { last = now; clockStarted = true; }
+        const double wall = now - last; last = now;
+        accumulator += wall * tw.speed + (double)steps * step;
+        // Trop de retard (hitch, vitesse hors de portée): on abandonne plutôt que de geler le rendu
+        const double maxBacklog = (double)maxCatchUp * step * std::max(1.0, tw.speed) + (double)steps * step;
+        uint64_t dropped = 0;
+        if (accumulator > maxBacklog) { dropped = (uint64_t)((accumulator - maxBacklog) / step) + 1; accumulator -= (double)dropped * step; }
+
+        const double start = SimulationThread::Now(), budget = tw.frameBudgetMs / 1000.0;
+        uint64_t done = 0, batches = 0, batchTicks = 0; bool limited = false; double tickMs = 0.0, maxMs = 0.0;
+        while (accumulator >= step) {
+            const double spent = SimulationThread::Now() - start;
+            if (done > 0 && spent >= budget) { limited = true; break; }
+            const int due = (int)std::min(accumulator / step, 1e6);
+            int k = 1;
+            if (batchUpdate && due >= std::max(2, tw.batchThreshold)) {
+                // Autant de ticks que le budget restant en permet, d'après le coût mesuré
+                const double left = std::max(0.0, budget - spent) * 1000.0;
+                k = tickCostMs > 0.0 ? (int)std::clamp(left / tickCostMs, 1.0, (double)due) : std::min(due, tw.batchThreshold);
+            }
+            const double t0 = SimulationThread::Now();
+            if (k > 1) { batchUpdate(step, k); ++batches; batchTicks += (uint64_t)k; }
+            else if (fixedUpdate) fixedUpdate(step);
+            const double ms = (SimulationThread::Now() - t0) * 1000.0;
+            Ema(tickCostMs, ms / k); tickMs = ms / k; maxMs = std::max(maxMs, ms);
+            tick += (uint64_t)k; simTime += step * k; accumulator -= step * k; done += (uint64_t)k;
+        }
+        if (limited) { // le budget ne suit pas: l'arriéré au-delà d'un pas est abandonné, la vitesse effective baisse
+            uint64_t drop = (uint64_t)(accumulator / step); accumulator -= (double)drop * step; dropped += drop;
+        }
+        {
+            std::lock_guard<std::mutex> lk(statsMutex);
+            stats.droppedTicks += dropped; stats.requestedSpeed = tw.speed; stats.ticks += done;
+            if (wall > 0.0) Ema(stats.effectiveSpeed, (double)done * step / wall);
+            if (done > 0) { Ema(stats.tickMs, tickMs); stats.tickMaxMs = std::max(stats.tickMaxMs * (1.0 - kEma), maxMs); }
+            if (batches > 0) { stats.batches += batches; Ema(stats.ticksPerBatch, (double)batchTicks / (double)batches); }
+            if (limited) ++stats.budgetHits;
+        }
+        if (done == 0) return;
+        PROFILE_ZONE("Sim.snapshot");
+        SimSnapshot& s = buffer.back();
+        s.tick = tick; s.simTime = simTime; s.dueTime = now - (tw.speed > 0.0 ? accumulator / tw.speed : 0.0);
+        s.speed = tw.speed; s.clearEntities();
+        if (writer) writer(s);
+        s.publishTime = SimulationThread::Now();
+        buffer.publish();
+        std::lock_guard<std::mutex> lk(statsMutex); ++stats.snapshotsPublished;
+    }
+
+    // Temps mur jusqu'au prochain tick dû (borné à un pas pour voir les changements de vitesse)
+    double nextWait() const {
+        double speed; { std::lock_guard<std::mutex> lk(settingsMutex); speed = warp.speed; if (pendingSteps > 0) return 0.0; }
+        if (speed <= 0.0) return step;
+        return std::clamp((step - accumulator) / speed, 0.0, step);
+    }
+
+    void loop() {
+        Profiler::SetThreadName("Simulation");
+        while (!stopRequested.load(std::memory_order_acquire)) {
+            advance(SimulationThread::Now());
+            double wait = nextWait();
+            if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait)); else std::this_thread::yield();
+        }
+    }
+};
+
+SimulationThread::SimulationThread(std::function<void(double)> fixedUpdate, double fixedStep) : impl_(new SimulationThreadImpl) {
+    impl_->fixedUpdate = std::move(fixedUpdate); impl_->step = fixedStep > 0.0 ? fixedStep : 1.0 / 60.0;
+}
+SimulationThread::~SimulationThread() { stop(); delete impl_; }
+
+void SimulationThread::setSnapshotWriter(SnapshotWriter writer) { impl_->writer = std::move(writer); }
+void SimulationThread::setMaxCatchUpTicks(int n) { impl_->maxCatchUp = std::max(n, 1); }
+void SimulationThread::setBatchUpdate(std::function<void(double, int)> batchUpdate) { impl_->batchUpdate = std::move(batchUpdate); }
+
+void SimulationThread::setTimewarp(const Timewarp::Settings& settings) {
+    std::lock_guard<std::mutex> lk(impl_->settingsMutex);
+    impl_->warp = settings;
+    impl_->warp.speed = settings.speed > 0.0 ? std::min(settings.speed, Timewarp::kMaxSpeed) : 0.0; // NaN/négatif -> pause
+    impl_->warp.frameBudgetMs = std::max(0.1, settings.frameBudgetMs);
+}
+Timewarp::Settings SimulationThread::timewarp() const { std::lock_guard<std::mutex> lk(impl_->settingsMutex); return impl_->warp; }
+void SimulationThread::setSpeed(double speed) { Timewarp::Settings s = timewarp(); s.speed = speed; setTimewarp(s); }
+void SimulationThread::stepTicks(int ticks) { std::lock_guard<std::mutex> lk(impl_->settingsMutex); impl_->pendingSteps += std::max(ticks, 0); }
+
+void SimulationThread::start() {
+    if (impl_->running.load()) return;
+    impl_->stopRequested.store(false); impl_->clockStarted = false; impl_->accumulator = 0.0; // pas de rattrapage du temps arrêté
+    impl_->running.store(true);
+    impl_->thread = std::thread([this]{ impl_->loop(); });
+}
+void SimulationThread::stop() {
+    if (!impl_->running.load()) return;
+    impl_->stopRequested.store(true, std::memory_order_release);
+    if (impl_->thread.joinable()) impl_->thread.join();
+    impl_->running.store(false); impl_->clockStarted = false;
+}
+bool SimulationThread::running() const { return impl_->running.load(); }
+
+void SimulationThread::pump() { if (!running()) impl_->advance(Now()); }
+
+bool SimulationThread::acquire() {
+    bool fresh = impl_->buffer.acquire([&](SimSnapshot& old){ std::swap(impl_->previous, old); });
+    if (fresh) {
+        double latency = (Now() - impl_->buffer.front().publishTime) * 1000.0;
+        std::lock_guard<std::mutex> lk(impl_->statsMutex); Ema(impl_->stats.snapshotLatencyMs, latency); ++impl_->stats.snapshotsConsumed;
+    }
+    return fresh;
+}
+const SimSnapshot& SimulationThread::current() const { return impl_->buffer.front(); }
+const SimSnapshot& SimulationThread::previous() const { return impl_->previous; }
+
+double SimulationThread::alpha(double now) const {
+    const double a = impl_->previous.dueTime, b = current().dueTime, speed = current().speed;
+    if (b <= a || !(speed > 0.0)) return 1.0; // pause (pas à pas): dernier état
+    return std::clamp((now - impl_->step / speed - a) / (b - a), 0.0, 1.0);
+}
+
+void SimulationThread::interpolate(double now, std::vector<uint32_t>& ids, std::vector<glm::vec2>& positions) const {
+    const SimSnapshot& p = previous(); const SimSnapshot& c = current();
+    const float t = (float)alpha(now);
+    ids.assign(c.ids.begin(), c.ids.end()); positions.resize(c.positions.size());
+    size_t j = 0;
+    for (size_t i=0; i<c.ids.size(); ++i) {
+        while (j < p.ids.size() && p.ids[j] < c.ids[i]) ++j;
+        const glm::vec2 to = c.positions[i];
+        positions[i] = (j < p.ids.size() && p.ids[j] == c.ids[i]) ? p.positions[j] + (to - p.positions[j]) * t : to;
+    }
+}
+
+void SimulationThread::reportRenderTime(double ms) { std::lock_guard<std::mutex> lk(impl_->statsMutex); Ema(impl_->stats.renderMs, ms); }
+SimStats SimulationThread::stats() const { std::lock_guard<std::mutex> lk(impl_->statsMutex); return impl_->stats; }
+double SimulationThread::fixedStep() const { return impl_->step; }
+
+double SimulationThread::Now() {
+    using namespace std::chrono;
+    static const steady_clock::time_point t0 = steady_clock::now();
+    return duration<double>(steady_clock::now() - t0).count();
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/vec2.hpp>
+#include "Timewarp.h"
+
+// État publié par la simulation, immuable une fois publié. Les entités sont triées par id
+// pour que l'interpolation apparie deux snapshots par fusion linéaire.
+struct SimSnapshot {
+    uint64_t tick = 0;          // nombre de ticks simulés
+    double   simTime = 0.0;     // temps simulé (s)
+    double   dueTime = 0.0;     // horloge murale (SimulationThread::Now) à laquelle ce tick correspond
+    double   publishTime = 0.0; // horloge murale de publication
+    double   speed = 1.0;       // vitesse timewarp à la publication (0 = pause): un pas simulé = step / speed en temps mur
+    std::vector<uint32_t>  ids;       // triés croissants
+    std::vector<glm::vec2> positions; // monde, parallèle à ids
+
+    void clearEntities() { ids.clear(); positions.clear(); }
+};
+
+// Compteurs (ms sauf mention contraire), moyennes glissantes exponentielles
+struct SimStats {
+    double tickMs = 0.0, tickMaxMs = 0.0;   // durée d'un updateFixed
+    double renderMs = 0.0;                  // durée d'une frame rendu (rapportée par le thread rendu)
+    double snapshotLatencyMs = 0.0;         // publication -> première lecture par le rendu
+    uint64_t ticks = 0, droppedTicks = 0, snapshotsPublished = 0, snapshotsConsumed = 0;
+    // Timewarp: vitesse demandée vs obtenue (temps simulé / temps mur), lots, itérations limitées par le budget
+    double requestedSpeed = 1.0, effectiveSpeed = 0.0, ticksPerBatch = 0.0;
+    uint64_t batches = 0, budgetHits = 0;
+};
+
+// Simulation à pas fixe sur son propre thread (fixedUpdate -> Scheduler::updateFixed), publication par triple buffer.
+// Le rendu acquiert le dernier snapshot et interpole entre les deux derniers avec la fraction d'accumulateur.
+// Les systèmes du Scheduler s'exécutent sur le thread simulation: ils ne doivent pas toucher l'état du rendu/GL.
+class SimulationThread {
+public:
+    using SnapshotWriter = std::function<void(SimSnapshot& out)>; // remplit les entités (thread simulation)
+
+    SimulationThread(std::function<void(double)> fixedUpdate, double fixedStep);
+    ~SimulationThread();
+
+    void setSnapshotWriter(SnapshotWriter writer); // avant start()
+    void setMaxCatchUpTicks(int n);                // ticks max par rattrapage (au-delà: ticks abandonnés), x vitesse
+    // Lot de N ticks en un appel (Scheduler::updateFixedBatch), utilisé en timewarp au-delà de batchThreshold
+    void setBatchUpdate(std::function<void(double dt, int ticks)> batchUpdate); // avant start()
+
+    // Timewarp (thread-safe, pris en compte à l'itération suivante)
+    void setTimewarp(const Timewarp::Settings& settings);
+    Timewarp::Settings timewarp() const;
+    void setSpeed(double speed);                   // 0 = pause, borné à Timewarp::kMaxSpeed
+    void stepTicks(int ticks = 1);                 // pas à pas (y compris en pause)
+
+    void start(); // lance le thread
+    void stop();  // attend la fin du tick en cours
+    bool running() const;
+
+    // Mode sans thread (debug/headless): exécute les ticks dus sur le thread appelant
+    void pump();
+
+    // Côté rendu: récupère le snapshot le plus récent; retourne true s'il est nouveau
+    bool acquire();
+    const SimSnapshot& current() const;
+    const SimSnapshot& previous() const;
+    // Fraction [0,1] entre previous() et current() pour l'instant 'now' (rendu décalé d'un pas simulé, en temps mur
+    // step / speed; 1 en pause)
+    double alpha(double now) const;
+    // Positions interpolées par id (fusion des deux snapshots; entités nouvelles/disparues non interpolées)
+    void interpolate(double now, std::vector<uint32_t>& ids, std::vector<glm::vec2>& positions) const;
+
+    void reportRenderTime(double ms);
+    SimStats stats() const;
+    double fixedStep() const;
+
+    static double Now(); // horloge monotone (s)
+
+private:
+    struct SimulationThreadImpl* impl_;
+};
@@ -1,3 +1,28 @@
 #pragma once
-// [6] TODO: Timewarp: pause, x0.5, x1, x2, x4, step-by-step
-namespace Timewarp { /* ... */ }
+#include <cstddef>
+
+// [6] Timewarp: pause, x0.5 ... x1000, pas à pas. La vitesse multiplie le temps mur injecté dans l'accumulateur
+// de SimulationThread; au-delà de batchThreshold ticks dus, les systèmes qui le déclarent avancent N ticks en un appel
+// (SystemDesc::tickBatch). Le budget par frame borne le travail: la vitesse effective est alors rapportée (SimStats).
+namespace Timewarp {
+
+inline constexpr double kSpeeds[] = { 0.0, 0.5, 1.0, 2.0, 4.0, 10.0, 30.0, 100.0, 300.0, 1000.0 };
+inline constexpr int kSpeedCount = (int)(sizeof(kSpeeds) / sizeof(kSpeeds[0]));
+inline constexpr double kMaxSpeed = 1000.0;
+
+struct Settings {
+    double speed = 1.0;          // 0 = pause
+    double frameBudgetMs = 10.0; // temps mur max de simulation par itération (au-delà: vitesse effective réduite)
+    int batchThreshold = 4;      // ticks dus à partir desquels on passe en lot
+};
+
+// Palier le plus proche de 'speed'
+inline int IndexOf(double speed) {
+    int best = 0;
+    for (int i=1; i<kSpeedCount; ++i) { double d = kSpeeds[i] - speed, b = kSpeeds[best] - speed; if (d*d < b*b) best = i; }
+    return best;
+}
+inline double Faster(double speed) { int i = IndexOf(speed); return kSpeeds[i + 1 < kSpeedCount ? i + 1 : i]; }
+inline double Slower(double speed) { int i = IndexOf(speed); return kSpeeds[i > 0 ? i - 1 : 0]; }
+
+}
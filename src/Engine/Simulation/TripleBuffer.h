@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Triple buffer sans verrou, un producteur / un consommateur.
+// Le producteur écrit back() puis publish(); le consommateur appelle acquire() puis lit front().
+// Aucun des deux ne bloque: le producteur écrase la version non lue la plus ancienne.
+template<class T>
+class TripleBuffer {
+public:
+    T& back() { return slots_[back_]; }
+    void publish() { back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndex; }
+
+    // true si une nouvelle version a été publiée depuis le dernier acquire.
+    // retire(old) est appelé sur l'ancien front avant qu'il ne retourne au producteur (ex: swap vers une copie locale).
+    template<class Retire> bool acquire(Retire&& retire) {
+        if (!(middle_.load(std::memory_order_acquire) & kFresh)) return false;
+        retire(slots_[front_]);
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    bool acquire() { return acquire([](T&){}); }
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint32_t kIndex = 3u, kFresh = 4u;
+    T slots_[3];
+    uint32_t back_ = 0, front_ = 2;       // propres à chaque côté
+    std::atomic<uint32_t> middle_{1u};    // slot d'échange (+ bit "fresh")
+};
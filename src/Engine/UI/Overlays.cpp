@@ -0,0 +1,33 @@
+#include "Overlays.h"
+#include <imgui.h>
+
+void Overlays::drawProfiler(double now) {
+    if (!profilerVisible_) return;
+    // Les stats parcourent tous les anneaux: rafraîchies 4 fois par seconde
+    if (lastRefresh_ < 0.0 || now - lastRefresh_ > 0.25) { stats_ = Profiler::Stats(windowSec_); lastRefresh_ = now; }
+    ImGui::SetNextWindowSize(ImVec2(560, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", &profilerVisible_)) { ImGui::End(); return; }
+    bool enabled = Profiler::Enabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) Profiler::SetEnabled(enabled);
+    ImGui::SameLine(); ImGui::SetNextItemWidth(120); ImGui::SliderFloat("Window (s)", &windowSec_, 0.5f, 10.0f, "%.1f");
+    ImGui::SetNextItemWidth(260); ImGui::InputText("##trace", tracePath_, sizeof(tracePath_)); ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) lastExport_ = Profiler::ExportChromeTrace(tracePath_) ? std::string("Saved ") + tracePath_ : std::string("Export failed");
+    if (!lastExport_.empty()) { ImGui::SameLine(); ImGui::TextUnformatted(lastExport_.c_str()); }
+    if (ImGui::BeginTable("zones", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Zone"); ImGui::TableSetupColumn("Calls"); ImGui::TableSetupColumn("Min ms"); ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("P99 ms"); ImGui::TableSetupColumn("Max ms"); ImGui::TableSetupColumn("Total ms");
+        ImGui::TableHeadersRow();
+        for (auto& z : stats_) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(z.name);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)z.calls);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.minMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.avgMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.p99Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", z.maxMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", z.totalMs);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
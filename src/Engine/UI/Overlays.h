@@ -1,3 +1,21 @@
 #pragma once
-// [11] TODO: Overlays: debug (fps, culling), infos carte/ville (heatmaps)
-struct Overlays { /* ... */ };
+#include <string>
+#include <vector>
+#include "../../Core/Profiler.h"
+
+// [11] Overlays debug: profileur (zones min/avg/p99 glissants, export trace Chrome).
+// TODO: culling, infos carte/ville (heatmaps)
+class Overlays {
+public:
+    void toggleProfiler() { profilerVisible_ = !profilerVisible_; }
+    bool profilerVisible() const { return profilerVisible_; }
+    void drawProfiler(double now);   // now: horloge secondes (rafraîchissement des stats)
+
+private:
+    bool profilerVisible_ = false;
+    float windowSec_ = 2.0f;         // fenêtre glissante des stats
+    double lastRefresh_ = -1.0;
+    std::vector<Profiler::ZoneStats> stats_;
+    char tracePath_[256] = "warland_trace.json";
+    std::string lastExport_;
+};
@@ -0,0 +1,70 @@
+// AdaptiveGrid.h - subdivision adaptative (kd-split) d'un raster de palette en cellules quasi uniformes
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Rendering/GL/TileMap.h"
+
+namespace AdaptiveGrid {
+    // forEachRect(x, y, w, h, visit) doit appeler visit(uint16_t palette) pour chaque cellule du rectangle,
+    // en commençant par (x,y) (disposition ligne ou chunkée: le résultat est identique).
+    // Accepte une boîte si >= majorityThreshold d'un index (ou largeur/hauteur 1); les boîtes mêlant eau
+    // profonde (0) et peu profonde (1) sont subdivisées pour garder le littoral. Retourne false si maxCells atteint.
+    template<class ForEachRect>
+    bool Build(int width, int height, float worldW, float worldH, ForEachRect&& forEachRect,
+               std::vector<AdaptiveCell>& out, float majorityThreshold = 0.99f, size_t maxCells = 200000) {
+        struct Node { int x,y,w,h; };
+        std::vector<Node> stack; stack.push_back({0,0,width,height});
+        out.reserve(out.size() + 4096);
+        const float cellSizeX = worldW / (float)width, cellSizeY = worldH / (float)height;
+        while(!stack.empty()) {
+            Node n = stack.back(); stack.pop_back();
+            int area = n.w * n.h;
+            // Boyer-Moore majority pass
+            uint16_t cand = 0; int cnt = 0; bool first = true;
+            forEachRect(n.x, n.y, n.w, n.h, [&](uint16_t p){
+                if (first) { cand=p; cnt=1; first=false; }
+                else if (p==cand) cnt++; else { cnt--; if (cnt==0){ cand=p; cnt=1; } }
+            });
+            // Validation du candidat + détection coexistence eau profonde / peu profonde
+            int occ = 0; bool hasDeep=false, hasShallow=false;
+            forEachRect(n.x, n.y, n.w, n.h, [&](uint16_t pv){ if (pv==0) hasDeep=true; else if (pv==1) hasShallow=true; if (pv==cand) occ++; });
+            float frac = (float)occ / (float)area;
+            bool waterMix = (hasDeep && hasShallow && area>1); // mélange 0 & 1 dans la même boîte
+            bool accept = ((frac >= majorityThreshold) || n.w==1 || n.h==1);
+            if (waterMix && (cand==0 || cand==1) && area>4) accept=false; // force subdivision pour conserver bande littorale
+            if (accept) {
+                out.push_back({ n.x * cellSizeX, n.y * cellSizeY, n.w * cellSizeX, n.h * cellSizeY, cand, 0.f });
+            } else {
+                if (n.w >= n.h) {
+                    int w1 = n.w/2; if (w1<1) w1=1; int w2 = n.w - w1; if (w2<1) w2=1;
+                    stack.push_back({n.x+w1, n.y, w2, n.h});
+                    stack.push_back({n.x, n.y, w1, n.h});
+                } else {
+                    int h1 = n.h/2; if (h1<1) h1=1; int h2 = n.h - h1; if (h2<1) h2=1;
+                    stack.push_back({n.x, n.y+h1, n.w, h2});
+                    stack.push_back({n.x, n.y, n.w, h1});
+                }
+            }
+            if (out.size() > maxCells) return false;
+        }
+        return true;
+    }
+
+    // Raster ligne (paletteIndices)
+    inline bool BuildRowMajor(const std::vector<uint16_t>& palette, int width, int height, float worldW, float worldH,
+                              std::vector<AdaptiveCell>& out, float majorityThreshold = 0.99f, size_t maxCells = 200000) {
+        const uint16_t* p = palette.data();
+        return Build(width, height, worldW, worldH, [&](int x0, int y0, int w, int h, auto&& visit){
+            for (int y=y0; y<y0+h; ++y) { const uint16_t* row = p + (size_t)y*width; for (int x=x0; x<x0+w; ++x) visit(row[x]); }
+        }, out, majorityThreshold, maxCells);
+    }
+
+    // Raster chunké 64x64 Z-order
+    inline bool BuildChunked(const ChunkedRaster<uint16_t>& palette, float worldW, float worldH,
+                             std::vector<AdaptiveCell>& out, float majorityThreshold = 0.99f, size_t maxCells = 200000) {
+        return Build(palette.width(), palette.height(), worldW, worldH, [&](int x0, int y0, int w, int h, auto&& visit){
+            palette.forEachInRect(x0, y0, w, h, [&](int, int, const uint16_t& v){ visit(v); });
+        }, out, majorityThreshold, maxCells);
+    }
+}
@@ -1,5 +1,6 @@
 #include "BiomeGenerator.h"
 #include "../Rendering/GL/TileMap.h"
+#include "../../Platform/ThreadPool.h"
 #include <glm/common.hpp>
 #include <glm/gtc/constants.hpp>
 #include <cmath>
@@ -15,6 +16,22 @@ static float HashNoise(int x, int y, uint64_t seed) {
     return (float)(h & 0xFFFFFFFFull) / 4294967295.0f;
 }
 
+// Hauteur d'un pixel pour un biome donné (échantillonnage multi-octaves simple, centré sur baseElevation)
+static float SampleBiomeHeight(int x, int y, const BiomeGenConfig& cfg, uint64_t seed) {
+    float h = 0.f; float sumW=0.f;
+    float freq = cfg.roughness; float amp = 1.f;
+    for (int o=0; o<4; ++o) {
+        int nx = (int)std::floor(x * freq);
+        int ny = (int)std::floor(y * freq);
+        float n = HashNoise(nx, ny, seed + (uint64_t)o*0x9E37ull);
+        h += n * amp; sumW += amp; amp *= 0.5f; freq *= 2.0f;
+    }
+    if (sumW>0) h/=sumW;
+    // centre autour de baseElevation puis applique variance
+    h = cfg.baseElevation + (h - 0.5f) * cfg.elevationVariance;
+    return std::clamp(h, 0.f, 1.f);
+}
+
 void BiomeGenerator::EnsureBiomeSeed(TileMap& map, int biomeId, uint64_t globalSeed) {
     if (biomeId < 0) return;
     if ((size_t)biomeId >= map.biomeSeeds.size()) map.biomeSeeds.resize(biomeId+1, 0);
@@ -56,6 +73,7 @@ BiomeGenConfig BiomeGenerator::DefaultConfigFor(const std::string& biomeName) {
 void BiomeGenerator::GenerateHeightsForBiome(TileMap& map, int biomeId, const BiomeGenConfig& cfg) {
     if (biomeId < 0) return;
     if (map.width <=0 || map.height<=0) return;
+    map.unpackHeights(); // écriture partielle: repartir des hauteurs existantes
     if (map.tileHeights.size() != (size_t)map.width * map.height) map.tileHeights.resize((size_t)map.width * map.height, 0.f);
     if ((size_t)biomeId >= map.biomeSeeds.size()) return; // EnsureBiomeSeed non appelé
     uint64_t seed = map.biomeSeeds[biomeId];
@@ -69,22 +87,84 @@ void BiomeGenerator::GenerateHeightsForBiome(TileMap& map, int biomeId, const Bi
                 uint16_t pal = map.paletteIndices[idx];
                 int bId = (pal >= 2) ? (int)pal - 2 : -1; // -1 eau
                 if (bId == biomeId) {
-                    // échantillonnage multi-octaves simple
-                    float h = 0.f; float sumW=0.f;
-                    float freq = cfg.roughness; float amp = 1.f;
-                    for (int o=0; o<4; ++o) {
-                        int nx = (int)std::floor(x * freq);
-                        int ny = (int)std::floor(y * freq);
-                        float n = HashNoise(nx, ny, seed + (uint64_t)o*0x9E37ull);
-                        h += n * amp; sumW += amp; amp *= 0.5f; freq *= 2.0f;
-                    }
-                    if (sumW>0) h/=sumW;
-                    // centre autour de baseElevation puis applique variance
-                    h = cfg.baseElevation + (h - 0.5f) * cfg.elevationVariance;
-                    h = std::clamp(h, 0.f, 1.f);
+                    float h = SampleBiomeHeight(x, y, cfg, seed);
                     map.tileHeights[idx] = h;
                 }
             }
         }
     }
 }
+
+std::vector<BiomeGenConfig> BiomeGenerator::DefaultConfigsFor(const TileMap& map) {
+    std::vector<BiomeGenConfig> cfgs; cfgs.reserve(map.biomeNames.size());
+    for (auto& n : map.biomeNames) cfgs.push_back(DefaultConfigFor(n));
+    return cfgs;
+}
+
+void BiomeGenerator::GenerateHeightsAllBiomes(TileMap& map, const std::vector<BiomeGenConfig>& configs, int blendRadius) {
+    if (map.width <=0 || map.height<=0) return;
+    const int w = map.width, h = map.height;
+    const size_t total = (size_t)w * h;
+    if (map.paletteIndices.size() != total) return;
+    map.unpackHeights();
+    if (map.tileHeights.size() != total) map.tileHeights.resize(total, 0.f);
+
+    // Table résolue par biomeId: config + seed (seed 0 = biome non généré, comme GenerateHeightsForBiome)
+    const size_t nBiomes = std::max({configs.size(), map.biomeSeeds.size(), map.biomeNames.size()});
+    std::vector<BiomeGenConfig> cfgs(nBiomes);
+    std::vector<uint64_t> seeds(nBiomes, 0);
+    for (size_t b=0; b<nBiomes; ++b) {
+        if (b < configs.size()) cfgs[b] = configs[b];
+        else cfgs[b] = DefaultConfigFor(b < map.biomeNames.size() ? map.biomeNames[b] : std::string());
+        if (b < map.biomeSeeds.size()) seeds[b] = map.biomeSeeds[b];
+    }
+    auto biomeAt = [&](int x, int y)->int {
+        uint16_t pal = map.paletteIndices[(size_t)y * w + x];
+        int b = (pal >= 2) ? (int)pal - 2 : -1; // -1 eau
+        return (b >= 0 && (size_t)b < nBiomes && seeds[b] != 0) ? b : -1;
+    };
+
+    // Passe unique par blocs: un bloc dont le voisinage (+blendRadius) ne contient qu'un biome terrestre
+    // est généré directement; sinon chaque pixel mélange les biomes d'un stencil 5x5 (poids en tente).
+    const int R = std::max(blendRadius, 0);
+    const int step = std::max(1, R / 2);
+    constexpr int kBlock = 32;
+    const int blocksX = (w + kBlock - 1) / kBlock, blocksY = (h + kBlock - 1) / kBlock;
+    ThreadPool::Shared().parallelFor((size_t)blocksX * blocksY, 4, [&](size_t begin, size_t end){
+        for (size_t bi=begin; bi<end; ++bi) {
+            const int x0 = (int)(bi % blocksX) * kBlock, y0 = (int)(bi / blocksX) * kBlock;
+            const int x1 = std::min(x0 + kBlock, w), y1 = std::min(y0 + kBlock, h);
+            int single = -1; bool mixed = false;
+            for (int y=std::max(0,y0-R); y<std::min(h,y1+R) && !mixed; ++y) {
+                for (int x=std::max(0,x0-R); x<std::min(w,x1+R); ++x) {
+                    int b = biomeAt(x, y); if (b < 0) continue;
+                    if (single < 0) single = b; else if (b != single) { mixed = true; break; }
+                }
+            }
+            if (single < 0) continue; // bloc entièrement eau
+            for (int y=y0; y<y1; ++y) {
+                for (int x=x0; x<x1; ++x) {
+                    int own = biomeAt(x, y); if (own < 0) continue;
+                    size_t idx = (size_t)y * w + x;
+                    if (!mixed || R == 0) { map.tileHeights[idx] = SampleBiomeHeight(x, y, cfgs[own], seeds[own]); continue; }
+                    int ids[25]; float wts[25]; int n = 0;
+                    for (int j=-2; j<=2; ++j) {
+                        int yy = std::clamp(y + j*step, 0, h-1);
+                        for (int i=-2; i<=2; ++i) {
+                            int xx = std::clamp(x + i*step, 0, w-1);
+                            int b = biomeAt(xx, yy); if (b < 0) continue;
+                            float wt = (float)((3 - std::abs(i)) * (3 - std::abs(j)));
+                            int k = 0; while (k < n && ids[k] != b) ++k;
+                            if (k == n) { ids[n] = b; wts[n] = 0.f; ++n; }
+                            wts[k] += wt;
+                        }
+                    }
+                    if (n == 1) { map.tileHeights[idx] = SampleBiomeHeight(x, y, cfgs[own], seeds[own]); continue; }
+                    float acc = 0.f, sumW = 0.f;
+                    for (int k=0; k<n; ++k) { acc += wts[k] * SampleBiomeHeight(x, y, cfgs[ids[k]], seeds[ids[k]]); sumW += wts[k]; }
+                    map.tileHeights[idx] = acc / sumW;
+                }
+            }
+        }
+    });
+}
@@ -27,4 +27,10 @@ public:
     static void EnsureBiomeSeed(TileMap& map, int biomeId, uint64_t globalSeed);
     static BiomeGenConfig DefaultConfigFor(const std::string& biomeName);
     static void GenerateHeightsForBiome(TileMap& map, int biomeId, const BiomeGenConfig& cfg);
+    // Table de configs par biomeId construite à partir de map.biomeNames (DefaultConfigFor)
+    static std::vector<BiomeGenConfig> DefaultConfigsFor(const TileMap& map);
+    // Génère les hauteurs de tous les biomes en une seule passe parallèle sur paletteIndices.
+    // configs indexé par biomeId (biome sans entrée -> DefaultConfigFor(nom)); seeds lues dans map.biomeSeeds (EnsureBiomeSeed).
+    // blendRadius (pixels): près d'une frontière la hauteur est la moyenne pondérée des biomes voisins (0 = pas de mélange).
+    static void GenerateHeightsAllBiomes(TileMap& map, const std::vector<BiomeGenConfig>& configs, int blendRadius = 4);
 };
@@ -0,0 +1,349 @@
+#include "Hydrology.h"
+#include "../Rendering/GL/TileMap.h"
+#include "../../Platform/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+constexpr uint8_t  kNoFlow = HydrologyResult::kNoFlow;
+constexpr uint8_t  kFlat = 0xFE;          // temporaire: aucune pente descendante, résolu ensuite
+constexpr uint32_t kNone = 0xFFFFFFFFu;
+constexpr uint32_t kOceanLabel = 1;       // label global des exutoires (mer + bord de carte)
+constexpr uint32_t kPending = 0x80000000u; // bassin: cible hors tuile à résoudre
+static const int   kDx[8] = { 1, 1, 0,-1,-1,-1, 0, 1 };
+static const int   kDy[8] = { 0, 1, 1, 1, 0,-1,-1,-1 };
+static const float kDist[8] = { 1.f, 1.41421356f, 1.f, 1.41421356f, 1.f, 1.41421356f, 1.f, 1.41421356f };
+
+static double MsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+struct Tile { int x0, y0, w, h; };
+
+struct Grid {
+    int w = 0, h = 0, ts = 1, tilesX = 0, tilesY = 0;
+    int tileCount() const { return tilesX * tilesY; }
+    Tile tile(int t) const { int tx = t % tilesX, ty = t / tilesX; int x0 = tx*ts, y0 = ty*ts; return { x0, y0, std::min(ts, w-x0), std::min(ts, h-y0) }; }
+    bool inTile(const Tile& T, uint32_t g) const { int x = (int)(g % (uint32_t)w), y = (int)(g / (uint32_t)w); return x>=T.x0 && y>=T.y0 && x<T.x0+T.w && y<T.y0+T.h; }
+    uint32_t local(const Tile& T, uint32_t g) const { int x = (int)(g % (uint32_t)w), y = (int)(g / (uint32_t)w); return (uint32_t)((y-T.y0)*T.w + (x-T.x0)); }
+    uint32_t global(const Tile& T, uint32_t l) const { return (uint32_t)((T.y0 + (int)(l / (uint32_t)T.w)) * w + T.x0 + (int)(l % (uint32_t)T.w)); }
+};
+
+struct FloodCell { float e; uint32_t l; };
+struct FloodOrder { bool operator()(const FloodCell& a, const FloodCell& b) const { return a.e > b.e || (a.e == b.e && a.l > b.l); } };
+
+struct TileFlood {
+    uint32_t labelCount = 0;                   // labels locaux 2..labelCount+1
+    std::unordered_map<uint64_t, float> spill; // (labelA<<32 | labelB), a<b -> altitude min de débordement
+};
+
+struct Entry { uint32_t cell; uint32_t exit; uint32_t inflow; }; // cellule recevant un flux d'une autre tuile
+struct TileFlow {
+    std::vector<uint32_t> order;  // ordre topologique local (amont -> aval)
+    std::vector<uint32_t> exits;  // cellules dont l'aval est hors tuile
+    std::vector<Entry>    entries;
+};
+
+static inline uint64_t SpillKey(uint32_t a, uint32_t b) { if (a > b) std::swap(a, b); return ((uint64_t)a << 32) | b; }
+static inline void AddSpill(std::unordered_map<uint64_t, float>& m, uint32_t a, uint32_t b, float e) {
+    auto [it, inserted] = m.emplace(SpillKey(a, b), e);
+    if (!inserted && e < it->second) it->second = e;
+}
+}
+
+namespace Hydrology {
+
+bool Generate(TileMap& map, const HydrologyConfig& cfg, HydrologyResult* out) {
+    if (map.width <= 1 || map.height <= 1) return false;
+    const int w = map.width, h = map.height;
+    const size_t total = (size_t)w * h;
+    std::vector<float> decoded; const float* H = map.heightData(decoded); // hauteurs float ou couche quantifiée décodée
+    const size_t heightCount = map.heightsQuantized() ? map.tileHeightsQ.size() : map.tileHeights.size();
+    if (heightCount != total || total >= (size_t)kPending) return false;
+    const bool hasPalette = map.paletteIndices.size() == total;
+    auto isOutlet = [&](int x, int y, size_t g) {
+        return x==0 || y==0 || x==w-1 || y==h-1 || H[g] <= cfg.seaLevel || (hasPalette && map.paletteIndices[g] < 2);
+    };
+    auto isSea = [&](size_t g) { return H[g] <= cfg.seaLevel || (hasPalette && map.paletteIndices[g] < 2); };
+
+    Grid grid; grid.w = w; grid.h = h; grid.ts = std::max(cfg.tileSize, 16);
+    grid.tilesX = (w + grid.ts - 1) / grid.ts; grid.tilesY = (h + grid.ts - 1) / grid.ts;
+    const int tileCount = grid.tileCount();
+    ThreadPool& pool = ThreadPool::Shared();
+
+    HydrologyResult local; HydrologyResult& res = out ? *out : local;
+    res = HydrologyResult{};
+    std::vector<float>& filled = res.filled; filled.assign(H, H + total);
+    std::vector<uint32_t> labels(total, 0);
+
+    // 1) Priority-Flood par tuile: chaque tuile est comblée relativement à son périmètre, les cellules reçoivent
+    //    le label de leur graine; les paires de labels adjacents donnent un graphe de débordement.
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<TileFlood> floods(tileCount);
+    pool.parallelFor((size_t)tileCount, 1, [&](size_t begin, size_t end){
+        for (size_t t=begin; t<end; ++t) {
+            const Tile T = grid.tile((int)t); TileFlood& tf = floods[t];
+            std::vector<uint8_t> closed((size_t)T.w * T.h, 0);
+            std::priority_queue<FloodCell, std::vector<FloodCell>, FloodOrder> open;
+            std::queue<uint32_t> pit;
+            for (int ly=0; ly<T.h; ++ly) for (int lx=0; lx<T.w; ++lx) {
+                uint32_t l = (uint32_t)(ly*T.w + lx); size_t g = (size_t)(T.y0+ly)*w + T.x0+lx;
+                bool perim = lx==0 || ly==0 || lx==T.w-1 || ly==T.h-1;
+                if (isOutlet(T.x0+lx, T.y0+ly, g)) { labels[g] = kOceanLabel; closed[l] = 1; open.push({filled[g], l}); }
+                else if (perim) { closed[l] = 1; open.push({filled[g], l}); }
+            }
+            uint32_t nextLabel = 2;
+            while (!open.empty() || !pit.empty()) {
+                uint32_t c;
+                if (!pit.empty()) { c = pit.front(); pit.pop(); } else { c = open.top().l; open.pop(); }
+                const int cx = (int)(c % (uint32_t)T.w), cy = (int)(c / (uint32_t)T.w);
+                const size_t gc = (size_t)(T.y0+cy)*w + T.x0+cx; const float ce = filled[gc];
+                if (labels[gc] == 0) labels[gc] = nextLabel++;
+                const uint32_t L = labels[gc];
+                for (int k=0; k<8; ++k) {
+                    int nx = cx + kDx[k], ny = cy + kDy[k]; if (nx<0 || ny<0 || nx>=T.w || ny>=T.h) continue;
+                    uint32_t ln = (uint32_t)(ny*T.w + nx); size_t gn = (size_t)(T.y0+ny)*w + T.x0+nx;
+                    if (closed[ln]) { uint32_t Ln = labels[gn]; if (Ln != 0 && Ln != L) AddSpill(tf.spill, L, Ln, std::max(ce, filled[gn])); continue; }
+                    closed[ln] = 1; labels[gn] = L;
+                    if (filled[gn] <= ce) { filled[gn] = ce; pit.push(ln); }
+                    else open.push({filled[gn], ln});
+                }
+            }
+            tf.labelCount = nextLabel - 2;
+        }
+    });
+    // Labels globaux: 1 = mer, puis plages contiguës par tuile
+    std::vector<uint32_t> labelOffset(tileCount, 0); uint32_t labelTotal = 2;
+    for (int t=0; t<tileCount; ++t) { labelOffset[t] = labelTotal; labelTotal += floods[t].labelCount; }
+    auto toGlobal = [&](int t, uint32_t l) { return l <= kOceanLabel ? l : labelOffset[t] + (l - 2); };
+    pool.parallelFor((size_t)tileCount, 1, [&](size_t begin, size_t end){
+        for (size_t t=begin; t<end; ++t) { const Tile T = grid.tile((int)t);
+            for (int y=T.y0; y<T.y0+T.h; ++y) for (int x=T.x0; x<T.x0+T.w; ++x) { size_t g = (size_t)y*w + x; labels[g] = toGlobal((int)t, labels[g]); } }
+    });
+    // Graphe de débordement: arêtes internes aux tuiles + arêtes entre cellules de tuiles voisines
+    std::unordered_map<uint64_t, float> spill;
+    for (int t=0; t<tileCount; ++t) for (auto& [key, e] : floods[t].spill) AddSpill(spill, toGlobal(t, (uint32_t)(key >> 32)), toGlobal(t, (uint32_t)key), e);
+    floods.clear();
+    for (int t=0; t<tileCount; ++t) { const Tile T = grid.tile(t);
+        for (int ly=0; ly<T.h; ++ly) for (int lx=0; lx<T.w; ++lx) {
+            if (!(lx==0 || ly==0 || lx==T.w-1 || ly==T.h-1)) continue;
+            int x = T.x0+lx, y = T.y0+ly; size_t g = (size_t)y*w + x;
+            for (int k=0; k<8; ++k) {
+                int nx = x + kDx[k], ny = y + kDy[k]; if (nx<0 || ny<0 || nx>=w || ny>=h) continue;
+                if (nx>=T.x0 && ny>=T.y0 && nx<T.x0+T.w && ny<T.y0+T.h) continue;
+                size_t gn = (size_t)ny*w + nx; if (labels[gn] != labels[g]) AddSpill(spill, labels[g], labels[gn], std::max(filled[g], filled[gn]));
+            }
+        }
+    }
+    // Priority-Flood sur le graphe: niveau d'eau minimal pour que chaque label rejoigne la mer
+    std::vector<std::vector<std::pair<uint32_t,float>>> adj(labelTotal);
+    for (auto& [key, e] : spill) { uint32_t a = (uint32_t)(key >> 32), b = (uint32_t)key; adj[a].push_back({b, e}); adj[b].push_back({a, e}); }
+    spill.clear();
+    std::vector<float> level(labelTotal, -std::numeric_limits<float>::infinity());
+    {
+        std::vector<uint8_t> done(labelTotal, 0);
+        using LabelCell = std::pair<float, uint32_t>;
+        std::priority_queue<LabelCell, std::vector<LabelCell>, std::greater<LabelCell>> pq;
+        pq.push({-std::numeric_limits<float>::infinity(), kOceanLabel});
+        while (!pq.empty()) {
+            auto [e, a] = pq.top(); pq.pop();
+            if (done[a]) continue; done[a] = 1; level[a] = e;
+            for (auto& [b, s] : adj[a]) if (!done[b]) pq.push({std::max(e, s), b});
+        }
+    }
+    adj.clear();
+    pool.parallelFor((size_t)h, 16, [&](size_t begin, size_t end){
+        for (size_t y=begin; y<end; ++y) for (int x=0; x<w; ++x) { size_t g = y*w + x; filled[g] = std::max(filled[g], level[labels[g]]); }
+    });
+    res.fillMs = MsSince(t0);
+
+    // 2) Directions D8 (plus forte pente) puis résolution des plats par BFS depuis leurs exutoires
+    t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t>& dir = res.flowDir; dir.assign(total, kNoFlow);
+    pool.parallelFor((size_t)h, 16, [&](size_t begin, size_t end){
+        for (size_t y=begin; y<end; ++y) for (int x=0; x<w; ++x) {
+            size_t g = y*w + x; if (isOutlet(x, (int)y, g)) continue;
+            float best = 0.f; uint8_t bd = kFlat;
+            for (int k=0; k<8; ++k) {
+                size_t gn = (size_t)((int)y + kDy[k])*w + (x + kDx[k]);
+                float drop = (filled[g] - filled[gn]) / kDist[k];
+                if (drop > best) { best = drop; bd = (uint8_t)k; }
+            }
+            dir[g] = bd;
+        }
+    });
+    auto down = [&](uint32_t g)->uint32_t { uint8_t d = dir[g]; if (d >= 8) return kNone; return (uint32_t)((int)g + kDy[d]*w + kDx[d]); };
+    {
+        std::vector<uint32_t> queue; size_t head = 0;
+        for (size_t g=0; g<total; ++g) {
+            if (dir[g] != kFlat) continue; int x = (int)(g % w), y = (int)(g / w);
+            for (int k=0; k<8; ++k) {
+                size_t gn = (size_t)(y + kDy[k])*w + (x + kDx[k]);
+                bool resolvedNb = dir[gn] < 8 || dir[gn] == kNoFlow; // exclut les graines marquées (0x80|k) de ce balayage
+                if (resolvedNb && filled[gn] <= filled[g]) { dir[g] = (uint8_t)(k | 0x80); queue.push_back((uint32_t)g); break; }
+            }
+        }
+        for (uint32_t g : queue) dir[g] &= 0x7F;
+        while (head < queue.size()) {
+            uint32_t g = queue[head++]; int x = (int)(g % w), y = (int)(g / w);
+            for (int k=0; k<8; ++k) {
+                int nx = x + kDx[k], ny = y + kDy[k]; if (nx<0 || ny<0 || nx>=w || ny>=h) continue;
+                size_t gn = (size_t)ny*w + nx;
+                if (dir[gn] == kFlat && filled[gn] == filled[g]) { dir[gn] = (uint8_t)((k + 4) & 7); queue.push_back((uint32_t)gn); }
+            }
+        }
+        for (auto& d : dir) if (d == kFlat) d = kNoFlow;
+    }
+    res.flowMs = MsSince(t0);
+
+    // 3) Accumulation par tuiles: ordre topologique local, flux sortants fusionnés sur le graphe des bords,
+    //    puis propagation des flux entrants dans chaque tuile
+    t0 = std::chrono::steady_clock::now();
+    std::vector<uint32_t>& acc = res.accumulation; acc.assign(total, 1u);
+    std::vector<TileFlow> flows(tileCount);
+    pool.parallelFor((size_t)tileCount, 1, [&](size_t begin, size_t end){
+        for (size_t t=begin; t<end; ++t) {
+            const Tile T = grid.tile((int)t); TileFlow& tf = flows[t]; const uint32_t n = (uint32_t)(T.w * T.h);
+            std::vector<uint8_t> indeg(n, 0);
+            for (uint32_t l=0; l<n; ++l) { uint32_t d = down(grid.global(T, l)); if (d != kNone && grid.inTile(T, d)) indeg[grid.local(T, d)]++; }
+            tf.order.reserve(n);
+            for (uint32_t l=0; l<n; ++l) if (indeg[l] == 0) tf.order.push_back(l);
+            for (size_t i=0; i<tf.order.size(); ++i) {
+                uint32_t g = grid.global(T, tf.order[i]); uint32_t d = down(g);
+                if (d == kNone || !grid.inTile(T, d)) continue;
+                acc[d] += acc[g]; uint32_t ld = grid.local(T, d); if (--indeg[ld] == 0) tf.order.push_back(ld);
+            }
+            // Sortie de tuile atteinte par chaque cellule (parcours aval -> amont)
+            std::vector<uint32_t> link(n, kNone);
+            for (size_t i=tf.order.size(); i-- > 0; ) {
+                uint32_t l = tf.order[i]; uint32_t g = grid.global(T, l); uint32_t d = down(g);
+                if (d == kNone) continue;
+                if (!grid.inTile(T, d)) { link[l] = g; tf.exits.push_back(g); }
+                else link[l] = link[grid.local(T, d)];
+            }
+            for (int ly=0; ly<T.h; ++ly) for (int lx=0; lx<T.w; ++lx) {
+                if (!(lx==0 || ly==0 || lx==T.w-1 || ly==T.h-1)) continue;
+                int x = T.x0+lx, y = T.y0+ly; uint32_t g = (uint32_t)(y*w + x);
+                for (int k=0; k<8; ++k) {
+                    int nx = x + kDx[k], ny = y + kDy[k]; if (nx<0 || ny<0 || nx>=w || ny>=h) continue;
+                    uint32_t gn = (uint32_t)(ny*w + nx); if (grid.inTile(T, gn)) continue;
+                    if (down(gn) == g) { tf.entries.push_back({g, link[(uint32_t)(ly*T.w + lx)], 0}); break; }
+                }
+            }
+        }
+    });
+    {
+        // Graphe des sorties: F(x) = acc local(x) + flux entrants dont le chemin ressort par x
+        std::unordered_map<uint32_t, Entry*> entryOf;
+        std::unordered_map<uint32_t, uint32_t> exitIdx; std::vector<uint32_t> exitCell;
+        for (auto& tf : flows) { for (auto& e : tf.entries) entryOf[e.cell] = &e; for (uint32_t x : tf.exits) { exitIdx[x] = (uint32_t)exitCell.size(); exitCell.push_back(x); } }
+        std::vector<uint32_t> F(exitCell.size()), indeg(exitCell.size(), 0);
+        for (size_t i=0; i<exitCell.size(); ++i) {
+            F[i] = acc[exitCell[i]];
+            Entry* e = entryOf[down(exitCell[i])];
+            if (e && e->exit != kNone) indeg[exitIdx[e->exit]]++;
+        }
+        std::vector<uint32_t> ready; for (size_t i=0; i<exitCell.size(); ++i) if (indeg[i] == 0) ready.push_back((uint32_t)i);
+        for (size_t r=0; r<ready.size(); ++r) {
+            uint32_t i = ready[r]; Entry* e = entryOf[down(exitCell[i])]; if (!e) continue;
+            e->inflow += F[i];
+            if (e->exit == kNone) continue;
+            uint32_t j = exitIdx[e->exit]; F[j] += F[i]; if (--indeg[j] == 0) ready.push_back(j);
+        }
+    }
+    pool.parallelFor((size_t)tileCount, 1, [&](size_t begin, size_t end){
+        for (size_t t=begin; t<end; ++t) {
+            const Tile T = grid.tile((int)t); TileFlow& tf = flows[t];
+            std::vector<uint32_t> add((size_t)T.w * T.h, 0);
+            for (auto& e : tf.entries) add[grid.local(T, e.cell)] += e.inflow;
+            for (uint32_t l : tf.order) {
+                if (add[l] == 0) continue;
+                uint32_t g = grid.global(T, l); acc[g] += add[l];
+                uint32_t d = down(g); if (d != kNone && grid.inTile(T, d)) add[grid.local(T, d)] += add[l];
+            }
+        }
+    });
+    res.accumMs = MsSince(t0);
+
+    // 4) Bassins versants: exutoire terminal de chaque cellule (par tuile puis résolution des sorties), IDs denses
+    t0 = std::chrono::steady_clock::now();
+    std::vector<uint32_t>& term = labels; // réutilise le buffer des labels
+    pool.parallelFor((size_t)tileCount, 1, [&](size_t begin, size_t end){
+        for (size_t t=begin; t<end; ++t) {
+            const Tile T = grid.tile((int)t); const auto& order = flows[t].order;
+            for (size_t i=order.size(); i-- > 0; ) {
+                uint32_t g = grid.global(T, order[i]); uint32_t d = down(g);
+                if (d == kNone) term[g] = g;
+                else if (!grid.inTile(T, d)) term[g] = d | kPending;
+                else term[g] = term[d];
+            }
+        }
+    });
+    std::unordered_map<uint32_t, uint32_t> resolved;
+    for (auto& tf : flows) for (auto& e : tf.entries) {
+        std::vector<uint32_t> chain; uint32_t c = e.cell, r = kNone;
+        for (;;) {
+            auto it = resolved.find(c); if (it != resolved.end()) { r = it->second; break; }
+            chain.push_back(c); uint32_t v = term[c];
+            if (!(v & kPending)) { r = v; break; }
+            c = v & ~kPending;
+        }
+        for (uint32_t q : chain) resolved[q] = r;
+    }
+    flows.clear();
+    pool.parallelFor((size_t)h, 16, [&](size_t begin, size_t end){
+        for (size_t y=begin; y<end; ++y) for (int x=0; x<w; ++x) { size_t g = y*w + x; if (term[g] & kPending) term[g] = resolved.at(term[g] & ~kPending); }
+    });
+    map.watersheds.assign(total, 0u);
+    {
+        std::vector<uint32_t> rootId(total, 0); uint32_t count = 0; // IDs attribués dans l'ordre de balayage (déterministe)
+        for (size_t g=0; g<total; ++g) {
+            if (isSea(g)) continue;
+            uint32_t r = term[g]; if (rootId[r] == 0) rootId[r] = ++count;
+            map.watersheds[g] = rootId[r];
+        }
+        res.watershedCount = count;
+    }
+    res.watershedMs = MsSince(t0);
+
+    // 5) Fleuves: cellules terrestres d'accumulation >= seuil, polylignes de source/confluence jusqu'à la confluence suivante ou la mer
+    t0 = std::chrono::steady_clock::now();
+    map.rivers.clear();
+    auto isRiver = [&](uint32_t g) { return acc[g] >= cfg.riverThreshold && !isSea(g); };
+    std::vector<uint8_t> donors(total, 0);
+    for (uint32_t g=0; g<(uint32_t)total; ++g) { if (!isRiver(g)) continue; uint32_t d = down(g); if (d != kNone && donors[d] < 255) donors[d]++; }
+    for (uint32_t s=0; s<(uint32_t)total; ++s) {
+        if (!isRiver(s) || donors[s] == 1) continue; // départ: source (0 affluent) ou confluence (>=2)
+        River rv; rv.watershed = map.watersheds[s];
+        std::vector<uint32_t> path{ s }; uint32_t c = down(s), last = s;
+        while (c != kNone) {
+            path.push_back(c);
+            if (!isRiver(c) || donors[c] >= 2) break;
+            last = c; c = down(c);
+        }
+        if (donors[s] == 0 && (int)path.size() < cfg.minRiverLength) continue;
+        rv.flow = acc[last];
+        rv.points.reserve(path.size());
+        for (size_t i=0; i<path.size(); ++i) {
+            // ne garde que les changements de direction (+ extrémités)
+            if (i > 0 && i+1 < path.size() && dir[path[i-1]] == dir[path[i]]) continue;
+            rv.points.push_back({ (int)(path[i] % (uint32_t)w), (int)(path[i] / (uint32_t)w) });
+        }
+        map.rivers.push_back(std::move(rv));
+    }
+    res.riversMs = MsSince(t0);
+
+    if (cfg.writeFilledHeights) {
+        const bool wasQuantized = !map.tileHeightsQ.empty(), floatKept = !map.tileHeights.empty();
+        map.tileHeights = filled; map.tileHeightsQ.clear();
+        if (wasQuantized) map.quantizeHeights(!floatKept); // même représentation qu'en entrée
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,30 @@
+// Hydrology.h - drainage dérivé de tileHeights: comblement des dépressions, directions D8, accumulation, fleuves
+#pragma once
+#include <cstdint>
+#include <vector>
+struct TileMap; // fwd
+
+struct HydrologyConfig {
+    int      tileSize = 256;          // taille des tuiles du traitement parallèle (cellules)
+    float    seaLevel = 0.f;          // hauteur <= seaLevel => mer (exutoire); paletteIndices 0/1 aussi
+    uint32_t riverThreshold = 400;    // accumulation minimale (cellules drainées) pour former un fleuve
+    int      minRiverLength = 8;      // tronçons de source plus courts ignorés (cellules)
+    bool     writeFilledHeights = false; // remplace tileHeights par la surface comblée
+};
+
+// Codage D8 de flowDir: 0..7 = E, SE, S, SW, W, NW, N, NE (y vers le bas); kNoFlow = exutoire
+struct HydrologyResult {
+    static constexpr uint8_t kNoFlow = 0xFF;
+    std::vector<float>    filled;       // surface sans dépression (width*height)
+    std::vector<uint8_t>  flowDir;      // direction D8 par cellule
+    std::vector<uint32_t> accumulation; // nombre de cellules drainées (cellule incluse)
+    uint32_t watershedCount = 0;
+    double fillMs = 0.0, flowMs = 0.0, accumMs = 0.0, watershedMs = 0.0, riversMs = 0.0;
+};
+
+namespace Hydrology {
+    // Priority-Flood par tuiles en parallèle (fusion des bords via graphe de débordement), D8 + résolution des plats,
+    // accumulation par tuiles (fusion des flux entrants), bassins versants et fleuves.
+    // Ecrit map.rivers (polylignes grille) et map.watersheds (ID bassin par cellule, 0 = mer).
+    bool Generate(TileMap& map, const HydrologyConfig& cfg, HydrologyResult* out = nullptr);
+}
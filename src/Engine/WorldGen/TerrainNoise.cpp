@@ -1,5 +1,6 @@
 #include "TerrainNoise.h"
 #include "../Rendering/GL/TileMap.h"
+#include "../../Platform/ThreadPool.h"
 #include <algorithm>
 #include <cmath>
 #include <vector>
@@ -12,7 +13,7 @@ static float ValueNoise(float x,float y,uint64_t seed){ int ix=(int)floor(x); in
 
 namespace TerrainNoise {
 void Generate(TileMap& map, uint64_t seed, const TerrainNoiseConfig& cfg){
-    if(map.width<=0||map.height<=0) return; size_t total=(size_t)map.width*map.height; map.tileHeights.assign(total,0.f);
+    if(map.width<=0||map.height<=0) return; size_t total=(size_t)map.width*map.height; map.tileHeights.assign(total,0.f); map.tileHeightsQ.clear();
     map.landMinHeight=1e9f; map.landMaxHeight=-1e9f; map.waterMinHeight=1e9f; map.waterMaxHeight=-1e9f;
     // Générateur classique: FBM simple (0..1), puis clamp niveau de la mer et options de lissage / pente globale
     // 1) Bruit brut (0..1)
@@ -38,19 +39,8 @@ void Generate(TileMap& map, uint64_t seed, const TerrainNoiseConfig& cfg){
     }
     // 2) Blur passes (box 3x3)
     if(cfg.blurPasses>0){
-        std::vector<float> tmp(total,0.f);
-        for(int p=0;p<cfg.blurPasses;++p){
-            for(int y=0;y<map.height;++y){
-                for(int x=0;x<map.width;++x){
-                    float acc=0.f; int cnt=0;
-                    for(int dy=-1;dy<=1;++dy){ int yy=y+dy; if(yy<0||yy>=map.height) continue;
-                        for(int dx=-1;dx<=1;++dx){ int xx=x+dx; if(xx<0||xx>=map.width) continue; acc+=raw[(size_t)yy*map.width+xx]; ++cnt; }
-                    }
-                    tmp[(size_t)y*map.width+x] = acc / (float)cnt;
-                }
-            }
-            raw.swap(tmp);
-        }
+        if(cfg.chunkedBlur){ ChunkedRaster<float> r; r.importRowMajor(raw, map.width, map.height); BoxBlur(r, cfg.blurPasses); r.exportRowMajor(raw.data()); }
+        else BoxBlur(raw, map.width, map.height, cfg.blurPasses);
     }
     // 3) Application sea level -> hauteur relative (0 = mer/plat, >0 = terre)
     map.landMinHeight=1e9f; map.landMaxHeight=-1e9f; map.waterMinHeight=0.f; map.waterMaxHeight=0.f;
@@ -62,4 +52,44 @@ void Generate(TileMap& map, uint64_t seed, const TerrainNoiseConfig& cfg){
     }
     if(map.landMinHeight>map.landMaxHeight){ map.landMinHeight=0.f; map.landMaxHeight=0.f; }
 }
+
+void BoxBlur(std::vector<float>& raw, int width, int height, int passes){
+    if(width<=0||height<=0||passes<=0) return; size_t total=(size_t)width*height;
+    std::vector<float> tmp(total,0.f);
+    for(int p=0;p<passes;++p){
+        for(int y=0;y<height;++y){
+            for(int x=0;x<width;++x){
+                float acc=0.f; int cnt=0;
+                for(int dy=-1;dy<=1;++dy){ int yy=y+dy; if(yy<0||yy>=height) continue;
+                    for(int dx=-1;dx<=1;++dx){ int xx=x+dx; if(xx<0||xx>=width) continue; acc+=raw[(size_t)yy*width+xx]; ++cnt; }
+                }
+                tmp[(size_t)y*width+x] = acc / (float)cnt;
+            }
+        }
+        raw.swap(tmp);
+    }
+}
+void BoxBlur(ChunkedRaster<float>& raw, int passes, bool parallel){
+    if(raw.empty()||passes<=0) return;
+    constexpr int kSide=ChunkedLayout::kSize+2; const int W=raw.width(), H=raw.height();
+    ChunkedRaster<float> tmp(W, H);
+    for(int p=0;p<passes;++p){
+        // Chunk + halo 1 copié en local (hors carte = 0, le compteur exclut ces cellules comme la version ligne)
+        auto blurChunks=[&](size_t begin, size_t end){
+            std::vector<float> halo((size_t)kSide*kSide);
+            for(size_t s=begin;s<end;++s){
+                auto src=raw.chunk(s); auto dst=tmp.chunk(s); raw.gatherHalo(src.cx, src.cy, 1, halo.data(), 0.f);
+                for(int ly=0;ly<src.h;++ly){ int y=src.y0+ly; int ny=1+(y>0)+(y<H-1);
+                    for(int lx=0;lx<src.w;++lx){ int x=src.x0+lx; int nx=1+(x>0)+(x<W-1);
+                        const float* c=&halo[(size_t)ly*kSide+lx]; float acc=0.f;
+                        for(int dy=0;dy<3;++dy){ const float* r=c+(size_t)dy*kSide; acc+=r[0]; acc+=r[1]; acc+=r[2]; }
+                        dst.data[((size_t)ly<<ChunkedLayout::kShift)+lx] = acc / (float)(nx*ny);
+                    }
+                }
+            }
+        };
+        if(parallel) ThreadPool::Shared().parallelFor(raw.chunkCount(), 4, blurChunks); else blurChunks(0, raw.chunkCount());
+        std::swap(raw, tmp);
+    }
+}
 }
@@ -1,7 +1,9 @@
 // TerrainNoise.h - génération procédurale de relief continu
 #pragma once
 #include <cstdint>
+#include <vector>
 struct TileMap; // fwd
+template<class T> class ChunkedRaster; // fwd
 struct TerrainNoiseConfig {
     int   octaves = 9;                  // valeurs par défaut (classique FBM)
     float lacunarity = 2.07f;
@@ -10,6 +12,7 @@ struct TerrainNoiseConfig {
     float globalAmplitude = 0.68f;      // hauteur max (0..1) avant extrusion (multiplie landScale)
     float seaLevel = 0.48f;             // seuil : tout en dessous = 0
     int   blurPasses = 2;               // lissage box (0 = brut)
+    bool  chunkedBlur = false;          // lissage sur raster chunké 64x64 Z-order (parallèle par chunk)
     float continentFrequency = 0.00018f;// optionnel (macro forme)
     float continentStrength = 0.0f;     // 0 = désactivé (plat)
     float ridgeStrength = 0.0f;         // pas de crêtes
@@ -20,4 +23,7 @@ struct TerrainNoiseConfig {
 };
 namespace TerrainNoise {
     void Generate(TileMap& map, uint64_t seed, const TerrainNoiseConfig& cfg);
+    // Box 3x3 (moyenne des voisins dans la carte), résultats identiques entre dispositions
+    void BoxBlur(std::vector<float>& data, int width, int height, int passes);
+    void BoxBlur(ChunkedRaster<float>& data, int passes, bool parallel = true);
 }
@@ -0,0 +1,158 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// Worker courant: pool propriétaire + index de sa file (les threads extérieurs n'ont pas de file)
+thread_local ThreadPoolImpl* tl_pool = nullptr;
+thread_local unsigned tl_queue = 0;
+std::atomic<int> gSharedWorkers{-1};
+std::atomic<ThreadPool::WorkerStartHook> gWorkerStart{nullptr};
+}
+
+struct WorkQueue {
+    std::mutex m;
+    std::deque<ThreadPool::Task> tasks;
+};
+
+struct ThreadPoolImpl {
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues; // [0,n) workers, [n] injection (threads extérieurs)
+    std::atomic<size_t> queued{0};                  // tâches en file (réveil des workers)
+    std::mutex sleepM;
+    std::condition_variable wake;
+    bool stop = false;
+
+    unsigned injection() const { return (unsigned)workers.size(); }
+
+    void push(ThreadPool::Task task) {
+        unsigned q = (tl_pool == this) ? tl_queue : injection();
+        { std::lock_guard<std::mutex> lk(queues[q]->m); queues[q]->tasks.push_back(std::move(task)); }
+        queued.fetch_add(1, std::memory_order_release);
+        { std::lock_guard<std::mutex> lk(sleepM); }
+        wake.notify_one();
+    }
+
+    // File locale (LIFO: cache chaud), puis injection, puis vol FIFO chez les voisins
+    bool pop(ThreadPool::Task& out) {
+        if (queued.load(std::memory_order_acquire) == 0) return false;
+        const unsigned n = (unsigned)queues.size();
+        const unsigned self = (tl_pool == this) ? tl_queue : injection();
+        auto take = [&](unsigned q, bool back) {
+            WorkQueue& wq = *queues[q]; std::lock_guard<std::mutex> lk(wq.m);
+            if (wq.tasks.empty()) return false;
+            if (back) { out = std::move(wq.tasks.back()); wq.tasks.pop_back(); } else { out = std::move(wq.tasks.front()); wq.tasks.pop_front(); }
+            queued.fetch_sub(1, std::memory_order_acq_rel); return true;
+        };
+        if (self != injection() && take(self, true)) return true;
+        if (take(injection(), false)) return true;
+        for (unsigned k=1; k<n; ++k) { unsigned v = (self + k) % n; if (v != injection() && take(v, false)) return true; }
+        return false;
+    }
+
+    // Fin d'un TaskGroup: réveille ceux qui dorment dans wait() (les workers se rendorment aussitôt)
+    void notifyDone() {
+        { std::lock_guard<std::mutex> lk(sleepM); }
+        wake.notify_all();
+    }
+
+    void workerLoop(unsigned index) {
+        tl_pool = this; tl_queue = index;
+        if (ThreadPool::WorkerStartHook hook = gWorkerStart.load(std::memory_order_acquire)) hook(index);
+        ThreadPool::Task task;
+        for (;;) {
+            if (pop(task)) { task(); task = nullptr; continue; }
+            std::unique_lock<std::mutex> lk(sleepM);
+            wake.wait(lk, [&]{ return stop || queued.load(std::memory_order_acquire) > 0; });
+            if (stop) return;
+        }
+    }
+};
+
+ThreadPool::ThreadPool(unsigned threadCount) : ThreadPool(threadCount, false) {}
+
+ThreadPool::ThreadPool(unsigned threadCount, bool exactCount) : impl_(new ThreadPoolImpl) {
+    if (threadCount == 0 && !exactCount) { unsigned hc = std::thread::hardware_concurrency(); threadCount = hc > 1 ? hc - 1 : 0; }
+    for (unsigned i=0; i<=threadCount; ++i) impl_->queues.push_back(std::make_unique<WorkQueue>());
+    impl_->workers.reserve(threadCount);
+    for (unsigned i=0; i<threadCount; ++i) impl_->workers.emplace_back([this, i]{ impl_->workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    { std::lock_guard<std::mutex> lk(impl_->sleepM); impl_->stop = true; }
+    impl_->wake.notify_all();
+    for (auto& t : impl_->workers) if (t.joinable()) t.join();
+    delete impl_;
+}
+
+ThreadPool& ThreadPool::Shared() {
+    // WARLAND_THREADS = nombre de workers (0 = séquentiel), sinon hardware_concurrency()-1
+    static const int forced = []{
+        int n = gSharedWorkers.load();
+        if (n < 0) if (const char* env = std::getenv("WARLAND_THREADS")) n = std::max(0, std::atoi(env));
+        return n;
+    }();
+    static ThreadPool pool(forced >= 0 ? (unsigned)forced : 0u, forced >= 0);
+    return pool;
+}
+
+void ThreadPool::SetSharedWorkerCount(int workers) { gSharedWorkers.store(workers); }
+void ThreadPool::SetWorkerStartHook(WorkerStartHook hook) { gWorkerStart.store(hook, std::memory_order_release); }
+
+unsigned ThreadPool::workerCount() const { return (unsigned)impl_->workers.size(); }
+
+unsigned ThreadPool::currentWorker() const { return tl_pool == impl_ ? tl_queue : impl_->injection(); }
+
+void ThreadPool::push(Task task) { impl_->push(std::move(task)); }
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (!impl_->pop(task)) return false;
+    task(); return true;
+}
+
+void ThreadPool::TaskGroup::run(Task task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    if (pool_.workerCount() == 0) { task(); pending_.fetch_sub(1, std::memory_order_release); return; }
+    // impl copié: le groupe peut être détruit dès que pending_ tombe à 0
+    pool_.push([this, impl = pool_.impl_, t = std::move(task)]{ t(); if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) impl->notifyDone(); });
+}
+
+void ThreadPool::TaskGroup::wait() {
+    ThreadPoolImpl& p = *pool_.impl_;
+    while (pending_.load(std::memory_order_acquire) != 0) {
+        if (pool_.runPendingTask()) continue;
+        // Rien à aider: dort jusqu'à une nouvelle tâche ou la fin du groupe
+        std::unique_lock<std::mutex> lk(p.sleepM);
+        p.wake.wait(lk, [&]{ return pending_.load(std::memory_order_acquire) == 0 || p.queued.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    const size_t chunks = (count + grain - 1) / grain;
+    if (impl_->workers.empty() || chunks == 1) {
+        for (size_t b=0; b<count; b+=grain) fn(b, std::min(count, b + grain));
+        return;
+    }
+    // Quelques coureurs tirent les blocs d'un compteur partagé (équilibrage dynamique, peu de tâches allouées)
+    std::atomic<size_t> next{0};
+    auto runner = [&]{
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks; ) {
+            size_t b = c * grain; fn(b, std::min(count, b + grain));
+        }
+    };
+    TaskGroup group(*this);
+    const size_t helpers = std::min<size_t>(chunks - 1, impl_->workers.size());
+    for (size_t i=0; i<helpers; ++i) group.run(runner);
+    runner();
+    group.wait();
+}
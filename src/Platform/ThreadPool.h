@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+// Pool de threads persistant pour les passes parallèles (génération terrain, import, simulation).
+// Ordonnancement par vol de travail: chaque worker a sa file (LIFO local, vol FIFO chez les autres),
+// les threads extérieurs passent par une file d'injection. Un thread qui attend exécute des tâches en attendant,
+// donc les appels imbriqués (parallelFor dans une tâche, TaskGroup dans un système) ne bloquent pas le pool.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount = 0 -> hardware_concurrency()-1 workers (le thread appelant participe aussi)
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Instance partagée (créée à la première utilisation; variable d'environnement WARLAND_THREADS = nombre de workers)
+    static ThreadPool& Shared();
+    // Force le nombre de workers de Shared() (avant sa première utilisation; prioritaire sur WARLAND_THREADS)
+    static void SetSharedWorkerCount(int workers);
+    // Appelé au démarrage de chaque worker (nom de thread du profileur...), pour les pools créés ensuite
+    using WorkerStartHook = void (*)(unsigned worker);
+    static void SetWorkerStartHook(WorkerStartHook hook);
+
+    unsigned workerCount() const;
+    // Index du worker appelant dans [0,workerCount()), workerCount() pour un thread extérieur au pool
+    unsigned currentWorker() const;
+
+    // Exécute fn(begin,end) sur des blocs de 'grain' éléments couvrant [0,count) puis attend la fin.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& fn);
+
+    // Ensemble de tâches attendues ensemble; wait() aide à vider les files, puis dort jusqu'à la fin du groupe
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+        ~TaskGroup() { wait(); }
+        void run(Task task);
+        void wait();
+    private:
+        friend class ThreadPool;
+        ThreadPool& pool_;
+        std::atomic<size_t> pending_{0};
+    };
+
+    // Exécute une tâche en attente si possible (file locale, injection, vol); false si rien à faire
+    bool runPendingTask();
+
+private:
+    ThreadPool(unsigned threadCount, bool exactCount);
+    void push(Task task);
+    struct ThreadPoolImpl* impl_;
+};
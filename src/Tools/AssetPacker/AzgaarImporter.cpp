@@ -1,4 +1,6 @@
 #include "AzgaarImporter.h"
+#include "../../Engine/WorldGen/AdaptiveGrid.h"
+#include "../../Core/Profiler.h"
 #include <glm/vec2.hpp>
 #include <nlohmann/json.hpp>
 #include <fstream>
@@ -93,6 +95,8 @@ bool Load(const std::string& jsonPath,
           const std::string& atlasImage,
           uint64_t worldSeed,
           AzgaarImportResult& out) {
+    PROFILE_ZONE("Azgaar::Load");
+    Profiler::Zone parseZone("Azgaar::readParse");
     SPDLOG_INFO("[Azgaar] Ouverture fichier: {}", jsonPath);
     std::ifstream f(jsonPath, std::ios::binary);
     if (!f.is_open()) { SPDLOG_ERROR("[Azgaar] Echec ouverture fichier"); return false; }
@@ -116,6 +120,7 @@ bool Load(const std::string& jsonPath,
         return false;
     }
 
+    parseZone.end();
     size_t rootKeys = j.is_object() ? j.size() : 0;
     SPDLOG_INFO("[Azgaar] JSON chargé (éléments racine: {})", rootKeys);
 
@@ -276,7 +281,7 @@ bool Load(const std::string& jsonPath,
     out.map.width = cfg.targetWidth; out.map.height = cfg.targetHeight; out.map.tileSize=1; out.map.atlasImagePath = atlasImage;
     out.map.tiles.assign(out.map.width * out.map.height, 0);
     out.map.countries.assign(out.map.width * out.map.height, 0);
-    out.map.tileHeights.assign(out.map.width * out.map.height, 0.f);
+    out.map.tileHeights.assign(out.map.width * out.map.height, 0.f); out.map.tileHeightsQ.clear();
     out.map.paletteIndices.assign(out.map.width * out.map.height, 0u);
     out.sourceCellCount = (int)cells.size();
 
@@ -486,7 +491,9 @@ bool Load(const std::string& jsonPath,
     }
     SPDLOG_INFO("[Azgaar] Cells placées: {} / {} (skipped={})", filledCells, cells.size(), out.skippedCells);
 
-    out.map.places.clear(); out.placedBurgs=0;
+    out.map.places.clear(); out.map.strings.clear(); out.placedBurgs=0;
+    out.map.places.reserve(burgs.size()); out.map.strings.reserve(burgs.size() + 1, burgs.size() * 12);
+    const uint32_t cityType = out.map.strings.intern("city");
     for (auto& b : burgs) {
         if (!b.is_object()) continue; double bx=0,by=0; if (b.contains("x")) { bx=b.value("x",0.0); by=b.value("y",0.0);} else if (b.contains("p") && b["p"].is_array() && b["p"].size()>=2){ bx=b["p"][0].get<double>(); by=b["p"][1].get<double>(); }
         int gx = (int)(bx / maxX * (out.map.width -1)); int gy = (int)(by / maxY * (out.map.height -1));
@@ -494,26 +501,27 @@ bool Load(const std::string& jsonPath,
         if (gx==0 && gy==0) continue; // ignore artefact (0,0)
         size_t tileIndex = (size_t)gy * out.map.width + gx;
         if (tileIndex < out.map.countries.size() && out.map.countries[tileIndex]==0) continue; // skip water
-        Place p; p.x=gx; p.y=gy; p.type="city"; std::string azName = b.value("name", std::string(""));
-        if (cfg.keepAzgaarNames && !azName.empty()) p.name=azName; else { uint64_t seed = worldSeed ^ ((uint64_t)gx<<32) ^ (uint64_t)gy; p.name = gen_name(seed, "culture"); }
-        out.map.places.push_back(std::move(p)); out.placedBurgs++;
+        auto nameIt = b.find("name"); uint32_t nameId = StringPool::kEmpty;
+        if (cfg.keepAzgaarNames && nameIt != b.end() && nameIt->is_string()) nameId = out.map.strings.intern(nameIt->get_ref<const std::string&>());
+        if (nameId == StringPool::kEmpty) { uint64_t seed = worldSeed ^ ((uint64_t)gx<<32) ^ (uint64_t)gy; nameId = out.map.strings.intern(gen_name(seed, "culture")); }
+        out.map.places.add(gx, gy, cityType, nameId); out.placedBurgs++;
     }
     SPDLOG_INFO("[Azgaar] Burgs placés: {}", out.placedBurgs);
 
     size_t roadsAddedBefore = out.map.roads.size();
     if (j.contains("roads")) {
         for (auto& rr : j["roads"]) {
-            if (!rr.is_object()) continue; Road road;
+            if (!rr.is_object()) continue; auto& road = out.map.roads;
             if (rr.contains("points")) {
                 for (auto& p : rr["points"]) {
-                    double rx = p.value("x",0.0); double ry=p.value("y",0.0); int gx=(int)(rx/maxX*(out.map.width-1)); int gy=(int)(ry/maxY*(out.map.height-1)); if (gx<0||gy<0||gx>=out.map.width||gy>=out.map.height) continue; road.points.push_back({gx,gy});
+                    double rx = p.value("x",0.0); double ry=p.value("y",0.0); int gx=(int)(rx/maxX*(out.map.width-1)); int gy=(int)(ry/maxY*(out.map.height-1)); if (gx<0||gy<0||gx>=out.map.width||gy>=out.map.height) continue; road.addPoint(gx,gy);
                 }
             } else if (rr.contains("coords")) {
                 for (auto& p : rr["coords"]) {
-                    if (!p.is_array() || p.size()<2) continue; double rx=p[0].get<double>(); double ry=p[1].get<double>(); int gx=(int)(rx/maxX*(out.map.width-1)); int gy=(int)(ry/maxY*(out.map.height-1)); if (gx<0||gy<0||gx>=out.map.width||gy>=out.map.height) continue; road.points.push_back({gx,gy});
+                    if (!p.is_array() || p.size()<2) continue; double rx=p[0].get<double>(); double ry=p[1].get<double>(); int gx=(int)(rx/maxX*(out.map.width-1)); int gy=(int)(ry/maxY*(out.map.height-1)); if (gx<0||gy<0||gx>=out.map.width||gy>=out.map.height) continue; road.addPoint(gx,gy);
                 }
             }
-            if (!road.points.empty()) out.map.roads.push_back(std::move(road));
+            road.commitRoad();
         }
     }
     SPDLOG_INFO("[Azgaar] Routes importées: {}", out.map.roads.size()-roadsAddedBefore);
@@ -521,6 +529,7 @@ bool Load(const std::string& jsonPath,
     // RASTERISATION COMPLETE DES POLYGONES POUR GRILLE POLITIQUE ADAPTATIVE (palette indices directs)
     std::vector<uint16_t> paletteGrid; // même dimensions que countries, mais contient indices palette (0/1 eau, land décalé +2)
     if (!out.map.polygonVertices.empty()) {
+        PROFILE_ZONE("Azgaar::rasterize");
         paletteGrid.assign(out.map.width * out.map.height, 0u);
         // Pré-calcul des facteurs de conversion monde -> grille
         float sx = (out.map.width  > 1 && maxX>0)? (float)(out.map.width  - 1) / (float)maxX : 1.f;
@@ -573,63 +582,15 @@ bool Load(const std::string& jsonPath,
     float worldH = out.map.worldMaxY;
     if (out.map.worldMaxX > 0 && out.map.worldMaxY > 0) {
         // worldW/worldH déjà définis
-        bool usePaletteGrid = !paletteGrid.empty();
-        auto getPalette = [&](int gx, int gy)->uint16_t {
-            if (gx<0||gy<0||gx>=out.map.width||gy>=out.map.height) return 0;
-            if (usePaletteGrid) return paletteGrid[gy*out.map.width+gx];
-            // fallback sparse (ancienne logique) -> convert raw country id en palette
-            uint16_t raw = out.map.countries[gy*out.map.width+gx];
-            if (raw==0) return 0; return (uint16_t)(raw + 2);
-        };
-        struct Node { int x,y,w,h; };
-        std::vector<Node> stack; stack.push_back({0,0,out.map.width,out.map.height});
-        out.map.adaptiveCells.reserve(4096);
+        PROFILE_ZONE("Azgaar::adaptiveGrid");
         const float majorityThreshold = 0.99f; // accepte si >=99% d'un seul index
-        while(!stack.empty()) {
-            Node n = stack.back(); stack.pop_back();
-            int area = n.w * n.h;
-            // Boyer-Moore majority pass
-            uint16_t cand = getPalette(n.x, n.y); int cnt = 1;
-            for (int yy=n.y; yy<n.y+n.h; ++yy) {
-                for (int xx=n.x; xx<n.x+n.w; ++xx) {
-                    if (yy==n.y && xx==n.x) continue; // premier déjà pris
-                    uint16_t p = getPalette(xx, yy);
-                    if (p==cand) cnt++; else { cnt--; if (cnt==0){ cand=p; cnt=1; } }
-                }
-            }
-            // Validation du candidat + détection coexistence eau profonde / peu profonde
-            int occ = 0; bool hasDeep=false, hasShallow=false;
-            for (int yy=n.y; yy<n.y+n.h; ++yy) {
-                for (int xx=n.x; xx<n.x+n.w; ++xx) {
-                    uint16_t pv = getPalette(xx,yy);
-                    if (pv==0) hasDeep=true; else if (pv==1) hasShallow=true;
-                    if (pv==cand) occ++;
-                }
-            }
-            float frac = (float)occ / (float)area;
-            bool waterMix = (hasDeep && hasShallow && area>1); // mélange 0 & 1 dans la même boîte
-            bool accept = ((frac >= majorityThreshold) || n.w==1 || n.h==1);
-            if (waterMix && (cand==0 || cand==1) && area>4) accept=false; // force subdivision pour conserver bande littorale
-            if (accept) {
-                float cellSizeX = worldW / (float)out.map.width;
-                float cellSizeY = worldH / (float)out.map.height;
-                out.map.adaptiveCells.push_back({ n.x * cellSizeX, n.y * cellSizeY, n.w * cellSizeX, n.h * cellSizeY, cand, 0.f });
-            } else {
-                if (n.w >= n.h) {
-                    int w1 = n.w/2; if (w1<1) w1=1; int w2 = n.w - w1; if (w2<1) w2=1;
-                    stack.push_back({n.x+w1, n.y, w2, n.h});
-                    stack.push_back({n.x, n.y, w1, n.h});
-                } else {
-                    int h1 = n.h/2; if (h1<1) h1=1; int h2 = n.h - h1; if (h2<1) h2=1;
-                    stack.push_back({n.x, n.y+h1, n.w, h2});
-                    stack.push_back({n.x, n.y, n.w, h1});
-                }
-            }
-            if (out.map.adaptiveCells.size() > 200000) {
-                SPDLOG_WARN("[Azgaar][Adaptive] Limite cellules atteinte, arrêt subdivision");
-                break;
-            }
-        }
+        bool complete;
+        if (!paletteGrid.empty()) complete = AdaptiveGrid::BuildRowMajor(paletteGrid, out.map.width, out.map.height, worldW, worldH, out.map.adaptiveCells, majorityThreshold);
+        else complete = AdaptiveGrid::Build(out.map.width, out.map.height, worldW, worldH, [&](int x0, int y0, int w, int h, auto&& visit){
+            // fallback sparse (ancienne logique) -> convert raw country id en palette
+            for (int yy=y0; yy<y0+h; ++yy) for (int xx=x0; xx<x0+w; ++xx) { uint16_t raw = out.map.countries[(size_t)yy*out.map.width+xx]; visit(raw==0 ? (uint16_t)0 : (uint16_t)(raw + 2)); }
+        }, out.map.adaptiveCells, majorityThreshold);
+        if (!complete) SPDLOG_WARN("[Azgaar][Adaptive] Limite cellules atteinte, arrêt subdivision");
         SPDLOG_INFO("[Azgaar][Adaptive] Cellules adaptatives: {} (majorité {:.2f}%)", out.map.adaptiveCells.size(), majorityThreshold*100.f);
     }
 
@@ -669,6 +630,11 @@ bool Load(const std::string& jsonPath,
         SPDLOG_INFO("[Azgaar] CountryInfos: {}", out.map.countryInfos.size());
     }
 
+    if (cfg.quantizeHeights) {
+        out.map.quantizeHeights();
+        SPDLOG_INFO("[Azgaar] Hauteurs quantifiées 16 bits: scale={} offset={} ({:.1f} MB)", out.map.heightQScale, out.map.heightQOffset, out.map.tileHeightsQ.size()*sizeof(uint16_t)/(1024.0*1024.0));
+    }
+
     SPDLOG_INFO("[Azgaar] Import terminé: map {}x{} places={} roads={} colors={}", out.map.width, out.map.height, out.map.places.size(), out.map.roads.size(), out.map.countryColorsRGB.size());
     return true;
 }
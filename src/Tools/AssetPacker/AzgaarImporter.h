@@ -10,6 +10,7 @@ struct AzgaarImportConfig {
     bool clampToMap = true;   // clamp coords dans la grille
     bool keepAzgaarNames = true; // sinon passer par générateur interne
     float worldKmWidth = 2700.f; // largeur monde en km (pour km grid)
+    bool quantizeHeights = false; // hauteurs stockées en uint16 (tileHeightsQ), tileHeights libéré
 };
 
 struct AzgaarImportResult {
@@ -71,7 +71,7 @@ bool WorldGenerator::Generate(const std::string& biomePng,
     }
 
     // Places from cities layer with deterministic names
-    out->map.places.clear();
+    out->map.places.clear(); out->map.strings.clear();
     for (int y=0; y<hb; ++y) {
         for (int x=0; x<wb; ++x) {
             int i = (y*wb + x)*3;
@@ -80,12 +80,10 @@ bool WorldGenerator::Generate(const std::string& biomePng,
             if (it == lutPlace.end()) continue; // background/no place
             // Deduplicate: only take pixel if it’s a local maximum of intensity to avoid clusters (simple heuristic)
             if ((x%3)!=(y%3)) continue; // crude thinning
-            Place p; p.type = it->second; p.x = x; p.y = y;
             uint16_t cid = out->map.countries[y*wb + x];
             std::string culture = "human"; // placeholder; derive from country later
-            uint64_t seed = worldSeed ^ ((uint64_t)x<<32) ^ (uint64_t)y ^ ((uint64_t)cid<<16) ^ std::hash<std::string>{}(p.type);
-            p.name = gen_name(seed, culture);
-            out->map.places.push_back(std::move(p));
+            uint64_t seed = worldSeed ^ ((uint64_t)x<<32) ^ (uint64_t)y ^ ((uint64_t)cid<<16) ^ std::hash<std::string>{}(it->second);
+            out->map.addPlace(x, y, it->second, gen_name(seed, culture));
         }
     }
 
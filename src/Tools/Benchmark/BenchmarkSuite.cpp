@@ -0,0 +1,793 @@
+#include "BenchmarkSuite.h"
+#include "../../Engine/Rendering/GL/TileMap.h"
+#include "../../Engine/WorldGen/TerrainNoise.h"
+#include "../../Engine/WorldGen/Hydrology.h"
+#include "../../Engine/Rendering/GL/HeightCodec.h"
+#include "../../Engine/WorldGen/AdaptiveGrid.h"
+#include "../../Engine/Simulation/Scheduler.h"
+#include "../../Engine/ECS/Registry.h"
+#include "../../Engine/ECS/SpatialIndex.h"
+#include "../../Engine/ECS/Components/Transform.h"
+#include "../../Engine/ECS/Components/Name.h"
+#include "../../Engine/ECS/Components/Residence.h"
+#include "../../Engine/ECS/Prefab.h"
+#include "../../Engine/Simulation/SaveGame.h"
+#include "../../Engine/Simulation/Autosave.h"
+#include "../../Engine/ECS/Systems/MessagingSystem.h"
+#include "../../Engine/Gameplay/City/Building.h"
+#include "../../Engine/Gameplay/WorldMap/Country.h"
+#include "../../Engine/Gameplay/WorldMap/RoadNetwork.h"
+#include "../../Engine/Gameplay/WorldMap/ContractionHierarchy.h"
+#include "../../Engine/Gameplay/WorldMap/TravelTimeMatrix.h"
+#include "../../Engine/AI/Pathfinding.h"
+#include "../../Platform/ThreadPool.h"
+#include "../../Core/EventBus.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+static double MsSince(Clock::time_point t0) { return std::chrono::duration<double, std::milli>(Clock::now() - t0).count(); }
+
+// Carte synthétique identique au viewer (TerrainNoise par défaut), dimension opt.mapSize
+static TileMap MakeTerrain(const BenchmarkOptions& opt) {
+    TileMap map; map.width = opt.mapSize; map.height = opt.mapSize;
+    map.worldMaxX = (float)opt.mapSize; map.worldMaxY = (float)opt.mapSize;
+    map.paletteIndices.assign((size_t)map.width * map.height, 2u);
+    TerrainNoise::Generate(map, opt.seed, TerrainNoiseConfig{});
+    return map;
+}
+
+// Vérifications des benchmarks (résultats contre une référence): un échec est signalé et compté, la mesure continue
+static size_t gFailures = 0;
+static bool Check(bool ok, const char* bench, const std::string& what) {
+    if (!ok) { std::fprintf(stderr, "[%s] ECHEC: %s\n", bench, what.c_str()); ++gFailures; }
+    return ok;
+}
+
+// Conserve le meilleur temps de chaque mesure sur opt.repeat exécutions
+static void KeepBest(std::vector<BenchmarkResult>& out, const std::vector<BenchmarkResult>& run) {
+    for (auto& r : run) {
+        auto it = std::find_if(out.begin(), out.end(), [&](const BenchmarkResult& o){ return o.name == r.name; });
+        if (it == out.end()) out.push_back(r); else if (r.ms < it->ms) *it = r;
+    }
+}
+
+static void BenchHydrology(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap base = MakeTerrain(opt);
+    const double cells = (double)base.width * base.height;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        TileMap map = base; HydrologyResult res;
+        auto t0 = Clock::now();
+        Hydrology::Generate(map, HydrologyConfig{}, &res);
+        double total = MsSince(t0);
+        KeepBest(out, {
+            { "hydrology.fill", res.fillMs, cells },
+            { "hydrology.flowdir", res.flowMs, cells },
+            { "hydrology.accumulation", res.accumMs, cells },
+            { "hydrology.watersheds", res.watershedMs, cells },
+            { "hydrology.rivers", res.riversMs, cells },
+            { "hydrology.total", total, cells },
+        });
+    }
+}
+
+// Encodage/décodage uint16 des hauteurs + erreur max (en pas de quantification)
+static void BenchHeightCodec(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map = MakeTerrain(opt);
+    const size_t n = map.tileHeights.size(); const double cells = (double)n;
+    float lo, hi, scale, offset; HeightCodec::MinMax(map.tileHeights.data(), n, lo, hi); HeightCodec::RangeFor(lo, hi, scale, offset);
+    std::vector<uint16_t> q(n); std::vector<float> back(n);
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        auto t0 = Clock::now(); HeightCodec::Encode(map.tileHeights.data(), q.data(), n, scale, offset); double enc = MsSince(t0);
+        t0 = Clock::now(); HeightCodec::Decode(q.data(), back.data(), n, scale, offset); double dec = MsSince(t0);
+        KeepBest(out, { { "heights.encode16", enc, cells }, { "heights.decode16", dec, cells } });
+    }
+    double maxErr = 0.0; for (size_t i=0; i<n; ++i) maxErr = std::max(maxErr, (double)std::fabs(back[i] - map.tileHeights[i]));
+    std::printf("[heights] range [%g, %g] step %g max error %g (%.3f step) memory %.1f -> %.1f MB\n", lo, hi, scale, maxErr, scale > 0 ? maxErr / scale : 0.0,
+                n*sizeof(float)/(1024.0*1024.0), n*sizeof(uint16_t)/(1024.0*1024.0));
+}
+
+// Disposition ligne vs chunks 64x64 Z-order: lissage, subdivision adaptative, échantillonnage hauteurs
+static void BenchRasterLayout(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map = MakeTerrain(opt);
+    const int w = map.width, h = map.height; const double cells = (double)w * h;
+    ChunkedRaster<float> heightsC; heightsC.importRowMajor(map.tileHeights, w, h);
+    // Palette synthétique cohérente: mer profonde/peu profonde selon distance à la côte approximée, bandes d'altitude
+    std::vector<uint16_t> palette((size_t)w * h);
+    for (size_t i=0; i<palette.size(); ++i) { float v = map.tileHeights[i]; palette[i] = v <= 0.f ? (uint16_t)((i / w) % 97 < 90 ? 0 : 1) : (uint16_t)(2 + (int)(v * 8.f)); }
+    ChunkedRaster<uint16_t> paletteC; paletteC.importRowMajor(palette, w, h);
+    const int passes = 4;
+    size_t adaptRow = 0, adaptChunk = 0, blurMismatch = 0;
+    std::mt19937 rng((uint32_t)opt.seed); std::uniform_real_distribution<float> ux(0.f, (float)(w - 1)), uy(0.f, (float)(h - 1));
+    const size_t samples = 4u << 20; std::vector<float> sx(samples), sy(samples); for (size_t i=0; i<samples; ++i) { sx[i] = ux(rng); sy[i] = uy(rng); }
+    volatile float sink = 0.f;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        std::vector<float> rowBlur = map.tileHeights;
+        auto t0 = Clock::now(); TerrainNoise::BoxBlur(rowBlur, w, h, passes); run.push_back({ "layout.blur.rowmajor", MsSince(t0), cells * passes });
+        ChunkedRaster<float> cBlur = heightsC;
+        t0 = Clock::now(); TerrainNoise::BoxBlur(cBlur, passes, false); run.push_back({ "layout.blur.chunked", MsSince(t0), cells * passes });
+        ChunkedRaster<float> cBlurMt = heightsC;
+        t0 = Clock::now(); TerrainNoise::BoxBlur(cBlurMt, passes, true); run.push_back({ "layout.blur.chunked_mt", MsSince(t0), cells * passes });
+        std::vector<float> back = cBlur.exportRowMajor(); blurMismatch = 0; for (size_t i=0; i<back.size(); ++i) blurMismatch += back[i] != rowBlur[i];
+
+        std::vector<AdaptiveCell> a, b;
+        t0 = Clock::now(); AdaptiveGrid::BuildRowMajor(palette, w, h, (float)w, (float)h, a, 0.99f, (size_t)-1); run.push_back({ "layout.adaptive.rowmajor", MsSince(t0), cells });
+        t0 = Clock::now(); AdaptiveGrid::BuildChunked(paletteC, (float)w, (float)h, b, 0.99f, (size_t)-1); run.push_back({ "layout.adaptive.chunked", MsSince(t0), cells });
+        adaptRow = a.size(); adaptChunk = b.size();
+
+        // Bilinéaire à positions aléatoires (caméra, agents)
+        float acc = 0.f;
+        t0 = Clock::now();
+        for (size_t i=0; i<samples; ++i) {
+            int x0 = (int)sx[i], y0 = (int)sy[i], x1 = std::min(x0 + 1, w - 1), y1 = std::min(y0 + 1, h - 1); float tx = sx[i] - x0, ty = sy[i] - y0;
+            const float* H = map.tileHeights.data(); float a0 = H[(size_t)y0*w+x0], a1 = H[(size_t)y0*w+x1], b0 = H[(size_t)y1*w+x0], b1 = H[(size_t)y1*w+x1];
+            acc += (a0 + (a1 - a0) * tx) + ((b0 + (b1 - b0) * tx) - (a0 + (a1 - a0) * tx)) * ty;
+        }
+        run.push_back({ "layout.sample.bilinear.rowmajor", MsSince(t0), (double)samples });
+        t0 = Clock::now();
+        for (size_t i=0; i<samples; ++i) {
+            int x0 = (int)sx[i], y0 = (int)sy[i]; float tx = sx[i] - x0, ty = sy[i] - y0;
+            float a0 = heightsC.at(x0, y0), a1 = heightsC.neighbor(x0, y0, 1, 0), b0 = heightsC.neighbor(x0, y0, 0, 1), b1 = heightsC.neighbor(x0, y0, 1, 1);
+            acc += (a0 + (a1 - a0) * tx) + ((b0 + (b1 - b0) * tx) - (a0 + (a1 - a0) * tx)) * ty;
+        }
+        run.push_back({ "layout.sample.bilinear.chunked", MsSince(t0), (double)samples });
+        // Parcours vertical (colonnes): cas pathologique de la disposition ligne
+        t0 = Clock::now(); for (int x=0; x<w; ++x) for (int y=0; y<h; ++y) acc += map.tileHeights[(size_t)y*w+x];
+        run.push_back({ "layout.sample.column.rowmajor", MsSince(t0), cells });
+        t0 = Clock::now(); for (int x=0; x<w; ++x) for (int y=0; y<h; ++y) acc += heightsC.at(x, y);
+        run.push_back({ "layout.sample.column.chunked", MsSince(t0), cells });
+        sink = sink + acc;
+        KeepBest(out, run);
+    }
+    std::printf("[layout] %dx%d chunks=%zu blur mismatches=%zu adaptive cells row=%zu chunked=%zu\n", w, h, heightsC.chunkCount(), blurMismatch, adaptRow, adaptChunk);
+}
+
+// Systèmes à 60/10/1/0.1 Hz sur N entités: pire tick avec tout le travail lent d'un coup vs découpé en tranches
+static void BenchSimRates(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    const size_t n = (size_t)opt.mapSize * 64; const double dt = 1.0 / 60.0; const int ticks = 1200;
+    const double rates[] = { 0.0, 10.0, 1.0, 0.1 };
+    const char* names[] = { "fast", "medium", "slow", "world" };
+    for (int sliced=0; sliced<2; ++sliced) {
+        double best = 1e30, bestAvg = 0.0; size_t processed = 0;
+        for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+            // Un état et un compteur par système: ils peuvent tourner en parallèle
+            std::vector<std::vector<float>> state(4); std::vector<size_t> done(4, 0);
+            Scheduler sched;
+            for (int s=0; s<4; ++s) {
+                const size_t count = s == 0 ? n / 60 : n;   // le système rapide ne touche qu'un petit lot
+                state[s].assign(count, 1.0f);
+                auto work = [&state, &done, s](size_t b, size_t e, double sdt) {
+                    float* v = state[s].data();
+                    for (size_t i=b; i<e; ++i) { float x = v[i]; for (int k=0; k<16; ++k) x = x * 0.999f + std::sqrt(x + (float)sdt); v[i] = x; }
+                    done[s] += e - b;
+                };
+                SystemDesc d; d.name = names[s]; d.rateHz = rates[s]; d.writes = { std::string("state.") + names[s] };
+                if (sliced && rates[s] > 0.0) d.tickSlice = [work, count](double sdt, size_t k, size_t kc) { size_t b, e; Scheduler::SliceRange(count, k, kc, b, e); work(b, e, sdt); };
+                else d.tick = [work, count](double sdt) { work(0, count, sdt); };
+                sched.addSystem(std::move(d));
+            }
+            double worst = 0.0, total = 0.0;
+            for (int t=0; t<ticks; ++t) { auto t0 = Clock::now(); sched.updateFixed(dt); double ms = MsSince(t0); worst = std::max(worst, ms); total += ms; }
+            if (worst < best) { best = worst; bestAvg = total / ticks; }
+            processed = 0; for (size_t c : done) processed += c;
+        }
+        const char* tag = sliced ? "sliced" : "unsliced";
+        out.push_back({ std::string("simrates.") + tag + ".worst_tick", best, (double)ticks });
+        std::printf("[simrates] %s entities=%zu ticks=%d worst=%.3f ms avg=%.3f ms processed=%zu\n", tag, n, ticks, best, bestAvg, processed);
+    }
+}
+
+// ECS (archétypes, SoA) vs tableau de structures: création/destruction en masse et intégration position += vitesse*dt.
+// L'objet AoS porte aussi ses données froides (64 octets) comme un objet de jeu classique: la boucle chaude les traverse quand même.
+namespace BenchEcsTypes {
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Cold { float data[16]; };
+struct Agent { Position p; Velocity v; Cold cold; };
+struct Flag { uint32_t tick; };
+}
+
+static void BenchEcs(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    using namespace BenchEcsTypes;
+    const size_t n = (size_t)opt.mapSize * opt.mapSize / 4; const float dt = 1.f / 60.f; const int passes = 10;
+    double sink = 0.0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        Registry reg; std::vector<Entity> handles;
+        auto t0 = Clock::now(); reg.createMany(n, &handles, Position{0, 0, 0}, Velocity{1, 0.5f, 0}, Cold{});
+        run.push_back({ "ecs.create_bulk", MsSince(t0), (double)n });
+        std::vector<Agent> aos(n, Agent{ {0, 0, 0}, {1, 0.5f, 0}, {} });
+
+        t0 = Clock::now();
+        for (int p=0; p<passes; ++p) reg.each<Position, const Velocity>([dt](Position& pos, const Velocity& v){ pos.x += v.x*dt; pos.y += v.y*dt; pos.z += v.z*dt; });
+        run.push_back({ "ecs.iterate.view", MsSince(t0), (double)n * passes });
+        t0 = Clock::now();
+        for (int p=0; p<passes; ++p) reg.view<Position, const Velocity>().eachChunk([dt](size_t count, const Entity*, Position* pos, Velocity* v){
+            for (size_t i=0; i<count; ++i) { pos[i].x += v[i].x*dt; pos[i].y += v[i].y*dt; pos[i].z += v[i].z*dt; } });
+        run.push_back({ "ecs.iterate.chunk", MsSince(t0), (double)n * passes });
+        t0 = Clock::now();
+        for (int p=0; p<passes; ++p) for (Agent& a : aos) { a.p.x += a.v.x*dt; a.p.y += a.v.y*dt; a.p.z += a.v.z*dt; }
+        run.push_back({ "ecs.iterate.aos_baseline", MsSince(t0), (double)n * passes });
+        t0 = Clock::now();
+        for (int p=0; p<passes; ++p) for (size_t i=0; i<n; ++i) { Position* pos = reg.tryGet<Position>(handles[i]); const Velocity* v = reg.tryGet<Velocity>(handles[i]); pos->x += v->x*dt; pos->y += v->y*dt; pos->z += v->z*dt; }
+        run.push_back({ "ecs.iterate.by_handle", MsSince(t0), (double)n * passes });
+        // Suivi des changements: écriture par handle nue vs marquée (patch), puis vue filtrée sur 1% d'entités modifiées
+        ECS::ChangeCursor cursor;
+        t0 = Clock::now(); for (size_t i=0; i<n; ++i) reg.tryGet<Position>(handles[i])->x += dt;
+        run.push_back({ "ecs.write.plain", MsSince(t0), (double)n });
+        t0 = Clock::now(); for (size_t i=0; i<n; ++i) reg.patch<Position>(handles[i]).x += dt;
+        run.push_back({ "ecs.write.marked", MsSince(t0), (double)n });
+        cursor.since(reg);
+        for (size_t i=0; i<n; i+=100) reg.markChanged<Position>(handles[i]);
+        size_t changed = 0; const uint32_t since = cursor.since(reg);
+        t0 = Clock::now(); reg.view<const Position>().changed<Position>(since).each([&](const Position&){ ++changed; });
+        run.push_back({ "ecs.iterate.changed_1pct", MsSince(t0), (double)n });
+        if (changed != (n + 99) / 100) std::printf("[ecs] changed: %zu != %zu\n", changed, (n + 99) / 100);
+        t0 = Clock::now();
+        for (int p=0; p<passes; ++p) reg.view<Position, const Velocity>().forEachParallel([dt](Position& pos, const Velocity& v){ pos.x += v.x*dt; pos.y += v.y*dt; pos.z += v.z*dt; });
+        run.push_back({ "ecs.iterate.parallel", MsSince(t0), (double)n * passes });
+        // Changements structurels différés depuis les workers (1 entité sur 8), fusionnés au point de synchronisation
+        t0 = Clock::now();
+        reg.view<const Position>().forEachParallel([](CommandBuffer& cb, Entity e, const Position&){ if ((e.index & 7) == 0) cb.add<Flag>(e, Flag{ e.index }); });
+        run.push_back({ "ecs.parallel_deferred_add", MsSince(t0), (double)n });
+
+        // Une entité sur deux perd Cold (changement d'archétype), puis destruction en masse de la moitié
+        t0 = Clock::now(); for (size_t i=0; i<n; i+=2) reg.remove<Cold>(handles[i]);
+        run.push_back({ "ecs.remove_component", MsSince(t0), (double)(n / 2) });
+        std::vector<Entity> doomed; doomed.reserve(n / 2); for (size_t i=1; i<n; i+=2) doomed.push_back(handles[i]);
+        t0 = Clock::now(); reg.destroy(doomed.data(), doomed.size());
+        run.push_back({ "ecs.destroy_bulk", MsSince(t0), (double)doomed.size() });
+
+        reg.each<const Position>([&](const Position& p){ sink += p.x; });
+        for (const Agent& a : aos) sink -= a.p.x;
+        KeepBest(out, run);
+    }
+    std::printf("[ecs] entities=%zu passes=%d checksum=%.1f\n", n, passes, sink);
+}
+
+// Index spatial: n = mapSize²/8 entités mobiles (moitié dans une ville de 4 km, moitié sur un monde de 2000 km),
+// synchronisation incrémentale après déplacement de toutes les entités, puis requêtes ville et monde.
+static void BenchSpatial(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    const size_t n = (size_t)opt.mapSize * opt.mapSize / 8; const size_t queries = 10000;
+    std::mt19937 rng(opt.seed);
+    std::uniform_real_distribution<float> city(0.f, 4000.f), world(-1.0e6f, 1.0e6f), step(-2.f, 2.f);
+    std::vector<glm::vec2> cityQ(queries); for (auto& q : cityQ) q = glm::vec2(city(rng), city(rng));
+    size_t sink = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        Registry reg; SpatialIndex index;
+        std::vector<Entity> handles; handles.reserve(n);
+        for (size_t i=0; i<n; ++i) {
+            Transform t; t.position = (i & 1) ? glm::vec3(city(rng), city(rng), 0.f) : glm::vec3(world(rng), world(rng), 0.f);
+            handles.push_back(reg.create(t));
+        }
+        auto t0 = Clock::now(); index.sync(reg);
+        run.push_back({ "spatial.build", MsSince(t0), (double)n });
+        for (Entity e : handles) { Transform& t = reg.patch<Transform>(e); t.position.x += step(rng); t.position.y += step(rng); }
+        t0 = Clock::now(); index.sync(reg, ThreadPool::Shared());
+        run.push_back({ "spatial.sync_all_moved", MsSince(t0), (double)n });
+
+        std::vector<Entity> found;
+        t0 = Clock::now(); for (const glm::vec2& q : cityQ) { found.clear(); index.queryRadius(q, 50.f, found); sink += found.size(); }
+        run.push_back({ "spatial.radius50m.city", MsSince(t0), (double)queries });
+        t0 = Clock::now(); for (const glm::vec2& q : cityQ) { index.queryKNearest(q, 16, found); sink += found.size(); }
+        run.push_back({ "spatial.knn16.city", MsSince(t0), (double)queries });
+        t0 = Clock::now(); for (size_t i=0; i<100; ++i) { found.clear(); glm::vec2 c(world(rng), world(rng)); index.queryAABB(c, c + glm::vec2(2.0e5f), found); sink += found.size(); }
+        run.push_back({ "spatial.aabb200km.world", MsSince(t0), 100.0 });
+        t0 = Clock::now(); for (size_t i=0; i<1000; ++i) { glm::vec2 c(world(rng), world(rng)); index.queryKNearest(c, 4, found); sink += found.size(); }
+        run.push_back({ "spatial.knn4.world", MsSince(t0), 1000.0 });
+        std::vector<uint32_t> offsets;
+        t0 = Clock::now(); index.queryRadiusBatch(cityQ.data(), cityQ.size(), 50.f, offsets, found); sink += found.size();
+        run.push_back({ "spatial.radius50m.batch", MsSince(t0), (double)queries });
+        KeepBest(out, run);
+    }
+    std::printf("[spatial] entities=%zu checksum=%zu\n", n, sink);
+}
+
+// Prefabs: ville de 50k entités (data/defs/buildings.json) instanciée par lots avec positions,
+// contre la création entité par entité (create + add de chaque composant).
+static void BenchPrefab(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    PrefabLibrary lib;
+    auto t0 = Clock::now();
+    if (!lib.loadDirectory("data/defs") || lib.find("house_small") == PrefabLibrary::kInvalid) { std::printf("[prefab] data/defs introuvable (lancer depuis la racine du dépôt)\n"); return; }
+    const double loadMs = MsSince(t0);
+    const struct { const char* id; size_t count; } mix[] = { { "house_small", 30000 }, { "house_large", 12000 }, { "apartment_block", 4000 }, { "workshop", 3000 }, { "market", 600 }, { "farm", 399 }, { "town_hall", 1 } };
+    size_t total = 0; for (const auto& m : mix) total += m.count;
+    size_t sink = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        run.push_back({ "prefab.load_defs", loadMs, (double)lib.size() });
+        {
+            Registry reg; std::vector<Entity> handles; handles.reserve(total);
+            t0 = Clock::now();
+            for (const auto& m : mix) {
+                lib.instantiate<Transform>(reg, lib.find(m.id), m.count, &handles, [&](size_t i, Transform& t) {
+                    t.position = glm::vec3((float)(i % 256) * 30.f, (float)(i / 256) * 30.f, 0.f);
+                });
+            }
+            run.push_back({ "prefab.city.batched", MsSince(t0), (double)total });
+            sink += handles.size() + reg.archetypeCount();
+        }
+        {
+            Registry reg; const PrefabId house = lib.find("house_small");
+            const Building b{}; const Name n{ lib.strings().find("building.house_small") };
+            t0 = Clock::now();
+            for (size_t i=0; i<total; ++i) {
+                Entity e = reg.create();
+                Transform t; t.position = glm::vec3((float)(i % 256) * 30.f, (float)(i / 256) * 30.f, 0.f);
+                reg.add<Transform>(e, t); reg.add<Name>(e, n); reg.add<Building>(e, b); reg.add<Residence>(e, Residence{ Entity::Null(), 4, 0 });
+            }
+            run.push_back({ "prefab.city.one_by_one", MsSince(t0), (double)total });
+            sink += reg.alive() + house;
+        }
+        KeepBest(out, run);
+    }
+    std::printf("[prefab] prefabs=%zu entities=%zu checksum=%zu\n", lib.size(), total, sink);
+}
+
+// Sauvegarde binaire: carte opt.mapSize + ville de mapSize²/16 entités. Capture (arrêt du thread appelant), écriture
+// zstd, chargement complet et partiel (monde sans villes: couches header/tiles/heightsQ, entités sans Building).
+static void BenchSave(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map = MakeTerrain(opt); map.quantizeHeights();
+    const size_t n = (size_t)opt.mapSize * opt.mapSize / 16;
+    Registry reg; std::mt19937 rng(opt.seed);
+    std::uniform_real_distribution<float> pos(0.f, 4000.f);
+    std::vector<Entity> handles; handles.reserve(n);
+    for (size_t i=0; i<n; ++i) {
+        Transform t; t.position = glm::vec3(pos(rng), pos(rng), 0.f);
+        if (i % 4 == 0) handles.push_back(reg.create(t, Building{ (uint32_t)(i % 7), 10.f, 12.f, (uint16_t)(1 + i % 5) }, Name{ (uint32_t)(i % 64) }));
+        else handles.push_back(reg.create(t, Residence{ handles[i - i % 4], 0, 0 }));
+    }
+    for (uint16_t c=1; c<=64; ++c) reg.create(Transform{}, Country{ c, 0x336699u });
+    const std::string path = (std::filesystem::temp_directory_path() / "warland_bench.wsav").string();
+    uintmax_t fileBytes = 0; size_t rawBytes = 0, sink = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        SaveGame::Snapshot world, snap;
+        auto t0 = Clock::now(); SaveGame::CaptureMap(map, world);
+        run.push_back({ "save.capture.map", MsSince(t0), (double)map.width * map.height });
+        t0 = Clock::now(); snap = world; SaveGame::CaptureMeta(1, snap); SaveGame::CaptureEntities(reg, snap);
+        run.push_back({ "save.capture.entities", MsSince(t0), (double)reg.alive() });
+        rawBytes = snap.rawBytes();
+        t0 = Clock::now(); SaveGame::AsyncWriter writer; writer.begin(snap, path);
+        run.push_back({ "save.async.begin", MsSince(t0), 1.0 });
+        writer.wait();
+        run.push_back({ "save.write.zstd3", writer.lastWriteMs(), (double)rawBytes });
+        fileBytes = std::filesystem::file_size(path);
+        { Registry r2; TileMap m2; t0 = Clock::now(); SaveGame::Load(path, &r2, &m2); run.push_back({ "save.load.full", MsSince(t0), (double)r2.alive() }); sink += r2.alive(); }
+        {
+            Registry r2; TileMap m2; SaveGame::LoadOptions lo; lo.mapLayers = { "header", "tiles", "heightsQ" }; lo.skipComponents = { "Building" };
+            t0 = Clock::now(); SaveGame::Load(path, &r2, &m2, lo);
+            run.push_back({ "save.load.world_only", MsSince(t0), (double)r2.alive() }); sink += r2.alive();
+        }
+        KeepBest(out, run);
+    }
+    std::error_code ec; std::filesystem::remove(path, ec);
+    std::printf("[save] entities=%zu raw=%.1f MB file=%.1f MB checksum=%zu\n", reg.alive(), rawBytes / 1048576.0, fileBytes / 1048576.0, sink);
+}
+
+// Autosave incrémental: même monde que "save", 1% des Transform modifiés, 0.1% des entités détruites/créées et un
+// rectangle de hauteurs entre deux sauvegardes. Delta vs checkpoint (capture + écriture), rejeu d'une chaîne de 8 deltas
+// vs chargement complet, compaction. Vérifie que les deltas restent des deltas et que la chaîne rejouée comme le
+// checkpoint compacté redonnent exactement le registre et la carte vivants.
+static void BenchAutosave(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map = MakeTerrain(opt); map.quantizeHeights();
+    const size_t n = (size_t)opt.mapSize * opt.mapSize / 16;
+    Registry reg; std::mt19937 rng(opt.seed);
+    std::uniform_real_distribution<float> pos(0.f, 4000.f);
+    std::vector<Entity> handles; handles.reserve(n);
+    for (size_t i=0; i<n; ++i) {
+        Transform t; t.position = glm::vec3(pos(rng), pos(rng), 0.f);
+        if (i % 4 == 0) handles.push_back(reg.create(t, Building{ (uint32_t)(i % 7), 10.f, 12.f, (uint16_t)(1 + i % 5) }, Name{ (uint32_t)(i % 64) }));
+        else handles.push_back(reg.create(t, Residence{ handles[i - i % 4], 0, 0 }));
+    }
+    const std::string dir = (std::filesystem::temp_directory_path() / "warland_bench_autosave").string();
+    size_t fullRaw = 0, deltaRaw = 0, sink = 0; uintmax_t fullFile = 0, deltaFile = 0;
+    reg.trackRemovals<Transform>(); ECS::ChangeCursor poll;
+    auto tick = [&](Autosave& as) {
+        for (size_t k=0; k<n / 100; ++k) { Entity e = handles[rng() % handles.size()]; if (reg.valid(e)) reg.patch<Transform>(e).position.z += 1.f; }
+        for (size_t k=0; k<n / 1000; ++k) {
+            const size_t i = rng() % handles.size(); reg.destroy(handles[i]);
+            Transform t; t.position = glm::vec3(pos(rng), pos(rng), 0.f); handles[i] = reg.create(t, Residence{ handles[i & ~size_t(3)], 0, 0 });
+        }
+        const int x = (int)(rng() % (uint32_t)std::max(map.width - 32, 1)), y = (int)(rng() % (uint32_t)std::max(map.height - 32, 1));
+        for (int yy=y; yy<std::min(y + 32, map.height); ++yy) for (int xx=x; xx<std::min(x + 32, map.width); ++xx) map.tileHeightsQ[(size_t)yy * map.width + xx] ^= 1;
+        as.markTiles("heightsQ", x, y, x + 32, y + 32);
+        for (int k=0; k<4096; ++k) poll.since(reg); // systèmes réactifs entre deux sauvegardes: l'horloge avance bien plus vite
+    };
+    auto verify = [&](const char* what, Registry& r2, const TileMap& m2) {
+        auto same = [](const auto* a, const auto* b, auto eq) { return (!a && !b) || (a && b && eq(*a, *b)); };
+        size_t bad = 0;
+        for (Entity e : handles) {
+            if (!r2.valid(e)) { ++bad; continue; }
+            const bool ok = same(reg.tryGet<Transform>(e), r2.tryGet<Transform>(e), [](const Transform& a, const Transform& b) { return a.position == b.position; })
+                && same(reg.tryGet<Building>(e), r2.tryGet<Building>(e), [](const Building& a, const Building& b) { return a.typeId == b.typeId && a.footprintX == b.footprintX && a.footprintY == b.footprintY && a.floors == b.floors; })
+                && same(reg.tryGet<Name>(e), r2.tryGet<Name>(e), [](const Name& a, const Name& b) { return a.id == b.id; })
+                && same(reg.tryGet<Residence>(e), r2.tryGet<Residence>(e), [](const Residence& a, const Residence& b) { return a.home == b.home && a.capacity == b.capacity && a.occupants == b.occupants; });
+            bad += ok ? 0 : 1;
+        }
+        Check(r2.alive() == reg.alive(), "autosave", std::string(what) + ": " + std::to_string(r2.alive()) + " entités chargées, " + std::to_string(reg.alive()) + " vivantes");
+        Check(bad == 0, "autosave", std::string(what) + ": " + std::to_string(bad) + " entités absentes ou différentes");
+        Check(m2.tileHeightsQ == map.tileHeightsQ, "autosave", std::string(what) + ": hauteurs différentes");
+    };
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        std::error_code ec; std::filesystem::remove_all(dir, ec);
+        {
+            AutosavePolicy pol; pol.fullEvery = 1000; pol.fullRatio = 1.0;
+            Autosave as(dir, "bench", pol);
+            as.save(reg, &map, 1, nullptr, true); as.wait();
+            run.push_back({ "autosave.full.capture", as.lastCaptureMs(), (double)reg.alive() });
+            run.push_back({ "autosave.full.write", as.lastWriteMs(), (double)as.lastRawBytes() });
+            fullRaw = as.lastRawBytes();
+            double capture = 1e30, write = 1e30;
+            for (int d=0; d<8; ++d) {
+                tick(as); as.save(reg, &map, 2 + d);
+                Check(as.wait() && !as.lastWasFull(), "autosave", "sauvegarde " + std::to_string(d + 1) + " écrite en checkpoint ou en échec");
+                capture = std::min(capture, as.lastCaptureMs()); write = std::min(write, as.lastWriteMs()); deltaRaw = as.lastRawBytes();
+            }
+            run.push_back({ "autosave.delta.capture", capture, (double)(n / 100) });
+            run.push_back({ "autosave.delta.write", write, (double)deltaRaw });
+        }
+        const std::vector<std::string> chain = Autosave::FindChain(dir, "bench");
+        fullFile = chain.empty() ? 0 : std::filesystem::file_size(chain.front(), ec);
+        deltaFile = chain.size() < 2 ? 0 : std::filesystem::file_size(chain.back(), ec);
+        Check(chain.size() == 9, "autosave", "chaîne de " + std::to_string(chain.size()) + " fichiers (9 attendus)");
+        {
+            Registry r2; TileMap m2; auto t0 = Clock::now(); const bool ok = Autosave::LoadLatest(dir, "bench", &r2, &m2);
+            run.push_back({ "autosave.load.chain", MsSince(t0), (double)chain.size() }); sink += r2.alive();
+            if (Check(ok, "autosave", "chargement de la chaîne")) verify("chaîne", r2, m2);
+        }
+        { auto t0 = Clock::now(); Check(Autosave::Compact(dir, "bench"), "autosave", "compaction"); run.push_back({ "autosave.compact", MsSince(t0), (double)chain.size() }); }
+        {
+            Registry r2; TileMap m2; auto t0 = Clock::now(); const bool ok = Autosave::LoadLatest(dir, "bench", &r2, &m2);
+            run.push_back({ "autosave.load.compacted", MsSince(t0), 1.0 }); sink += r2.alive();
+            if (Check(ok, "autosave", "chargement compacté")) verify("compacté", r2, m2);
+        }
+        KeepBest(out, run);
+    }
+    std::error_code ec; std::filesystem::remove_all(dir, ec);
+    std::printf("[autosave] entities=%zu full raw=%.1f MB file=%.2f MB | delta raw=%.2f MB file=%.3f MB checksum=%zu\n",
+                reg.alive(), fullRaw / 1048576.0, fullFile / 1048576.0, deltaRaw / 1048576.0, deltaFile / 1048576.0, sink);
+}
+
+// EventBus: mapSize² événements publiés depuis le thread appelant puis depuis tous les workers (clé = index), livrés par
+// lot à deux abonnés. Tampons déjà à leur taille (régime établi, sans allocation); comparé à un vector sous mutex.
+// Le checksum dépend de l'ordre de livraison: identique en séquentiel et en parallèle si l'ordre est déterministe.
+struct BenchEvent { uint32_t index; float value; };
+static void BenchEvents(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    const size_t n = (size_t)opt.mapSize * opt.mapSize;
+    ThreadPool& pool = ThreadPool::Shared();
+    EventBus bus; uint64_t hash = 0; size_t delivered = 0;
+    bus.subscribe<BenchEvent>([&](std::span<const BenchEvent> events) { for (const BenchEvent& e : events) hash = hash * 1099511628211ull + e.index; });
+    bus.subscribe<BenchEvent>([&](std::span<const BenchEvent> events) { delivered += events.size(); });
+    auto publishAll = [&](bool parallel) {
+        if (!parallel) { for (size_t i=0; i<n; ++i) bus.publish(BenchEvent{ (uint32_t)i, 1.f }, i); return; }
+        pool.parallelFor(n, 16384, [&](size_t b, size_t e) { for (size_t i=b; i<e; ++i) bus.publish(BenchEvent{ (uint32_t)i, 1.f }, i); });
+    };
+    publishAll(false); bus.dispatch(); publishAll(true); bus.dispatch(); // tampons de tous les threads à taille
+    uint64_t seqHash = 0, parHash = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        auto t0 = Clock::now(); publishAll(false);
+        run.push_back({ "events.publish.single", MsSince(t0), (double)n });
+        hash = 0; t0 = Clock::now(); bus.dispatch();
+        run.push_back({ "events.dispatch.single", MsSince(t0), (double)n }); seqHash = hash;
+        t0 = Clock::now(); publishAll(true);
+        run.push_back({ "events.publish.parallel", MsSince(t0), (double)n });
+        hash = 0; t0 = Clock::now(); bus.dispatch();
+        run.push_back({ "events.dispatch.parallel_sorted", MsSince(t0), (double)n }); parHash = hash;
+        std::mutex m; std::vector<BenchEvent> locked; locked.reserve(n);
+        t0 = Clock::now();
+        pool.parallelFor(n, 16384, [&](size_t b, size_t e) { for (size_t i=b; i<e; ++i) { std::lock_guard<std::mutex> lock(m); locked.push_back({ (uint32_t)i, 1.f }); } });
+        run.push_back({ "events.publish.mutex_baseline", MsSince(t0), (double)n });
+        KeepBest(out, run);
+    }
+    std::printf("[events] events=%zu threads=%u delivered=%zu deterministic=%s\n", n, pool.workerCount() + 1, delivered, seqHash == parHash ? "yes" : "NO");
+}
+
+// Messagers: max(100k, mapSize²/16) messages en vol, arrivées uniformes sur une journée de jeu (60 ticks/s).
+// Planification, une minute tick par tick (coût par tick constant), annulation de 10%, puis timewarp jusqu'à la
+// dernière arrivée (cases vides sautées). Comparé à une file de priorité (annulation non O(1): non mesurée).
+static void BenchMessaging(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    using namespace InUniverseMessaging;
+    const size_t n = std::max<size_t>(100000, (size_t)opt.mapSize * opt.mapSize / 16);
+    const Tick day = 24 * 3600 * 60, minute = 3600;
+    std::vector<Tick> arrivals(n); std::mt19937_64 rng(opt.seed);
+    for (Tick& a : arrivals) a = 1 + rng() % day;
+    size_t sink = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        MessagingSystem sys; sys.setDeliver([&](Tick, std::span<const Message> batch) { sink += batch.size(); });
+        std::vector<MessageId> ids(n); sys.wheel().reserve(n);
+        auto t0 = Clock::now();
+        for (size_t i=0; i<n; ++i) { Message m; m.kind = (uint32_t)i; ids[i] = sys.send(m, (double)arrivals[i] / 60.0); }
+        run.push_back({ "messaging.schedule", MsSince(t0), (double)n });
+        t0 = Clock::now(); for (Tick t=0; t<minute; ++t) sys.advance(1);
+        run.push_back({ "messaging.tick", MsSince(t0), (double)minute });
+        t0 = Clock::now(); for (size_t i=0; i<n; i+=10) sys.cancel(ids[i]);
+        run.push_back({ "messaging.cancel", MsSince(t0), (double)(n / 10) });
+        t0 = Clock::now(); sys.tickBatch(1.0 / 60.0, (int)day);
+        run.push_back({ "messaging.timewarp_day", MsSince(t0), (double)day });
+        sink += sys.inFlight();
+        // File de priorité: même planification, même minute tick par tick, même journée
+        using Item = std::pair<Tick, uint32_t>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+        t0 = Clock::now(); for (size_t i=0; i<n; ++i) pq.push({ arrivals[i], (uint32_t)i });
+        run.push_back({ "messaging.heap_baseline.schedule", MsSince(t0), (double)n });
+        t0 = Clock::now();
+        for (Tick t=1; t<=day; ++t) while (!pq.empty() && pq.top().first <= t) { sink += pq.top().second & 1; pq.pop(); }
+        run.push_back({ "messaging.heap_baseline.day_by_tick", MsSince(t0), (double)day });
+        KeepBest(out, run);
+    }
+    std::printf("[messaging] in flight=%zu checksum=%zu\n", n, sink);
+}
+
+// Routes synthétiques façon import Azgaar: polylignes de cases (Bresenham), bourgs reliés à leurs 3 voisins les plus
+// proches, extrémités partagées, croisements sans point commun; jusqu'à targetPoints points.
+static void MakeRoads(TileMap& map, const BenchmarkOptions& opt, size_t targetPoints) {
+    map.width = map.height = opt.mapSize; map.worldMaxX = map.worldMaxY = (float)opt.mapSize; map.kmPerUnit = 0.5f;
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<int> coord(0, opt.mapSize - 1);
+    std::vector<glm::ivec2> towns(std::max<size_t>(64, (size_t)std::sqrt((double)targetPoints) * 3));
+    for (glm::ivec2& t : towns) t = { coord(rng), coord(rng) };
+    for (size_t i=0; i<towns.size() && map.roads.points.size() < targetPoints; ++i) {
+        std::vector<std::pair<int64_t, size_t>> near;
+        for (size_t j=i+1; j<towns.size(); ++j) { const glm::ivec2 d = towns[j] - towns[i]; near.push_back({ (int64_t)d.x * d.x + (int64_t)d.y * d.y, j }); }
+        std::partial_sort(near.begin(), near.begin() + std::min<size_t>(3, near.size()), near.end());
+        for (size_t k=0; k<std::min<size_t>(3, near.size()); ++k) {
+            glm::ivec2 p = towns[i]; const glm::ivec2 q = towns[near[k].second];
+            const int dx = std::abs(q.x - p.x), dy = -std::abs(q.y - p.y), stepX = p.x < q.x ? 1 : -1, stepY = p.y < q.y ? 1 : -1;
+            for (int err=dx + dy;;) {
+                map.roads.addPoint(p.x, p.y);
+                if (p == q) break;
+                const int e2 = 2 * err;
+                if (e2 >= dy) { err += dy; p.x += stepX; }
+                if (e2 <= dx) { err += dx; p.y += stepY; }
+            }
+            map.roads.commitRoad(2);
+        }
+    }
+}
+
+// Graphe routier: ~100k points de routes synthétiques. Compilation complète, puis aller-retour par le cache de la carte
+// cuite (section NET.roads, empreinte des entrées vérifiée au chargement) et recherche du noeud le plus proche.
+static void BenchRoads(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map; MakeRoads(map, opt, 100000);
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<int> coord(0, opt.mapSize - 1);
+    const std::string path = (std::filesystem::temp_directory_path() / "warland_bench_roads.wsav").string();
+    RoadNetwork net; size_t sink = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        auto t0 = Clock::now(); net.build(map);
+        run.push_back({ "roads.build", MsSince(t0), (double)map.roads.points.size() });
+        SaveGame::Snapshot snap;
+        t0 = Clock::now(); net.capture(snap); SaveGame::Write(snap, path);
+        run.push_back({ "roads.cache.write", MsSince(t0), (double)net.edgeCount() });
+        RoadNetwork cached;
+        t0 = Clock::now(); const bool hit = cached.load(path, map);
+        run.push_back({ "roads.cache.load", MsSince(t0), (double)cached.edgeCount() });
+        uint32_t probe = 0;
+        t0 = Clock::now(); for (int i=0; i<100000; ++i) probe += cached.nearestNode(glm::vec2((float)coord(rng), (float)coord(rng)));
+        run.push_back({ "roads.nearest_node", MsSince(t0), 100000.0 });
+        sink += hit + probe;
+        KeepBest(out, run);
+    }
+    std::error_code ec; std::filesystem::remove(path, ec);
+    const RoadNetwork::BuildStats& st = net.stats();
+    std::printf("[roads] roads=%zu points=%zu snapped=%zu crossings=%zu -> nodes=%zu edges=%zu checksum=%zu\n",
+                map.roads.size(), st.points, st.snapped, st.crossings, net.nodeCount(), net.edgeCount(), sink);
+}
+
+// Itinéraires monde: hiérarchie de contraction sur le graphe des ~100k points de BenchRoads. Ordre + personnalisation,
+// 100k requêtes de temps de parcours et 10k itinéraires dépliés entre noeuds aléatoires, puis une route coupée
+// (personnalisation partielle) comparée à une personnalisation complète.
+static void BenchRoutes(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map; MakeRoads(map, opt, 100000);
+    RoadNetwork net; net.build(map);
+    if (net.empty()) return;
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<uint32_t> pick(0, (uint32_t)net.nodeCount() - 1);
+    const int queries = 100000, routes = 10000;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(queries);
+    for (auto& p : pairs) p = { pick(rng), pick(rng) };
+    ContractionHierarchy ch; double sink = 0.0; size_t updated = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        auto t0 = Clock::now(); ch.build(net);
+        run.push_back({ "routes.build", MsSince(t0), (double)net.nodeCount() });
+        ContractionHierarchy::Query q(ch);
+        t0 = Clock::now(); for (const auto& p : pairs) { const float s = q.travelSeconds(p.first, p.second); if (s < ContractionHierarchy::kInf) sink += s; }
+        run.push_back({ "routes.query", MsSince(t0), (double)queries });
+        std::vector<uint32_t> path;
+        t0 = Clock::now(); for (int i=0; i<routes; ++i) { q.route(pairs[i].first, pairs[i].second, path); sink += (double)path.size(); }
+        run.push_back({ "routes.route_unpacked", MsSince(t0), (double)routes });
+        const uint32_t blocked = (uint32_t)(rng() % net.edgeCount()); const float speed = net.edge(blocked).speedKmh;
+        net.setSpeed(blocked, 0.f);
+        t0 = Clock::now(); updated = ch.update(net, std::span<const uint32_t>(&blocked, 1));
+        run.push_back({ "routes.update_one_blocked", MsSince(t0), (double)updated });
+        t0 = Clock::now(); ch.customize(net);
+        run.push_back({ "routes.customize_full", MsSince(t0), (double)ch.stats().arcs });
+        net.setSpeed(blocked, speed); ch.update(net, std::span<const uint32_t>(&blocked, 1));
+        KeepBest(out, run);
+    }
+    const ContractionHierarchy::Stats& st = ch.stats();
+    std::printf("[routes] nodes=%zu edges=%zu arcs=%zu triangles=%zu tree height=%zu checksum=%.0f\n", st.nodes, st.edges, st.arcs, st.triangles, st.treeHeight, sink);
+}
+
+// Tables de délais: 300 sources x 3000 cibles sur le graphe de BenchRoutes, calcul groupé (RPHAST multi-sources,
+// tous les workers) comparé à une requête point à point par cellule (échantillon de 30 lignes, extrapolé). Puis une
+// route coupée: rafraîchissement du cache limité aux lignes/colonnes touchées.
+static void BenchMatrix(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    TileMap map; MakeRoads(map, opt, 100000);
+    RoadNetwork net; net.build(map);
+    if (net.empty()) return;
+    ContractionHierarchy ch; ch.build(net);
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<uint32_t> pick(0, (uint32_t)net.nodeCount() - 1);
+    std::vector<uint32_t> sources(300), targets(3000);
+    for (uint32_t& s : sources) s = pick(rng);
+    for (uint32_t& t : targets) t = pick(rng);
+    const size_t cells = sources.size() * targets.size();
+    double sink = 0.0; size_t refreshed = 0;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        TravelTimeMatrix m; m.setEndpoints(sources, targets);
+        auto t0 = Clock::now(); m.refresh(ch);
+        run.push_back({ "matrix.compute", MsSince(t0), (double)cells });
+        ContractionHierarchy::Query q(ch);
+        const size_t sampleRows = 30;
+        t0 = Clock::now();
+        for (size_t i=0; i<sampleRows; ++i) for (size_t j=0; j<targets.size(); ++j) { const float s = q.travelSeconds(sources[i], targets[j]); if (s < ContractionHierarchy::kInf) sink += s - m.at(i, j); }
+        run.push_back({ "matrix.point_queries_baseline", MsSince(t0) * (double)sources.size() / sampleRows, (double)cells });
+        const uint32_t blocked = (uint32_t)(rng() % net.edgeCount()); const float speed = net.edge(blocked).speedKmh;
+        net.setSpeed(blocked, 0.f); ch.update(net, std::span<const uint32_t>(&blocked, 1));
+        t0 = Clock::now(); refreshed = m.refresh(ch);
+        run.push_back({ "matrix.refresh_one_blocked", MsSince(t0), (double)refreshed });
+        t0 = Clock::now(); m.refresh(ch);
+        run.push_back({ "matrix.refresh_cached", MsSince(t0), 1.0 });
+        net.setSpeed(blocked, speed); ch.update(net, std::span<const uint32_t>(&blocked, 1));
+        for (size_t j=0; j<targets.size(); ++j) if (m.at(0, j) < TravelTimeMatrix::kInf) sink += m.at(0, j);
+        KeepBest(out, run);
+    }
+    std::printf("[matrix] %zux%zu nodes=%zu threads=%u last refresh=%zu cells checksum=%.0f\n", sources.size(), targets.size(), net.nodeCount(), ThreadPool::Shared().workerCount() + 1, refreshed, sink);
+}
+
+// Déplacements hors route (HPA*) sur la carte de MakeTerrain: mer infranchissable, biomes par bande d'altitude
+// (coûts 1/2/4/8). Construction complète (clusters 32x32, régions 256x256), 500 requêtes entre cases de terre tirées
+// au hasard (chemin abstrait, puis raffinement en cases), comparées à un A* direct sur la grille (échantillon de 3
+// requêtes, extrapolé). Puis une crue (bloc 64x64 -> eau): mise à jour des seuls clusters et régions touchés.
+static void BenchPathfinding(const BenchmarkOptions& opt, std::vector<BenchmarkResult>& out) {
+    using Pathfinding::HierarchicalGrid;
+    TileMap map = MakeTerrain(opt);
+    const int w = map.width, h = map.height;
+    for (size_t i=0; i<map.paletteIndices.size(); ++i) { const float v = map.tileHeights[i]; map.paletteIndices[i] = v <= 0.f ? 0u : (uint16_t)(2 + std::min((int)(v * 4.f), 3)); }
+    Pathfinding::TerrainCosts costs; costs.biome = { 1, 2, 4, 8 };
+    std::vector<uint32_t> land;
+    for (uint32_t i=0; i<(uint32_t)map.paletteIndices.size(); ++i) if (map.paletteIndices[i]) land.push_back(i);
+    if (land.empty()) return;
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<size_t> pick(0, land.size() - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(500);
+    for (auto& p : pairs) p = { land[pick(rng)], land[pick(rng)] };
+    // Référence: A* octile sur la grille entière (même modèle de coût)
+    auto gridAStar = [&](const HierarchicalGrid& g, uint32_t s, uint32_t t) -> uint64_t {
+        std::vector<uint32_t> dist((size_t)w * h, 0xFFFFFFFFu);
+        using Item = std::pair<uint64_t, uint32_t>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+        const int tx = (int)(t % w), ty = (int)(t / w);
+        auto est = [&](uint32_t c) { const int dx = std::abs((int)(c % w) - tx), dy = std::abs((int)(c / w) - ty); return (uint64_t)(std::min(dx, dy) * 7 + (std::max(dx, dy) - std::min(dx, dy)) * 5) * 2; };
+        dist[s] = 0; q.push({ est(s), s });
+        while (!q.empty()) {
+            const auto [f, c] = q.top(); q.pop();
+            if (f != dist[c] + est(c)) continue;
+            if (c == t) return dist[c];
+            const int x = (int)(c % w), y = (int)(c / w);
+            for (int dy=-1; dy<=1; ++dy) for (int dx=-1; dx<=1; ++dx) {
+                const int nx = x + dx, ny = y + dy;
+                if ((!dx && !dy) || nx < 0 || ny < 0 || nx >= w || ny >= h || !g.cost(nx, ny)) continue;
+                if (dx && dy && (!g.cost(nx, y) || !g.cost(x, ny))) continue;
+                const uint32_t nc = (uint32_t)(ny * w + nx), nd = dist[c] + (uint32_t)(g.cost(x, y) + g.cost(nx, ny)) * (dx && dy ? 7u : 5u);
+                if (nd < dist[nc]) { dist[nc] = nd; q.push({ nd + est(nc), nc }); }
+            }
+        }
+        return 0;
+    };
+    double sink = 0.0; size_t found = 0, expanded = 0, rebuilt = 0, cellsOut = 0;
+    HierarchicalGrid grid;
+    for (int r=0; r<std::max(opt.repeat, 1); ++r) {
+        std::vector<BenchmarkResult> run;
+        auto t0 = Clock::now(); grid.build(map, costs);
+        run.push_back({ "hpa.build", MsSince(t0), (double)w * h });
+        HierarchicalGrid::Query q(grid);
+        std::vector<HierarchicalGrid::Path> paths(pairs.size());
+        found = expanded = 0;
+        t0 = Clock::now();
+        for (size_t i=0; i<pairs.size(); ++i) {
+            const auto [s, t] = pairs[i];
+            if (q.findPath((int)(s % w), (int)(s / w), (int)(t % w), (int)(t / w), paths[i])) { ++found; sink += paths[i].cost; }
+            expanded += q.lastExpanded();
+        }
+        run.push_back({ "hpa.query", MsSince(t0), (double)pairs.size() });
+        std::vector<uint32_t> cells; cellsOut = 0;
+        t0 = Clock::now();
+        for (auto& p : paths) if (p.found() && q.refine(p, cells)) cellsOut += cells.size();
+        run.push_back({ "hpa.refine", MsSince(t0), (double)found });
+        const size_t sample = 3;
+        t0 = Clock::now();
+        for (size_t i=0; i<sample; ++i) sink += (double)gridAStar(grid, pairs[i].first, pairs[i].second) - (paths[i].found() ? paths[i].cost : 0);
+        run.push_back({ "hpa.grid_astar_baseline", MsSince(t0) * (double)pairs.size() / sample, (double)pairs.size() });
+        // Crue: bloc 64x64 centré sur une case de terre -> eau peu profonde, puis retour
+        const uint32_t center = land[pick(rng)];
+        const int x0 = std::max((int)(center % w) - 32, 0), y0 = std::max((int)(center / w) - 32, 0);
+        std::vector<uint16_t> saved;
+        for (int y=y0; y<std::min(y0 + 64, h); ++y) for (int x=x0; x<std::min(x0 + 64, w); ++x) { uint16_t& pi = map.paletteIndices[(size_t)y * w + x]; saved.push_back(pi); pi = 1; }
+        t0 = Clock::now(); grid.updateFromMap(map, costs, x0, y0, x0 + 64, y0 + 64); rebuilt = grid.flush();
+        run.push_back({ "hpa.update_flood_64", MsSince(t0), (double)rebuilt });
+        size_t k = 0;
+        for (int y=y0; y<std::min(y0 + 64, h); ++y) for (int x=x0; x<std::min(x0 + 64, w); ++x) map.paletteIndices[(size_t)y * w + x] = saved[k++];
+        grid.updateFromMap(map, costs, x0, y0, x0 + 64, y0 + 64); grid.flush();
+        KeepBest(out, run);
+    }
+    const HierarchicalGrid::Stats& st = grid.stats();
+    std::printf("[hpa] %dx%d clusters=%zu nodes=%zu components=%zu gates=%zu gate edges=%zu found=%zu/%zu expanded/query=%zu cells/path=%zu flood rebuilt=%zu clusters %zu regions checksum=%.0f\n",
+                w, h, st.clusters, st.nodes, st.components, st.gates, st.gateEdges, found, pairs.size(), expanded / pairs.size(), found ? cellsOut / found : 0, rebuilt, st.rebuiltRegions, sink);
+}
+
+struct Entry { const char* name; std::function<void(const BenchmarkOptions&, std::vector<BenchmarkResult>&)> run; };
+static const std::vector<Entry>& Entries() {
+    static const std::vector<Entry> entries = {
+        { "hydrology", BenchHydrology },
+        { "heights", BenchHeightCodec },
+        { "layout", BenchRasterLayout },
+        { "simrates", BenchSimRates },
+        { "ecs", BenchEcs },
+        { "spatial", BenchSpatial },
+        { "prefab", BenchPrefab },
+        { "save", BenchSave },
+        { "autosave", BenchAutosave },
+        { "events", BenchEvents },
+        { "messaging", BenchMessaging },
+        { "roads", BenchRoads },
+        { "routes", BenchRoutes },
+        { "matrix", BenchMatrix },
+        { "hpa", BenchPathfinding },
+    };
+    return entries;
+}
+}
+
+namespace BenchmarkSuite {
+
+std::vector<std::string> List() {
+    std::vector<std::string> names; for (auto& e : Entries()) names.push_back(e.name); return names;
+}
+
+std::vector<BenchmarkResult> Run(const BenchmarkOptions& opt) {
+    std::vector<BenchmarkResult> results;
+    gFailures = 0;
+    for (auto& e : Entries()) {
+        if (!opt.filter.empty() && std::string(e.name).find(opt.filter) == std::string::npos) continue;
+        e.run(opt, results);
+    }
+    return results;
+}
+
+void Print(const std::vector<BenchmarkResult>& results) {
+    std::printf("%-36s %12s %16s\n", "benchmark", "ms", "items/s");
+    for (auto& r : results) std::printf("%-36s %12.3f %16.0f\n", r.name.c_str(), r.ms, r.itemsPerSec());
+}
+
+size_t Failures() { return gFailures; }
+
+}
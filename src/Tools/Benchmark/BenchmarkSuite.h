@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Suite de benchmarks moteur (génération monde, simulation...). Chaque entrée produit une ou plusieurs mesures.
+struct BenchmarkOptions {
+    int mapSize = 2048;               // taille de carte synthétique (cellules par côté)
+    uint64_t seed = 123456789ull;     // seed terrain
+    int repeat = 1;                   // répétitions (meilleur temps retenu)
+    std::string filter;               // sous-chaîne du nom, vide = tout
+};
+
+struct BenchmarkResult {
+    std::string name;     // ex: "hydrology.fill"
+    double ms = 0.0;      // temps mur (meilleur des répétitions)
+    double items = 0.0;   // éléments traités (cellules, ticks, entités...)
+    double itemsPerSec() const { return ms > 0.0 ? items / (ms / 1000.0) : 0.0; }
+};
+
+namespace BenchmarkSuite {
+    std::vector<std::string> List();
+    std::vector<BenchmarkResult> Run(const BenchmarkOptions& opt);
+    void Print(const std::vector<BenchmarkResult>& results);
+    // Vérifications de cohérence échouées pendant le dernier Run() (résultat comparé à une référence, détail sur stderr)
+    size_t Failures();
+}
@@ -7,6 +7,10 @@
 #include <imgui_impl_opengl3.h>
 
 #include "Core/Application.h"
+#include "Core/Headless.h"
+#include "Core/Profiler.h"
+#include "Platform/ThreadPool.h"
+#include <string>
 
 static void SetupImGui(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
@@ -27,7 +31,11 @@ static void ShutdownImGui() {
     ImGui::DestroyContext();
 }
 
-int main(int, char**) {
+int main(int argc, char** argv) {
+    // Workers nommés dans l'export du profileur (Platform ne dépend pas de Core: le nom est injecté ici)
+    ThreadPool::SetWorkerStartHook([](unsigned worker){ Profiler::SetThreadName(("Worker " + std::to_string(worker)).c_str()); });
+    // CI / serveurs sans GPU: aucune fenêtre ni contexte GL
+    if (Headless::Requested(argc, argv)) return Headless::Main(argc, argv);
     Application app;
     if (!app.init()) return -1;
     app.run();